@@ -35,18 +35,55 @@
 #define INC_DFPLAYER_MINI_H_
 
 #include "stm32f10x.h"
+#include "coroutine.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/* Frames sent by the module, either on its own or as the reply to a query */
+#define DF_RESPONSE_TF_FINISHED     0x3D /* A track on the TF card finished, param: global track number */
+#define DF_RESPONSE_ONLINE          0x3F /* Module online after power-up/reset, param: available devices */
+#define DF_RESPONSE_ERROR           0x40 /* Error, param: error code */
+#define DF_RESPONSE_ACK             0x41 /* Acknowledge of a command sent with feedback */
+#define DF_RESPONSE_TF_FILE_NUM     0x48 /* Reply to \ref df_query_tf_file_num, param: number of files */
+#define DF_RESPONSE_FOLDER_FILE_NUM 0x4E /* Reply to \ref df_query_file_num_from_folder, param: number of files */
+
+/* Error codes carried by \ref DF_RESPONSE_ERROR frames */
+#define DF_ERROR_BUSY               0x01 /* Module is busy (initializing) */
+#define DF_ERROR_SLEEP              0x02 /* Module is in sleep mode */
+#define DF_ERROR_FRAME              0x03 /* Frame not received completely */
+#define DF_ERROR_CHECKSUM           0x04 /* Checksum mismatch */
+#define DF_ERROR_OUT_OF_SCOPE       0x05 /* Track number out of scope */
+#define DF_ERROR_NOT_FOUND          0x06 /* Track or folder not found */
+#define DF_ERROR_INSERTION          0x07 /* Advert inserted while no track is playing */
+#define DF_ERROR_CARD               0x08 /* TF card read failure */
+
+/**
+ * \brief           Frame received from the module
+ */
+typedef struct df_response {
+    uint8_t cmd;    /*!< Command byte of the frame, one of `DF_RESPONSE_*` */
+    uint16_t param; /*!< Parameter of the frame (DH << 8 | DL) */
+} df_response_t;
+
 void df_init(uint8_t volume);
+coroutine_status_t df_init_process(void);
+uint8_t df_is_ready(void);
 void df_pause(void);
 void df_continue(void);
 void df_play_from_folder(uint8_t folder, uint8_t number);
+void df_play_from_large_folder(uint8_t folder, uint16_t number);
+void df_play_from_mp3_folder(uint16_t number);
+void df_play_advert(uint16_t number);
+void df_stop_advert(void);
 void df_loop_from_folder(uint8_t folder);
 void df_set_volume(uint8_t volume);
-uint8_t df_get_file_num_from_folder(uint8_t folder);
+uint32_t df_get_idle_ms(void);
+coroutine_status_t df_get_file_num_from_folder(coroutine_t* co, uint8_t folder, uint16_t* num);
+void df_query_tf_file_num(void);
+void df_query_file_num_from_folder(uint8_t folder);
+uint8_t df_read_response(df_response_t* response);
 
 #ifdef __cplusplus
 }
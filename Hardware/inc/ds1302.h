@@ -41,6 +41,16 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* Fields of the date and time, bit n is ds1302_time[n] */
+#define DS1302_FIELD_YEAR   0x01
+#define DS1302_FIELD_MONTH  0x02
+#define DS1302_FIELD_DAY    0x04
+#define DS1302_FIELD_HOUR   0x08
+#define DS1302_FIELD_MINUTE 0x10
+#define DS1302_FIELD_SECOND 0x20
+#define DS1302_FIELD_WEEK   0x40
+#define DS1302_FIELD_ALL    0x7F
+
 extern uint8_t ds1302_time[8]; //存放日期和时间
 
 void ds1302_write_byte(uint8_t addr_or_data);      //DS1302 写一字节 函数
@@ -49,6 +59,7 @@ uint8_t ds1302_read_byte(void);                    //DS1302 读一字节 函数
 uint8_t ds1302_read_data(uint8_t addr);            //DS1302 写一字节 函数
 void ds1302_bcd_to_dec(uint8_t* bcd, uint8_t times); //BCD 转 十进制 函数
 void ds1302_dec_to_bcd(uint8_t* dec, uint8_t times); //十进制 转 BCD 函数
+void ds1302_write_fields(const uint8_t* time, uint8_t fields); //DS1302 写入选定的日期和时间字段 函数
 void ds1302_init(void);                           //DS1302 初始化日期和时间 函数
 void ds1302_read(void);                           //DS1302 读取  日期和时间 函数
 
@@ -36,13 +36,16 @@
 #define ElysiaVACLK_DS18B20_H
 
 #include "stm32f10x.h"
+#include "coroutine.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
-void ds18b20_convert_t();
-float ds18b20_read_t();
+coroutine_status_t ds18b20_convert_t(coroutine_t* co);
+coroutine_status_t ds18b20_read_t(coroutine_t* co, float* t);
+float ds18b20_get_t(void);
+bool ds18b20_is_present(void);
 void ds18b20_init(void);
 
 #ifdef __cplusplus
@@ -50,9 +50,20 @@ extern "C" {
 
 /* The size of USART RX buffer for DMA to transfer */
 #define DMA_BUF_SIZE    (10)
+
+/* The size of the buffer collecting one burst of received bytes (until the line goes idle) */
+#define UART_RX_PACKET_SIZE (20)
 /*-----------------------------------------------------------------*/
 
+/**
+ * \brief           Callback invoked from the USART1 IDLE interrupt with the bytes received since the last idle
+ * \param[in]       data: Received bytes
+ * \param[in]       len: Number of received bytes
+ */
+typedef void (*uart_rx_callback_t)(const uint8_t* data, size_t len);
+
 void uart_init(void);
+void uart_set_rx_callback(uart_rx_callback_t callback);
 void uart_send_byte(uint8_t byte);
 void uart_send_bytes(const uint8_t bytes[], size_t len);
 void uart_send_string(const char* str);
@@ -33,10 +33,11 @@
 */
 
 #include "stm32f10x.h"
+#include "dfplayer_mini.h"
 #include "uart.h"
+#include "counter.h"
 
 #define LOG_TAG "DFPLAYER_MINI"
-#include "delay.h"
 #include "elog.h"
 
 /**
@@ -58,8 +59,36 @@
 #define PACKET_LEN (8)
 #define FEEDBACK   0x00 /* If we need for FEEDBACK: 0x01,  No FEEDBACK: 0 */
 
+/* A frame received from the module: START, VERSION, LEN, CMD, FEEDBACK, DH, DL, CHECKSUM(2), END */
+#define FRAME_LEN  (PACKET_LEN + 2)
+
+/* Number of received frames buffered until \ref df_read_response() picks them up, power of two */
+#define DF_RESPONSE_QUEUE_LEN (8)
+
+/* Time the module takes to read the TF card after selecting it as the source */
+#define DF_INIT_MS            (2000)
+
+/* Longest wait for the reply to a query */
+#define DF_REPLY_MS           (200)
+
 uint8_t uart_tx_packet[PACKET_LEN];
-uint8_t uart_rx_packet[PACKET_LEN];
+
+/* Frames received in the USART1 interrupt, consumed by the main loop */
+static df_response_t df_response_queue[DF_RESPONSE_QUEUE_LEN];
+static volatile uint8_t df_response_head; /* Written by the interrupt only */
+static volatile uint8_t df_response_tail; /* Written by the main loop only */
+
+/* Parameter of the latest \ref DF_RESPONSE_FOLDER_FILE_NUM frame, and whether one came since the query */
+static volatile uint16_t df_folder_file_num;
+static volatile uint8_t df_folder_file_num_fresh;
+
+/* Initialization sequence, commands are only sent once it is done */
+static coroutine_t df_init_co;
+static uint8_t df_init_volume;
+static uint8_t df_ready;
+
+/* Time the latest command was sent, see \ref df_get_idle_ms() */
+static uint32_t df_command_ms;
 
 /**
  * \brief Sends a packet using the UART communication
@@ -91,7 +120,7 @@ df_send_packet(void) {
  * \param Parameter2: Second parameter byte
  */
 static void
-df_send_cmd(uint8_t cmd, uint8_t Parameter1, uint8_t Parameter2) {
+df_write_cmd(uint8_t cmd, uint8_t Parameter1, uint8_t Parameter2) {
     uint16_t Checksum = VERSION + DATA_LEN + cmd + FEEDBACK + Parameter1 + Parameter2;
     Checksum = 0 - Checksum;
 
@@ -105,6 +134,68 @@ df_send_cmd(uint8_t cmd, uint8_t Parameter1, uint8_t Parameter2) {
     uart_tx_packet[7] = (Checksum & 0x00ff);
 
     df_send_packet();
+    df_command_ms = counter_get_ms();
+}
+
+/**
+ * \brief Sends a command packet once the module is initialized, drops it before
+ *
+ * \ref df_write_cmd
+ * \param cmd: Command byte
+ * \param Parameter1: First parameter byte
+ * \param Parameter2: Second parameter byte
+ */
+static void
+df_send_cmd(uint8_t cmd, uint8_t Parameter1, uint8_t Parameter2) {
+    if (!df_ready) {
+        log_w("Module starting, command %02X dropped.", cmd);
+        return;
+    }
+    df_write_cmd(cmd, Parameter1, Parameter2);
+}
+
+/**
+ * \brief Parse the frames received from the module and queue them
+ *
+ * Registered as the UART receive callback, so it runs in the USART1 IDLE interrupt.
+ * Frames with a wrong length, end byte or checksum are dropped, as are frames arriving
+ * while the queue is full.
+ *
+ * \param data: Bytes received since the last idle line
+ * \param len: Number of received bytes
+ */
+static void
+df_receive(const uint8_t* data, size_t len) {
+    while (len >= FRAME_LEN) {
+        if (data[0] != START_BYTE || data[FRAME_LEN - 1] != END_BYTE) {
+            data++;
+            len--;
+            continue;
+        }
+
+        uint16_t checksum = 0;
+        for (uint8_t i = 1; i < 7; i++) {
+            checksum += data[i];
+        }
+        checksum += (data[7] << 8) | data[8];
+        if (checksum == 0) {
+            uint8_t cmd = data[3];
+            uint16_t param = (data[5] << 8) | data[6];
+            if (cmd == DF_RESPONSE_FOLDER_FILE_NUM) {
+                df_folder_file_num = param;
+                df_folder_file_num_fresh = 1;
+            }
+            if ((uint8_t)(df_response_head - df_response_tail) < DF_RESPONSE_QUEUE_LEN) {
+                df_response_t* response = &df_response_queue[df_response_head % DF_RESPONSE_QUEUE_LEN];
+                response->cmd = cmd;
+                response->param = param;
+                df_response_head++;
+            }
+        }
+
+        data += FRAME_LEN;
+        len -= FRAME_LEN;
+    }
 }
 
 /**
@@ -115,17 +206,57 @@ df_send_cmd(uint8_t cmd, uint8_t Parameter1, uint8_t Parameter2) {
  * 2. Sends a command to set the source and wait for initialization to complete.
  * 3. Sends a command to set the volume.
  *
+ * Steps 1 and 2 are done here, the rest by \ref df_init_process, until then other commands are dropped.
+ *
  * \param volume: Volume level (0~30)
  */
 void
 df_init(uint8_t volume) // 0~30
 {
     uart_init();
-    df_send_cmd(0x3F, 0x00, SOURCE);
+    uart_set_rx_callback(df_receive);
+    df_init_volume = volume;
+    df_ready = 0;
+    coroutine_reset(&df_init_co);
+    df_init_process();
+}
+
+/**
+ * \brief Drives the initialization started by \ref df_init, call it from the main loop until it is done
+ * \return COROUTINE_DONE once the module takes commands
+ */
+coroutine_status_t
+df_init_process(void) {
+    COROUTINE_BEGIN(&df_init_co);
+    df_write_cmd(0x3F, 0x00, SOURCE);
     /* Wait for initialization to complete */
-    delay_s(2);
-    df_send_cmd(0x06, 0x00, volume);
+    COROUTINE_AWAIT_MS(&df_init_co, DF_INIT_MS);
+    df_write_cmd(0x06, 0x00, df_init_volume);
+    df_ready = 1;
     log_i("DF mini player is initialize success.");
+    COROUTINE_END(&df_init_co);
+}
+
+/**
+ * \brief Check whether the initialization is done
+ * \return 1 if the module takes commands, 0 otherwise
+ */
+uint8_t
+df_is_ready(void) {
+    return df_ready;
+}
+
+/**
+ * \brief Get the time since the latest command was sent
+ *
+ * The module needs a pause between two commands to take both, callers sending a burst of
+ * commands, such as volume steps, use this to pace them.
+ *
+ * \return Milliseconds since the latest command
+ */
+uint32_t
+df_get_idle_ms(void) {
+    return counter_get_ms() - df_command_ms;
 }
 
 /**
@@ -171,6 +302,54 @@ df_play_from_folder(uint8_t folder, uint8_t number) {
     df_send_cmd(0x0F, folder, number);
 }
 
+/**
+ * \brief Play a song from a specified folder holding up to 3000 songs
+ *
+ * \param folder Folder name (1 ~ 15)
+ * \note The folder should be named with two-digit numbers, such as 01, 02, ...
+ * \param number Song name (1 ~ 3000)
+ * \note The song number should be prefixed with four-digit numbers, such as 0001, 0002, ...
+ */
+void
+df_play_from_large_folder(uint8_t folder, uint16_t number) {
+    uint16_t param = (folder << 12) | (number & 0x0FFF);
+    df_send_cmd(0x14, param >> 8, param & 0xFF);
+}
+
+/**
+ * \brief Play a song from the folder named "MP3"
+ *
+ * \param number Song name (1 ~ 9999)
+ * \note The song number should be prefixed with four-digit numbers, such as 0001, 0002, ...
+ */
+void
+df_play_from_mp3_folder(uint16_t number) {
+    df_send_cmd(0x12, number >> 8, number & 0xFF);
+}
+
+/**
+ * \brief Interject a track of the folder named "ADVERT" into the playing track
+ *
+ * The playing track is suspended and resumes where it was once the advert ends.
+ * The module replies DF_ERROR_INSERTION if nothing is playing, and
+ * DF_ERROR_NOT_FOUND if the advert track does not exist.
+ *
+ * \param number Advert name (1 ~ 9999)
+ * \note The advert number should be prefixed with four-digit numbers, such as 0001, 0002, ...
+ */
+void
+df_play_advert(uint16_t number) {
+    df_send_cmd(0x13, number >> 8, number & 0xFF);
+}
+
+/**
+ * \brief Stop the advert and resume the interrupted track
+ */
+void
+df_stop_advert(void) {
+    df_send_cmd(0x15, 0, 0);
+}
+
 /**
  * \brief Set the DF Mini Player to loop playback from a specified folder
  *
@@ -188,14 +367,60 @@ df_loop_from_folder(uint8_t folder) {
  *
  * This function retrieves the number of files in the specified folder on the DF Mini Player.
  *
+ * \param co State of the coroutine
  * \param folder Folder name (1 ~ 99)
- * \return Number of files in the folder
+ * \param num Number of files in the folder, 0 if the module does not answer, set before the coroutine is done
+ * \return COROUTINE_DONE once the reply came or timed out
  */
-uint8_t
-df_get_file_num_from_folder(uint8_t folder) {
+coroutine_status_t
+df_get_file_num_from_folder(coroutine_t* co, uint8_t folder, uint16_t* num) {
+    COROUTINE_BEGIN(co);
+    df_folder_file_num_fresh = 0;
     df_send_cmd(0x4E, 0, folder);
-    delay_ms(200);
-    return (uart_rx_packet[5] << 4) | uart_rx_packet[6];
+    COROUTINE_AWAIT_TIMEOUT(co, df_folder_file_num_fresh, DF_REPLY_MS);
+    *num = df_folder_file_num_fresh ? df_folder_file_num : 0;
+    COROUTINE_END(co);
+}
+
+/**
+ * \brief Ask for the total number of files on the TF card without waiting for the reply
+ *
+ * The module answers with a \ref DF_RESPONSE_TF_FILE_NUM frame, see \ref df_read_response.
+ */
+void
+df_query_tf_file_num(void) {
+    df_send_cmd(0x48, 0, 0);
+}
+
+/**
+ * \brief Ask for the number of files in a folder without waiting for the reply
+ *
+ * The module answers with a \ref DF_RESPONSE_FOLDER_FILE_NUM frame, or with a
+ * \ref DF_RESPONSE_ERROR frame when the folder does not exist, see \ref df_read_response.
+ *
+ * \param folder Folder name (1 ~ 99)
+ */
+void
+df_query_file_num_from_folder(uint8_t folder) {
+    df_send_cmd(0x4E, 0, folder);
+}
+
+/**
+ * \brief Fetch the oldest frame received from the module
+ *
+ * Non-blocking, call it periodically from the main loop.
+ *
+ * \param response Filled with the received frame
+ * \return 1 if a frame was fetched, 0 if none is pending
+ */
+uint8_t
+df_read_response(df_response_t* response) {
+    if (df_response_tail == df_response_head) {
+        return 0;
+    }
+    *response = df_response_queue[df_response_tail % DF_RESPONSE_QUEUE_LEN];
+    df_response_tail++;
+    return 1;
 }
 
 #if defined(DEBUG)
@@ -213,17 +438,15 @@ df_test(void) {
     elog_init_();
     log_d("df_test");
     df_init(20);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
-    ELOG_ASSERT(df_get_file_num_from_folder(21) == 84);
+    while (df_init_process() == COROUTINE_WAITING) {}
+    for (uint8_t i = 0; i < 10; i++) {
+        coroutine_t co;
+        uint16_t num;
+
+        coroutine_reset(&co);
+        while (df_get_file_num_from_folder(&co, 21, &num) == COROUTINE_WAITING) {}
+        ELOG_ASSERT(num == 84);
+    }
     log_d("TEST PASSED!");
     while (1) {}
     return 0;
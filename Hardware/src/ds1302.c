@@ -32,7 +32,9 @@
 * Author:          JinLiang YAN <yanmiku0206@outlook.com>
 */
 
+#include <string.h>
 #include "ds1302.h"
+#include "profile.h"
 
 /* DS1302 RTC Clock GPIO Configuration */
 #define DS1302_CLK_RCC       RCC_APB2Periph_GPIOB /* Clock RCC */
@@ -79,6 +81,10 @@
 #define DS1302_WRITE_WEEK    0x8A /* Week */
 #define DS1302_WRITE_YEAR    0x8C /* Year */
 #define DS1302_WRITE_PROTECT 0x8E /* Protect */
+#define DS1302_WRITE_BURST   0xBE /* Clock burst, the 7 time registers and the protect register */
+
+#define DS1302_CLOCK_HALT    0x80 /* Seconds register bit, set while the oscillator is stopped */
+#define DS1302_PROTECT_ON    0x80 /* Protect register bit, set to ignore writes */
 
 /* Date and time definition: Year Month Day Hour Minute Second Week */
 uint8_t ds1302_time[8] = {23, 11, 23, 22, 2, 20, 4};
@@ -299,28 +305,66 @@ ds1302_dec_to_bcd(uint8_t* dec, uint8_t times) {
 }
 
 /**
- * \brief Initialize DS1302 module
+ * \brief Write fields of the date and time to DS1302
+ *
+ * This function writes the selected fields of a date and time, in the layout of `ds1302_time`, to the DS1302
+ * module in one write-enabled session. All seven fields go out as a single clock burst, fewer as single
+ * register writes, so the fields left out keep running. Write protection is enabled again afterwards.
  *
- * This function initializes the DS1302 module by configuring its pins, converting the current time from decimal to BCD,
- * and writing the BCD values to the corresponding DS1302 registers. It also enables write protection after initialization.
+ * \param[in] time: Year, month, day, hour, minute, second and week in decimal
+ * \param[in] fields: `DS1302_FIELD_*` to write
  */
 void
-ds1302_init(void) {
-    ds1302_config(); /* Configure pins */
+ds1302_write_fields(const uint8_t* time, uint8_t fields) {
+    static const uint8_t addr[7] = {
+        DS1302_WRITE_YEAR,   DS1302_WRITE_MONTH,  DS1302_WRITE_DAY,  DS1302_WRITE_HOUR,
+        DS1302_WRITE_MINUTE, DS1302_WRITE_SECOND, DS1302_WRITE_WEEK,
+    };
+    uint8_t bcd[7];
+    uint8_t i;
 
-    ds1302_dec_to_bcd(ds1302_time, 7); /* Convert current time from decimal to BCD */
+    memcpy(bcd, time, sizeof(bcd));
+    ds1302_dec_to_bcd(bcd, 7);
 
-    ds1302_write_cmd(DS1302_WRITE_PROTECT, 0x80); /* Enable write protection */
+    ds1302_write_cmd(DS1302_WRITE_PROTECT, 0x00); /* Disable write protection */
+    if ((fields & DS1302_FIELD_ALL) == DS1302_FIELD_ALL) {
+        DS1302_RST_LOW;
+        DS1302_CLK_LOW;
+        DS1302_RST_HIGH;
+        ds1302_write_byte(DS1302_WRITE_BURST);
+        ds1302_write_byte(bcd[5]); /* Second */
+        ds1302_write_byte(bcd[4]); /* Minute */
+        ds1302_write_byte(bcd[3]); /* Hour */
+        ds1302_write_byte(bcd[2]); /* Day */
+        ds1302_write_byte(bcd[1]); /* Month */
+        ds1302_write_byte(bcd[6]); /* Week */
+        ds1302_write_byte(bcd[0]); /* Year */
+        ds1302_write_byte(DS1302_PROTECT_ON);
+        DS1302_RST_LOW;
+        return;
+    }
+    for (i = 0; i < 7; i++) {
+        if (fields & (1 << i)) {
+            ds1302_write_cmd(addr[i], bcd[i]);
+        }
+    }
+    ds1302_write_cmd(DS1302_WRITE_PROTECT, DS1302_PROTECT_ON); /* Enable write protection */
+}
 
-    ds1302_write_cmd(DS1302_WRITE_YEAR, ds1302_time[0]);   /* Write year */
-    ds1302_write_cmd(DS1302_WRITE_MONTH, ds1302_time[1]);  /* Write month */
-    ds1302_write_cmd(DS1302_WRITE_DAY, ds1302_time[2]);    /* Write day */
-    ds1302_write_cmd(DS1302_WRITE_HOUR, ds1302_time[3]);   /* Write hour */
-    ds1302_write_cmd(DS1302_WRITE_MINUTE, ds1302_time[4]); /* Write minute */
-    ds1302_write_cmd(DS1302_WRITE_SECOND, ds1302_time[5]); /* Write second */
-    ds1302_write_cmd(DS1302_WRITE_WEEK, ds1302_time[6]);   /* Write week */
+/**
+ * \brief Initialize DS1302 module
+ *
+ * This function initializes the DS1302 module by configuring its pins. The date and time are left running;
+ * only when the oscillator is halted, as after the backup battery was replaced, `ds1302_time` is written
+ * to start it.
+ */
+void
+ds1302_init(void) {
+    ds1302_config(); /* Configure pins */
 
-    ds1302_write_cmd(DS1302_WRITE_PROTECT, 0x80); /* Enable write protection */
+    if (ds1302_read_data(DS1302_READ_SECOND) & DS1302_CLOCK_HALT) {
+        ds1302_write_fields(ds1302_time, DS1302_FIELD_ALL);
+    }
 }
 
 /**
@@ -331,6 +375,7 @@ ds1302_init(void) {
  */
 void
 ds1302_read(void) {
+    PROFILE_BEGIN(PROFILE_DS1302_READ);
     ds1302_time[0] = ds1302_read_data(DS1302_READ_YEAR);   /* Read year */
     ds1302_time[1] = ds1302_read_data(DS1302_READ_MONTH);  /* Read month */
     ds1302_time[2] = ds1302_read_data(DS1302_READ_DAY);    /* Read day */
@@ -340,4 +385,5 @@ ds1302_read(void) {
     ds1302_time[6] = ds1302_read_data(DS1302_READ_WEEK);   /* Read week */
 
     ds1302_bcd_to_dec(ds1302_time, 7); /* Convert BCD to decimal */
+    PROFILE_END(PROFILE_DS1302_READ);
 }
\ No newline at end of file
@@ -34,6 +34,8 @@
 
 #include "ds18b20.h"
 #include "delay.h"
+#include "irq_monitor.h"
+#include "profile.h"
 
 #define DS18B20_DQ_RCC          RCC_APB2Periph_GPIOB /* Clock */
 #define DS18B20_DQ_PORT         GPIOB                /* Port */
@@ -50,6 +52,13 @@
 #define DS18B20_CONVERT_T       0x44
 #define DS18B20_READ_SCRATCHPAD 0xBE
 
+/* Last temperature read from the sensor */
+static float ds18b20_last_t;
+
+/* The reset and presence steps of the transaction in progress, one at a time on the bus */
+static coroutine_t ds18b20_start_co;
+static bool ds18b20_ack = true;
+
 /**
  * \brief Set the DQ pin as pull-up input.
  */
@@ -82,25 +91,31 @@ ds18b20_init(void) {
  * \brief Start the one-wire communication for DS18B20 sensor
  *
  * This function initiates communication with the DS18B20 sensor using the one-wire protocol.
- * It sends a start signal, waits for the acknowledgment, and returns the acknowledgment status.
+ * It sends a start signal, waits for the acknowledgment, and stores the acknowledgment status.
+ * The reset pulse is waited for on the spot, as the line is held low during it and a pulse stretched
+ * past 960 us by the other tasks would reset the sensor instead, so are the 70 us to the presence
+ * pulse. Only the end of the presence window, with the line released, has no upper bound, the
+ * coroutine gives way during it.
  *
- * \return Acknowledgment status:
+ * \param co: State of the coroutine
+ * \param ack: Acknowledgment status, set before the coroutine is done:
  *         - `0`: Acknowledgment received
  *         - `1`: Acknowledgment not received
+ * \return COROUTINE_DONE once the bus is ready for a command
  */
-bool
-ds18b20_one_wire_start(void) {
+static coroutine_status_t
+ds18b20_one_wire_start(coroutine_t* co, bool* ack) {
+    COROUTINE_BEGIN(co);
     gpio_set_dq_output();
-    bool AckBit;
     DS18B20_DQ_HIGH();
 
     DS18B20_DQ_LOW();
     delay_us(500);
     gpio_set_dq_input();
     delay_us(70);
-    AckBit = DS18B20_DQ_READ();
-    delay_us(500);
-    return AckBit;
+    *ack = DS18B20_DQ_READ();
+    COROUTINE_AWAIT_US(co, 500);
+    COROUTINE_END(co);
 }
 
 /**
@@ -144,14 +159,16 @@ ds18b20_one_wire_receive_bit() {
  */
 void
 ds18b20_one_wire_send_byte(uint8_t Byte) {
+    PROFILE_BEGIN(PROFILE_DS18B20_BYTE);
     /* Disable interrupts after the byte transmission */
-    __disable_irq();
+    IRQ_MONITOR_MASK();
     uint8_t i;
     for (i = 0; i < 8; i++) {
         ds18b20_one_wire_send_bit(Byte & (0x01 << i));
     }
     /* Enable interrupts after the byte transmission */
-    __enable_irq();
+    IRQ_MONITOR_UNMASK();
+    PROFILE_END(PROFILE_DS18B20_BYTE);
 }
 
 /**
@@ -160,8 +177,9 @@ ds18b20_one_wire_send_byte(uint8_t Byte) {
  */
 uint8_t
 ds18b20_one_wire_receive_byte() {
+    PROFILE_BEGIN(PROFILE_DS18B20_BYTE);
     /* Disable interrupts during the byte reception */
-    __disable_irq();
+    IRQ_MONITOR_MASK();
     uint8_t i;
     uint8_t Byte = 0x00;
     for (i = 0; i < 8; i++) {
@@ -170,37 +188,75 @@ ds18b20_one_wire_receive_byte() {
         }
     }
     /* Enable interrupts after the byte reception */
-    __enable_irq();
+    IRQ_MONITOR_UNMASK();
+    PROFILE_END(PROFILE_DS18B20_BYTE);
     return Byte;
 }
 
 /**
  * \brief Initiate temperature conversion for DS18B20 sensor
+ * \param co: State of the coroutine
+ * \return COROUTINE_DONE once the conversion is started, or at once when no sensor answers
  */
-void
-ds18b20_convert_t() {
-    ds18b20_one_wire_start();
+coroutine_status_t
+ds18b20_convert_t(coroutine_t* co) {
+    COROUTINE_BEGIN(co);
+    COROUTINE_CALL(co, &ds18b20_start_co, ds18b20_one_wire_start(&ds18b20_start_co, &ds18b20_ack));
+    if (ds18b20_ack) {
+        COROUTINE_EXIT(co);
+    }
     ds18b20_one_wire_send_byte(DS18B20_SKIP_ROM);
     ds18b20_one_wire_send_byte(DS18B20_CONVERT_T);
+    COROUTINE_END(co);
 }
 
 /**
  * \brief Read temperature value from DS18B20 sensor
- * \return Temperature value in degrees Celsius
+ * \param co: State of the coroutine
+ * \param t: Temperature value in degrees Celsius, set before the coroutine is done, left as it is
+ *          when no sensor answers
+ * \return COROUTINE_DONE once the temperature is read, or when no sensor answers
  */
-float
-ds18b20_read_t() {
+coroutine_status_t
+ds18b20_read_t(coroutine_t* co, float* t) {
     uint8_t LSB;
     uint8_t MSB;
     int Temp;
-    float T;
-    ds18b20_one_wire_start();
+
+    COROUTINE_BEGIN(co);
+    COROUTINE_CALL(co, &ds18b20_start_co, ds18b20_one_wire_start(&ds18b20_start_co, &ds18b20_ack));
+    /* The released line would read as 0xFFFF, no answer keeps the last temperature */
+    if (ds18b20_ack) {
+        COROUTINE_EXIT(co);
+    }
     ds18b20_one_wire_send_byte(DS18B20_SKIP_ROM);
     ds18b20_one_wire_send_byte(DS18B20_READ_SCRATCHPAD);
     LSB = ds18b20_one_wire_receive_byte();
     MSB = ds18b20_one_wire_receive_byte();
 
-    Temp = (MSB << 8) | LSB;
-    T = Temp / 16.0;
-    return T;
+    Temp = (int16_t)((MSB << 8) | LSB); /* Two's complement, negative below 0 degree */
+    ds18b20_last_t = Temp / 16.0;
+    *t = ds18b20_last_t;
+    COROUTINE_END(co);
+}
+
+/**
+ * \brief Get the temperature of the last ds18b20_read_t without accessing the bus
+ *
+ * Safe to call from an interrupt while the main loop talks to the sensor.
+ *
+ * \return Temperature value in degrees Celsius
+ */
+float
+ds18b20_get_t(void) {
+    return ds18b20_last_t;
+}
+
+/**
+ * \brief Tell whether the sensor answered the reset of the last transaction
+ * \return `true` if it did, the temperature read then is valid
+ */
+bool
+ds18b20_is_present(void) {
+    return !ds18b20_ack;
 }
\ No newline at end of file
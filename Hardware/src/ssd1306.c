@@ -21,6 +21,7 @@
    ----------------------------------------------------------------------
  */
 #include "ssd1306.h"
+#include "profile.h"
 
 /**
  * \brief Write command to SSD1306
@@ -60,6 +61,10 @@
  */
 static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 
+/* What the display shows, so that only the changed bytes are sent */
+static uint8_t SSD1306_Shown[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+static uint8_t SSD1306_ShownValid;
+
 /**
  * \brief Private SSD1306 structure
  */
@@ -269,8 +274,9 @@ SSD1306_DrawBitmap(int16_t x, int16_t y, const unsigned char* bitmap, int16_t w,
  * This function initializes the SSD1306 OLED display by performing the following steps:
  * 1. Initialize the I2C communication.
  * 2. Add a delay for stability.
- * 3. Configure the SSD1306 settings, including display mode, addressing mode, and various parameters.
- * 4. Clear the screen and update it.
+ * 3. Configure the SSD1306 settings, including display mode, addressing mode, and various parameters,
+ *    leaving the panel off until the first \ref SSD1306_UpdateScreen.
+ * 4. Clear the screen buffer.
  * 5. Set default cursor position.
  * 6. Mark the initialization as successful.
  *
@@ -280,6 +286,7 @@ uint8_t
 SSD1306_Init(void) {
     /* Initialize I2C communication */
     ssd1306_I2C_Init();
+    SSD1306_ShownValid = 0;
 
     /* A little delay for stability */
     uint32_t delay_counter = 2500;
@@ -316,16 +323,15 @@ SSD1306_Init(void) {
     SSD1306_WRITECOMMAND(0x20); /* 0x20, 0.77xVcc */
     SSD1306_WRITECOMMAND(0x8D); /* Set DC-DC enable */
     SSD1306_WRITECOMMAND(0x14);
-    SSD1306_WRITECOMMAND(0xAF); /* Turn on SSD1306 panel */
 
     SSD1306_WRITECOMMAND(SSD1306_DEACTIVATE_SCROLL);
 
-    /* Clear the screen */
+    /*
+     * Clear the buffer only, the first update writes all of the display RAM and then turns the
+     * panel on, which saves sending a black frame before the first one
+     */
     SSD1306_Fill(SSD1306_COLOR_BLACK);
 
-    /* Update the screen */
-    SSD1306_UpdateScreen();
-
     /* Set default cursor position */
     SSD1306.CurrentX = 0;
     SSD1306.CurrentY = 0;
@@ -340,25 +346,50 @@ SSD1306_Init(void) {
 /**
  * \brief Update the content of the SSD1306 OLED screen
  *
- * This function updates the content of the SSD1306 OLED screen by performing the following steps:
- * 1. Set the page address for each of the 8 pages.
- * 2. Set the column address to span the entire width.
- * 3. Write multi-byte data to the display using I2C communication.
+ * This function updates the content of the SSD1306 OLED screen by performing the following steps for each of
+ * the 8 pages:
+ * 1. Find the first and the last column that differ from what the display shows.
+ * 2. Set the page address and the column address of the first one.
+ * 3. Write the bytes up to the last one using I2C communication.
  *
- * \note The display buffer is organized in pages, and each page is updated individually.
+ * \note Pages that did not change are skipped, a ticking second costs a few dozen bytes instead of 1 KiB.
+ * \note The panel stays off from SSD1306_Init to the first update, which writes every page.
  */
 void
 SSD1306_UpdateScreen(void) {
     uint8_t page;
 
+    PROFILE_BEGIN(PROFILE_SSD1306_UPDATE);
     for (page = 0; page < 8; page++) {
-        SSD1306_WRITECOMMAND(0xB0 + page); /* Set page address */
-        SSD1306_WRITECOMMAND(0x00);        /* Set low column address */
-        SSD1306_WRITECOMMAND(0x10);        /* Set high column address */
+        uint8_t* buffer = &SSD1306_Buffer[SSD1306_WIDTH * page];
+        uint8_t* shown = &SSD1306_Shown[SSD1306_WIDTH * page];
+        uint16_t first = 0, last = SSD1306_WIDTH - 1;
+
+        if (SSD1306_ShownValid) {
+            while (first < SSD1306_WIDTH && buffer[first] == shown[first]) {
+                first++;
+            }
+            if (first == SSD1306_WIDTH) {
+                continue;
+            }
+            while (buffer[last] == shown[last]) {
+                last--;
+            }
+        }
+
+        SSD1306_WRITECOMMAND(0xB0 + page);           /* Set page address */
+        SSD1306_WRITECOMMAND(0x00 | (first & 0x0F)); /* Set low column address */
+        SSD1306_WRITECOMMAND(0x10 | (first >> 4));   /* Set high column address */
 
         /* Write multi-byte data to the display */
-        ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * page], SSD1306_WIDTH);
+        ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, &buffer[first], last - first + 1);
+        memcpy(&shown[first], &buffer[first], last - first + 1);
+    }
+    if (!SSD1306_ShownValid) {
+        SSD1306_WRITECOMMAND(0xAF); /* Turn on SSD1306 panel, the display RAM is no longer noise */
+        SSD1306_ShownValid = 1;
     }
+    PROFILE_END(PROFILE_SSD1306_UPDATE);
 }
 
 /**
@@ -456,6 +487,7 @@ SSD1306_Putc(char ch, FontDef_t* Font, SSD1306_COLOR_t color) {
         return 0;
     }
 
+    PROFILE_BEGIN(PROFILE_SSD1306_PUTC);
     /* Go through font */
     for (i = 0; i < Font->FontHeight; i++) {
         b = Font->data[(ch - 32) * Font->FontHeight + i];
@@ -470,6 +502,7 @@ SSD1306_Putc(char ch, FontDef_t* Font, SSD1306_COLOR_t color) {
 
     /* Increase pointer */
     SSD1306.CurrentX += Font->FontWidth;
+    PROFILE_END(PROFILE_SSD1306_PUTC);
 
     /* Return character written */
     return ch;
@@ -37,6 +37,9 @@
 
 #include <string.h>
 #include "uart.h"
+#include "irq_monitor.h"
+#include "nvic.h"
+#include "profile.h"
 
 /* Clock configuration */
 #define UART_RCC      RCC_APB2Periph_USART1
@@ -49,9 +52,6 @@
 void uart_rx_check(void);
 void uart_process_data(const void* data, size_t len);
 
-#define PACKET_LEN (10)
-extern uint8_t uart_rx_packet[PACKET_LEN];
-
 /**
  * \brief           Calculate length of statically allocated array
  */
@@ -62,6 +62,16 @@ extern uint8_t uart_rx_packet[PACKET_LEN];
  */
 static int process_idx;
 
+/**
+ * \brief           Bytes received since the last IDLE line event
+ */
+static uint8_t uart_rx_packet[UART_RX_PACKET_SIZE];
+
+/**
+ * \brief           Receiver of complete packets, see \ref uart_set_rx_callback()
+ */
+static uart_rx_callback_t uart_rx_callback;
+
 /**
  * \brief           USART RX buffer for DMA to transfer every received byte
  * \note            Contains raw data that are about to be processed by different events
@@ -193,10 +203,22 @@ uart_process_data(const void* data, size_t len) {
      */
 
     for (; len > 0; --len, ++d, ++process_idx) {
-        uart_rx_packet[process_idx] = *d;
+        if (process_idx < UART_RX_PACKET_SIZE) {
+            uart_rx_packet[process_idx] = *d;
+        }
     }
 }
 
+/**
+ * \brief           Set the receiver of the packets collected between two IDLE line events
+ * \note            The callback runs in interrupt context and must not block
+ * \param[in]       callback: Packet receiver, `NULL` to drop received data
+ */
+void
+uart_set_rx_callback(uart_rx_callback_t callback) {
+    uart_rx_callback = callback;
+}
+
 /**
  * \brief           Send string to USART
  * \param[in]       str: String to send
@@ -237,9 +259,7 @@ static void uart_dma_init(void) {
     /* Enable HT & TC interrupts */
     DMA_ITConfig(DMA1_Channel5, DMA_IT_TC | DMA_IT_HT, ENABLE);
 
-    /* DMA1_Channel5_IRQn interrupt configuration */
-    NVIC_SetPriority(DMA1_Channel5_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0, 0));
-    NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+    nvic_enable(NVIC_IRQ_DMA1_CHANNEL5);
 
     /* Enable DMA */
     DMA_Cmd(DMA1_Channel5, ENABLE);
@@ -298,9 +318,7 @@ void uart_init(void) {
     /* Enable IDLE interrupt */
     USART_ITConfig(USART1, USART_IT_IDLE, ENABLE);
 
-    /* USART interrupt configuration */
-    NVIC_SetPriority(USART1_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0, 0));
-    NVIC_EnableIRQ(USART1_IRQn);
+    nvic_enable(NVIC_IRQ_USART1);
 
     /* USART1 DMA Init */
     uart_dma_init();
@@ -328,6 +346,7 @@ void uart_receive_err_handler(void) {
  */
 void
 DMA1_Channel5_IRQHandler(void) {
+    IRQ_MONITOR_ENTER(NVIC_IRQ_DMA1_CHANNEL5);
     /* Check half-transfer complete interrupt */
     if (DMA_GetITStatus(DMA1_IT_HT5) == SET) {
         DMA_ClearITPendingBit(DMA1_IT_HT5); /* Clear half-transfer complete flag */
@@ -341,6 +360,7 @@ DMA1_Channel5_IRQHandler(void) {
     }
 
     /* Implement other events when needed */
+    IRQ_MONITOR_EXIT(NVIC_IRQ_DMA1_CHANNEL5);
 }
 
 /**
@@ -348,6 +368,8 @@ DMA1_Channel5_IRQHandler(void) {
  */
 void
 USART1_IRQHandler(void) {
+    IRQ_MONITOR_ENTER(NVIC_IRQ_USART1);
+    PROFILE_ISR_ENTER(PROFILE_ISR_USART1);
     /* Check for IDLE line interrupt */
     if (USART_GetITStatus(USART1, USART_IT_IDLE) == SET) {
         /* Read the DR register to clear USART_IT_IDLE pending flag*/
@@ -356,15 +378,19 @@ USART1_IRQHandler(void) {
         uart_rx_check();
         /*
         * Upon the occurrence of an IDLE interrupt, the data packet should have been fully sent.
-        * Therefore, we reset process_idx to zero.
+        * Therefore, we hand it over and reset process_idx to zero.
         */
-        if (process_idx >= PACKET_LEN) {
+        if (process_idx > UART_RX_PACKET_SIZE) {
             uart_receive_err_handler();
+        } else if (process_idx > 0 && uart_rx_callback != NULL) {
+            uart_rx_callback(uart_rx_packet, process_idx);
         }
         process_idx = 0;
     }
 
     /* Implement other events when needed */
+    PROFILE_ISR_EXIT(PROFILE_ISR_USART1);
+    IRQ_MONITOR_EXIT(NVIC_IRQ_USART1);
 }
 
 /* Debug here */
@@ -116,8 +116,10 @@
 
 /* EasyLogger object */
 static EasyLogger elog;
-/* every line log's buffer */
-static char log_buf[ELOG_LINE_BUF_SIZE] = { 0 };
+#ifndef ELOG_ASYNC_OUTPUT_ENABLE
+/* every line log's buffer, taken under the output lock */
+static char line_buf[ELOG_LINE_BUF_SIZE] = { 0 };
+#endif
 /* level output info */
 static const char *level_output_info[] = {
         [ELOG_LVL_ASSERT]  = "A/",
@@ -142,6 +144,8 @@ static const char *color_output_info[] = {
 
 static bool get_fmt_enabled(uint8_t level, size_t set);
 static void elog_set_filter_tag_lvl_default(void);
+static char *elog_line_take(void);
+static void elog_line_give(void);
 
 /* EasyLogger assert hook */
 void (*elog_assert_hook)(const char* expr, const char* func, size_t line);
@@ -388,6 +392,34 @@ void elog_output_unlock(void) {
     }
 }
 
+/**
+ * take the buffer to package a log in, the shared one under the output lock or, in asynchronous
+ * mode, the line of the calling context without any lock
+ *
+ * @return buffer of ELOG_LINE_BUF_SIZE, NULL when the log is dropped
+ */
+static char *elog_line_take(void) {
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+    extern char *elog_async_line_take(void);
+    return elog_async_line_take();
+#else
+    elog_output_lock();
+    return line_buf;
+#endif
+}
+
+/**
+ * give back the buffer of elog_line_take()
+ */
+static void elog_line_give(void) {
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+    extern void elog_async_line_give(void);
+    elog_async_line_give();
+#else
+    elog_output_unlock();
+#endif
+}
+
 /**
  * set log filter's tag level val to default
  */
@@ -483,7 +515,10 @@ uint8_t elog_get_filter_tag_lvl(const char *tag)
         return level;
     }
 
+    /* the asynchronous logs take no lock, the setter masks the interrupts while it writes */
+#ifndef ELOG_ASYNC_OUTPUT_ENABLE
     elog_output_lock();
+#endif
     /* find the tag in arr */
     for (i =0; i< ELOG_FILTER_TAG_LVL_MAX_NUM; i++){
         if (elog.filter.tag_lvl[i].tag_use_flag == true &&
@@ -492,7 +527,9 @@ uint8_t elog_get_filter_tag_lvl(const char *tag)
             break;
         }
     }
+#ifndef ELOG_ASYNC_OUTPUT_ENABLE
     elog_output_unlock();
+#endif
 
     return level;
 }
@@ -504,6 +541,7 @@ uint8_t elog_get_filter_tag_lvl(const char *tag)
  * @param ... args
  */
 void elog_raw_output(const char *format, ...) {
+    char *log_buf;
     va_list args;
     size_t log_len = 0;
     int fmt_result;
@@ -513,12 +551,15 @@ void elog_raw_output(const char *format, ...) {
         return;
     }
 
+    /* take the line buffer */
+    log_buf = elog_line_take();
+    if (log_buf == NULL) {
+        return;
+    }
+
     /* args point to the first variable parameter */
     va_start(args, format);
 
-    /* lock output */
-    elog_output_lock();
-
     /* package log data to buffer */
     fmt_result = vsnprintf(log_buf, ELOG_LINE_BUF_SIZE, format, args);
 
@@ -539,8 +580,8 @@ void elog_raw_output(const char *format, ...) {
 #else
     elog_port_output(log_buf, log_len);
 #endif
-    /* unlock output */
-    elog_output_unlock();
+    /* give the line buffer back */
+    elog_line_give();
 
     va_end(args);
 }
@@ -566,6 +607,7 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
     size_t tag_len = strlen(tag), log_len = 0, newline_len = strlen(ELOG_NEWLINE_SIGN);
     char line_num[ELOG_LINE_NUM_MAX_LEN + 1] = { 0 };
     char tag_sapce[ELOG_FILTER_TAG_MAX_LEN / 2 + 1] = { 0 };
+    char *log_buf;
     va_list args;
     int fmt_result;
 
@@ -581,10 +623,13 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
     } else if (!strstr(tag, elog.filter.tag)) { /* tag filter */
         return;
     }
+    /* take the line buffer */
+    log_buf = elog_line_take();
+    if (log_buf == NULL) {
+        return;
+    }
     /* args point to the first variable parameter */
     va_start(args, format);
-    /* lock output */
-    elog_output_lock();
 
 #ifdef ELOG_COLOR_ENABLE
     /* add CSI start sign and color info */
@@ -690,8 +735,8 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
         log_buf[log_len] = '\0';
         /* find the keyword */
         if (!strstr(log_buf, elog.filter.keyword)) {
-            /* unlock output */
-            elog_output_unlock();
+            /* give the line buffer back */
+            elog_line_give();
             return;
         }
     }
@@ -715,8 +760,8 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
 #else
     elog_port_output(log_buf, log_len);
 #endif
-    /* unlock output */
-    elog_output_unlock();
+    /* give the line buffer back */
+    elog_line_give();
 }
 
 /**
@@ -858,6 +903,7 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
     uint16_t log_len = 0;
     const uint8_t *buf_p = buf;
     char dump_string[8] = {0};
+    char *log_buf;
     int fmt_result;
 
     if (!elog.output_enabled) {
@@ -871,8 +917,11 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
         return;
     }
 
-    /* lock output */
-    elog_output_lock();
+    /* take the line buffer */
+    log_buf = elog_line_take();
+    if (log_buf == NULL) {
+        return;
+    }
 
     for (i = 0; i < size; i += width) {
         /* package header */
@@ -920,6 +969,6 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
         elog_port_output(log_buf, log_len);
 #endif
     }
-    /* unlock output */
-    elog_output_unlock();
+    /* give the line buffer back */
+    elog_line_give();
 }
@@ -81,45 +81,53 @@ extern "C" {
     #define elog_debug(tag, ...)
     #define elog_verbose(tag, ...)
 #else /* ELOG_OUTPUT_ENABLE */
-    #define elog_raw(...)  elog_raw_output(__VA_ARGS__)
+    #ifdef ELOG_TOKEN_OUTPUT_ENABLE
+        #include "elog_token.h"
+        #define elog_raw(...)  ELOG_TOKEN(ELOG_TOKEN_RAW_LVL, "", __VA_ARGS__)
+        #define ELOG_OUTPUT(level, tag, ...) ELOG_TOKEN(level, tag, __VA_ARGS__)
+    #else
+        #define elog_raw(...)  elog_raw_output(__VA_ARGS__)
+        #define ELOG_OUTPUT(level, tag, ...) \
+                elog_output(level, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+    #endif /* ELOG_TOKEN_OUTPUT_ENABLE */
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_ASSERT
         #define elog_assert(tag, ...) \
-                elog_output(ELOG_LVL_ASSERT, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_ASSERT, tag, __VA_ARGS__)
     #else
         #define elog_assert(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_ASSERT */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_ERROR
         #define elog_error(tag, ...) \
-                elog_output(ELOG_LVL_ERROR, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_ERROR, tag, __VA_ARGS__)
     #else
         #define elog_error(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_ERROR */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_WARN
         #define elog_warn(tag, ...) \
-                elog_output(ELOG_LVL_WARN, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_WARN, tag, __VA_ARGS__)
     #else
         #define elog_warn(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_WARN */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_INFO
         #define elog_info(tag, ...) \
-                elog_output(ELOG_LVL_INFO, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_INFO, tag, __VA_ARGS__)
     #else
         #define elog_info(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_INFO */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_DEBUG
         #define elog_debug(tag, ...) \
-                elog_output(ELOG_LVL_DEBUG, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_DEBUG, tag, __VA_ARGS__)
     #else
         #define elog_debug(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_DEBUG */
 
     #if ELOG_OUTPUT_LVL == ELOG_LVL_VERBOSE
         #define elog_verbose(tag, ...) \
-                elog_output(ELOG_LVL_VERBOSE, tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__)
+                ELOG_OUTPUT(ELOG_LVL_VERBOSE, tag, __VA_ARGS__)
     #else
         #define elog_verbose(tag, ...)
     #endif /* ELOG_OUTPUT_LVL == ELOG_LVL_VERBOSE */
@@ -262,8 +270,13 @@ void elog_flush(void);
 
 /* elog_async.c */
 void elog_async_enabled(bool enabled);
-size_t elog_async_get_log(char *log, size_t size);
-size_t elog_async_get_line_log(char *log, size_t size);
+const char *elog_async_peek_line(size_t *size);
+void elog_async_release_line(void);
+uint32_t elog_async_get_dropped(void);
+uint8_t elog_async_line_index(void);
+
+/* elog_port.c */
+void elog_port_drain(void);
 
 /* elog_utils.c */
 size_t elog_strcpy(size_t cur_len, char *dst, const char *src);
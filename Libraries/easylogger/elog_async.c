@@ -0,0 +1,217 @@
+/**
+* \file            elog_async.c
+* \date            10/19/2026
+* \brief           EasyLogger asynchronous output on a lock-free ring, without threads
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include <elog.h>
+#include "log_ring.h"
+
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+
+#if ELOG_ASYNC_OUTPUT_BUF_SIZE & (ELOG_ASYNC_OUTPUT_BUF_SIZE - 1)
+    #error "ELOG_ASYNC_OUTPUT_BUF_SIZE must be a power of 2"
+#endif
+
+#if ELOG_ASYNC_LINE_NUM < 1 || ELOG_ASYNC_LINE_NUM > 255
+    #error "ELOG_ASYNC_LINE_NUM must be from 1 to 255"
+#endif
+
+#ifdef ELOG_ASYNC_OUTPUT_USING_PTHREAD
+    #error "The bare metal asynchronous output has no thread, the port drains it"
+#endif
+
+/*
+ * Each log is a record of the ring, complete with its newline sign, in place of the output thread
+ * of the upstream elog_async.c the port takes the records out from idle time and sends them on.
+ * The caller of a log only pays for its formatting and a copy, not for the UART. A log that does
+ * not fit is dropped whole and counted, the port tells how many in the output.
+ *
+ * Nor is there a lock around the formatting, each context packages its log in a line of its own:
+ * the main loop takes the first one, an interrupt the next and so on. Interrupts nest, the one
+ * that takes a line gives it back before the context it preempted goes on, so a plain counter
+ * tells which line is free. A log nested deeper than ELOG_ASYNC_LINE_NUM is dropped and counted.
+ * Only the synchronous output, the levels below ELOG_ASYNC_OUTPUT_LVL or the mode disabled, masks
+ * the interrupts around the UART it shares.
+ */
+
+/* asynchronous output log buffer */
+static uint8_t log_buf[ELOG_ASYNC_OUTPUT_BUF_SIZE] __attribute__((aligned(4)));
+/* asynchronous output records */
+static log_ring_t log_ring;
+/* asynchronous output mode enabled flag */
+static bool is_enabled = false;
+/* lines to package the logs in, one for each nested context */
+static char line_buf[ELOG_ASYNC_LINE_NUM][ELOG_LINE_BUF_SIZE];
+/* lines taken, by the contexts nested at the moment */
+static volatile uint8_t line_depth = 0;
+/* logs dropped for want of a line */
+static volatile uint32_t line_dropped = 0;
+
+extern void elog_port_output(const char *log, size_t size);
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * output a log synchronously, the UART is shared by all the contexts
+ *
+ * @param log log buffer
+ * @param size log size
+ */
+static void elog_async_output_sync(const char *log, size_t size) {
+    elog_output_lock();
+    elog_port_output(log, size);
+    elog_output_unlock();
+}
+
+/**
+ * asynchronous output initialize
+ *
+ * @return result
+ */
+ElogErrCode elog_async_init(void) {
+    log_ring_init(&log_ring, log_buf, ELOG_ASYNC_OUTPUT_BUF_SIZE);
+
+    return ELOG_NO_ERR;
+}
+
+/**
+ * asynchronous output deinitialize
+ */
+void elog_async_deinit(void) {
+    is_enabled = false;
+}
+
+/**
+ * enable or disable asynchronous output mode
+ * the log will be output directly when mode is disabled
+ *
+ * @param enabled true: enabled, false: disabled
+ */
+void elog_async_enabled(bool enabled) {
+    is_enabled = enabled;
+}
+
+/**
+ * asynchronous output log, from any context
+ *
+ * @param level log level
+ * @param log log buffer
+ * @param size log size
+ */
+void elog_async_output(uint8_t level, const char *log, size_t size) {
+#if ELOG_ASYNC_OUTPUT_LVL > ELOG_LVL_ASSERT
+    if (level < ELOG_ASYNC_OUTPUT_LVL) {
+        elog_async_output_sync(log, size);
+        return;
+    }
+#else
+    (void)level;
+#endif
+    if (is_enabled) {
+        log_ring_write(&log_ring, log, size);
+    } else {
+        elog_async_output_sync(log, size);
+    }
+}
+
+/**
+ * take the line of the calling context to package a log in, from any context
+ *
+ * @return line of ELOG_LINE_BUF_SIZE, NULL when the contexts nest deeper than the lines
+ */
+char *elog_async_line_take(void) {
+    /* an interrupt after the load gives its line back before the store */
+    uint8_t depth = line_depth;
+    uint32_t dropped;
+
+    if (depth >= ELOG_ASYNC_LINE_NUM) {
+        do {
+            dropped = __LDREXW((uint32_t *)&line_dropped);
+        } while (__STREXW(dropped + 1, (uint32_t *)&line_dropped) != 0);
+        return NULL;
+    }
+    line_depth = depth + 1;
+    return line_buf[depth];
+}
+
+/**
+ * give back the line of elog_async_line_take()
+ */
+void elog_async_line_give(void) {
+    line_depth--;
+}
+
+/**
+ * get the line the calling context packages its log in, for the port to keep its texts apart
+ *
+ * @return index of the line
+ */
+uint8_t elog_async_line_index(void) {
+    uint8_t depth = line_depth;
+
+    return depth == 0 ? 0 : depth - 1;
+}
+
+/**
+ * get the oldest log not output yet, by the port
+ *
+ * @param size log size
+ *
+ * @return log, it stays in the buffer until elog_async_release_line(), NULL when there is none
+ */
+const char *elog_async_peek_line(size_t *size) {
+    uint32_t len;
+    const char *log = log_ring_peek(&log_ring, &len);
+
+    if (log != NULL) {
+        *size = len;
+    }
+    return log;
+}
+
+/**
+ * free the log of elog_async_peek_line() once it is output, by the port
+ */
+void elog_async_release_line(void) {
+    log_ring_release(&log_ring);
+}
+
+/**
+ * get the logs dropped for want of space or of a line
+ *
+ * @return logs since elog_async_init()
+ */
+uint32_t elog_async_get_dropped(void) {
+    return log_ring_get_dropped(&log_ring) + line_dropped;
+}
+
+#endif /* ELOG_ASYNC_OUTPUT_ENABLE */
@@ -26,9 +26,119 @@
  * Created on: 2015-04-28
  */
  
+#include <stdio.h>
 #include "elog.h"
 #include "printf.h"
 #include "core_cm3.h"
+#include "counter.h"
+#include "idle.h"
+#include "irq_monitor.h"
+#include "nvic.h"
+
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+/*
+ * The asynchronous logs go out of USART3 by DMA1 channel 2, a line at a time straight out of the
+ * ring of elog_async.c. elog_port_drain() starts a transfer from idle time and the end of each one
+ * starts the next, until the ring is empty.
+ */
+
+/* DMA1 channel 2 is sending */
+static volatile bool dma_busy = false;
+/* the transfer is a line of the ring, to release when sent */
+static bool dma_line = false;
+/* dropped logs already told */
+static uint32_t dma_dropped = 0;
+/* line telling the dropped logs */
+static char dma_note[40];
+
+/**
+ * start sending
+ *
+ * @param data bytes
+ * @param size bytes
+ */
+static void dma_start(const void *data, size_t size) {
+    DMA1_Channel2->CMAR = (uint32_t)data;
+    DMA1_Channel2->CNDTR = size;
+    /* the DMA writes the data register without reading the status one, TC only tells the end once cleared */
+    USART_ClearFlag(USART3, USART_FLAG_TC);
+    DMA_Cmd(DMA1_Channel2, ENABLE);
+    dma_busy = true;
+}
+
+/**
+ * write the line telling the dropped logs, without the formatter of the library as it runs from
+ * the DMA interrupt
+ *
+ * @param count dropped logs
+ *
+ * @return length of the line, without its terminating zero
+ */
+static size_t dma_note_format(uint32_t count) {
+    char digits[10];
+    size_t n = 0, size;
+
+    do {
+        digits[n++] = (char)('0' + count % 10);
+        count /= 10;
+    } while (count != 0);
+    size = elog_strcpy(0, dma_note, "(");
+    while (n != 0) {
+        dma_note[size++] = digits[--n];
+    }
+    size += elog_strcpy(size, dma_note + size, " logs dropped)" ELOG_NEWLINE_SIGN);
+    dma_note[size] = '\0';
+    return size;
+}
+
+/**
+ * start sending the next line, if any, with the interrupts masked or from the DMA interrupt
+ */
+static void dma_next(void) {
+    uint32_t dropped = elog_async_get_dropped();
+    const char *log;
+    size_t size;
+
+    if (dropped != dma_dropped) {
+        size = dma_note_format(dropped - dma_dropped);
+#ifdef ELOG_TOKEN_OUTPUT_ENABLE
+        /* with its terminating zero, a frame of its own between the tokenized logs */
+        size++;
+#endif
+        dma_dropped = dropped;
+        dma_line = false;
+        dma_start(dma_note, size);
+    } else if ((log = elog_async_peek_line(&size)) != NULL) {
+        dma_line = true;
+        dma_start(log, size);
+    } else {
+        dma_busy = false;
+    }
+}
+
+/**
+ * a transfer is over
+ */
+static void dma_done(void) {
+    DMA_Cmd(DMA1_Channel2, DISABLE);
+    if (dma_line) {
+        elog_async_release_line();
+    }
+    dma_next();
+}
+
+/**
+ * DMA1 channel 2 interrupt handler for USART3 TX
+ */
+void DMA1_Channel2_IRQHandler(void) {
+    IRQ_MONITOR_ENTER(NVIC_IRQ_DMA1_CHANNEL2);
+    if (DMA_GetITStatus(DMA1_IT_TC2) == SET) {
+        DMA_ClearITPendingBit(DMA1_IT_GL2);
+        dma_done();
+    }
+    IRQ_MONITOR_EXIT(NVIC_IRQ_DMA1_CHANNEL2);
+}
+#endif /* ELOG_ASYNC_OUTPUT_ENABLE */
 
 /**
  * EasyLogger port initialize
@@ -40,7 +150,29 @@ ElogErrCode elog_port_init(void) {
 
     /* add your code here */
     printf_init();
-    
+
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+    DMA_InitTypeDef dma_init_structure;
+
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    DMA_DeInit(DMA1_Channel2);
+    dma_init_structure.DMA_PeripheralBaseAddr = (uint32_t)&USART3->DR;
+    dma_init_structure.DMA_MemoryBaseAddr = 0;                           /* set for each line */
+    dma_init_structure.DMA_DIR = DMA_DIR_PeripheralDST;
+    dma_init_structure.DMA_BufferSize = 0;
+    dma_init_structure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma_init_structure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma_init_structure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    dma_init_structure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    dma_init_structure.DMA_Mode = DMA_Mode_Normal;
+    dma_init_structure.DMA_Priority = DMA_Priority_Low;
+    dma_init_structure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel2, &dma_init_structure);
+    DMA_ITConfig(DMA1_Channel2, DMA_IT_TC, ENABLE);
+    nvic_enable(NVIC_IRQ_DMA1_CHANNEL2);
+    USART_DMACmd(USART3, USART_DMAReq_Tx, ENABLE);
+#endif
+
     return result;
 }
 
@@ -61,8 +193,34 @@ void elog_port_deinit(void) {
  */
 void elog_port_output(const char *log, size_t size) {
     
-    /* add your code here */
-    printf_("%.*s", size, log);
+    /* add your code here, byte by byte as a tokenized log holds zeros */
+    for (size_t i = 0; i < size; i++) {
+        putchar_(log[i]);
+    }
+}
+
+/**
+ * send the asynchronous logs on, from the main loop before it sleeps
+ *
+ * It starts DMA when it is not sending, the DMA interrupt goes on to the end of the logs. It also
+ * ends a transfer whose interrupt cannot come, when the caller is an interrupt of higher priority
+ * waiting for its logs to go out. The MCU stays out of STOP until the last byte has left USART3.
+ */
+void elog_port_drain(void) {
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+    bool sending;
+
+    IRQ_MONITOR_MASK();
+    if (!dma_busy) {
+        dma_next();
+    } else if (DMA_GetFlagStatus(DMA1_FLAG_TC2) == SET) {
+        DMA_ClearFlag(DMA1_FLAG_GL2);
+        dma_done();
+    }
+    sending = dma_busy || USART_GetFlagStatus(USART3, USART_FLAG_TC) == RESET;
+    IRQ_MONITOR_UNMASK();
+    idle_hold(IDLE_CLIENT_LOG, sending);
+#endif
 }
 
 /**
@@ -70,8 +228,8 @@ void elog_port_output(const char *log, size_t size) {
  */
 void elog_port_output_lock(void) {
     
-    /* add your code here */
-    __disable_irq();
+    /* add your code here, only the synchronous logs take it, the asynchronous ones need none */
+    IRQ_MONITOR_MASK();
 }
 
 /**
@@ -80,18 +238,36 @@ void elog_port_output_lock(void) {
 void elog_port_output_unlock(void) {
     
     /* add your code here */
-    __enable_irq();
+    IRQ_MONITOR_UNMASK();
 }
 
 /**
  * get current time interface
  *
- * @return current time
+ * @return current time, seconds and milliseconds since the boot, valid until the next log of the
+ *         same context, an interrupt logging in between writes a text of its own
  */
 const char *elog_port_get_time(void) {
-    
-    /* add your code here */
-    return "";
+#ifdef ELOG_ASYNC_OUTPUT_ENABLE
+    static char texts[ELOG_ASYNC_LINE_NUM][16];
+    char *time = texts[elog_async_line_index()];
+#else
+    static char texts[1][16];
+    char *time = texts[0];
+#endif
+    uint32_t ms = counter_get_ms();
+
+    snprintf(time, sizeof(texts[0]), "%lu.%03lu", (unsigned long)(ms / 1000), (unsigned long)(ms % 1000));
+    return time;
+}
+
+/**
+ * get the timestamp of a tokenized log
+ *
+ * @return current time in us, wrapping around every 71 minutes
+ */
+uint32_t elog_port_get_timestamp(void) {
+    return (uint32_t)counter_get_us();
 }
 
 /**
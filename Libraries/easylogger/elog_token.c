@@ -0,0 +1,177 @@
+/**
+* \file            elog_token.c
+* \date            10/19/2026
+* \brief           EasyLogger tokenized output: a format string id and the raw arguments in place of the text
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include <elog.h>
+#include <stdarg.h>
+#include <string.h>
+
+#ifdef ELOG_TOKEN_OUTPUT_ENABLE
+
+#if ELOG_TOKEN_FRAME_MAX > 254
+    #error "ELOG_TOKEN_FRAME_MAX must keep a frame within one COBS block"
+#elif ELOG_TOKEN_FRAME_MAX < 100
+    #error "ELOG_TOKEN_FRAME_MAX must hold 8 integer arguments"
+#endif
+
+/*
+ * A log is a frame: the id in 2 bytes, little endian, the timestamp in us as a varint, then the
+ * arguments. An integer is a zigzag varint whatever its width, a string its length as a varint
+ * and its bytes, a floating point number its 8 bytes. The frame is COBS encoded and ends with a
+ * zero byte, so the decoder finds the next one after a byte lost on the wire. The frames go
+ * through the same output as the text logs, the asynchronous one when it is enabled.
+ */
+
+/* longest encoding of an integer argument */
+#define VARINT_MAX                               10
+
+/* frame being encoded, COBS on the fly */
+typedef struct {
+    uint8_t buf[ELOG_TOKEN_FRAME_MAX];
+    size_t code;   /* position of the current block's code byte */
+    size_t len;
+} elog_token_frame_t;
+
+extern uint32_t elog_port_get_timestamp(void);
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE)
+extern void elog_async_output(uint8_t level, const char *log, size_t size);
+#else
+extern void elog_port_output(const char *log, size_t size);
+#endif
+
+/**
+ * put a byte into the frame, the caller makes sure it fits
+ *
+ * @param frame frame
+ * @param byte byte
+ */
+static void frame_put(elog_token_frame_t *frame, uint8_t byte) {
+    if (byte == 0) {
+        frame->buf[frame->code] = (uint8_t)(frame->len - frame->code);
+        frame->code = frame->len++;
+    } else {
+        frame->buf[frame->len++] = byte;
+    }
+}
+
+/**
+ * put an unsigned varint into the frame
+ *
+ * @param frame frame
+ * @param value value
+ */
+static void frame_put_varint(elog_token_frame_t *frame, uint64_t value) {
+    while (value >= 0x80) {
+        frame_put(frame, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    frame_put(frame, (uint8_t)value);
+}
+
+/**
+ * output a tokenized log, from ELOG_TOKEN()
+ *
+ * @param id format string id
+ * @param types number and types of the arguments, see ELOG_TOKEN_TYPES()
+ * @param ... arguments
+ */
+void elog_token_output(uint16_t id, uint32_t types, ...) {
+    elog_token_frame_t frame;
+    uint32_t num = types & 0xF;
+    va_list args;
+
+    if (!elog_get_output_enabled()) {
+        return;
+    }
+
+    frame.code = 0;
+    frame.len = 1;
+    frame_put(&frame, (uint8_t)id);
+    frame_put(&frame, (uint8_t)(id >> 8));
+    frame_put_varint(&frame, elog_port_get_timestamp());
+
+    va_start(args, types);
+    for (uint32_t i = 0; i < num; i++) {
+        /* room for the rest of the arguments and the COBS overhead, the strings are cut to fit */
+        size_t room = ELOG_TOKEN_FRAME_MAX - 2 - frame.len - (num - 1 - i) * VARINT_MAX;
+
+        switch ((types >> (4 + 2 * i)) & 0x3) {
+        case ELOG_TOKEN_ARG_INT32: {
+            int32_t value = va_arg(args, int);
+            frame_put_varint(&frame, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+            break;
+        }
+        case ELOG_TOKEN_ARG_INT64: {
+            int64_t value = va_arg(args, long long);
+            frame_put_varint(&frame, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+            break;
+        }
+        case ELOG_TOKEN_ARG_STRING: {
+            const char *str = va_arg(args, const char *);
+            size_t len = str == NULL ? 0 : strlen(str);
+
+            if (len > room - 2) {
+                len = room - 2;
+            }
+            frame_put_varint(&frame, len);
+            for (size_t j = 0; j < len; j++) {
+                frame_put(&frame, (uint8_t)str[j]);
+            }
+            break;
+        }
+        default: {
+            double value = va_arg(args, double);
+            uint8_t bytes[sizeof(value)];
+
+            memcpy(bytes, &value, sizeof(value));
+            for (size_t j = 0; j < sizeof(value); j++) {
+                frame_put(&frame, bytes[j]);
+            }
+            break;
+        }
+        }
+    }
+    va_end(args);
+
+    frame.buf[frame.code] = (uint8_t)(frame.len - frame.code);
+    frame.buf[frame.len++] = 0;
+
+    /* at the level of the raw logs, the frame has to go the way of all the others */
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE)
+    elog_async_output(ELOG_LVL_ASSERT, (const char *)frame.buf, frame.len);
+#else
+    elog_port_output((const char *)frame.buf, frame.len);
+#endif
+}
+
+#endif /* ELOG_TOKEN_OUTPUT_ENABLE */
@@ -0,0 +1,118 @@
+/**
+* \file            elog_token.h
+* \date            10/19/2026
+* \brief           EasyLogger tokenized output: a format string id and the raw arguments in place of the text
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef __ELOG_TOKEN_H__
+#define __ELOG_TOKEN_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Each log puts its level, tag and format string into the section elog_token, the linker script
+ * keeps it in the ELF at address 0 without loading it, so the address of a string is its 16-bit
+ * id. A log only writes the id, a timestamp and its arguments, encoded by elog_token.c;
+ * tools/elog_token_decode formats them on the host against the ELF. The tag and the format must
+ * be string literals, with up to 8 arguments: integers, strings and floating point.
+ */
+
+/* address of the first string, 0 in the firmware, a host build loads the section */
+#ifdef ELOG_TOKEN_HOSTED
+    extern const char __start_elog_token[];
+    #define ELOG_TOKEN_BASE                      ((uintptr_t)__start_elog_token)
+#else
+    #define ELOG_TOKEN_BASE                      0
+#endif
+
+/* argument types, 2 bits each */
+#define ELOG_TOKEN_ARG_INT32                     0U
+#define ELOG_TOKEN_ARG_INT64                     1U
+#define ELOG_TOKEN_ARG_STRING                    2U
+#define ELOG_TOKEN_ARG_DOUBLE                    3U
+
+/* level character of a raw log in the section, the others are their number */
+#define ELOG_TOKEN_RAW_LVL                       R
+
+#define ELOG_TOKEN_STR_(x)                       #x
+#define ELOG_TOKEN_STR(x)                        ELOG_TOKEN_STR_(x)
+#define ELOG_TOKEN_CAT_(a, b)                    a##b
+#define ELOG_TOKEN_CAT(a, b)                     ELOG_TOKEN_CAT_(a, b)
+
+/* number of arguments, 0 to 8 */
+#define ELOG_TOKEN_NARGS(...)                                                 \
+    ELOG_TOKEN_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define ELOG_TOKEN_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+/* type of an argument after the default promotions */
+#define ELOG_TOKEN_TYPE(arg)                                                  \
+    _Generic((arg), char *: ELOG_TOKEN_ARG_STRING,                            \
+                    const char *: ELOG_TOKEN_ARG_STRING,                      \
+                    float: ELOG_TOKEN_ARG_DOUBLE,                             \
+                    double: ELOG_TOKEN_ARG_DOUBLE,                            \
+                    default: (sizeof(arg) > sizeof(int) ? ELOG_TOKEN_ARG_INT64 : ELOG_TOKEN_ARG_INT32))
+
+/* the number of arguments in bits 0 ~ 3, then the type of each, a constant once compiled */
+#define ELOG_TOKEN_TYPES(...)                                                 \
+    ELOG_TOKEN_CAT(ELOG_TOKEN_TYPES_, ELOG_TOKEN_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define ELOG_TOKEN_TYPES_0()                     0U
+#define ELOG_TOKEN_TYPES_1(a)                    (1U | ELOG_TOKEN_TYPE(a) << 4)
+#define ELOG_TOKEN_TYPES_N(n, a, rest)           ((n) | ELOG_TOKEN_TYPE(a) << 4 | ((rest) & ~0xFU) << 2)
+#define ELOG_TOKEN_TYPES_2(a, ...)               ELOG_TOKEN_TYPES_N(2U, a, ELOG_TOKEN_TYPES_1(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_3(a, ...)               ELOG_TOKEN_TYPES_N(3U, a, ELOG_TOKEN_TYPES_2(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_4(a, ...)               ELOG_TOKEN_TYPES_N(4U, a, ELOG_TOKEN_TYPES_3(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_5(a, ...)               ELOG_TOKEN_TYPES_N(5U, a, ELOG_TOKEN_TYPES_4(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_6(a, ...)               ELOG_TOKEN_TYPES_N(6U, a, ELOG_TOKEN_TYPES_5(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_7(a, ...)               ELOG_TOKEN_TYPES_N(7U, a, ELOG_TOKEN_TYPES_6(__VA_ARGS__))
+#define ELOG_TOKEN_TYPES_8(a, ...)               ELOG_TOKEN_TYPES_N(8U, a, ELOG_TOKEN_TYPES_7(__VA_ARGS__))
+
+/* output a log, level is a number or ELOG_TOKEN_RAW_LVL */
+#define ELOG_TOKEN(level, tag, format, ...)                                   \
+    do {                                                                      \
+        static const char elog_token_str[]                                    \
+            __attribute__((section("elog_token"), used)) =                    \
+            ELOG_TOKEN_STR(level) "\x1F" tag "\x1F" format;                   \
+        elog_token_output((uint16_t)((uintptr_t)elog_token_str - ELOG_TOKEN_BASE), \
+                          ELOG_TOKEN_TYPES(__VA_ARGS__), ##__VA_ARGS__);      \
+    } while (0)
+
+/* elog_token.c */
+void elog_token_output(uint16_t id, uint32_t types, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ELOG_TOKEN_H__ */
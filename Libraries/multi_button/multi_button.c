@@ -11,8 +11,6 @@
 //button handle list head.
 static struct Button* head_handle = NULL;
 
-static void button_handler(struct Button* handle);
-
 /**
   * @brief  Initializes the button struct handle.
   * @param  handle: the button handle struct.
@@ -55,10 +53,11 @@ PressEvent get_button_event(struct Button* handle)
 
 /**
   * @brief  Button driver core function, driver state machine.
+  *         Called by button_ticks for the started buttons, or once per tick by a scanner of its own.
   * @param  handle: the button handle struct.
   * @retval None
   */
-static void button_handler(struct Button* handle)
+void button_handler(struct Button* handle)
 {
 	uint8_t read_gpio_level = handle->hal_button_Level(handle->button_id);
 
@@ -110,6 +109,7 @@ static void button_handler(struct Button* handle)
 			if(handle->repeat != PRESS_REPEAT_MAX_NUM) {
 				handle->repeat++;
 			}
+			handle->event = (uint8_t)PRESS_REPEAT; // callbacks read the event from the handle
 			EVENT_CB(PRESS_REPEAT); // repeat hit
 			handle->ticks = 0;
 			handle->state = 3;
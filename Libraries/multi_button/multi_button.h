@@ -11,7 +11,9 @@
 
 //According to your need to modify the constants.
 #define TICKS_INTERVAL    5	//ms
-#define DEBOUNCE_TICKS    3	//MAX 7 (0 ~ 7)
+#ifndef DEBOUNCE_TICKS
+#define DEBOUNCE_TICKS    0	//MAX 7 (0 ~ 7), the keys are debounced by key_scan before the state machine
+#endif
 #define SHORT_TICKS       (300 /TICKS_INTERVAL)
 #define LONG_TICKS        (400 /TICKS_INTERVAL)
 
@@ -54,6 +56,7 @@ PressEvent get_button_event(struct Button* handle);
 int  button_start(struct Button* handle);
 void button_stop(struct Button* handle);
 void button_ticks(void);
+void button_handler(struct Button* handle);
 
 #ifdef __cplusplus
 }
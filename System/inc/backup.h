@@ -0,0 +1,80 @@
+/**
+* \file            backup.h
+* \date            10/19/2026
+* \brief           Header file for the battery-backed data registers
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_BACKUP_H
+#define ElysiaVACLK_BACKUP_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Allocation of the backup data registers (BKP_DR1 ~ BKP_DR10 on the STM32F103C8).
+ * They keep their content across resets as long as VDD or VBAT is present,
+ * and read back as 0 after a full power loss.
+ */
+#define BACKUP_REG_MAGIC             BKP_DR1 /* Holds BACKUP_MAGIC once the registers were written */
+#define BACKUP_REG_PLAYLIST_MODE     BKP_DR2 /* playlist_mode_t of the music playlist */
+#define BACKUP_REG_PLAYLIST_POSITION BKP_DR3 /* Current position of the music playlist */
+#define BACKUP_REG_PLAYLIST_SEED_L   BKP_DR4 /* Shuffle seed of the music playlist, low half */
+#define BACKUP_REG_PLAYLIST_SEED_H   BKP_DR5 /* Shuffle seed of the music playlist, high half */
+#define BACKUP_REG_GETUP_TIME        BKP_DR6 /* Getup alarm set in the editor, see clock_set_getup_time */
+
+/**
+* \brief           Enables the access to the backup domain
+* \return          1 if the registers kept the content written before the reset, 0 otherwise
+*/
+uint8_t backup_init(void);
+
+/**
+* \brief           Reads a backup data register
+* \param[in]       reg: One of `BACKUP_REG_*`
+* \return          Content of the register
+*/
+uint16_t backup_read(uint16_t reg);
+
+/**
+* \brief           Writes a backup data register
+* \param[in]       reg: One of `BACKUP_REG_*`
+* \param[in]       value: New content of the register
+*/
+void backup_write(uint16_t reg, uint16_t value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_BACKUP_H
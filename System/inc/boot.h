@@ -0,0 +1,127 @@
+/**
+* \file            boot.h
+* \date            10/19/2026
+* \brief           Dependency-ordered bring-up of the modules with a timeline of the steps
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_BOOT_H
+#define ElysiaVACLK_BOOT_H
+
+#include "stm32f10x.h"
+#include "coroutine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The bring-up is a const table of steps, each naming the steps it comes after. A pass of
+ * boot_process() starts, in the order of the table, every step whose steps before are done, and
+ * drives the ones started, so a step that waits on its hardware as a coroutine runs alongside the
+ * blocking ones that follow it. Every step has the time it started and the time it was done in
+ * a RAM table, in microseconds of counter_get_us(), which boot_report() logs once.
+ */
+
+/**
+* \brief           Most steps in a table, one bit each in `after`
+*/
+#define BOOT_STEPS_MAX 32
+
+/**
+* \brief           Bit of a step for `after` and boot_is_done()
+* \param[in]       step: Index of the step in the table
+* \hideinitializer
+*/
+#define BOOT_STEP(step) (1UL << (step))
+
+/**
+* \brief           A step of the bring-up
+*/
+typedef struct boot_step {
+    const char* name;                    /*!< Name in the timeline */
+    uint32_t after;                      /*!< BOOT_STEP() of the steps to be done first, 0 for none */
+    void (*start)(void);                 /*!< Starts the bring-up, NULL for none */
+    coroutine_status_t (*process)(void); /*!< Drives it until COROUTINE_DONE, NULL when `start` is all of it */
+} boot_step_t;
+
+/**
+* \brief           Timeline of a step, in microseconds of counter_get_us()
+*/
+typedef struct boot_time {
+    uint32_t start_us; /*!< Started */
+    uint32_t done_us;  /*!< Done */
+} boot_time_t;
+
+/**
+* \brief           Takes a step table, no step is started yet
+* \param[in]       steps: The steps, usually a const table, a step only comes after steps before it
+* \param[out]      times: One record per step, RAM sized with the table
+* \param[in]       num: Number of steps, up to BOOT_STEPS_MAX
+*/
+void boot_init(const boot_step_t* steps, boot_time_t* times, uint8_t num);
+
+/**
+* \brief           A pass over the steps: starts those whose steps before are done and drives those started
+* \return          COROUTINE_DONE once every step is done
+*/
+coroutine_status_t boot_process(void);
+
+/**
+* \brief           Checks whether steps are done
+* \param[in]       steps: BOOT_STEP() of the steps
+* \return          1 if all of them are done, 0 otherwise
+*/
+uint8_t boot_is_done(uint32_t steps);
+
+/**
+* \brief           Gets a step of the table
+* \param[in]       step: Index of the step in the table
+* \return          The step, NULL past the table
+*/
+const boot_step_t* boot_get_step(uint8_t step);
+
+/**
+* \brief           Gets the timeline of a step
+* \param[in]       step: Index of the step in the table
+* \return          The timeline, complete once the step is done, NULL past the table
+*/
+const boot_time_t* boot_get_time(uint8_t step);
+
+/**
+* \brief           Logs the timeline once every step is done, only the first call does
+*/
+void boot_report(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_BOOT_H
@@ -0,0 +1,201 @@
+/**
+* \file            coroutine.h
+* \date            10/19/2026
+* \brief           Stackless coroutines for multi-step driver sequences, in the style of protothreads
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_COROUTINE_H
+#define ElysiaVACLK_COROUTINE_H
+
+#include "stm32f10x.h"
+#include "counter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A coroutine is a function returning coroutine_status_t, its body between COROUTINE_BEGIN()
+ * and COROUTINE_END(). A wait returns COROUTINE_WAITING, and the next call jumps back to the
+ * wait through a switch on the line it is at, so the state is the 8 bytes of coroutine_t and
+ * no stack: local variables do not survive a wait, keep them static or in the caller, and the
+ * body must not contain a switch statement of its own.
+ *
+ * The caller calls again from its task until COROUTINE_DONE, the time waits are measured on
+ * counter_get_ms() and counter_get_us(), so they last their time, from the start of the
+ * millisecond or microsecond they begin in, and at most until the next call after it.
+ */
+
+/* Marks the fall from a wait into its own case label as intended */
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define COROUTINE_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define COROUTINE_FALLTHROUGH ((void)0)
+#endif
+
+/**
+* \brief           Result of a call to a coroutine
+*/
+typedef enum coroutine_status {
+    COROUTINE_WAITING = 0, /*!< Waiting, call again */
+    COROUTINE_DONE,        /*!< Finished, the next call starts over */
+} coroutine_status_t;
+
+/**
+* \brief           State of a coroutine
+*/
+typedef struct coroutine {
+    uint16_t line; /*!< Line to resume at, 0 at the start */
+    uint32_t mark; /*!< Deadline of the current time wait */
+} coroutine_t;
+
+/**
+* \brief           Starts a coroutine over at its next call
+* \param[out]      co: State of the coroutine
+*/
+static inline void
+coroutine_reset(coroutine_t* co) {
+    co->line = 0;
+}
+
+/**
+* \brief           Opens the body of a coroutine
+* \param[in]       co: State of the coroutine
+* \hideinitializer
+*/
+#define COROUTINE_BEGIN(co)                                                                                     \
+    switch ((co)->line) {                                                                                       \
+        case 0:
+
+/**
+* \brief           Closes the body of a coroutine, which returns COROUTINE_DONE
+* \param[in]       co: State of the coroutine
+* \hideinitializer
+*/
+#define COROUTINE_END(co)                                                                                       \
+    }                                                                                                           \
+    (co)->line = 0;                                                                                             \
+    return COROUTINE_DONE
+
+/**
+* \brief           Returns COROUTINE_DONE from anywhere in the body
+* \param[in]       co: State of the coroutine
+* \hideinitializer
+*/
+#define COROUTINE_EXIT(co)                                                                                      \
+    do {                                                                                                        \
+        (co)->line = 0;                                                                                         \
+        return COROUTINE_DONE;                                                                                  \
+    } while (0)
+
+/**
+* \brief           Waits until a condition holds, an event another task or an interrupt brings
+* \param[in]       co: State of the coroutine
+* \param[in]       cond: Condition, evaluated at every call
+* \hideinitializer
+*/
+#define COROUTINE_AWAIT(co, cond)                                                                               \
+    do {                                                                                                        \
+        (co)->line = __LINE__;                                                                                  \
+        COROUTINE_FALLTHROUGH;                                                                                  \
+        case __LINE__:                                                                                          \
+            if (!(cond)) {                                                                                      \
+                return COROUTINE_WAITING;                                                                       \
+            }                                                                                                   \
+    } while (0)
+
+/**
+* \brief           Gives way once, the sequence goes on at the next call
+* \param[in]       co: State of the coroutine
+* \hideinitializer
+*/
+#define COROUTINE_YIELD(co)                                                                                     \
+    do {                                                                                                        \
+        (co)->line = __LINE__;                                                                                  \
+        return COROUTINE_WAITING;                                                                               \
+        case __LINE__:;                                                                                         \
+    } while (0)
+
+/**
+* \brief           Waits for some milliseconds, the ticks of the main loop
+* \param[in]       co: State of the coroutine
+* \param[in]       ms: Time to wait
+* \hideinitializer
+*/
+#define COROUTINE_AWAIT_MS(co, ms)                                                                              \
+    do {                                                                                                        \
+        (co)->mark = counter_deadline_ms(ms);                                                                   \
+        COROUTINE_AWAIT(co, counter_reached_ms((co)->mark));                                                    \
+    } while (0)
+
+/**
+* \brief           Waits for some microseconds, in practice until the next call after them
+* \param[in]       co: State of the coroutine
+* \param[in]       us: Time to wait
+* \hideinitializer
+*/
+#define COROUTINE_AWAIT_US(co, us)                                                                              \
+    do {                                                                                                        \
+        (co)->mark = counter_deadline_us(us);                                                                   \
+        COROUTINE_AWAIT(co, counter_reached_us((co)->mark));                                                    \
+    } while (0)
+
+/**
+* \brief           Waits until a condition holds or some milliseconds went by, test the condition again to tell
+* \param[in]       co: State of the coroutine
+* \param[in]       cond: Condition, evaluated at every call
+* \param[in]       ms: Longest time to wait
+* \hideinitializer
+*/
+#define COROUTINE_AWAIT_TIMEOUT(co, cond, ms)                                                                   \
+    do {                                                                                                        \
+        (co)->mark = counter_deadline_ms(ms);                                                                   \
+        COROUTINE_AWAIT(co, (cond) || counter_reached_ms((co)->mark));                                          \
+    } while (0)
+
+/**
+* \brief           Runs another coroutine from its start to its end
+* \param[in]       co: State of the coroutine
+* \param[in]       child: State of the other coroutine, not shared with a running one
+* \param[in]       call: Call of the other coroutine, made at every call until it returns COROUTINE_DONE
+* \hideinitializer
+*/
+#define COROUTINE_CALL(co, child, call)                                                                         \
+    do {                                                                                                        \
+        coroutine_reset(child);                                                                                 \
+        COROUTINE_AWAIT(co, (call) == COROUTINE_DONE);                                                          \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_COROUTINE_H
@@ -32,19 +32,76 @@
 * Author:          JinLiang YAN <yanmiku0206@outlook.com>
 */
 
-#ifndef ElysiaVACLK_TIMER_H
-#define ElysiaVACLK_TIMER_H
+#ifndef ElysiaVACLK_COUNTER_H
+#define ElysiaVACLK_COUNTER_H
 
 #include "stm32f10x.h"
 
+/* Core cycle counter for delays below the TIM2 resolution, the DWT by default */
+#ifndef COUNTER_CYCLES
+#define COUNTER_CYCLES()      (*(volatile uint32_t*)0xE0001004)
+#define COUNTER_CYCLES_DWT
+#endif /* COUNTER_CYCLES */
+
+/* Core cycles per microsecond at the system clock */
+#ifndef COUNTER_CYCLES_PER_US
+#define COUNTER_CYCLES_PER_US 72
+#endif /* COUNTER_CYCLES_PER_US */
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 void counter_init(void);
+uint16_t counter_get(void);
+void counter_reset(void);
+uint32_t counter_get_ms(void);
+uint32_t counter_get_us(void);
+void counter_wake_at(uint32_t ms);
+void counter_advance_ms(uint32_t ms);
+
+/**
+ * \brief Get a deadline some milliseconds from now
+ * \param[in] ms Milliseconds from now, less than ~24 days
+ * \return Deadline for \ref counter_reached_ms
+ */
+static inline uint32_t
+counter_deadline_ms(uint32_t ms) {
+    return counter_get_ms() + ms;
+}
+
+/**
+ * \brief Check whether a deadline from \ref counter_deadline_ms has passed, correct across the wrap
+ * \param[in] deadline Deadline
+ * \return 1 when reached, 0 otherwise
+ */
+static inline uint8_t
+counter_reached_ms(uint32_t deadline) {
+    return (int32_t)(counter_get_ms() - deadline) >= 0;
+}
+
+/**
+ * \brief Get a deadline some microseconds from now
+ * \param[in] us Microseconds from now, less than ~35 minutes
+ * \return Deadline for \ref counter_reached_us
+ */
+static inline uint32_t
+counter_deadline_us(uint32_t us) {
+    return counter_get_us() + us;
+}
+
+/**
+ * \brief Check whether a deadline from \ref counter_deadline_us has passed, correct across the wrap
+ * \param[in] deadline Deadline
+ * \return 1 when reached, 0 otherwise
+ */
+static inline uint8_t
+counter_reached_us(uint32_t deadline) {
+    return (int32_t)(counter_get_us() - deadline) >= 0;
+}
 
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
 
-#endif //ElysiaVACLK_TIMER_H
+#endif //ElysiaVACLK_COUNTER_H
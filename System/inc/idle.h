@@ -0,0 +1,107 @@
+/**
+* \file            idle.h
+* \date            10/19/2026
+* \brief           Idle manager, sleeps in WFI or STOP while no task is released
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_IDLE_H
+#define ElysiaVACLK_IDLE_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Shortest time worth a STOP, waking up restarts the HSE and the PLL
+*/
+#define IDLE_STOP_MIN_MS 20
+
+/**
+* \brief           Enumeration for the modules that can hold the MCU out of STOP
+*/
+typedef enum idle_client {
+    IDLE_CLIENT_KEYS,   /*!< TIM3 is sampling the keys */
+    IDLE_CLIENT_VOICE,  /*!< The DFPlayer plays or is expected to answer over the UART */
+    IDLE_CLIENT_EDITOR, /*!< The editor is open and blinking */
+    IDLE_CLIENT_LOG,    /*!< The log UART is sending, DEBUG only */
+    IDLE_CLIENT_NUM,
+} idle_client_t;
+
+/**
+* \brief           Residency since idle_init(), in ms
+*/
+typedef struct idle_stats {
+    uint32_t run_ms;   /*!< Running at 72 MHz */
+    uint32_t sleep_ms; /*!< In WFI, the clocks and peripherals running */
+    uint32_t stop_ms;  /*!< In STOP, only the LSI, the RTC and the EXTI running */
+    uint32_t sleeps;   /*!< Times in WFI */
+    uint32_t stops;    /*!< Times in STOP */
+} idle_stats_t;
+
+/**
+* \brief           Sets the RTC up on the LSI as the timer of a STOP, after backup_init() is allowed
+*/
+void idle_init(void);
+
+/**
+* \brief           Holds the MCU out of STOP or lets it go, from any context
+* \param[in]       client: The module
+* \param[in]       hold: 1 while the module needs the clocks, 0 once it does not
+*/
+void idle_hold(idle_client_t client, uint8_t hold);
+
+/**
+* \brief           Sleeps until the next release of the scheduler or an interrupt, from the main loop when
+*                  no task is released
+*
+* With no module holding the MCU and no task without SCHEDULER_POLL released for IDLE_STOP_MIN_MS,
+* it STOPs until an RTC alarm at that release or a key EXTI, otherwise it waits in WFI.
+*/
+void idle_wait(void);
+
+/**
+* \brief           Gets the residency
+* \param[out]      stats: The residency
+*/
+void idle_get_stats(idle_stats_t* stats);
+
+/**
+* \brief           Logs the residency in run, sleep and stop, DEBUG only
+*/
+void idle_report(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_IDLE_H
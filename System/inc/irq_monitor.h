@@ -0,0 +1,161 @@
+/**
+* \file            irq_monitor.h
+* \date            10/19/2026
+* \brief           Interrupt monitor: masked sections, entry latency and execution time of the interrupts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_IRQ_MONITOR_H
+#define ElysiaVACLK_IRQ_MONITOR_H
+
+#include "stm32f10x.h"
+#include "counter.h"
+#include "nvic.h"
+#include "../../config/irq_monitor_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * IRQ_MONITOR_MASK() and IRQ_MONITOR_UNMASK() stand in for __disable_irq() and __enable_irq()
+ * around a critical section, and keep the longest one with its function and line. As with the
+ * bare intrinsics, the first unmask ends the section. The WFI of idle_wait() is masked on purpose
+ * and left out.
+ *
+ * IRQ_MONITOR_ENTER(irq) and IRQ_MONITOR_EXIT(irq) open and close an interrupt handler, the
+ * handlers that know when their event was, a timer update or compare, add IRQ_MONITOR_LATENCY()
+ * with the cycles from the event to the handler. All durations are in COUNTER_CYCLES().
+ */
+
+/**
+* \brief           Entries and durations of an interrupt
+*/
+typedef struct irq_monitor_stats {
+    uint32_t count;         /*!< Entries */
+    uint32_t cycles_max;    /*!< Longest execution, the interrupts preempting it included */
+    uint64_t cycles_sum;    /*!< Total execution */
+    uint32_t latency_count; /*!< Entries with a known event time */
+    uint32_t latency_max;   /*!< Longest time from the event to the handler */
+} irq_monitor_stats_t;
+
+/**
+* \brief           Masked sections
+*/
+typedef struct irq_monitor_mask {
+    uint32_t count;      /*!< Sections */
+    uint32_t cycles_max; /*!< Longest */
+    const char* func;    /*!< Function of the longest, NULL before the first */
+    uint16_t line;       /*!< Line of its IRQ_MONITOR_MASK() */
+} irq_monitor_mask_t;
+
+#if IRQ_MONITOR_CFG_ENABLE
+
+/**
+* \brief           Masks the interrupts and starts timing the section
+* \hideinitializer
+*/
+#define IRQ_MONITOR_MASK()                                                                                      \
+    do {                                                                                                        \
+        __disable_irq();                                                                                        \
+        irq_monitor_mask_begin(__func__, __LINE__);                                                             \
+    } while (0)
+
+/**
+* \brief           Ends timing the section and unmasks the interrupts
+* \hideinitializer
+*/
+#define IRQ_MONITOR_UNMASK()                                                                                    \
+    do {                                                                                                        \
+        irq_monitor_mask_end();                                                                                 \
+        __enable_irq();                                                                                         \
+    } while (0)
+
+/**
+* \brief           Starts timing an interrupt handler, first thing in it
+* \param[in]       irq: Interrupt, a \ref nvic_irq_t
+* \hideinitializer
+*/
+#define IRQ_MONITOR_ENTER(irq)           const uint32_t irq_monitor_start = COUNTER_CYCLES()
+
+/**
+* \brief           Notes the time from the event to the handler
+* \param[in]       irq: Interrupt
+* \param[in]       cycles: Time, only evaluated when the monitor is enabled
+* \hideinitializer
+*/
+#define IRQ_MONITOR_LATENCY(irq, cycles) irq_monitor_latency(irq, cycles)
+
+/**
+* \brief           Ends timing an interrupt handler, last thing in it
+* \param[in]       irq: Interrupt
+* \hideinitializer
+*/
+#define IRQ_MONITOR_EXIT(irq)            irq_monitor_exit(irq, COUNTER_CYCLES() - irq_monitor_start)
+
+void irq_monitor_mask_begin(const char* func, uint16_t line);
+void irq_monitor_mask_end(void);
+void irq_monitor_latency(nvic_irq_t irq, uint32_t cycles);
+void irq_monitor_exit(nvic_irq_t irq, uint32_t cycles);
+
+#else
+
+#define IRQ_MONITOR_MASK()               __disable_irq()
+#define IRQ_MONITOR_UNMASK()             __enable_irq()
+#define IRQ_MONITOR_ENTER(irq)           ((void)(irq))
+#define IRQ_MONITOR_LATENCY(irq, cycles) ((void)(irq))
+#define IRQ_MONITOR_EXIT(irq)            ((void)(irq))
+
+#endif /* IRQ_MONITOR_CFG_ENABLE */
+
+/**
+* \brief           Gets the entries and durations of an interrupt, zero with the monitor disabled
+* \param[in]       irq: Interrupt
+* \param[out]      stats: Where to copy them
+*/
+void irq_monitor_get_stats(nvic_irq_t irq, irq_monitor_stats_t* stats);
+
+/**
+* \brief           Gets the masked sections, zero with the monitor disabled
+* \param[out]      mask: Where to copy them
+*/
+void irq_monitor_get_mask(irq_monitor_mask_t* mask);
+
+/**
+* \brief           Logs the longest masked section and, for every interrupt of the priority map, its
+*                  priority, entries, execution time and latency, DEBUG only
+*/
+void irq_monitor_report(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_IRQ_MONITOR_H
@@ -0,0 +1,134 @@
+/**
+* \file            log_ring.h
+* \date            10/19/2026
+* \brief           Lock-free multi-producer record ring, for logs written from any context
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_LOG_RING_H
+#define ElysiaVACLK_LOG_RING_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Records of any length up to LOG_RING_LEN_MAX, written by any number of producers, the main
+ * loop and interrupts preempting each other, and read in order by a single consumer. A producer
+ * reserves its record by moving the head with LDREX/STREX, fills it and commits it; none of them
+ * masks the interrupts or waits for another. A record that does not fit is dropped and counted.
+ *
+ * The consumer takes the records in the order of their reservation: a record reserved but not
+ * committed yet, by a producer an interrupt preempted, holds the ones after it back until it is.
+ */
+
+/**
+* \brief           Longest record
+*/
+#define LOG_RING_LEN_MAX 0xFFFFU
+
+/**
+* \brief           Ring, only touched through the functions
+*/
+typedef struct log_ring {
+    uint8_t* buf;              /*!< Records, 4-byte aligned */
+    uint32_t size;             /*!< Bytes of buf, a power of 2 */
+    volatile uint32_t head;    /*!< Reserved up to, free running */
+    volatile uint32_t tail;    /*!< Released up to, free running */
+    volatile uint32_t dropped; /*!< Records that did not fit */
+} log_ring_t;
+
+/**
+* \brief           Sets a ring up empty
+* \param[in]       ring: The ring
+* \param[in]       buf: Its records, 4-byte aligned
+* \param[in]       size: Bytes of buf, a power of 2 up to 64 KB
+*/
+void log_ring_init(log_ring_t* ring, void* buf, uint32_t size);
+
+/**
+* \brief           Reserves a record, from any context
+* \param[in]       ring: The ring
+* \param[in]       len: Bytes of the record
+* \return          The record to fill and pass to log_ring_commit(), NULL when it does not fit and is dropped
+*/
+void* log_ring_reserve(log_ring_t* ring, uint32_t len);
+
+/**
+* \brief           Hands a filled record over to the consumer
+* \param[in]       ring: The ring
+* \param[in]       record: The record of log_ring_reserve()
+*/
+void log_ring_commit(log_ring_t* ring, void* record);
+
+/**
+* \brief           Copies a record in, from any context
+* \param[in]       ring: The ring
+* \param[in]       data: The record
+* \param[in]       len: Its bytes
+* \return          1 when written, 0 when dropped
+*/
+uint8_t log_ring_write(log_ring_t* ring, const void* data, uint32_t len);
+
+/**
+* \brief           Gets the oldest record, by the consumer
+* \param[in]       ring: The ring
+* \param[out]      len: Bytes of the record
+* \return          The record, in the ring until log_ring_release(), NULL when there is none or it is not committed yet
+*/
+const void* log_ring_peek(log_ring_t* ring, uint32_t* len);
+
+/**
+* \brief           Frees the record of log_ring_peek(), by the consumer
+* \param[in]       ring: The ring
+*/
+void log_ring_release(log_ring_t* ring);
+
+/**
+* \brief           Tells whether the ring is empty, holding no record committed or not
+* \param[in]       ring: The ring
+* \return          1 when it is empty, 0 otherwise
+*/
+uint8_t log_ring_is_empty(const log_ring_t* ring);
+
+/**
+* \brief           Gets the records dropped since log_ring_init()
+* \param[in]       ring: The ring
+* \return          The records
+*/
+uint32_t log_ring_get_dropped(const log_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_LOG_RING_H
@@ -1,7 +1,7 @@
 /**
 * \file            nvic.h
 * \date            12/4/2023
-* \brief
+* \brief           Interrupt priority map, the one source of the priority scheme
 */
 
 /*
@@ -40,8 +40,67 @@ extern "C" {
 #endif /* __cplusplus */
 
 #include "stm32f10x.h"
+
+/**
+* \brief           Priority grouping of the whole firmware: 2 bits of preemption priority, 2 of subpriority
+*/
+#define NVIC_GROUPING NVIC_PriorityGroup_2
+
+/**
+* \brief           Enumeration for the interrupts of the priority map in nvic.c, the only place their
+*                  priorities are set
+*/
+typedef enum nvic_irq {
+    NVIC_IRQ_TIM3,          /*!< Key tick */
+    NVIC_IRQ_EXTI0,         /*!< Key edges, PA0 */
+    NVIC_IRQ_EXTI1,         /*!< PA1 */
+    NVIC_IRQ_EXTI2,         /*!< PA2 */
+    NVIC_IRQ_EXTI3,         /*!< PA3 */
+    NVIC_IRQ_EXTI4,         /*!< PA4 */
+    NVIC_IRQ_EXTI9_5,       /*!< PA5 ~ PA7 */
+    NVIC_IRQ_USART1,        /*!< DFPlayer frames, idle line */
+    NVIC_IRQ_DMA1_CHANNEL5, /*!< DFPlayer bytes, USART1 RX DMA half and full */
+    NVIC_IRQ_TIM2,          /*!< Time base overflow and wake-up compare */
+    NVIC_IRQ_RTC_ALARM,     /*!< End of a STOP */
+    NVIC_IRQ_DMA1_CHANNEL2, /*!< Log lines sent, USART3 TX DMA, DEBUG only */
+    NVIC_IRQ_NUM,
+} nvic_irq_t;
+
+/**
+* \brief           Entry of the priority map
+*/
+typedef struct nvic_priority {
+    const char* name; /*!< Name in the reports */
+    IRQn_Type irqn;   /*!< Channel */
+    uint8_t preempt;  /*!< Preemption priority, 0 ~ 3, 0 preempts the others */
+    uint8_t sub;      /*!< Subpriority, 0 ~ 3, 0 goes first among those pending at once */
+} nvic_priority_t;
+
+/**
+* \brief           Sets the priority grouping, first thing in system_init before any interrupt is enabled
+*/
 void nvic_init(void);
 
+/**
+* \brief           Sets an interrupt to its priority of the map and enables it
+* \param[in]       irq: Interrupt
+*/
+void nvic_enable(nvic_irq_t irq);
+
+/**
+* \brief           Gets the entry of an interrupt in the priority map
+* \param[in]       irq: Interrupt
+* \return          Entry
+*/
+const nvic_priority_t* nvic_get_priority(nvic_irq_t irq);
+
+/**
+* \brief           Checks the NVIC against the priority map: the grouping, the priority and the enable of every
+*                  interrupt of the map, and no interrupt enabled outside of it. Logs each difference
+* \return          Number of differences, 0 if the NVIC is as the map says
+*/
+uint8_t nvic_verify(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
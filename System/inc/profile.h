@@ -0,0 +1,173 @@
+/**
+* \file            profile.h
+* \date            10/19/2026
+* \brief           Cycle profiler, log2 histograms of the time spent in scoped points and interrupts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_PROFILE_H
+#define ElysiaVACLK_PROFILE_H
+
+#include "stm32f10x.h"
+#include "counter.h"
+#include "../../config/profile_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A point is timed between PROFILE_BEGIN(id) and PROFILE_END(id) in the same scope, or between
+ * PROFILE_ISR_ENTER(id) and PROFILE_ISR_EXIT(id) in an interrupt handler. The time the
+ * instrumented interrupts took in between is taken out, so a point counts its own cycles
+ * whatever preempts it, the other points it calls included. A point is updated from one
+ * context only, the main loop or one interrupt.
+ *
+ * profile_dump() prints a snapshot of the histograms to the log as `prof <hex>` lines and
+ * starts them over. A snapshot is a byte stream:
+ *
+ *   - PROFILE_MAGIC_0, PROFILE_MAGIC_1, PROFILE_VERSION, PROFILE_NUM, PROFILE_CFG_BINS and
+ *     COUNTER_CYCLES_PER_US, then the milliseconds since the previous snapshot as a varint
+ *   - for each point timed since then: its id, then as varints its count, its longest and its
+ *     total cycles, the mask of its non-empty bins and the count of each of them
+ *   - PROFILE_END_MARK
+ *
+ * A varint holds 7 bits per byte, least significant first, bit 7 set on all but the last byte.
+ * tools/profile_view renders the snapshots of a log.
+ */
+#define PROFILE_MAGIC_0  'P'
+#define PROFILE_MAGIC_1  'F'
+#define PROFILE_VERSION  1
+#define PROFILE_END_MARK 0xFF
+
+/**
+* \brief           Read the cycle counter the points are timed with, the DWT CYCCNT counter_init() starts
+*/
+#ifndef PROFILE_CYCLES
+#define PROFILE_CYCLES() COUNTER_CYCLES()
+#endif /* PROFILE_CYCLES */
+
+/**
+* \brief           Enumeration for the points of PROFILE_CFG_POINTS
+*/
+typedef enum profile_point {
+#define PROFILE_POINT_ID(id, name) id,
+    PROFILE_CFG_POINTS(PROFILE_POINT_ID)
+#undef PROFILE_POINT_ID
+    PROFILE_NUM,
+} profile_point_t;
+
+/**
+* \brief           Durations of a point, in PROFILE_CYCLES()
+*/
+typedef struct profile_stats {
+    uint32_t count;                  /*!< Times it was timed */
+    uint32_t max;                    /*!< Longest */
+    uint64_t sum;                    /*!< Total */
+    uint32_t bins[PROFILE_CFG_BINS]; /*!< Histogram, see \ref PROFILE_CFG_BINS */
+} profile_stats_t;
+
+#if PROFILE_CFG_ENABLE
+
+/* Cycles spent in the instrumented interrupts, taken out of the points they preempt */
+extern volatile uint32_t profile_isr_cycles;
+
+/**
+* \brief           Starts timing a point, declares its start in the current scope
+* \param[in]       id: Point, a \ref profile_point_t
+* \hideinitializer
+*/
+#define PROFILE_BEGIN(id)                                                                                       \
+    const uint32_t profile_start_##id = PROFILE_CYCLES();                                                       \
+    const uint32_t profile_isr_##id = profile_isr_cycles
+
+/**
+* \brief           Ends timing a point started in the same scope
+* \param[in]       id: Point
+* \hideinitializer
+*/
+#define PROFILE_END(id)                                                                                         \
+    profile_add(id, PROFILE_CYCLES() - profile_start_##id - (profile_isr_cycles - profile_isr_##id))
+
+/**
+* \brief           Starts timing an interrupt handler, first thing in it
+* \param[in]       id: Point
+* \hideinitializer
+*/
+#define PROFILE_ISR_ENTER(id) PROFILE_BEGIN(id)
+
+/**
+* \brief           Ends timing an interrupt handler, last thing in it
+* \param[in]       id: Point
+* \hideinitializer
+*/
+#define PROFILE_ISR_EXIT(id)                                                                                    \
+    profile_add_isr(id, PROFILE_CYCLES() - profile_start_##id - (profile_isr_cycles - profile_isr_##id))
+
+/**
+* \brief           Adds a duration to the histogram of a point, use PROFILE_END()
+* \param[in]       id: Point
+* \param[in]       cycles: Duration
+*/
+void profile_add(profile_point_t id, uint32_t cycles);
+
+/**
+* \brief           Adds the duration of an interrupt, use PROFILE_ISR_EXIT()
+* \param[in]       id: Point
+* \param[in]       cycles: Duration, the nested instrumented interrupts taken out
+*/
+void profile_add_isr(profile_point_t id, uint32_t cycles);
+
+/**
+* \brief           Gets the durations of a point since the last dump
+* \param[in]       id: Point
+* \param[out]      stats: Where to copy them
+*/
+void profile_get_stats(profile_point_t id, profile_stats_t* stats);
+
+/**
+* \brief           Prints a snapshot of all the points to the log and starts them over, from the main loop
+*/
+void profile_dump(void);
+
+#else
+
+#define PROFILE_BEGIN(id)     ((void)0)
+#define PROFILE_END(id)       ((void)0)
+#define PROFILE_ISR_ENTER(id) ((void)0)
+#define PROFILE_ISR_EXIT(id)  ((void)0)
+
+#endif /* PROFILE_CFG_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_PROFILE_H
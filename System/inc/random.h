@@ -0,0 +1,67 @@
+/**
+* \file            random.h
+* \date            10/19/2026
+* \brief           Header file for the pseudo-random number generator
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_RANDOM_H
+#define ElysiaVACLK_RANDOM_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Seeds the generator with ADC noise, the device unique ID and the given value
+* \param[in]       seed: Extra entropy, such as the RTC time
+*/
+void random_init(uint32_t seed);
+
+/**
+* \brief           Draws a uniformly distributed 32-bit number
+* \return          Random number
+*/
+uint32_t random_u32(void);
+
+/**
+* \brief           Draws a uniformly distributed number below a bound, without modulo bias
+* \param[in]       bound: Number of possible values
+* \return          Random number in [0, bound), 0 if bound is 0
+*/
+uint32_t random_range(uint32_t bound);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_RANDOM_H
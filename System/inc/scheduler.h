@@ -0,0 +1,168 @@
+/**
+* \file            scheduler.h
+* \date            10/19/2026
+* \brief           Time-triggered cooperative scheduler over a const task table
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_SCHEDULER_H
+#define ElysiaVACLK_SCHEDULER_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Read the cycle counter used to time the runs, the DWT CYCCNT at 72 MHz
+*
+* A host build defines its own, scheduler_init() then leaves the DWT alone.
+*/
+#ifndef SCHEDULER_CYCLES
+#define SCHEDULER_CYCLES() (*(volatile uint32_t*)0xE0001004)
+#define SCHEDULER_CYCLES_DWT
+#endif /* SCHEDULER_CYCLES */
+
+/**
+* \brief           SCHEDULER_CYCLES() per microsecond
+*/
+#define SCHEDULER_CYCLES_PER_US 72
+
+/**
+* \brief           Flag of a task that only polls for work an interrupt or another task brings
+*
+* Its releases do not bound a STOP, see scheduler_stop_ms(), and after one it is released at once.
+* \hideinitializer
+*/
+#define SCHEDULER_POLL 0x01
+
+/**
+* \brief           A task, released every `period_ms` on the millisecond tick of counter_get_ms()
+*
+* A task runs to completion and must not wait, it keeps its own state between runs.
+*/
+typedef struct scheduler_task {
+    const char* name;   /*!< Name in the report */
+    void (*run)(void);  /*!< Body of the task */
+    uint16_t period_ms; /*!< Time between two releases, at least 1 */
+    uint16_t phase_ms;  /*!< Time from scheduler_init() to the first release, spreads the tasks apart */
+    uint16_t budget_us; /*!< Longest a run should take, a longer run counts as an overrun */
+    uint8_t priority;   /*!< Of the tasks released, the lowest value runs first, then the first in the table */
+    uint8_t flags;      /*!< SCHEDULER_POLL or 0 */
+} scheduler_task_t;
+
+/**
+* \brief           Run time state and instrumentation of a task, durations in SCHEDULER_CYCLES()
+*/
+typedef struct scheduler_stats {
+    uint32_t release_ms;   /*!< Next release */
+    uint32_t runs;         /*!< Runs so far */
+    uint32_t late;         /*!< Releases skipped because the task started a whole period late */
+    uint32_t lateness_max; /*!< Longest time from a release to the start of its run, in ms */
+    uint32_t overruns;     /*!< Runs longer than the budget */
+    uint32_t cycles_max;   /*!< Longest run */
+    uint64_t cycles_sum;   /*!< Sum of the runs */
+} scheduler_stats_t;
+
+/**
+* \brief           Starts scheduling a task table, all releases count from now
+* \param[in]       tasks: The tasks, usually a const table
+* \param[out]      stats: One record per task, RAM sized with the table
+* \param[in]       num: Number of tasks
+*/
+void scheduler_init(const scheduler_task_t* tasks, scheduler_stats_t* stats, uint8_t num);
+
+/**
+* \brief           Runs the most urgent of the released tasks, if any
+* \return          1 if a task ran, 0 if none was released
+*/
+uint8_t scheduler_run(void);
+
+/**
+* \brief           Releases a task now, ahead of its period, the following releases count from now
+* \param[in]       task: Index of the task in the table
+*/
+void scheduler_release(uint8_t task);
+
+/**
+* \brief           Brings the next release of a task forward to some time from now, a later time changes nothing
+* \param[in]       task: Index of the task in the table
+* \param[in]       ms: Time from now, above INT32_MAX changes nothing
+*/
+void scheduler_release_in(uint8_t task, uint32_t ms);
+
+/**
+* \brief           Gets the time to the next release
+* \return          0 if a task is released already
+*/
+uint32_t scheduler_idle_ms(void);
+
+/**
+* \brief           Gets the time to the next release of a task without SCHEDULER_POLL, how long the MCU may STOP
+* \return          0 if such a task is released already
+*/
+uint32_t scheduler_stop_ms(void);
+
+/**
+* \brief           Picks up after a STOP: the SCHEDULER_POLL tasks it kept waiting are released now, not late
+*/
+void scheduler_resume(void);
+
+/**
+* \brief           Gets a task of the table
+* \param[in]       task: Index of the task in the table
+* \return          The task, NULL for an index beyond the table
+*/
+const scheduler_task_t* scheduler_get_task(uint8_t task);
+
+/**
+* \brief           Gets the state and instrumentation of a task
+* \param[in]       task: Index of the task in the table
+* \return          The record, NULL for an index beyond the table
+*/
+const scheduler_stats_t* scheduler_get_stats(uint8_t task);
+
+/**
+* \brief           Gets the time since scheduler_init()
+* \return          Elapsed time, in ms
+*/
+uint32_t scheduler_get_elapsed_ms(void);
+
+/**
+* \brief           Logs the instrumentation of every task, CPU share, WCET, overruns and lateness, DEBUG only
+*/
+void scheduler_report(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_SCHEDULER_H
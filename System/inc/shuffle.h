@@ -0,0 +1,88 @@
+/**
+* \file            shuffle.h
+* \date            10/19/2026
+* \brief           Header file for the table-free shuffle permutation
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_SHUFFLE_H
+#define ElysiaVACLK_SHUFFLE_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Shuffle bag: draws every item once, in random order, before starting over
+* \note            Zero-initialize it before the first draw
+*/
+typedef struct shuffle_bag {
+    uint16_t seed;    /*!< Permutation of the current round */
+    uint8_t position; /*!< Number of items drawn in the current round */
+    uint8_t size;     /*!< Number of items of the current round */
+} shuffle_bag_t;
+
+/**
+* \brief           Maps a position of a shuffled sequence to the item played there
+* \note            Every seed gives a permutation of [0, size): each item shows up
+*                  exactly once while position runs from 0 to size - 1
+* \param[in]       position: Position in the shuffled sequence, lower than size
+* \param[in]       size: Number of items
+* \param[in]       seed: Permutation seed
+* \return          Item at that position
+*/
+uint16_t shuffle_index(uint16_t position, uint16_t size, uint32_t seed);
+
+/**
+* \brief           Finds the position of an item in a shuffled sequence, inverse of shuffle_index
+* \param[in]       index: Item, lower than size
+* \param[in]       size: Number of items
+* \param[in]       seed: Permutation seed
+* \return          Position of the item
+*/
+uint16_t shuffle_position(uint16_t index, uint16_t size, uint32_t seed);
+
+/**
+* \brief           Draws the next item of a shuffle bag
+* \note            A new round starts when the bag is empty or its size changed.
+*                  The first item of a round is never the last one of the previous round.
+* \param[in]       bag: The bag
+* \param[in]       size: Number of items, at least 1
+* \return          Item in [0, size)
+*/
+uint8_t shuffle_bag_draw(shuffle_bag_t* bag, uint8_t size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_SHUFFLE_H
@@ -0,0 +1,147 @@
+/**
+* \file            soft_timer.h
+* \date            10/19/2026
+* \brief           One-shot and periodic software timers on a hierarchical timing wheel
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ElysiaVACLK_SOFT_TIMER_H
+#define ElysiaVACLK_SOFT_TIMER_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Wheel geometry: SOFT_TIMER_LEVELS wheels of 2^SOFT_TIMER_BITS slots
+*
+* A slot of level n spans 2^(n * SOFT_TIMER_BITS) ms, the finest wheel has a slot per millisecond.
+* A timer further out than the top wheel reaches (~17 minutes) waits there and is put back when
+* its slot comes round, so any time below 2^31 ms works.
+*/
+#define SOFT_TIMER_BITS   5
+#define SOFT_TIMER_LEVELS 4
+
+/**
+* \brief           Value of \ref soft_timer_next_ms when no timer is running
+*/
+#define SOFT_TIMER_NEVER  UINT32_MAX
+
+typedef struct soft_timer soft_timer_t;
+
+/**
+* \brief           Timer callback, runs in thread context from soft_timer_process()
+* \param[in]       timer: The timer that expired, a callback may start or stop any timer, this one included
+*/
+typedef void (*soft_timer_fn)(soft_timer_t* timer);
+
+/**
+* \brief           A timer, owned by the module using it, usually static
+*
+* There is no pool: the number of timers is the number of these objects in the program.
+*/
+struct soft_timer {
+    soft_timer_t* next;     /*!< Next timer in the same slot */
+    soft_timer_t* prev;     /*!< Previous timer in the same slot, NULL for the first */
+    soft_timer_fn callback; /*!< Called at expiry */
+    uint32_t expire_ms;     /*!< Time of the next expiry, on the time base of counter_get_ms() */
+    uint32_t period_ms;     /*!< Time between expiries, 0 for a one-shot timer */
+    uint16_t slot;          /*!< Slot it is linked in, SOFT_TIMER_STOPPED when not running */
+};
+
+/**
+* \brief           Value of soft_timer_t::slot when the timer is not running
+*/
+#define SOFT_TIMER_STOPPED 0xFFFF
+
+/**
+* \brief           Prepares a timer, stopped
+* \param[out]      timer: Timer
+* \param[in]       callback: Called at every expiry
+*/
+void soft_timer_init(soft_timer_t* timer, soft_timer_fn callback);
+
+/**
+* \brief           Starts a timer, or restarts it if running
+* \param[in]       timer: Timer prepared by soft_timer_init()
+* \param[in]       ms: Time to the first expiry, 0 expires at the next soft_timer_process(), from a callback at the next millisecond
+* \param[in]       period_ms: Time between the following expiries, 0 for a one-shot timer
+* \note            Thread context only, like the callbacks
+*/
+void soft_timer_start(soft_timer_t* timer, uint32_t ms, uint32_t period_ms);
+
+/**
+* \brief           Stops a timer, nothing happens if it is not running
+* \param[in]       timer: Timer
+*/
+void soft_timer_stop(soft_timer_t* timer);
+
+/**
+* \brief           Checks whether a timer is running
+* \param[in]       timer: Timer
+* \return          1 if it is going to expire, 0 otherwise
+*/
+uint8_t soft_timer_is_running(const soft_timer_t* timer);
+
+/**
+* \brief           Advances the wheel to counter_get_ms() and calls back the timers that expired
+*
+* A periodic timer more than a period late expires once, its later expiries stay on its grid.
+*
+* \return          Number of callbacks
+*/
+uint16_t soft_timer_process(void);
+
+/**
+* \brief           Gets the time to the next call of soft_timer_process() that has work to do
+*
+* That is the next expiry, or earlier the time a far timer moves to a finer wheel.
+*
+* \return          Time in ms, 0 if already due, \ref SOFT_TIMER_NEVER if no timer is running
+*/
+uint32_t soft_timer_next_ms(void);
+
+/**
+* \brief           Sets a function told the time to the next work whenever it may have come closer
+*
+* It is called after soft_timer_start() and soft_timer_process() with the value of
+* soft_timer_next_ms(), to bring forward the task that calls soft_timer_process().
+*
+* \param[in]       wake: The function, NULL for none
+*/
+void soft_timer_set_wake_callback(void (*wake)(uint32_t ms));
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif //ElysiaVACLK_SOFT_TIMER_H
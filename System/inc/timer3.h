@@ -40,8 +40,32 @@ extern "C" {
 #endif /* __cplusplus */
 
 #include "stm32f10x.h"
+
+/**
+* \brief           Period of the TIM3 update interrupt
+*/
+#define TIMER3_PERIOD_MS 5
+
+/**
+* \brief           Core clock cycles per TIM3 count, one count is 100us
+*/
+#define TIMER3_CYCLES_PER_COUNT 7200
+
+/**
+* \brief           Sets TIM3 up for an update interrupt every TIMER3_PERIOD_MS, stopped
+*/
 void timer3_init(void);
 
+/**
+* \brief           Starts TIM3, the first update comes a full period later
+*/
+void timer3_start(void);
+
+/**
+* \brief           Stops TIM3 and drops a pending update
+*/
+void timer3_stop(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
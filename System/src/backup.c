@@ -0,0 +1,67 @@
+/**
+* \file            backup.c
+* \date            10/19/2026
+* \brief           Battery-backed data registers
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "backup.h"
+
+#define BACKUP_MAGIC 0xE1A5
+
+static uint8_t backup_ready; /*!< Whether the backup domain is writable */
+static uint8_t backup_valid; /*!< Whether the registers survived the last reset */
+
+uint8_t
+backup_init(void) {
+    /* Several modules own registers, only the first call looks at the magic */
+    if (backup_ready) {
+        return backup_valid;
+    }
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR | RCC_APB1Periph_BKP, ENABLE);
+    PWR_BackupAccessCmd(ENABLE);
+    backup_ready = 1;
+
+    backup_valid = BKP_ReadBackupRegister(BACKUP_REG_MAGIC) == BACKUP_MAGIC;
+    if (!backup_valid) {
+        BKP_WriteBackupRegister(BACKUP_REG_MAGIC, BACKUP_MAGIC);
+    }
+    return backup_valid;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    return BKP_ReadBackupRegister(reg);
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    BKP_WriteBackupRegister(reg, value);
+}
@@ -0,0 +1,122 @@
+/**
+* \file            boot.c
+* \date            10/19/2026
+* \brief           Dependency-ordered bring-up of the modules with a timeline of the steps
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "boot.h"
+#include "counter.h"
+
+#define LOG_TAG "BOOT"
+#include "elog.h"
+
+static const boot_step_t* boot_steps;
+static boot_time_t* boot_times;
+static uint8_t boot_num;
+static uint32_t boot_started; /* BOOT_STEP() of the steps started */
+static uint32_t boot_done;    /* And of those done */
+static uint8_t boot_reported;
+
+/* BOOT_STEP() of every step of the table */
+#define BOOT_ALL (boot_num == BOOT_STEPS_MAX ? 0xFFFFFFFFUL : BOOT_STEP(boot_num) - 1)
+
+void
+boot_init(const boot_step_t* steps, boot_time_t* times, uint8_t num) {
+    boot_steps = steps;
+    boot_times = times;
+    boot_num = num > BOOT_STEPS_MAX ? BOOT_STEPS_MAX : num;
+    boot_started = 0;
+    boot_done = 0;
+    boot_reported = 0;
+    for (uint8_t i = 0; i < boot_num; i++) {
+        times[i] = (boot_time_t){0};
+    }
+}
+
+coroutine_status_t
+boot_process(void) {
+    for (uint8_t i = 0; i < boot_num; i++) {
+        const boot_step_t* step = &boot_steps[i];
+        uint32_t bit = BOOT_STEP(i);
+
+        if (boot_done & bit) {
+            continue;
+        }
+        if (!(boot_started & bit)) {
+            if ((boot_done & step->after) != step->after) {
+                continue;
+            }
+            boot_started |= bit;
+            boot_times[i].start_us = counter_get_us();
+            if (step->start != NULL) {
+                step->start();
+            }
+        }
+        /* A step done here lets the steps after it in the table start in the same pass */
+        if (step->process == NULL || step->process() == COROUTINE_DONE) {
+            boot_done |= bit;
+            boot_times[i].done_us = counter_get_us();
+        }
+    }
+    return boot_is_done(BOOT_ALL) ? COROUTINE_DONE : COROUTINE_WAITING;
+}
+
+uint8_t
+boot_is_done(uint32_t steps) {
+    return (boot_done & steps) == steps;
+}
+
+const boot_step_t*
+boot_get_step(uint8_t step) {
+    return step < boot_num ? &boot_steps[step] : NULL;
+}
+
+const boot_time_t*
+boot_get_time(uint8_t step) {
+    return step < boot_num ? &boot_times[step] : NULL;
+}
+
+void
+boot_report(void) {
+    if (boot_reported || !boot_is_done(BOOT_ALL)) {
+        return;
+    }
+    boot_reported = 1;
+#if defined(DEBUG)
+    for (uint8_t i = 0; i < boot_num; i++) {
+        const boot_time_t* time = &boot_times[i];
+
+        log_d("%-12s %6lu.%03lu ~ %6lu.%03lu ms, %lu us", boot_steps[i].name, (unsigned long)time->start_us / 1000,
+              (unsigned long)time->start_us % 1000, (unsigned long)time->done_us / 1000,
+              (unsigned long)time->done_us % 1000, (unsigned long)(time->done_us - time->start_us));
+    }
+#endif /* defined(DEBUG) */
+}
@@ -33,9 +33,39 @@
 */
 
 #include "counter.h"
+#include "irq_monitor.h"
+#include "nvic.h"
+#include "profile.h"
+
+/*
+ * TIM2 counts microseconds and overflows every 65.536 ms, the update interrupt counts the
+ * overflows. Both time bases are derived from the overflow count and the counter alone, with
+ * 32-bit arithmetic only, so a reader needs no state the interrupt updates in several steps:
+ * 65536 us = 65 ms + 536 us, and 1000 overflows add exactly 536 ms of those 536 us.
+ */
+#define COUNTER_PERIOD_US 65536
+
+/* TIM2 overflows since counter_init, advanced by the TIM2 update interrupt */
+static volatile uint32_t counter_overflows;
+
+/* Time TIM2 stood still in STOP mode, added by counter_advance_ms */
+static volatile uint32_t counter_stopped_ms;
+
+/* A consistent reading of the time */
+typedef struct {
+    uint32_t us;  /* Microseconds, wrapping */
+    uint32_t ms;  /* Milliseconds, wrapping */
+    uint32_t sub; /* Microseconds into the millisecond */
+    uint32_t cnt; /* TIM2 counter */
+} counter_time_t;
 
 void
 counter_init(void) {
+#ifdef COUNTER_CYCLES_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    *(volatile uint32_t*)0xE0001000 |= 1; /* DWT_CTRL.CYCCNTENA */
+#endif /* COUNTER_CYCLES_DWT */
+
     //开启时钟
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
 
@@ -46,11 +76,20 @@ counter_init(void) {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
     TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInitStructure.TIM_Period = 10000 - 1;
-    TIM_TimeBaseInitStructure.TIM_Prescaler = 7200 - 1;
+    TIM_TimeBaseInitStructure.TIM_Period = COUNTER_PERIOD_US - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = 72 - 1;
     TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0; //基本定时器无，随便设为0
     TIM_TimeBaseInit(TIM2, &TIM_TimeBaseInitStructure);
 
+    //TIM_TimeBaseInit会产生一次更新事件, 清除它以免溢出多计一次
+    TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+    counter_overflows = 0;
+
+    //使能中断, 每65.536ms一次
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+
+    nvic_enable(NVIC_IRQ_TIM2);
+
     //启动定时器
     TIM_Cmd(TIM2, ENABLE);
 }
@@ -60,7 +99,130 @@ counter_get(void) {
     return TIM_GetCounter(TIM2);
 }
 
+/**
+ * \brief Reset the part of the counter within the TIM2 period
+ * \note The time bases returned by \ref counter_get_ms and \ref counter_get_us jump backwards when this is called
+ */
 void
 counter_reset(void) {
     TIM_SetCounter(TIM2, 0);
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Read the time, consistently with the overflows
+ */
+static void
+counter_read(counter_time_t* time) {
+    uint32_t overflows, cnt, stopped, extra = 0, us_in;
+
+    do {
+        overflows = counter_overflows;
+        cnt = TIM_GetCounter(TIM2);
+    } while (overflows != counter_overflows);
+    stopped = counter_stopped_ms;
+
+    /* Overflowed, but the update interrupt has not run yet (masked or preempted) */
+    if (TIM_GetFlagStatus(TIM2, TIM_FLAG_Update) == SET && cnt < COUNTER_PERIOD_US / 2) {
+        extra = COUNTER_PERIOD_US;
+    }
+
+    us_in = overflows % 1000 * 536 + extra + cnt;
+    time->us = (overflows << 16) + extra + cnt + stopped * 1000;
+    time->ms = overflows * 65 + overflows / 1000 * 536 + us_in / 1000 + stopped;
+    time->sub = us_in % 1000;
+    time->cnt = cnt;
+}
+
+/**
+ * \brief Get the milliseconds elapsed since \ref counter_init
+ *
+ * The value wraps after ~49 days, compare time stamps by subtraction only.
+ * Safe to call from thread context and from interrupts of any priority.
+ *
+ * \return Monotonic time in milliseconds
+ */
+uint32_t
+counter_get_ms(void) {
+    counter_time_t time;
+
+    counter_read(&time);
+    return time.ms;
+}
+
+/**
+ * \brief Get the microseconds elapsed since \ref counter_init
+ *
+ * The value wraps after ~71 minutes, compare time stamps by subtraction only.
+ * Safe to call from thread context and from interrupts of any priority.
+ *
+ * \return Monotonic time in microseconds
+ */
+uint32_t
+counter_get_us(void) {
+    counter_time_t time;
+
+    counter_read(&time);
+    return time.us;
+}
+
+/**
+ * \brief Raise the TIM2 interrupt when \ref counter_get_ms reaches a time, to wake from WFI
+ *
+ * A time past the current TIM2 period needs nothing, the update interrupt of the overflow comes
+ * first and the caller sleeps again from there.
+ *
+ * \param[in] ms Time to wake at
+ */
+void
+counter_wake_at(uint32_t ms) {
+    counter_time_t time;
+    int32_t left;
+    uint32_t at;
+
+    counter_read(&time);
+    left = (int32_t)(ms - time.ms);
+    TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
+    if (left <= 0 || left > COUNTER_PERIOD_US / 1000) {
+        return;
+    }
+    at = time.cnt + (uint32_t)left * 1000 - time.sub;
+    if (at >= COUNTER_PERIOD_US) {
+        return;
+    }
+    TIM_SetCompare1(TIM2, (uint16_t)at);
+    TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+    TIM_ITConfig(TIM2, TIM_IT_CC1, ENABLE);
+}
+
+/**
+ * \brief Account for a time TIM2 stood still, its clock stops in STOP mode
+ * \param[in] ms Time stopped, measured by a clock that kept running
+ */
+void
+counter_advance_ms(uint32_t ms) {
+    counter_stopped_ms += ms;
+}
+
+/**
+ * \brief TIM2 interrupt handler, counts the overflows for \ref counter_get_ms and ends a \ref counter_wake_at
+ */
+void
+TIM2_IRQHandler(void) {
+    IRQ_MONITOR_ENTER(NVIC_IRQ_TIM2);
+    PROFILE_ISR_ENTER(PROFILE_ISR_TIM2);
+    if (TIM_GetITStatus(TIM2, TIM_IT_Update) == SET) {
+        /* The counter has run on from 0 since the overflow */
+        IRQ_MONITOR_LATENCY(NVIC_IRQ_TIM2, TIM_GetCounter(TIM2) * COUNTER_CYCLES_PER_US);
+        counter_overflows++;
+        TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+    }
+    /* counter_wake_at is one-shot, waking up was the point */
+    if (TIM_GetITStatus(TIM2, TIM_IT_CC1) == SET) {
+        IRQ_MONITOR_LATENCY(NVIC_IRQ_TIM2,
+                            (uint16_t)(TIM_GetCounter(TIM2) - TIM_GetCapture1(TIM2)) * COUNTER_CYCLES_PER_US);
+        TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
+        TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+    }
+    PROFILE_ISR_EXIT(PROFILE_ISR_TIM2);
+    IRQ_MONITOR_EXIT(NVIC_IRQ_TIM2);
+}
@@ -1,18 +1,19 @@
 #include "stm32f10x.h"
+#include "counter.h"
 
 /**
-  * @brief  微秒级延时
-  * @param  xus 延时时长，范围：0~233015
+  * @brief  微秒级延时, 在周期计数器上忙等, 不占用SysTick, 可在中断中使用
+  * @note   周期计数器由counter_init开启
+  * @param  xus 延时时长，范围：0~59652323
   * @retval 无
   */
 void
 delay_us(uint32_t xus) {
-    SysTick->LOAD = 72 * xus;   //设置定时器重装值
-    SysTick->VAL = 0x00;        //清空当前计数值
-    SysTick->CTRL = 0x00000005; //设置时钟源为HCLK，启动定时器
-    while (!(SysTick->CTRL & 0x00010000))
-        ;                       //等待计数到0
-    SysTick->CTRL = 0x00000004; //关闭定时器
+    uint32_t start = COUNTER_CYCLES();            //记录起点
+    uint32_t cycles = xus * COUNTER_CYCLES_PER_US; //需要等待的周期数
+
+    while (COUNTER_CYCLES() - start < cycles)
+        ;                                          //差值计算, 计数器回绕也正确
 }
 
 /**
@@ -0,0 +1,208 @@
+/**
+* \file            idle.c
+* \date            10/19/2026
+* \brief           Idle manager, sleeps in WFI or STOP while no task is released
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "idle.h"
+#include "backup.h"
+#include "counter.h"
+#include "irq_monitor.h"
+#include "nvic.h"
+#include "scheduler.h"
+
+#define LOG_TAG "IDLE"
+#include "elog.h"
+
+/*
+ * WFI keeps every clock running, TIM2 wakes it at the next release (counter_wake_at) and any
+ * other interrupt on the way. STOP halts the clocks but the LSI: the RTC, counting milliseconds
+ * off the LSI, wakes it by its alarm through EXTI line 17, the keys by their EXTI lines. TIM2
+ * stands still meanwhile, the RTC tells counter_advance_ms how long. The LSI is only good to a
+ * few percent, so is the time of a STOP, the time of day comes from the DS1302 anyway.
+ *
+ * The UART cannot wake a STOP and TIM3 stops with it, so the voice and the keys hold the MCU
+ * out of it while they expect a byte or sample the keys, the log while its DMA is sending.
+ */
+
+#define IDLE_RTC_PRESCALER 39 /* The LSI at 40 kHz down to 1 kHz */
+
+static volatile uint8_t idle_holds[IDLE_CLIENT_NUM]; /* Each written by its client only */
+static uint32_t idle_start_ms;
+static uint64_t idle_sleep_us; /* WFI are short, counted in the microseconds of counter_get_us */
+static uint32_t idle_stop_ms;
+static uint32_t idle_sleeps, idle_stops;
+
+/**
+ * \brief           Get the clocks of SystemInit back, the MCU wakes from STOP on the HSI
+ */
+static void
+idle_restore_clock(void) {
+    RCC_HSEConfig(RCC_HSE_ON);
+    if (RCC_WaitForHSEStartUp() != SUCCESS) {
+        return;
+    }
+    /* The PLL keeps its source and factor, only its enable is cleared */
+    RCC_PLLCmd(ENABLE);
+    while (RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET) {}
+    RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+    while (RCC_GetSYSCLKSource() != 0x08) {}
+}
+
+/**
+ * \brief           STOP until the RTC alarm in `ms` or an EXTI, with the interrupts masked
+ */
+static void
+idle_stop(uint32_t ms) {
+    uint32_t from = RTC_GetCounter();
+    uint32_t slept;
+
+    RTC_SetAlarm(from + ms);
+    RTC_WaitForLastTask();
+    PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
+    idle_restore_clock();
+
+    /* The RTC registers read stale until resynchronized with the APB1 clock */
+    RTC_WaitForSynchro();
+    slept = RTC_GetCounter() - from;
+    counter_advance_ms(slept);
+    idle_stop_ms += slept;
+    idle_stops++;
+    scheduler_resume();
+}
+
+void
+idle_init(void) {
+    EXTI_InitTypeDef EXTI_InitStructure;
+
+    RCC_LSICmd(ENABLE);
+    while (RCC_GetFlagStatus(RCC_FLAG_LSIRDY) == RESET) {}
+
+    /* The RTC is in the backup domain, its clock source is kept until the domain is reset */
+    backup_init();
+    RCC_RTCCLKConfig(RCC_RTCCLKSource_LSI);
+    RCC_RTCCLKCmd(ENABLE);
+    RTC_WaitForSynchro();
+    RTC_WaitForLastTask();
+    RTC_SetPrescaler(IDLE_RTC_PRESCALER);
+    RTC_WaitForLastTask();
+    RTC_ITConfig(RTC_IT_ALR, ENABLE);
+    RTC_WaitForLastTask();
+
+    /* The RTC alarm wakes a STOP through the EXTI only */
+    EXTI_InitStructure.EXTI_Line = EXTI_Line17;
+    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&EXTI_InitStructure);
+    nvic_enable(NVIC_IRQ_RTC_ALARM);
+
+#if defined(DEBUG)
+    /* Keep the debugger attached through WFI and STOP */
+    DBGMCU_Config(DBGMCU_SLEEP | DBGMCU_STOP, ENABLE);
+#endif /* defined(DEBUG) */
+
+    idle_start_ms = counter_get_ms();
+}
+
+void
+idle_hold(idle_client_t client, uint8_t hold) {
+    idle_holds[client] = hold;
+}
+
+void
+idle_wait(void) {
+    uint32_t start = counter_get_us();
+    uint32_t sleep_ms, stop_ms;
+    uint8_t held = 0;
+
+    /* An interrupt between the decision and the WFI still ends it, it runs once unmasked */
+    __disable_irq();
+    for (uint8_t i = 0; i < IDLE_CLIENT_NUM; i++) {
+        held |= idle_holds[i];
+    }
+    sleep_ms = scheduler_idle_ms();
+    stop_ms = scheduler_stop_ms();
+    if (sleep_ms == 0) {
+        /* Released meanwhile */
+    } else if (!held && stop_ms >= IDLE_STOP_MIN_MS) {
+        idle_stop(stop_ms);
+    } else {
+        counter_wake_at(counter_get_ms() + sleep_ms);
+        __WFI();
+        idle_sleep_us += counter_get_us() - start;
+        idle_sleeps++;
+    }
+    __enable_irq();
+}
+
+void
+idle_get_stats(idle_stats_t* stats) {
+    stats->sleep_ms = (uint32_t)(idle_sleep_us / 1000);
+    stats->stop_ms = idle_stop_ms;
+    stats->run_ms = counter_get_ms() - idle_start_ms - stats->sleep_ms - stats->stop_ms;
+    stats->sleeps = idle_sleeps;
+    stats->stops = idle_stops;
+}
+
+void
+idle_report(void) {
+#if defined(DEBUG)
+    idle_stats_t stats;
+    uint32_t total, run, sleep, stop;
+
+    idle_get_stats(&stats);
+    total = stats.run_ms + stats.sleep_ms + stats.stop_ms;
+    if (total == 0) {
+        return;
+    }
+    run = (uint32_t)((uint64_t)stats.run_ms * 1000 / total);
+    sleep = (uint32_t)((uint64_t)stats.sleep_ms * 1000 / total);
+    stop = (uint32_t)((uint64_t)stats.stop_ms * 1000 / total);
+    log_d("run %lu.%lu%% sleep %lu.%lu%% in %lu stop %lu.%lu%% in %lu", (unsigned long)run / 10,
+          (unsigned long)run % 10, (unsigned long)sleep / 10, (unsigned long)sleep % 10, (unsigned long)stats.sleeps,
+          (unsigned long)stop / 10, (unsigned long)stop % 10, (unsigned long)stats.stops);
+#endif /* defined(DEBUG) */
+}
+
+/**
+ * \brief           RTC alarm interrupt handler, the end of a STOP
+ */
+void
+RTCAlarm_IRQHandler(void) {
+    IRQ_MONITOR_ENTER(NVIC_IRQ_RTC_ALARM);
+    if (RTC_GetITStatus(RTC_IT_ALR) == SET) {
+        RTC_ClearITPendingBit(RTC_IT_ALR);
+        RTC_WaitForLastTask();
+    }
+    EXTI_ClearITPendingBit(EXTI_Line17);
+    IRQ_MONITOR_EXIT(NVIC_IRQ_RTC_ALARM);
+}
@@ -0,0 +1,155 @@
+/**
+* \file            irq_monitor.c
+* \date            10/19/2026
+* \brief           Interrupt monitor: masked sections, entry latency and execution time of the interrupts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "irq_monitor.h"
+#include <string.h>
+
+#define LOG_TAG "IRQ_MONITOR"
+#include "elog.h"
+
+#if IRQ_MONITOR_CFG_ENABLE
+
+static irq_monitor_stats_t irq_monitor_stats[NVIC_IRQ_NUM];
+static irq_monitor_mask_t irq_monitor_mask;
+
+/* Section in progress, written with the interrupts masked only */
+static uint8_t irq_monitor_masking;
+static uint32_t irq_monitor_mask_start;
+static const char* irq_monitor_mask_func;
+static uint16_t irq_monitor_mask_line;
+
+void
+irq_monitor_mask_begin(const char* func, uint16_t line) {
+    /* Masking again inside a section does not start another, the first unmask ends both */
+    if (irq_monitor_masking) {
+        return;
+    }
+    irq_monitor_masking = 1;
+    irq_monitor_mask_func = func;
+    irq_monitor_mask_line = line;
+    irq_monitor_mask_start = COUNTER_CYCLES();
+}
+
+void
+irq_monitor_mask_end(void) {
+    uint32_t cycles = COUNTER_CYCLES() - irq_monitor_mask_start;
+
+    if (!irq_monitor_masking) {
+        return;
+    }
+    irq_monitor_masking = 0;
+    irq_monitor_mask.count++;
+    if (cycles > irq_monitor_mask.cycles_max) {
+        irq_monitor_mask.cycles_max = cycles;
+        irq_monitor_mask.func = irq_monitor_mask_func;
+        irq_monitor_mask.line = irq_monitor_mask_line;
+    }
+}
+
+void
+irq_monitor_latency(nvic_irq_t irq, uint32_t cycles) {
+    irq_monitor_stats_t* stats = &irq_monitor_stats[irq];
+
+    stats->latency_count++;
+    if (cycles > stats->latency_max) {
+        stats->latency_max = cycles;
+    }
+}
+
+void
+irq_monitor_exit(nvic_irq_t irq, uint32_t cycles) {
+    irq_monitor_stats_t* stats = &irq_monitor_stats[irq];
+
+    stats->count++;
+    stats->cycles_sum += cycles;
+    if (cycles > stats->cycles_max) {
+        stats->cycles_max = cycles;
+    }
+}
+
+void
+irq_monitor_get_stats(nvic_irq_t irq, irq_monitor_stats_t* stats) {
+    __disable_irq();
+    *stats = irq_monitor_stats[irq];
+    __enable_irq();
+}
+
+void
+irq_monitor_get_mask(irq_monitor_mask_t* mask) {
+    __disable_irq();
+    *mask = irq_monitor_mask;
+    __enable_irq();
+}
+
+#else
+
+void
+irq_monitor_get_stats(nvic_irq_t irq, irq_monitor_stats_t* stats) {
+    (void)irq;
+    memset(stats, 0, sizeof(*stats));
+}
+
+void
+irq_monitor_get_mask(irq_monitor_mask_t* mask) {
+    memset(mask, 0, sizeof(*mask));
+}
+
+#endif /* IRQ_MONITOR_CFG_ENABLE */
+
+void
+irq_monitor_report(void) {
+#if defined(DEBUG)
+    irq_monitor_mask_t mask;
+
+    irq_monitor_get_mask(&mask);
+    if (mask.func != NULL) {
+        log_d("masked %lu times, longest %lu us in %s line %u", (unsigned long)mask.count,
+              (unsigned long)(mask.cycles_max / COUNTER_CYCLES_PER_US), mask.func, mask.line);
+    }
+    for (uint8_t i = 0; i < NVIC_IRQ_NUM; i++) {
+        const nvic_priority_t* priority = nvic_get_priority((nvic_irq_t)i);
+        irq_monitor_stats_t stats;
+
+        irq_monitor_get_stats((nvic_irq_t)i, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+        log_d("%-9s prio %u.%u runs %lu exec max %lu mean %lu cycles latency max %lu us in %lu",
+              priority->name, priority->preempt, priority->sub, (unsigned long)stats.count,
+              (unsigned long)stats.cycles_max,
+              (unsigned long)(stats.cycles_sum / stats.count),
+              (unsigned long)(stats.latency_max / COUNTER_CYCLES_PER_US), (unsigned long)stats.latency_count);
+    }
+#endif /* defined(DEBUG) */
+}
@@ -0,0 +1,175 @@
+/**
+* \file            log_ring.c
+* \date            10/19/2026
+* \brief           Lock-free multi-producer record ring, for logs written from any context
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include <string.h>
+#include "log_ring.h"
+
+/*
+ * A record is a header word and its bytes, rounded up to words. The header holds the length,
+ * LOG_RING_COMMITTED once the bytes are in and LOG_RING_PAD on the filler that takes the end of
+ * the buffer when a record does not fit before it, so that a record is never split. The free space
+ * is kept zero, a header not written yet reads as not committed: the consumer clears a record
+ * before it gives the space back.
+ */
+
+#define LOG_RING_COMMITTED (1UL << 31)
+#define LOG_RING_PAD       (1UL << 30)
+#define LOG_RING_LEN_MASK  0xFFFFUL
+#define LOG_RING_SPAN(len) (sizeof(uint32_t) + (((len) + 3U) & ~3U))
+
+/**
+ * \brief           Header of the record at a position
+ */
+static volatile uint32_t*
+log_ring_header(const log_ring_t* ring, uint32_t pos) {
+    return (volatile uint32_t*)&ring->buf[pos & (ring->size - 1U)];
+}
+
+/**
+ * \brief           Counts a dropped record, from any context
+ */
+static void
+log_ring_drop(log_ring_t* ring) {
+    uint32_t dropped;
+
+    do {
+        dropped = __LDREXW((uint32_t*)&ring->dropped);
+    } while (__STREXW(dropped + 1U, (uint32_t*)&ring->dropped) != 0);
+}
+
+void
+log_ring_init(log_ring_t* ring, void* buf, uint32_t size) {
+    memset(buf, 0, size);
+    ring->buf = buf;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+}
+
+void*
+log_ring_reserve(log_ring_t* ring, uint32_t len) {
+    uint32_t span = LOG_RING_SPAN(len);
+    uint32_t head, pad;
+    volatile uint32_t* header;
+
+    if (len > LOG_RING_LEN_MAX || span > ring->size) {
+        log_ring_drop(ring);
+        return NULL;
+    }
+    /* An interrupt between the load and the store makes the store fail, the loop tries again */
+    do {
+        head = __LDREXW((uint32_t*)&ring->head);
+        pad = ring->size - (head & (ring->size - 1U));
+        if (pad >= span) {
+            pad = 0;
+        }
+        if (head + pad + span - ring->tail > ring->size) {
+            __CLREX();
+            log_ring_drop(ring);
+            return NULL;
+        }
+    } while (__STREXW(head + pad + span, (uint32_t*)&ring->head) != 0);
+
+    if (pad != 0) {
+        *log_ring_header(ring, head) = LOG_RING_COMMITTED | LOG_RING_PAD | pad;
+    }
+    header = log_ring_header(ring, head + pad);
+    *header = len;
+    return (void*)(header + 1);
+}
+
+void
+log_ring_commit(log_ring_t* ring, void* record) {
+    volatile uint32_t* header = (volatile uint32_t*)record - 1;
+
+    (void)ring;
+    __DMB(); /* The bytes land before the flag */
+    *header |= LOG_RING_COMMITTED;
+}
+
+uint8_t
+log_ring_write(log_ring_t* ring, const void* data, uint32_t len) {
+    void* record = log_ring_reserve(ring, len);
+
+    if (record == NULL) {
+        return 0;
+    }
+    memcpy(record, data, len);
+    log_ring_commit(ring, record);
+    return 1;
+}
+
+const void*
+log_ring_peek(log_ring_t* ring, uint32_t* len) {
+    volatile uint32_t* header;
+    uint32_t word;
+
+    for (;;) {
+        header = log_ring_header(ring, ring->tail);
+        word = *header;
+        if ((word & LOG_RING_COMMITTED) == 0) {
+            return NULL;
+        }
+        __DMB(); /* The bytes are read after the flag */
+        if ((word & LOG_RING_PAD) == 0) {
+            *len = word & LOG_RING_LEN_MASK;
+            return (const void*)(header + 1);
+        }
+        /* The filler before the wrap, the rest of it is zero already */
+        *header = 0;
+        __DMB();
+        ring->tail += word & LOG_RING_LEN_MASK;
+    }
+}
+
+void
+log_ring_release(log_ring_t* ring) {
+    volatile uint32_t* header = log_ring_header(ring, ring->tail);
+    uint32_t span = LOG_RING_SPAN(*header & LOG_RING_LEN_MASK);
+
+    memset((void*)header, 0, span);
+    __DMB(); /* Zero before a producer can reserve it again */
+    ring->tail += span;
+}
+
+uint8_t
+log_ring_is_empty(const log_ring_t* ring) {
+    return ring->head == ring->tail;
+}
+
+uint32_t
+log_ring_get_dropped(const log_ring_t* ring) {
+    return ring->dropped;
+}
@@ -1,7 +1,7 @@
 /**
 * \file            nvic.c
 * \date            12/4/2023
-* \brief
+* \brief           Interrupt priority map, the one source of the priority scheme
 */
 
 /*
@@ -34,30 +34,95 @@
 
 #include "nvic.h"
 
+#define LOG_TAG "NVIC"
+#include "elog.h"
+
+/* NVIC_GROUPING as NVIC_EncodePriority() and NVIC_GetPriorityGrouping() count it */
+#define NVIC_PRIGROUP (NVIC_GROUPING >> 8)
+
+/*
+ * The priority scheme. The keys come first and at one level, so that an edge and the tick never
+ * preempt each other and the 5 ms tick stays steady. The DFPlayer reception comes next, the DMA
+ * buffer covers the time a key interrupt takes. The time base and the end of a STOP come last
+ * among the preempting levels but before the UART when pending at once: counter_read() copes
+ * with a pending overflow, the TIM2 interrupt only has to come within 65 ms. The log drain comes
+ * after all of them, a line sent late only makes the UART pause.
+ */
+static const nvic_priority_t nvic_priorities[NVIC_IRQ_NUM] = {
+    [NVIC_IRQ_TIM3]          = {"TIM3",     TIM3_IRQn,          0, 0},
+    [NVIC_IRQ_EXTI0]         = {"EXTI0",    EXTI0_IRQn,         0, 0},
+    [NVIC_IRQ_EXTI1]         = {"EXTI1",    EXTI1_IRQn,         0, 0},
+    [NVIC_IRQ_EXTI2]         = {"EXTI2",    EXTI2_IRQn,         0, 0},
+    [NVIC_IRQ_EXTI3]         = {"EXTI3",    EXTI3_IRQn,         0, 0},
+    [NVIC_IRQ_EXTI4]         = {"EXTI4",    EXTI4_IRQn,         0, 0},
+    [NVIC_IRQ_EXTI9_5]       = {"EXTI9_5",  EXTI9_5_IRQn,       0, 0},
+    [NVIC_IRQ_USART1]        = {"USART1",   USART1_IRQn,        1, 1},
+    [NVIC_IRQ_DMA1_CHANNEL5] = {"DMA1_CH5", DMA1_Channel5_IRQn, 1, 1},
+    [NVIC_IRQ_TIM2]          = {"TIM2",     TIM2_IRQn,          1, 0},
+    [NVIC_IRQ_RTC_ALARM]     = {"RTCAlarm", RTCAlarm_IRQn,      1, 0},
+    [NVIC_IRQ_DMA1_CHANNEL2] = {"DMA1_CH2", DMA1_Channel2_IRQn, 3, 0},
+};
+
 void
 nvic_init(void) {
-    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2); // 抢占优先级为2位, 从优先级为2位
-
-    NVIC_InitTypeDef NVIC_InitStructure;
-
-    /* USART1_IRQn */
-    NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;         // 开启串口1的中断通道
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;           // 使能中断通道
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1; // 设置抢占优先级为2
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;        // 设置从优先级为1
-    NVIC_Init(&NVIC_InitStructure);                           // 初始化
-
-    /* DMA1_Channel5_IRQn-USART1_Rx */
-    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel5_IRQn;  // 开启DMA1通道5(USART1-RX)的中断通道
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;           // 使能中断通道
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1; // 设置抢占优先级为2
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;        // 设置从优先级为1
-    NVIC_Init(&NVIC_InitStructure);                           // 初始化
-
-    /* TIM3_IRQn */
-    NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
-    NVIC_Init(&NVIC_InitStructure);
-}
\ No newline at end of file
+    NVIC_PriorityGroupConfig(NVIC_GROUPING);
+}
+
+void
+nvic_enable(nvic_irq_t irq) {
+    const nvic_priority_t* priority = &nvic_priorities[irq];
+
+    NVIC_SetPriority(priority->irqn, NVIC_EncodePriority(NVIC_PRIGROUP, priority->preempt, priority->sub));
+    NVIC_EnableIRQ(priority->irqn);
+}
+
+const nvic_priority_t*
+nvic_get_priority(nvic_irq_t irq) {
+    return &nvic_priorities[irq];
+}
+
+uint8_t
+nvic_verify(void) {
+    uint32_t mapped[2] = {0, 0};
+    uint8_t differences = 0;
+
+    if (NVIC_GetPriorityGrouping() != NVIC_PRIGROUP) {
+        log_e("Priority grouping %lu, the map is for %lu", (unsigned long)NVIC_GetPriorityGrouping(),
+              (unsigned long)NVIC_PRIGROUP);
+        differences++;
+    }
+    for (uint8_t i = 0; i < NVIC_IRQ_NUM; i++) {
+        const nvic_priority_t* priority = &nvic_priorities[i];
+        uint32_t expected = NVIC_EncodePriority(NVIC_PRIGROUP, priority->preempt, priority->sub);
+        uint32_t bit = 1UL << ((uint32_t)priority->irqn & 0x1F);
+
+        mapped[(uint32_t)priority->irqn >> 5] |= bit;
+        if (priority->preempt > 3 || priority->sub > 3) {
+            log_e("%s priority %u.%u out of the grouping", priority->name, priority->preempt, priority->sub);
+            differences++;
+        }
+        if (NVIC_GetPriority(priority->irqn) != expected) {
+            log_e("%s priority %lu, the map says %lu", priority->name, (unsigned long)NVIC_GetPriority(priority->irqn),
+                  (unsigned long)expected);
+            differences++;
+        }
+        if ((NVIC->ISER[(uint32_t)priority->irqn >> 5] & bit) == 0) {
+            log_e("%s not enabled", priority->name);
+            differences++;
+        }
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        uint32_t unmapped = NVIC->ISER[i] & ~mapped[i];
+
+        for (uint8_t bit = 0; bit < 32; bit++) {
+            if (unmapped >> bit & 1) {
+                log_e("IRQ %u enabled outside the priority map", i * 32 + bit);
+                differences++;
+            }
+        }
+    }
+    if (differences == 0) {
+        log_i("NVIC as the priority map says, %u interrupts", NVIC_IRQ_NUM);
+    }
+    return differences;
+}
@@ -0,0 +1,165 @@
+/**
+* \file            profile.c
+* \date            10/19/2026
+* \brief           Cycle profiler, log2 histograms of the time spent in scoped points and interrupts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "profile.h"
+
+#define LOG_TAG "PROFILE"
+#include "elog.h"
+
+#if PROFILE_CFG_ENABLE
+
+_Static_assert(PROFILE_CFG_BINS >= 2 && PROFILE_CFG_BINS <= 32, "PROFILE_CFG_BINS out of 2 ~ 32");
+_Static_assert(PROFILE_NUM < PROFILE_END_MARK, "Too many profile points");
+
+static profile_stats_t profile_stats[PROFILE_NUM];
+volatile uint32_t profile_isr_cycles;
+
+/* Time of the previous snapshot */
+static uint32_t profile_dump_ms;
+
+/* Snapshot bytes waiting for a full log line */
+static uint8_t profile_line[PROFILE_CFG_LINE];
+static uint8_t profile_line_len;
+
+void
+profile_add(profile_point_t id, uint32_t cycles) {
+    profile_stats_t* stats = &profile_stats[id];
+    uint8_t bin = cycles == 0 ? 0 : (uint8_t)(32 - __builtin_clz(cycles));
+
+    stats->count++;
+    stats->sum += cycles;
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->bins[bin < PROFILE_CFG_BINS ? bin : PROFILE_CFG_BINS - 1]++;
+}
+
+void
+profile_add_isr(profile_point_t id, uint32_t cycles) {
+    profile_add(id, cycles);
+    /* A higher priority interrupt between the load and the store loses its cycles, they show in this one */
+    profile_isr_cycles += cycles;
+}
+
+void
+profile_get_stats(profile_point_t id, profile_stats_t* stats) {
+    __disable_irq();
+    *stats = profile_stats[id];
+    __enable_irq();
+}
+
+/**
+ * \brief Print the bytes of the line as a `prof <hex>` line
+ */
+static void
+profile_flush(void) {
+    static const char hex[] = "0123456789abcdef";
+    char line[PROFILE_CFG_LINE * 2 + 1];
+
+    if (profile_line_len == 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < profile_line_len; i++) {
+        line[2 * i] = hex[profile_line[i] >> 4];
+        line[2 * i + 1] = hex[profile_line[i] & 0x0F];
+    }
+    line[2 * profile_line_len] = '\0';
+    elog_raw("prof %s\r\n", line);
+    profile_line_len = 0;
+}
+
+static void
+profile_put(uint8_t byte) {
+    profile_line[profile_line_len++] = byte;
+    if (profile_line_len == PROFILE_CFG_LINE) {
+        profile_flush();
+    }
+}
+
+static void
+profile_put_varint(uint64_t value) {
+    while (value >= 0x80) {
+        profile_put((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    profile_put((uint8_t)value);
+}
+
+void
+profile_dump(void) {
+    uint32_t now = counter_get_ms();
+
+    profile_put(PROFILE_MAGIC_0);
+    profile_put(PROFILE_MAGIC_1);
+    profile_put(PROFILE_VERSION);
+    profile_put(PROFILE_NUM);
+    profile_put(PROFILE_CFG_BINS);
+    profile_put(COUNTER_CYCLES_PER_US);
+    profile_put_varint(now - profile_dump_ms);
+    profile_dump_ms = now;
+
+    for (uint8_t id = 0; id < PROFILE_NUM; id++) {
+        profile_stats_t stats;
+        uint32_t mask = 0;
+
+        /* Copy and clear at once, the interrupts keep adding to their points */
+        __disable_irq();
+        stats = profile_stats[id];
+        profile_stats[id] = (profile_stats_t){0};
+        __enable_irq();
+        if (stats.count == 0) {
+            continue;
+        }
+
+        for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+            if (stats.bins[bin] != 0) {
+                mask |= 1UL << bin;
+            }
+        }
+        profile_put(id);
+        profile_put_varint(stats.count);
+        profile_put_varint(stats.max);
+        profile_put_varint(stats.sum);
+        profile_put_varint(mask);
+        for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+            if (stats.bins[bin] != 0) {
+                profile_put_varint(stats.bins[bin]);
+            }
+        }
+    }
+    profile_put(PROFILE_END_MARK);
+    profile_flush();
+}
+
+#endif /* PROFILE_CFG_ENABLE */
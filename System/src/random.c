@@ -0,0 +1,130 @@
+/**
+* \file            random.c
+* \date            10/19/2026
+* \brief           PCG32 pseudo-random number generator
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "random.h"
+#include "delay.h"
+
+/* PCG32 (XSH RR variant), see https://www.pcg-random.org */
+#define RANDOM_MULTIPLIER   6364136223846793005ULL
+#define RANDOM_INCREMENT    1442695040888963407ULL
+
+/* 96-bit unique ID of the STM32F1 */
+#define RANDOM_UID_ADDR     0x1FFFF7E8
+
+/* Number of ADC conversions mixed into the seed */
+#define RANDOM_ADC_SAMPLES  64
+
+static uint64_t random_state = 0x853C49E6748FEA9BULL;
+static uint64_t random_increment = RANDOM_INCREMENT;
+
+/**
+ * \brief           Collect the noise of the internal temperature sensor
+ *
+ * The shortest sample time leaves the lowest bits of every conversion to thermal and
+ * quantization noise. The ADC is switched off again afterwards.
+ *
+ * \return          Samples folded into 32 bits
+ */
+static uint32_t
+random_adc_noise(void) {
+    ADC_InitTypeDef ADC_InitStructure;
+    uint32_t noise = 0;
+
+    RCC_ADCCLKConfig(RCC_PCLK2_Div6);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE);
+
+    ADC_StructInit(&ADC_InitStructure);
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_NbrOfChannel = 1;
+    ADC_Init(ADC1, &ADC_InitStructure);
+    ADC_TempSensorVrefintCmd(ENABLE);
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_TempSensor, 1, ADC_SampleTime_1Cycles5);
+
+    ADC_Cmd(ADC1, ENABLE);
+    delay_us(10); /* Power-up of the ADC and the temperature sensor */
+    ADC_ResetCalibration(ADC1);
+    while (ADC_GetResetCalibrationStatus(ADC1) == SET) {}
+    ADC_StartCalibration(ADC1);
+    while (ADC_GetCalibrationStatus(ADC1) == SET) {}
+
+    for (uint8_t i = 0; i < RANDOM_ADC_SAMPLES; i++) {
+        ADC_SoftwareStartConvCmd(ADC1, ENABLE);
+        while (ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC) == RESET) {}
+        noise = (noise << 5 | noise >> 27) ^ ADC_GetConversionValue(ADC1);
+    }
+
+    ADC_Cmd(ADC1, DISABLE);
+    ADC_TempSensorVrefintCmd(DISABLE);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, DISABLE);
+    return noise;
+}
+
+void
+random_init(uint32_t seed) {
+    const volatile uint32_t* uid = (const volatile uint32_t*)RANDOM_UID_ADDR;
+
+    /* The unique ID picks the stream, so two clocks never share a sequence */
+    random_increment = ((uint64_t)(uid[0] ^ uid[2]) << 32 | uid[1]) << 1 | 1;
+    random_state = 0;
+    random_u32();
+    random_state += (uint64_t)random_adc_noise() << 32 | seed;
+    random_u32();
+}
+
+uint32_t
+random_u32(void) {
+    uint64_t state = random_state;
+    random_state = state * RANDOM_MULTIPLIER + random_increment;
+
+    uint32_t xorshifted = (uint32_t)(((state >> 18) ^ state) >> 27);
+    uint32_t rot = (uint32_t)(state >> 59);
+    return xorshifted >> rot | xorshifted << ((-rot) & 31);
+}
+
+uint32_t
+random_range(uint32_t bound) {
+    if (bound == 0) {
+        return 0;
+    }
+
+    /* Reject the low values that would make the modulo uneven */
+    uint32_t threshold = (0 - bound) % bound;
+    for (;;) {
+        uint32_t r = random_u32();
+        if (r >= threshold) {
+            return r % bound;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/**
+* \file            scheduler.c
+* \date            10/19/2026
+* \brief           Time-triggered cooperative scheduler over a const task table
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "scheduler.h"
+#include "counter.h"
+
+#define LOG_TAG "SCHEDULER"
+#include "elog.h"
+
+/*
+ * Every pass of the main loop runs at most one task, the released one of lowest priority value,
+ * and comes back, so a task of higher priority waits for one run at most. A release is kept on
+ * the grid of its phase: a task that starts late keeps its next release where it was, and only
+ * when a whole period went by are the releases in between skipped and counted.
+ */
+
+#define SCHEDULER_NONE 0xFF
+
+static const scheduler_task_t* scheduler_tasks;
+static scheduler_stats_t* scheduler_stats;
+static uint8_t scheduler_num;
+static uint32_t scheduler_start_ms;
+
+void
+scheduler_init(const scheduler_task_t* tasks, scheduler_stats_t* stats, uint8_t num) {
+#ifdef SCHEDULER_CYCLES_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    *(volatile uint32_t*)0xE0001000 |= 1; /* DWT_CTRL.CYCCNTENA */
+#endif /* SCHEDULER_CYCLES_DWT */
+
+    scheduler_tasks = tasks;
+    scheduler_stats = stats;
+    scheduler_num = num;
+    scheduler_start_ms = counter_get_ms();
+    for (uint8_t i = 0; i < num; i++) {
+        stats[i] = (scheduler_stats_t){0};
+        stats[i].release_ms = scheduler_start_ms + tasks[i].phase_ms;
+    }
+}
+
+uint8_t
+scheduler_run(void) {
+    uint32_t now = counter_get_ms();
+    uint8_t pick = SCHEDULER_NONE;
+    const scheduler_task_t* task;
+    scheduler_stats_t* stats;
+    uint32_t lateness, start, cycles;
+
+    for (uint8_t i = 0; i < scheduler_num; i++) {
+        if ((int32_t)(now - scheduler_stats[i].release_ms) >= 0
+            && (pick == SCHEDULER_NONE || scheduler_tasks[i].priority < scheduler_tasks[pick].priority)) {
+            pick = i;
+        }
+    }
+    if (pick == SCHEDULER_NONE) {
+        return 0;
+    }
+    task = &scheduler_tasks[pick];
+    stats = &scheduler_stats[pick];
+
+    lateness = now - stats->release_ms;
+    if (lateness > stats->lateness_max) {
+        stats->lateness_max = lateness;
+    }
+    stats->late += lateness / task->period_ms;
+    stats->release_ms += (lateness / task->period_ms + 1) * task->period_ms;
+
+    start = SCHEDULER_CYCLES();
+    task->run();
+    cycles = SCHEDULER_CYCLES() - start;
+
+    stats->runs++;
+    stats->cycles_sum += cycles;
+    if (cycles > stats->cycles_max) {
+        stats->cycles_max = cycles;
+    }
+    if (cycles > (uint32_t)task->budget_us * SCHEDULER_CYCLES_PER_US) {
+        stats->overruns++;
+    }
+    return 1;
+}
+
+void
+scheduler_release(uint8_t task) {
+    scheduler_release_in(task, 0);
+}
+
+void
+scheduler_release_in(uint8_t task, uint32_t ms) {
+    uint32_t at = counter_get_ms() + ms;
+
+    if (task < scheduler_num && ms <= INT32_MAX && (int32_t)(scheduler_stats[task].release_ms - at) > 0) {
+        scheduler_stats[task].release_ms = at;
+    }
+}
+
+/**
+ * \brief           Get the time to the next release of the tasks without the flags in `skip`
+ */
+static uint32_t
+scheduler_next_ms(uint8_t skip) {
+    uint32_t now = counter_get_ms();
+    uint32_t next = UINT32_MAX;
+
+    for (uint8_t i = 0; i < scheduler_num; i++) {
+        int32_t left = (int32_t)(scheduler_stats[i].release_ms - now);
+
+        if (scheduler_tasks[i].flags & skip) {
+            continue;
+        }
+        if (left <= 0) {
+            return 0;
+        }
+        if ((uint32_t)left < next) {
+            next = (uint32_t)left;
+        }
+    }
+    return next;
+}
+
+uint32_t
+scheduler_idle_ms(void) {
+    return scheduler_next_ms(0);
+}
+
+uint32_t
+scheduler_stop_ms(void) {
+    return scheduler_next_ms(SCHEDULER_POLL);
+}
+
+void
+scheduler_resume(void) {
+    uint32_t now = counter_get_ms();
+
+    for (uint8_t i = 0; i < scheduler_num; i++) {
+        if ((scheduler_tasks[i].flags & SCHEDULER_POLL) && (int32_t)(now - scheduler_stats[i].release_ms) > 0) {
+            scheduler_stats[i].release_ms = now;
+        }
+    }
+}
+
+const scheduler_task_t*
+scheduler_get_task(uint8_t task) {
+    return task < scheduler_num ? &scheduler_tasks[task] : NULL;
+}
+
+const scheduler_stats_t*
+scheduler_get_stats(uint8_t task) {
+    return task < scheduler_num ? &scheduler_stats[task] : NULL;
+}
+
+uint32_t
+scheduler_get_elapsed_ms(void) {
+    return counter_get_ms() - scheduler_start_ms;
+}
+
+void
+scheduler_report(void) {
+#if defined(DEBUG)
+    uint64_t elapsed = (uint64_t)scheduler_get_elapsed_ms() * 1000 * SCHEDULER_CYCLES_PER_US;
+
+    if (elapsed == 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < scheduler_num; i++) {
+        const scheduler_stats_t* stats = &scheduler_stats[i];
+        uint32_t permille = (uint32_t)(stats->cycles_sum * 1000 / elapsed);
+
+        log_d("%-12s cpu %lu.%lu%% runs %lu wcet %lu us overruns %lu late %lu (max %lu ms)",
+              scheduler_tasks[i].name, (unsigned long)permille / 10, (unsigned long)permille % 10,
+              (unsigned long)stats->runs, (unsigned long)(stats->cycles_max / SCHEDULER_CYCLES_PER_US),
+              (unsigned long)stats->overruns, (unsigned long)stats->late, (unsigned long)stats->lateness_max);
+    }
+#endif /* defined(DEBUG) */
+}
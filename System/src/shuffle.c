@@ -0,0 +1,212 @@
+/**
+* \file            shuffle.c
+* \date            10/19/2026
+* \brief           Table-free shuffle permutation
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "shuffle.h"
+#include "random.h"
+
+#if defined(DEBUG)
+#define LOG_TAG "SHUFFLE"
+#include "elog.h"
+#endif /* DEBUG */
+
+/*
+ * The permutation is a balanced Feistel network over the smallest 2^(2k) domain holding `size`
+ * items. A Feistel network is a bijection whatever its round function, so walking the cycle
+ * (applying it again while the result is out of range) gives a permutation of [0, size) without
+ * any table. The domain is less than 4 times `size`, so a few rounds of walking are enough.
+ */
+#define SHUFFLE_ROUNDS 4
+
+/* Seeds drawn at most to avoid repeating the last item across two bag rounds, 2^-32 odds to fail for 2 items */
+#define SHUFFLE_BAG_TRIES 32
+
+/**
+ * \brief           Get the half width of the Feistel domain
+ * \param[in]       size: Number of items, at least 2
+ * \return          Number of bits of each half
+ */
+static uint8_t
+shuffle_half_bits(uint16_t size) {
+    uint8_t bits = 0;
+
+    for (uint16_t max = size - 1; max != 0; max >>= 1) {
+        bits++;
+    }
+    return (bits + 1) / 2;
+}
+
+/**
+ * \brief           Feistel round function
+ * \param[in]       half: Right half of the block
+ * \param[in]       seed: Permutation seed
+ * \param[in]       round: Round number
+ * \return          Unmasked round output
+ */
+static uint32_t
+shuffle_round(uint32_t half, uint32_t seed, uint8_t round) {
+    uint32_t x = (half + 1) * 0x9E3779B1UL ^ (seed + round * 0x85EBCA77UL);
+
+    x ^= x >> 15;
+    x *= 0x2C1B3C6DUL;
+    x ^= x >> 12;
+    return x;
+}
+
+/**
+ * \brief           Apply the Feistel network once
+ */
+static uint16_t
+shuffle_encrypt(uint16_t x, uint8_t half_bits, uint32_t seed) {
+    uint32_t mask = (1UL << half_bits) - 1;
+    uint32_t left = x >> half_bits;
+    uint32_t right = x & mask;
+
+    for (uint8_t round = 0; round < SHUFFLE_ROUNDS; round++) {
+        uint32_t next = left ^ (shuffle_round(right, seed, round) & mask);
+        left = right;
+        right = next;
+    }
+    return (uint16_t)(left << half_bits | right);
+}
+
+/**
+ * \brief           Undo shuffle_encrypt
+ */
+static uint16_t
+shuffle_decrypt(uint16_t x, uint8_t half_bits, uint32_t seed) {
+    uint32_t mask = (1UL << half_bits) - 1;
+    uint32_t left = x >> half_bits;
+    uint32_t right = x & mask;
+
+    for (uint8_t round = SHUFFLE_ROUNDS; round-- > 0;) {
+        uint32_t prev = right ^ (shuffle_round(left, seed, round) & mask);
+        right = left;
+        left = prev;
+    }
+    return (uint16_t)(left << half_bits | right);
+}
+
+uint16_t
+shuffle_index(uint16_t position, uint16_t size, uint32_t seed) {
+    if (size < 2) {
+        return 0;
+    }
+
+    uint8_t half_bits = shuffle_half_bits(size);
+    uint16_t x = position % size;
+    do {
+        x = shuffle_encrypt(x, half_bits, seed);
+    } while (x >= size);
+    return x;
+}
+
+uint16_t
+shuffle_position(uint16_t index, uint16_t size, uint32_t seed) {
+    if (size < 2) {
+        return 0;
+    }
+
+    uint8_t half_bits = shuffle_half_bits(size);
+    uint16_t x = index % size;
+    do {
+        x = shuffle_decrypt(x, half_bits, seed);
+    } while (x >= size);
+    return x;
+}
+
+uint8_t
+shuffle_bag_draw(shuffle_bag_t* bag, uint8_t size) {
+    if (bag->position >= bag->size || bag->size != size) {
+        uint8_t tries = 0;
+        int16_t last = -1;
+
+        if (bag->size == size && bag->position > 0) {
+            last = shuffle_index(bag->position - 1, size, bag->seed);
+        }
+        do {
+            bag->seed = (uint16_t)random_u32();
+        } while (size > 1 && shuffle_index(0, size, bag->seed) == last && ++tries < SHUFFLE_BAG_TRIES);
+        bag->position = 0;
+        bag->size = size;
+    }
+    return (uint8_t)shuffle_index(bag->position++, size, bag->seed);
+}
+
+#if defined(DEBUG)
+/**
+ * \brief Check that every item comes up exactly once per cycle
+ *
+ * Runs the permutation over a few library sizes and seeds, including the
+ * degenerate and power-of-four ones, and checks shuffle_position undoes it,
+ * then draws a few rounds from a shuffle bag.
+ *
+ * \return 0 if the test passed
+ */
+int
+shuffle_test(void) {
+    static const uint16_t sizes[] = {1, 2, 3, 4, 5, 16, 17, 84, 255, 256, 1000, 3091};
+    static const uint32_t seeds[] = {0, 1, 0xDEADBEEFUL, 0xFFFFFFFFUL};
+    static uint8_t seen[(3091 + 7) / 8];
+    shuffle_bag_t bag = {0};
+
+    log_d("shuffle_test");
+    for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (uint8_t k = 0; k < sizeof(seeds) / sizeof(seeds[0]); k++) {
+            for (uint16_t i = 0; i < sizeof(seen); i++) {
+                seen[i] = 0;
+            }
+            for (uint16_t position = 0; position < sizes[s]; position++) {
+                uint16_t index = shuffle_index(position, sizes[s], seeds[k]);
+                ELOG_ASSERT(index < sizes[s]);
+                ELOG_ASSERT(!(seen[index / 8] & (1 << (index % 8))));
+                seen[index / 8] |= 1 << (index % 8);
+                ELOG_ASSERT(shuffle_position(index, sizes[s], seeds[k]) == position);
+            }
+        }
+    }
+    /* Every round of a bag draws each line once, and never the last line again first */
+    for (uint8_t round = 0, last = 0xFF; round < 10; round++) {
+        uint8_t drawn[84] = {0};
+        for (uint8_t i = 0; i < 84; i++) {
+            uint8_t line = shuffle_bag_draw(&bag, 84);
+            ELOG_ASSERT(line < 84 && !drawn[line]);
+            ELOG_ASSERT(i != 0 || line != last);
+            drawn[line] = 1;
+            last = line;
+        }
+    }
+    log_d("TEST PASSED!");
+    return 0;
+}
+#endif /* DEBUG */
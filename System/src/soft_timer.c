@@ -0,0 +1,293 @@
+/**
+* \file            soft_timer.c
+* \date            10/19/2026
+* \brief           One-shot and periodic software timers on a hierarchical timing wheel
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include <stddef.h>
+#include "soft_timer.h"
+#include "counter.h"
+
+/*
+ * The wheel is advanced in thread context to counter_get_ms(), TIM2 being the only hardware
+ * timer behind it: no interrupt ticks every millisecond, so the MCU keeps sleeping between
+ * expiries, and the wake callback has the scheduler run soft_timer_process() when work is due.
+ *
+ * A timer sits in the slot of the finest wheel that reaches its expiry from the wheel's current
+ * tick. When the tick crosses a slot boundary of a coarser wheel, that slot is emptied into the
+ * finer ones ("cascade"). Start, stop and expiry are O(1), a timer is cascaded at most once per
+ * level, and a bitmap of the busy slots of each wheel finds the next work without a scan.
+ */
+
+#define SOFT_TIMER_SLOTS         (1 << SOFT_TIMER_BITS)
+#define SOFT_TIMER_MASK          (SOFT_TIMER_SLOTS - 1)
+/* Span of a slot of a level, in ms */
+#define SOFT_TIMER_SPAN(level)   (1UL << ((level) * SOFT_TIMER_BITS))
+/* Farthest expiry the top wheel holds */
+#define SOFT_TIMER_REACH         (SOFT_TIMER_SPAN(SOFT_TIMER_LEVELS) - 1)
+/* List of the timers expiring at the current tick, after the slots of the wheels */
+#define SOFT_TIMER_EXPIRING      (SOFT_TIMER_LEVELS * SOFT_TIMER_SLOTS)
+
+_Static_assert(SOFT_TIMER_SLOTS <= 32, "the busy slots of a wheel are a uint32_t");
+_Static_assert(SOFT_TIMER_LEVELS * SOFT_TIMER_BITS <= 31, "the wheels reach beyond a signed time difference");
+
+static soft_timer_t* soft_timer_slots[SOFT_TIMER_EXPIRING + 1];
+static uint32_t soft_timer_busy[SOFT_TIMER_LEVELS]; /* Bit n set when slot n of the wheel is not empty */
+static uint32_t soft_timer_tick;                    /* Next millisecond the wheel processes, or the last one again */
+static void (*soft_timer_wake)(uint32_t ms);
+
+/**
+ * \brief           Rotate right, brings bit `n` to bit 0
+ */
+static inline uint32_t
+soft_timer_ror(uint32_t bits, uint8_t n) {
+    return n ? bits >> n | bits << (32 - n) : bits;
+}
+
+static void
+soft_timer_link(soft_timer_t* timer, uint16_t slot) {
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = soft_timer_slots[slot];
+    if (timer->next != NULL) {
+        timer->next->prev = timer;
+    }
+    soft_timer_slots[slot] = timer;
+    if (slot < SOFT_TIMER_EXPIRING) {
+        soft_timer_busy[slot / SOFT_TIMER_SLOTS] |= 1UL << (slot % SOFT_TIMER_SLOTS);
+    }
+}
+
+static void
+soft_timer_unlink(soft_timer_t* timer) {
+    uint16_t slot = timer->slot;
+
+    if (timer->next != NULL) {
+        timer->next->prev = timer->prev;
+    }
+    if (timer->prev != NULL) {
+        timer->prev->next = timer->next;
+    } else {
+        soft_timer_slots[slot] = timer->next;
+        if (timer->next == NULL && slot < SOFT_TIMER_EXPIRING) {
+            soft_timer_busy[slot / SOFT_TIMER_SLOTS] &= ~(1UL << (slot % SOFT_TIMER_SLOTS));
+        }
+    }
+    timer->slot = SOFT_TIMER_STOPPED;
+}
+
+/**
+ * \brief           Put a timer in the slot of its expiry, on the finest wheel reaching it
+ */
+static void
+soft_timer_insert(soft_timer_t* timer) {
+    uint32_t at = timer->expire_ms;
+    uint32_t delta = at - soft_timer_tick;
+    uint8_t level = 0;
+
+    if ((int32_t)delta < 0) {
+        /* Due already, expires at the next tick processed */
+        at = soft_timer_tick;
+        delta = 0;
+    } else if (delta > SOFT_TIMER_REACH) {
+        /* Beyond the top wheel, put back when this slot comes round */
+        at = soft_timer_tick + SOFT_TIMER_REACH;
+        delta = SOFT_TIMER_REACH;
+    }
+    while (delta >= SOFT_TIMER_SPAN(level + 1)) {
+        level++;
+    }
+    soft_timer_link(timer, level * SOFT_TIMER_SLOTS + ((at >> (level * SOFT_TIMER_BITS)) & SOFT_TIMER_MASK));
+}
+
+/**
+ * \brief           Get the ticks from the current one to the next that has work, a cascade or an expiry
+ * \return          Ticks, \ref SOFT_TIMER_NEVER if the wheels are empty
+ */
+static uint32_t
+soft_timer_next(void) {
+    uint32_t next = SOFT_TIMER_NEVER;
+
+    for (uint8_t level = 0; level < SOFT_TIMER_LEVELS; level++) {
+        uint8_t shift = level * SOFT_TIMER_BITS;
+        uint32_t base, at;
+
+        if (soft_timer_busy[level] == 0) {
+            continue;
+        }
+        /* First slot boundary of this level at or after the current tick, then the first busy slot from there */
+        base = (soft_timer_tick + SOFT_TIMER_SPAN(level) - 1) >> shift;
+        at = (base + __builtin_ctz(soft_timer_ror(soft_timer_busy[level], base & SOFT_TIMER_MASK))) << shift;
+        if (at - soft_timer_tick < next) {
+            next = at - soft_timer_tick;
+        }
+    }
+    return next;
+}
+
+/**
+ * \brief           Move the current tick up to `now` if nothing happens in between
+ */
+static void
+soft_timer_sync(uint32_t now) {
+    uint32_t behind = now - soft_timer_tick;
+
+    if ((int32_t)behind > 0 && soft_timer_next() > behind) {
+        soft_timer_tick = now;
+    }
+}
+
+/**
+ * \brief           Process the current tick: cascade the slots whose boundary it is, then call back the expired timers
+ * \param[in]       now: Time of the call, where late periodic timers resume
+ * \return          Number of callbacks
+ */
+static uint16_t
+soft_timer_expire(uint32_t now) {
+    uint32_t tick = soft_timer_tick;
+    uint16_t slot = tick & SOFT_TIMER_MASK;
+    uint16_t calls = 0;
+    soft_timer_t* timer;
+
+    for (uint8_t level = SOFT_TIMER_LEVELS - 1; level > 0; level--) {
+        uint16_t from = level * SOFT_TIMER_SLOTS + ((tick >> (level * SOFT_TIMER_BITS)) & SOFT_TIMER_MASK);
+
+        if ((tick & (SOFT_TIMER_SPAN(level) - 1)) != 0) {
+            continue;
+        }
+        while ((timer = soft_timer_slots[from]) != NULL) {
+            soft_timer_unlink(timer);
+            soft_timer_insert(timer);
+        }
+    }
+
+    /* Moved aside so that a timer started again by a callback lands in a later tick */
+    while ((timer = soft_timer_slots[slot]) != NULL) {
+        soft_timer_unlink(timer);
+        soft_timer_link(timer, SOFT_TIMER_EXPIRING);
+    }
+    soft_timer_tick = tick + 1;
+
+    while ((timer = soft_timer_slots[SOFT_TIMER_EXPIRING]) != NULL) {
+        soft_timer_unlink(timer);
+        if ((int32_t)(timer->expire_ms - tick) > 0) {
+            soft_timer_insert(timer);
+            continue;
+        }
+        if (timer->period_ms != 0) {
+            timer->expire_ms += timer->period_ms;
+            if ((int32_t)(now - timer->expire_ms) >= 0) {
+                timer->expire_ms += ((now - timer->expire_ms) / timer->period_ms + 1) * timer->period_ms;
+            }
+            soft_timer_insert(timer);
+        }
+        calls++;
+        timer->callback(timer);
+    }
+    return calls;
+}
+
+void
+soft_timer_init(soft_timer_t* timer, soft_timer_fn callback) {
+    timer->next = timer->prev = NULL;
+    timer->callback = callback;
+    timer->expire_ms = 0;
+    timer->period_ms = 0;
+    timer->slot = SOFT_TIMER_STOPPED;
+}
+
+void
+soft_timer_start(soft_timer_t* timer, uint32_t ms, uint32_t period_ms) {
+    uint32_t now = counter_get_ms();
+
+    soft_timer_stop(timer);
+    soft_timer_sync(now);
+    timer->expire_ms = now + ms;
+    timer->period_ms = period_ms;
+    soft_timer_insert(timer);
+    if (soft_timer_wake != NULL) {
+        soft_timer_wake(soft_timer_next_ms());
+    }
+}
+
+void
+soft_timer_stop(soft_timer_t* timer) {
+    if (timer->slot != SOFT_TIMER_STOPPED) {
+        soft_timer_unlink(timer);
+    }
+}
+
+uint8_t
+soft_timer_is_running(const soft_timer_t* timer) {
+    return timer->slot != SOFT_TIMER_STOPPED;
+}
+
+uint16_t
+soft_timer_process(void) {
+    uint32_t now = counter_get_ms();
+    uint16_t calls = 0;
+
+    while ((int32_t)(now - soft_timer_tick) >= 0) {
+        uint32_t next = soft_timer_next();
+
+        if (next > now - soft_timer_tick) {
+            break;
+        }
+        soft_timer_tick += next;
+        calls += soft_timer_expire(now);
+    }
+    /*
+     * Processing the current tick again is harmless: the slots it cascaded cannot have been
+     * refilled, and its slot of the finest wheel only holds timers started for 0 ms since
+     */
+    soft_timer_tick = now;
+    if (soft_timer_wake != NULL) {
+        soft_timer_wake(soft_timer_next_ms());
+    }
+    return calls;
+}
+
+uint32_t
+soft_timer_next_ms(void) {
+    uint32_t next = soft_timer_next();
+    int32_t left;
+
+    if (next == SOFT_TIMER_NEVER) {
+        return SOFT_TIMER_NEVER;
+    }
+    left = (int32_t)(soft_timer_tick + next - counter_get_ms());
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void
+soft_timer_set_wake_callback(void (*wake)(uint32_t ms)) {
+    soft_timer_wake = wake;
+}
@@ -33,6 +33,7 @@
 */
 
 #include "timer3.h"
+#include "nvic.h"
 
 void
 timer3_init(void) {
@@ -46,18 +47,27 @@ timer3_init(void) {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
     TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInitStructure.TIM_Period = 10 - 1;
-    TIM_TimeBaseInitStructure.TIM_Prescaler = 7200 - 1;
+    TIM_TimeBaseInitStructure.TIM_Period = TIMER3_PERIOD_MS * 10 - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = TIMER3_CYCLES_PER_COUNT - 1;
     TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0; //基本定时器无，随便设为0
     TIM_TimeBaseInit(TIM3, &TIM_TimeBaseInitStructure);
 
     //使能中断
     TIM_ITConfig(TIM3, TIM_IT_Update, ENABLE);
 
-    /* TIM3_IRQn interrupt configuration */
-    NVIC_SetPriority(TIM3_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0, 0));
-    NVIC_EnableIRQ(TIM3_IRQn);
+    nvic_enable(NVIC_IRQ_TIM3);
+}
 
-    //启动定时器
+void
+timer3_start(void) {
+    /* A full period to the first update */
+    TIM_SetCounter(TIM3, 0);
+    TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
     TIM_Cmd(TIM3, ENABLE);
+}
+
+void
+timer3_stop(void) {
+    TIM_Cmd(TIM3, DISABLE);
+    TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+* \file            alarm.h
+* \date            10/19/2026
+* \brief           Header file for the wake-up alarm
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_ALARM_H
+#define ELYSIA_VOICE_ALARM_CLOCK_ALARM_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Fires the alarm when the getup time is reached, call it from the main loop after clock_update
+* \note            The alarm greets, then plays music while the volume ramps up from
+*                  CLOCK_CFG_ALARM_START_VOLUME, and keeps escalating until dismissed
+*/
+void alarm_process(void);
+
+/**
+* \brief           Checks if the alarm is ringing
+* \return          1 if it is ringing, 0 otherwise
+*/
+uint8_t alarm_is_ringing(void);
+
+/**
+* \brief           Dismisses the alarm: stops the music and restores the volume
+* \note            Safe to call from the key interrupt, the alarm stops in alarm_process
+*/
+void alarm_dismiss(void);
+
+/**
+* \brief           Checks if the alarm went off recently
+* \param[in]       minutes: How far back to look
+* \return          1 if the alarm went off in the last `minutes`, 0 otherwise
+*/
+uint8_t alarm_went_off(uint16_t minutes);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_ALARM_H */
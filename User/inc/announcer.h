@@ -0,0 +1,77 @@
+/**
+* \file            announcer.h
+* \date            10/19/2026
+* \brief           Header file for the talking clock announcer
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_ANNOUNCER_H
+#define ELYSIA_VOICE_ALARM_CLOCK_ANNOUNCER_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the phrases the announcer can say
+*/
+typedef enum announcer_phrase {
+    ANNOUNCER_TIME,             /*!< "It is 7 32" */
+    ANNOUNCER_TIME_TEMPERATURE, /*!< "It is 7 32, 18 degrees" */
+    ANNOUNCER_GREETING,         /*!< "Good morning, it is 7 30, 18 degrees" */
+    ANNOUNCER_PHRASE_NUM,
+} announcer_phrase_t;
+
+/**
+* \brief           Compiles a phrase with the current time and temperature and plays its first clip
+* \note            Use voice_announce, which keeps track of the music being interrupted
+* \param[in]       phrase: Phrase to say
+* \return          1 if the phrase started, 0 otherwise
+*/
+uint8_t announcer_start(announcer_phrase_t phrase);
+
+/**
+* \brief           Plays the next clip of the phrase, call it when the DFPlayer reports a finished track
+* \return          1 if a clip was started, 0 if no phrase is being said or it just ended
+*/
+uint8_t announcer_on_finished(void);
+
+/**
+* \brief           Drops the rest of the phrase
+*/
+void announcer_stop(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_ANNOUNCER_H */
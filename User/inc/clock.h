@@ -68,6 +68,11 @@ typedef enum clock_season {
 */
 extern uint8_t clock_year, clock_month, clock_day, clock_hour, clock_minute, clock_second, clock_week;
 
+/**
+* \brief           Hour and minute of the getup alarm
+*/
+extern uint8_t clock_get_up_time[2];
+
 /**
 * \brief           Advice for the current time
 */
@@ -93,6 +98,37 @@ void clock_init(void);
 */
 void clock_update(void);
 
+/**
+* \brief           Sets fields of the date and time
+* \param[in]       time: Year, month, day, hour, minute, second and week, in the layout of `ds1302_time`
+* \param[in]       fields: `DS1302_FIELD_*` to set
+*/
+void clock_set_time(const uint8_t* time, uint8_t fields);
+
+/**
+* \brief           Sets the getup alarm, kept across resets
+* \param[in]       hour: Hour of the alarm
+* \param[in]       minute: Minute of the alarm
+*/
+void clock_set_getup_time(uint8_t hour, uint8_t minute);
+
+/**
+* \brief           Gets the number of days of a month
+* \param[in]       year: Year in the century
+* \param[in]       month: Month, 1 ~ 12
+* \return          28 ~ 31
+*/
+uint8_t clock_days_in_month(uint8_t year, uint8_t month);
+
+/**
+* \brief           Gets the day of the week of a date
+* \param[in]       year: Year in the century
+* \param[in]       month: Month, 1 ~ 12
+* \param[in]       day: Day of the month
+* \return          1 (Monday) ~ 7 (Sunday)
+*/
+uint8_t clock_weekday(uint8_t year, uint8_t month, uint8_t day);
+
 /**
 * \brief           Checks if it's sleep time
 * \return          1 if it's sleep time, 0 otherwise
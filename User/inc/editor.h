@@ -0,0 +1,129 @@
+/**
+* \file            editor.h
+* \date            10/19/2026
+* \brief           Header file for the time and alarm editor
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_EDITOR_H
+#define ELYSIA_VOICE_ALARM_CLOCK_EDITOR_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the fields of the editor, in the order they are visited
+*/
+typedef enum editor_field {
+    EDITOR_HOUR,         /*!< Hour of the time */
+    EDITOR_MINUTE,       /*!< Minute of the time */
+    EDITOR_YEAR,         /*!< Year of the date, in the century */
+    EDITOR_MONTH,        /*!< Month of the date */
+    EDITOR_DAY,          /*!< Day of the date */
+    EDITOR_ALARM_HOUR,   /*!< Hour of the getup alarm */
+    EDITOR_ALARM_MINUTE, /*!< Minute of the getup alarm */
+    EDITOR_FIELD_NUM,
+} editor_field_t;
+
+/**
+* \brief           Opens the editor on the hour, with the current date, time and alarm
+*/
+void editor_open(void);
+
+/**
+* \brief           Writes the changed fields and closes the editor
+*/
+void editor_save(void);
+
+/**
+* \brief           Closes the editor, dropping the changes
+*/
+void editor_cancel(void);
+
+/**
+* \brief           Checks if the editor is open
+* \return          1 if open, 0 otherwise
+*/
+uint8_t editor_is_open(void);
+
+/**
+* \brief           Moves to the next field, after the last back to the first
+*/
+void editor_next(void);
+
+/**
+* \brief           Steps the field once, on a press of a time key
+* \param[in]       delta: 1 or -1
+*/
+void editor_step(int8_t delta);
+
+/**
+* \brief           Keeps stepping the field while a time key is held, faster and faster
+* \param[in]       delta: 1 or -1
+*/
+void editor_hold(int8_t delta);
+
+/**
+* \brief           Stops the stepping of editor_hold, on the release of the key
+*/
+void editor_release(void);
+
+/**
+* \brief           Runs the held stepping and closes the editor after a while without keys
+*/
+void editor_process(void);
+
+/**
+* \brief           Gets the field being edited
+* \return          The field
+*/
+editor_field_t editor_get_field(void);
+
+/**
+* \brief           Gets the edited value of a field
+* \param[in]       field: The field
+* \return          The value
+*/
+uint8_t editor_get_value(editor_field_t field);
+
+/**
+* \brief           Checks if the field being edited is highlighted now, it blinks while untouched
+* \return          1 if highlighted, 0 otherwise
+*/
+uint8_t editor_is_highlighted(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_EDITOR_H */
@@ -56,6 +56,7 @@ typedef enum Key_KeyDef {
 } Key_KeyDef;
 
 void key_init(void);
+void key_process(void);
 
 #ifdef __cplusplus
 }
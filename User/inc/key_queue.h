@@ -0,0 +1,123 @@
+/**
+* \file            key_queue.h
+* \date            10/19/2026
+* \brief           Header file for the key event queue
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_KEY_QUEUE_H
+#define ELYSIA_VOICE_ALARM_CLOCK_KEY_QUEUE_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Number of events the queue holds, power of two
+*/
+#define KEY_QUEUE_LEN 16
+
+/**
+* \brief           Read the cycle counter used for the time stamps, the DWT CYCCNT at 72 MHz
+*
+* A host build defines its own, key_queue_init() then leaves the DWT alone.
+*/
+#ifndef KEY_QUEUE_CYCLES
+#define KEY_QUEUE_CYCLES() (*(volatile uint32_t*)0xE0001004)
+#define KEY_QUEUE_CYCLES_DWT
+#endif /* KEY_QUEUE_CYCLES */
+
+/**
+* \brief           A key event posted by the key interrupt
+*/
+typedef struct key_event {
+    uint8_t key;    /*!< `Key_KeyDef` of the key */
+    uint8_t event;  /*!< multi_button `PressEvent` */
+    uint32_t stamp; /*!< KEY_QUEUE_CYCLES() when posted */
+} key_event_t;
+
+/**
+* \brief           Instrumentation of the queue, durations in cycles
+*/
+typedef struct key_queue_stats {
+    uint8_t depth;        /*!< Events waiting now */
+    uint8_t depth_max;    /*!< Most events ever waiting */
+    uint16_t dropped;     /*!< Events lost to a full queue */
+    uint32_t handled;     /*!< Events taken and handled */
+    uint32_t isr_max;     /*!< Longest key interrupt */
+    uint32_t latency_max; /*!< Longest time from posting an event to the end of its handler */
+    uint32_t latency_sum; /*!< Sum of those times, over `handled` events */
+} key_queue_stats_t;
+
+/**
+* \brief           Starts the cycle counter of the time stamps
+*/
+void key_queue_init(void);
+
+/**
+* \brief           Posts an event, from the key interrupt only
+* \param[in]       key: `Key_KeyDef` of the key
+* \param[in]       event: multi_button `PressEvent`
+* \return          1 if queued, 0 if the queue was full and the event dropped
+*/
+uint8_t key_queue_post(uint8_t key, uint8_t event);
+
+/**
+* \brief           Records the duration of a key interrupt, from the key interrupt only
+* \param[in]       cycles: Duration of the interrupt
+*/
+void key_queue_note_isr(uint32_t cycles);
+
+/**
+* \brief           Takes the oldest event, from the main loop only
+* \param[out]      event: The event
+* \return          1 if an event was taken, 0 if the queue is empty
+*/
+uint8_t key_queue_take(key_event_t* event);
+
+/**
+* \brief           Records that the handler of an event returned, from the main loop only
+* \param[in]       event: The event taken by key_queue_take
+*/
+void key_queue_note_handled(const key_event_t* event);
+
+/**
+* \brief           Gets the instrumentation of the queue
+* \param[out]      stats: The instrumentation
+*/
+void key_queue_get_stats(key_queue_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_KEY_QUEUE_H */
@@ -0,0 +1,89 @@
+/**
+* \file            key_record.h
+* \date            10/19/2026
+* \brief           Recorder of the key pins, for replaying field sessions on the host
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_KEY_RECORD_H
+#define ELYSIA_VOICE_ALARM_CLOCK_KEY_RECORD_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The record is a byte stream. It starts with KEY_RECORD_MAGIC_0, KEY_RECORD_MAGIC_1 and
+ * KEY_RECORD_VERSION, then holds one entry per change of the key pins:
+ *
+ *   - the milliseconds since the previous entry shifted left by one, or'ed with 1 if entries
+ *     were lost before this one, as a varint: 7 bits per byte, least significant first, bit 7
+ *     set on all but the last byte
+ *   - the low byte of GPIOA->IDR, the raw level of the 8 key pins
+ *
+ * The first entry, with 0 ms, is the level at key_record_init(). A session rarely needs more
+ * than 2 bytes per change. On a reset, a new header starts a new session.
+ */
+#define KEY_RECORD_MAGIC_0 'K'
+#define KEY_RECORD_MAGIC_1 'R'
+#define KEY_RECORD_VERSION 1
+
+/**
+* \brief           Starts the record with the header and the current level of the pins
+* \param[in]       level: Low byte of GPIOA->IDR
+*/
+void key_record_init(uint8_t level);
+
+/**
+* \brief           Appends an entry if the pins changed since the last one, from the key interrupts only
+* \param[in]       level: Low byte of GPIOA->IDR
+*/
+void key_record_sample(uint8_t level);
+
+/**
+* \brief           Takes the bytes recorded since the last call, from the main loop only
+* \param[out]      buf: Where to copy them
+* \param[in]       len: Size of `buf`
+* \return          Number of bytes copied
+*/
+uint16_t key_record_read(uint8_t* buf, uint16_t len);
+
+/**
+* \brief           Prints the bytes recorded since the last call to the log, as `krec <hex>` lines
+*/
+void key_record_process(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_KEY_RECORD_H */
@@ -0,0 +1,97 @@
+/**
+* \file            key_scan.h
+* \date            10/19/2026
+* \brief           Header file for the batched key scanner
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_KEY_SCAN_H
+#define ELYSIA_VOICE_ALARM_CLOCK_KEY_SCAN_H
+
+#include "multi_button.h"
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Debounce state of eight keys sampled together, one bit per key
+*
+* Each key has a 2-bit counter, bit 0 in `count0` and bit 1 in `count1`, counting the samples
+* that differ from its debounced level, so all eight advance with a few bitwise operations.
+*/
+typedef struct key_scan {
+    uint8_t level;      /*!< Debounced levels, 1 is pressed */
+    uint8_t count0;     /*!< Low bits of the counters */
+    uint8_t count1;     /*!< High bits of the counters */
+    uint8_t active_low; /*!< Keys pressed at the low level */
+    uint8_t busy;       /*!< Keys whose state machine is not idle */
+} key_scan_t;
+
+/**
+* \brief           Samples a key needs to differ from its level before the level changes,
+*                  as DEBOUNCE_TICKS of multi_button used to
+*/
+#define KEY_SCAN_DEBOUNCE 3
+
+/**
+* \brief           Initializes the scanner, the keys start at their current level
+* \param[out]      scan: The scanner
+* \param[in]       active_low: Keys pressed at the low level
+* \param[in]       sample: Current pin levels
+*/
+void key_scan_init(key_scan_t* scan, uint8_t active_low, uint8_t sample);
+
+/**
+* \brief           Debounces one sample of all the keys
+* \param[in,out]   scan: The scanner
+* \param[in]       sample: Pin levels, bit n is key n
+* \return          Keys whose debounced level changed
+*/
+uint8_t key_scan_update(key_scan_t* scan, uint8_t sample);
+
+/**
+* \brief           Debounces one sample and runs the state machine of the enabled keys that
+*                  changed or are not idle, once per TICKS_INTERVAL
+* \param[in,out]   scan: The scanner
+* \param[in]       sample: Pin levels, bit n is key n
+* \param[in]       buttons: Button of key n at n, its pin level read from `scan->level`
+* \param[in]       enabled: Keys whose state machine runs
+* \return          0 once every enabled key is idle and no level is changing, the ticks may stop
+*                  until the next edge, the state machines would do nothing but wait for it
+*/
+uint8_t key_scan_tick(key_scan_t* scan, uint8_t sample, struct Button* const* buttons, uint8_t enabled);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_KEY_SCAN_H */
@@ -0,0 +1,81 @@
+/**
+* \file            music.h
+* \date            10/19/2026
+* \brief           Header file for the music library spanning several TF card folders
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_MUSIC_H
+#define ELYSIA_VOICE_ALARM_CLOCK_MUSIC_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Gets the number of tracks in the whole library
+* \return          Number of tracks of all the VOICE_MUSIC_LIBRARY folders
+*/
+uint16_t music_get_size(void);
+
+/**
+* \brief           Gets the current track
+* \return          Index of the current track in the library, starting from 0
+*/
+uint16_t music_get_index(void);
+
+/**
+* \brief           Makes a track the current one without playing it
+* \param[in]       index: Index of the track in the library, wrapped to the library size
+*/
+void music_seek(uint16_t index);
+
+/**
+* \brief           Plays the current track
+*/
+void music_play(void);
+
+/**
+* \brief           Moves to the next track, wrapping to the first one, and plays it
+*/
+void music_next(void);
+
+/**
+* \brief           Moves to the previous track, wrapping to the last one, and plays it
+*/
+void music_previous(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_MUSIC_H */
@@ -0,0 +1,97 @@
+/**
+* \file            playlist.h
+* \date            10/19/2026
+* \brief           Header file for the music playlist
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_PLAYLIST_H
+#define ELYSIA_VOICE_ALARM_CLOCK_PLAYLIST_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the playlist modes
+*/
+typedef enum playlist_mode {
+    PLAYLIST_SEQUENTIAL, /*!< Play the library once in order, then stop */
+    PLAYLIST_REPEAT_ONE, /*!< Play the current track again and again */
+    PLAYLIST_REPEAT_ALL, /*!< Play the library in order, starting over at the end */
+    PLAYLIST_SHUFFLE,    /*!< Play the library in a new random order every cycle */
+    PLAYLIST_MODE_NUM,
+} playlist_mode_t;
+
+/**
+* \brief           Restores the mode, current track and shuffle seed saved before the reset
+*/
+void playlist_init(void);
+
+/**
+* \brief           Gets the playlist mode
+* \return          Current mode
+*/
+playlist_mode_t playlist_get_mode(void);
+
+/**
+* \brief           Sets the playlist mode, the current track stays the same
+* \param[in]       mode: New mode
+*/
+void playlist_set_mode(playlist_mode_t mode);
+
+/**
+* \brief           Plays the current track
+*/
+void playlist_play(void);
+
+/**
+* \brief           Skips to the next track and plays it, in every mode
+*/
+void playlist_next(void);
+
+/**
+* \brief           Skips back to the previous track and plays it, in every mode
+*/
+void playlist_previous(void);
+
+/**
+* \brief           Advances the playlist after the current track finished
+* \return          1 if a track was started, 0 if the playlist ended
+*/
+uint8_t playlist_on_finished(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_PLAYLIST_H */
@@ -0,0 +1,89 @@
+/**
+* \file            tasks.h
+* \date            10/19/2026
+* \brief           Task table of the application, run by the scheduler
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_TASKS_H
+#define ELYSIA_VOICE_ALARM_CLOCK_TASKS_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the tasks, the index of each in the table
+*/
+typedef enum tasks_id {
+    TASK_KEYS,        /*!< Key events to their handlers */
+    TASK_VOICE,       /*!< DFPlayer responses, volume steps and the voice state */
+    TASK_EDITOR,      /*!< Repeated steps and timeout of the editor */
+    TASK_TIMERS,      /*!< Software timer callbacks, released at the next expiry */
+    TASK_CLOCK,       /*!< RTC read and the values derived from it */
+    TASK_ALARM,       /*!< Getup alarm */
+    TASK_RENDER,      /*!< Screen */
+    TASK_TEMPERATURE, /*!< DS18B20 samples and trend */
+    TASK_REPORT,      /*!< Scheduler instrumentation, idle residency, interrupts and profile to the log */
+    TASK_BOOT,        /*!< The steps of the bring-up that wait on the DFPlayer, then the boot timeline */
+    TASK_NUM,
+} tasks_id_t;
+
+/**
+* \brief           Enumeration for the steps of the bring-up, the index of each in the step table
+*/
+typedef enum tasks_step {
+    TASK_STEP_IDLE,    /*!< LSI, RTC alarm and STOP */
+    TASK_STEP_TIMER3,  /*!< Key tick */
+    TASK_STEP_KEYS,    /*!< Key pins and edges */
+    TASK_STEP_CLOCK,   /*!< Settings and the DS1302, set if it was halted */
+    TASK_STEP_RANDOM,  /*!< Seeded from the clock */
+    TASK_STEP_SCREEN,  /*!< SSD1306 and DS18B20 pins */
+    TASK_STEP_FRAME,   /*!< First frame on the panel, the time to it is the one to keep short */
+    TASK_STEP_VOICE,   /*!< DFPlayer, reads the TF card for 2 s */
+    TASK_STEP_CATALOG, /*!< Track counts of the folders */
+    TASK_STEP_NVIC,    /*!< NVIC checked against the priority map */
+    TASK_STEP_NUM,
+} tasks_step_t;
+
+/**
+* \brief           Brings the modules up, and starts scheduling the tasks once all but the DFPlayer are up
+*
+* The time base and the NVIC grouping come first, the boot task drives the steps still waiting.
+*/
+void tasks_init(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_TASKS_H */
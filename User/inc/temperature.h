@@ -0,0 +1,105 @@
+/**
+* \file            temperature.h
+* \date            10/19/2026
+* \brief           Header file for the temperature history
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_H
+#define ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_H
+
+#include "stm32f10x.h"
+#include "coroutine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the temperature trend
+*/
+typedef enum temperature_trend {
+    TEMPERATURE_STEADY,  /*!< No clear trend, or not enough history yet */
+    TEMPERATURE_COOLING, /*!< Cooling down */
+    TEMPERATURE_WARMING, /*!< Warming up */
+} temperature_trend_t;
+
+/**
+* \brief           Statistics of the temperature history, all in 1/16 degree Celsius
+*/
+typedef struct temperature_stats {
+    int16_t min;   /*!< Lowest slot of the history */
+    int16_t max;   /*!< Highest slot of the history */
+    int16_t mean;  /*!< Mean of the history */
+    int16_t slope; /*!< Least-squares slope of the latest slots, per hour */
+    uint8_t slots; /*!< Slots in the history, the statistics are 0 while it is empty */
+} temperature_stats_t;
+
+/**
+* \brief           Reads the DS18B20, call it every second from the main loop
+*
+* A call less than 750 ms after the previous reading returns at once. One reading every
+* TEMPERATURE_CFG_SAMPLE_MS goes to the history, every one to ds18b20_get_t().
+*
+* \note            The history is a ring of TEMPERATURE_CFG_SLOTS readings, 2 bytes each,
+*                  plus 30 bytes of state: 222 bytes with the default configuration
+* \return          COROUTINE_WAITING in the middle of a bus transaction, call again within a millisecond
+*/
+coroutine_status_t temperature_process(void);
+
+/**
+* \brief           Adds a reading to the history
+* \param[in]       t: Temperature in 1/16 degree Celsius, the DS18B20 resolution
+*/
+void temperature_add(int16_t t);
+
+/**
+* \brief           Gets the statistics of the history
+* \param[out]      stats: The statistics
+*/
+void temperature_get_stats(temperature_stats_t* stats);
+
+/**
+* \brief           Gets the current trend
+* \return          The trend
+*/
+temperature_trend_t temperature_get_trend(void);
+
+/**
+* \brief           Takes the trend started since the last call, so each change is handled once
+* \return          TEMPERATURE_COOLING or TEMPERATURE_WARMING when one started, TEMPERATURE_STEADY otherwise
+*/
+temperature_trend_t temperature_take_event(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_H */
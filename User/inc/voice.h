@@ -36,6 +36,7 @@
 #define ELYSIA_VOICE_ALARM_CLOCK_VOICE_H
 
 #include "stm32f10x.h"
+#include "announcer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,7 +51,19 @@ typedef enum voice_status {
 } voice_status_t;
 
 /**
-* \brief           Invokes a random voice interaction
+* \brief           Enumeration for what the DFPlayer is playing
+*/
+typedef enum voice_audio {
+   VOICE_AUDIO_IDLE,            /*!< Nothing is playing */
+   VOICE_AUDIO_LINE,            /*!< A voice line is playing on its own */
+   VOICE_AUDIO_MUSIC,           /*!< A music track is playing */
+   VOICE_AUDIO_MUSIC_PAUSED,    /*!< The music track is paused */
+   VOICE_AUDIO_ADVERT,          /*!< A voice line was just interjected into the music track as an advert */
+   VOICE_AUDIO_LINE_OVER_MUSIC, /*!< The music track was stopped for a voice line, it plays again afterwards */
+} voice_audio_t;
+
+/**
+* \brief           Invokes a random voice interaction among the categories that fit the moment
 */
 void voice_invoke(void);
 
@@ -79,6 +92,12 @@ void voice_weather(void);
 */
 void voice_season(void);
 
+/**
+* \brief           Says the time, and the temperature, with the talking clock clips
+* \param[in]       phrase: The phrase to say
+*/
+void voice_announce(announcer_phrase_t phrase);
+
 /**
 * \brief           Initializes the voice module with the specified volume
 * \param[in]       volume: The initial volume level
@@ -86,10 +105,14 @@ void voice_season(void);
 void voice_init(uint8_t volume);
 
 /**
-* \brief           Initiates a voice interaction related to birthdays
-* \param[in]       meOrAlysia: 0 for character birthday, 1 for general birthday
+* \brief           Dispatches the DFPlayer replies and drives background tasks, call it from the main loop
+*/
+void voice_process(void);
+
+/**
+* \brief           Initiates a voice interaction related to birthdays and other special days
 */
-void voice_birthday(uint8_t meOrAlysia);
+void voice_birthday(void);
 
 /**
 * \brief           Sets the volume level for voice interactions
@@ -99,11 +122,13 @@ void voice_set_volume(uint16_t volume);
 
 /**
 * \brief           Increases the volume level for voice interactions
+* \note            Safe to call from the key interrupt, the DFPlayer is set from voice_process
 */
 void voice_volume_increase(void);
 
 /**
 * \brief           Decreases the volume level for voice interactions
+* \note            Safe to call from the key interrupt, the DFPlayer is set from voice_process
 */
 void voice_volume_decrease(void);
 
@@ -118,7 +143,7 @@ void voice_on(void);
 void voice_off(void);
 
 /**
-* \brief           Initiates playing the next music track
+* \brief           Plays the current music track, unless music is already playing
 */
 void voice_music_play(void);
 
@@ -132,6 +157,11 @@ void voice_music_pause(void);
 */
 void voice_music_continue(void);
 
+/**
+* \brief           Pauses the music if it is playing, otherwise continues or starts it
+*/
+void voice_music_play_pause(void);
+
 /**
 * \brief           Plays the next music track in the playlist
 */
@@ -142,6 +172,17 @@ void voice_music_next(void);
 */
 void voice_music_previous(void);
 
+/**
+* \brief           Switches to the next playlist mode: sequential, repeat one, repeat all, shuffle
+*/
+void voice_music_switch_mode(void);
+
+/**
+* \brief           Gets what the DFPlayer is playing
+* \return          Current audio state
+*/
+voice_audio_t voice_get_audio(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
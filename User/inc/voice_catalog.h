@@ -0,0 +1,84 @@
+/**
+* \file            voice_catalog.h
+* \date            10/19/2026
+* \brief           Header file for the catalog of voice folders on the TF card
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATALOG_H
+#define ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATALOG_H
+
+#include "stm32f10x.h"
+#include "dfplayer_mini.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Enumeration for the catalog scan status
+*/
+typedef enum voice_catalog_status {
+    VOICE_CATALOG_FALLBACK, /*!< Using the compile-time counts from voice_cfg.h */
+    VOICE_CATALOG_SCANNING, /*!< Querying the module folder by folder */
+    VOICE_CATALOG_READY,    /*!< Counts come from the TF card (scanned or cached), but for the folders that did not answer */
+} voice_catalog_status_t;
+
+/**
+* \brief           Starts the asynchronous catalog scan
+* \note            The DFPlayer must be initialized before
+*/
+void voice_catalog_init(void);
+
+/**
+* \brief           Hands a frame received from the DFPlayer to the catalog scan
+* \param[in]       response: The received frame
+* \return          1 if the frame was consumed by the scan, 0 otherwise
+*/
+uint8_t voice_catalog_on_response(const df_response_t* response);
+
+/**
+* \brief           Gets the number of tracks in a voice folder
+* \param[in]       folder: Folder number, a `VOICE_*` folder or a VOICE_MUSIC_LIBRARY folder (0: "MP3" folder)
+* \return          Number of tracks, 0 if the folder is unknown or empty
+*/
+uint16_t voice_catalog_count(uint8_t folder);
+
+/**
+* \brief           Gets the catalog scan status
+* \return          The catalog scan status
+*/
+voice_catalog_status_t voice_catalog_get_status(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATALOG_H */
@@ -0,0 +1,86 @@
+/**
+* \file            voice_category.h
+* \date            10/19/2026
+* \brief           Header file for the voice category registry and selection engine
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATEGORY_H
+#define ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATEGORY_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Group of the categories sharing the first digit of their folder number
+* \param[in]       base: A `VOICE_*_BASE` folder number
+*/
+#define VOICE_GROUP(base) ((uint16_t)(1U << ((base) / 10)))
+#define VOICE_GROUP_ALL   ((uint16_t)0xFFFF)
+
+/**
+* \brief           A voice line on the TF card
+*/
+typedef struct voice_line {
+    uint8_t folder; /*!< Folder of the line */
+    uint8_t number; /*!< Number of the line in the folder, starting from 1 */
+} voice_line_t;
+
+/**
+* \brief           Gets the conditions holding right now
+* \return          `VOICE_WHEN_*` flags
+*/
+uint32_t voice_category_context(void);
+
+/**
+* \brief           Picks a line among the categories of some groups whose trigger holds
+* \note            The pick is weighted by the score of each category, see VOICE_CATEGORY_LIST.
+*                  Falls back to VOICE_DEFAULT when no category of the groups can be said
+* \param[in]       groups: `VOICE_GROUP()` flags, or VOICE_GROUP_ALL
+* \param[out]      line: The picked line
+* \return          1 if a line was picked, 0 if the folders are empty
+*/
+uint8_t voice_category_pick(uint16_t groups, voice_line_t* line);
+
+/**
+* \brief           Picks a line of one category, whatever its trigger
+* \param[in]       folder: Folder of a VOICE_CATEGORY_LIST category
+* \return          Line number, 0 if the folder is empty or not a category
+*/
+uint8_t voice_category_line(uint8_t folder);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_VOICE_CATEGORY_H */
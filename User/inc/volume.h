@@ -0,0 +1,125 @@
+/**
+* \file            volume.h
+* \date            10/19/2026
+* \brief           Header file for the volume ramp engine
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_VOLUME_H
+#define ELYSIA_VOICE_ALARM_CLOCK_VOLUME_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+* \brief           Start a ramp from the current volume
+*/
+#define VOLUME_CURRENT 0xFF
+
+/**
+* \brief           Enumeration for the shape of a ramp
+*/
+typedef enum volume_curve {
+    VOLUME_CURVE_LINEAR,     /*!< Evenly spaced steps */
+    VOLUME_CURVE_PERCEPTUAL, /*!< Eases in: few steps at first, most near the end, for a gentle wake-up */
+} volume_curve_t;
+
+/**
+* \brief           Enumeration for the state of the latest ramp
+*/
+typedef enum volume_ramp_state {
+    VOLUME_RAMP_IDLE,     /*!< No ramp was started */
+    VOLUME_RAMP_RUNNING,  /*!< The ramp is moving the volume */
+    VOLUME_RAMP_DONE,     /*!< The ramp reached its volume */
+    VOLUME_RAMP_CANCELED, /*!< The volume was set, or a volume key pressed, before the end */
+} volume_ramp_state_t;
+
+/**
+* \brief           Initializes the volume, the DFPlayer is already at this volume
+* \param[in]       volume: Volume level 0 ~ VOICE_VOLUME_MAX
+*/
+void volume_init(uint8_t volume);
+
+/**
+* \brief           Moves the volume from a level to another over some time
+* \note            Sending is left to volume_process, this returns at once
+* \param[in]       from: Starting level, or VOLUME_CURRENT
+* \param[in]       to: Final level
+* \param[in]       duration_ms: Time to get there, 0 jumps at once
+* \param[in]       curve: Shape of the ramp
+*/
+void volume_ramp(uint8_t from, uint8_t to, uint32_t duration_ms, volume_curve_t curve);
+
+/**
+* \brief           Sets the volume, cancelling a running ramp
+* \param[in]       volume: Volume level 0 ~ VOICE_VOLUME_MAX
+*/
+void volume_set(uint8_t volume);
+
+/**
+* \brief           Steps the volume up or down, cancelling a running ramp
+* \note            The step is applied by volume_process, paced like the ramp steps
+* \param[in]       delta: Number of levels, negative to lower the volume
+*/
+void volume_step(int8_t delta);
+
+/**
+* \brief           Gets the volume the DFPlayer is at, or about to be set to
+* \return          Volume level
+*/
+uint8_t volume_get(void);
+
+/**
+* \brief           Checks whether the DFPlayer was sent the volume volume_get returns
+* \return          1 if it was, 0 while the command waits for its turn
+*/
+uint8_t volume_is_applied(void);
+
+/**
+* \brief           Gets the state of the latest ramp
+* \return          The state
+*/
+volume_ramp_state_t volume_get_ramp(void);
+
+/**
+* \brief           Applies the key steps and the ramp, and sends the volume when it changed
+* \note            Call it from the main loop. Steps closer than VOICE_VOLUME_COMMAND_GAP_MS
+*                  are merged, so a fast ramp sends fewer commands than it has levels.
+*/
+void volume_process(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_VOLUME_H */
@@ -0,0 +1,154 @@
+/**
+* \file            alarm.c
+* \date            10/19/2026
+* \brief           Wake-up alarm
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "alarm.h"
+#include "../../config/voice_cfg.h"
+#include "clock.h"
+#include "counter.h"
+#include "dfplayer_mini.h"
+#include "voice.h"
+#include "volume.h"
+
+#define LOG_TAG "ALARM"
+#include "elog.h"
+
+/**
+ * \brief           Enumeration for the stages of a ringing alarm
+ */
+typedef enum alarm_state {
+    ALARM_IDLE,       /*!< Not ringing */
+    ALARM_STARTING,   /*!< Waiting for the start volume to reach the DFPlayer */
+    ALARM_WAKING,     /*!< Ramping up to the volume set before the alarm */
+    ALARM_ESCALATING, /*!< Ramping up to full volume, or held where a volume key left it */
+} alarm_state_t;
+
+static uint32_t alarm_fired_ms;          /*!< Time the alarm last went off */
+static uint8_t alarm_fired;              /*!< Whether the alarm went off since boot */
+static uint8_t alarm_state;              /*!< Current `alarm_state_t` */
+static uint8_t alarm_volume;             /*!< Volume before the alarm, restored once dismissed */
+static uint8_t alarm_adjusted;           /*!< A volume key was pressed while ringing, keep that volume */
+static volatile uint8_t alarm_dismissed; /*!< Set by the key interrupt */
+
+/**
+ * \brief           Start ringing, quietly
+ */
+static void
+alarm_start(void) {
+    alarm_volume = volume_get();
+    alarm_adjusted = 0;
+    alarm_dismissed = 0;
+    volume_set(CLOCK_CFG_ALARM_START_VOLUME);
+    alarm_state = ALARM_STARTING;
+}
+
+/**
+ * \brief           Stop ringing and give the volume back
+ */
+static void
+alarm_stop(void) {
+    log_i("Alarm stopped after %d s", (int)((counter_get_ms() - alarm_fired_ms) / 1000));
+    voice_music_pause();
+    if (!alarm_adjusted) {
+        volume_set(alarm_volume);
+    }
+    alarm_state = ALARM_IDLE;
+}
+
+void
+alarm_process(void) {
+    static uint8_t getup_before;
+
+    /* clock_is_getup_time holds for a whole minute, fire on its rising edge only */
+    uint8_t getup = clock_is_getup_time();
+    if (getup && !getup_before) {
+        log_i("Getup time %02d:%02d", clock_hour, clock_minute);
+        alarm_start();
+        alarm_fired_ms = counter_get_ms();
+        alarm_fired = 1;
+    }
+    getup_before = getup;
+
+    if (alarm_state == ALARM_IDLE) {
+        return;
+    }
+    if (alarm_dismissed || counter_get_ms() - alarm_fired_ms >= CLOCK_CFG_ALARM_TIMEOUT_MS) {
+        alarm_stop();
+        return;
+    }
+
+    switch (alarm_state) {
+        case ALARM_STARTING:
+            /* The greeting must not start at the volume left from last night */
+            if (!volume_is_applied() || df_get_idle_ms() < VOICE_VOLUME_COMMAND_GAP_MS) {
+                return;
+            }
+            voice_announce(ANNOUNCER_GREETING);
+            volume_ramp(VOLUME_CURRENT,
+                        alarm_volume > CLOCK_CFG_ALARM_START_VOLUME ? alarm_volume : CLOCK_CFG_ALARM_START_VOLUME,
+                        CLOCK_CFG_ALARM_WAKE_MS, VOLUME_CURVE_PERCEPTUAL);
+            alarm_state = ALARM_WAKING;
+            return;
+        case ALARM_WAKING:
+            if (volume_get_ramp() == VOLUME_RAMP_DONE) {
+                log_i("Not dismissed, escalate");
+                volume_ramp(VOLUME_CURRENT, VOICE_VOLUME_MAX, CLOCK_CFG_ALARM_ESCALATE_MS, VOLUME_CURVE_LINEAR);
+                alarm_state = ALARM_ESCALATING;
+            }
+            break;
+        default: break;
+    }
+    if (volume_get_ramp() == VOLUME_RAMP_CANCELED) {
+        alarm_adjusted = 1;
+    }
+
+    /* Music once the greeting is over, and again should the playlist end */
+    if (voice_get_audio() == VOICE_AUDIO_IDLE && df_get_idle_ms() >= VOICE_VOLUME_COMMAND_GAP_MS) {
+        voice_music_play();
+    }
+}
+
+uint8_t
+alarm_is_ringing(void) {
+    return alarm_state != ALARM_IDLE;
+}
+
+void
+alarm_dismiss(void) {
+    alarm_dismissed = 1;
+}
+
+uint8_t
+alarm_went_off(uint16_t minutes) {
+    return alarm_fired && counter_get_ms() - alarm_fired_ms < (uint32_t)minutes * 60000;
+}
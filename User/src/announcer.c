@@ -0,0 +1,164 @@
+/**
+* \file            announcer.c
+* \date            10/19/2026
+* \brief           Talking clock announcer chaining number clips
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "announcer.h"
+#include "../../config/voice_cfg.h"
+#include "clock.h"
+#include "dfplayer_mini.h"
+#include "ds18b20.h"
+
+#define LOG_TAG "ANNOUNCER"
+#include "elog.h"
+
+/*
+ * A template is a zero-terminated list of clip numbers of the VOICE_CLIP folder, with a few
+ * bytes above VOICE_CLIP_NUM standing for values filled in when the phrase is compiled.
+ */
+#define ANNOUNCER_OP_HOUR        0xF0 /* Hour, 0 ~ 23 */
+#define ANNOUNCER_OP_MINUTE      0xF1 /* "o'clock", "oh 5" or "32" */
+#define ANNOUNCER_OP_TEMPERATURE 0xF2 /* "18 degrees", "minus 3 degrees" */
+#define ANNOUNCER_OP_GREETING    0xF3 /* Greeting matching the time of day */
+
+#define ANNOUNCER_TEMPLATE_LEN   6  /* Longest template, without the terminating 0 */
+#define ANNOUNCER_SEQUENCE_LEN   10 /* Longest compiled phrase */
+
+static const uint8_t announcer_templates[ANNOUNCER_PHRASE_NUM][ANNOUNCER_TEMPLATE_LEN + 1] = {
+    [ANNOUNCER_TIME] = {VOICE_CLIP_IT_IS, ANNOUNCER_OP_HOUR, ANNOUNCER_OP_MINUTE},
+    [ANNOUNCER_TIME_TEMPERATURE] = {VOICE_CLIP_IT_IS, ANNOUNCER_OP_HOUR, ANNOUNCER_OP_MINUTE,
+                                    ANNOUNCER_OP_TEMPERATURE},
+    [ANNOUNCER_GREETING] = {ANNOUNCER_OP_GREETING, VOICE_CLIP_IT_IS, ANNOUNCER_OP_HOUR, ANNOUNCER_OP_MINUTE,
+                            ANNOUNCER_OP_TEMPERATURE},
+};
+
+static uint8_t announcer_sequence[ANNOUNCER_SEQUENCE_LEN]; /*!< Clips of the phrase being said */
+static uint8_t announcer_len;                              /*!< Number of clips of the phrase */
+static uint8_t announcer_next;                             /*!< Next clip to play */
+
+/**
+ * \brief           Append a clip to the compiled phrase
+ */
+static void
+announcer_emit(uint8_t clip) {
+    if (announcer_len < ANNOUNCER_SEQUENCE_LEN) {
+        announcer_sequence[announcer_len++] = clip;
+    }
+}
+
+/**
+ * \brief           Append the clip saying a number, clamped to the vocabulary
+ */
+static void
+announcer_emit_number(int16_t number) {
+    announcer_emit(VOICE_CLIP_NUMBER(number < 0 ? 0 : number > 59 ? 59 : number));
+}
+
+/**
+ * \brief           Get the greeting for the current time of day
+ */
+static uint8_t
+announcer_greeting(void) {
+    switch (clock_time_of_day) {
+        case CLOCK_MORNING: return VOICE_CLIP_GOOD_MORNING;
+        case CLOCK_AFTERNOON: return VOICE_CLIP_GOOD_AFTERNOON;
+        case CLOCK_MIDNIGHT: return VOICE_CLIP_GOOD_NIGHT;
+        default: return VOICE_CLIP_GOOD_EVENING;
+    }
+}
+
+/**
+ * \brief           Compile a template into the clip sequence
+ * \param[in]       template: Zero-terminated template
+ */
+static void
+announcer_compile(const uint8_t* template) {
+    announcer_len = 0;
+    announcer_next = 0;
+
+    for (; *template != 0; template++) {
+        switch (*template) {
+            case ANNOUNCER_OP_HOUR: announcer_emit_number(clock_hour); break;
+            case ANNOUNCER_OP_MINUTE:
+                if (clock_minute == 0) {
+                    announcer_emit(VOICE_CLIP_OCLOCK);
+                    break;
+                }
+                if (clock_minute < 10) {
+                    announcer_emit(VOICE_CLIP_OH);
+                }
+                announcer_emit_number(clock_minute);
+                break;
+            case ANNOUNCER_OP_TEMPERATURE: {
+                float t = ds18b20_get_t();
+                int16_t degrees = (int16_t)(t < 0 ? t - 0.5f : t + 0.5f);
+                if (degrees < 0) {
+                    announcer_emit(VOICE_CLIP_MINUS);
+                    degrees = -degrees;
+                }
+                announcer_emit_number(degrees);
+                announcer_emit(VOICE_CLIP_DEGREES);
+                break;
+            }
+            case ANNOUNCER_OP_GREETING: announcer_emit(announcer_greeting()); break;
+            default: announcer_emit(*template); break;
+        }
+    }
+}
+
+uint8_t
+announcer_start(announcer_phrase_t phrase) {
+    if (phrase >= ANNOUNCER_PHRASE_NUM) {
+        return 0;
+    }
+
+    announcer_compile(announcer_templates[phrase]);
+    log_i("Announce phrase %d, %d clips", phrase, announcer_len);
+    return announcer_on_finished();
+}
+
+uint8_t
+announcer_on_finished(void) {
+    if (announcer_next >= announcer_len) {
+        announcer_len = 0;
+        announcer_next = 0;
+        return 0;
+    }
+    df_play_from_folder(VOICE_CLIP, announcer_sequence[announcer_next++]);
+    return 1;
+}
+
+void
+announcer_stop(void) {
+    announcer_len = 0;
+    announcer_next = 0;
+}
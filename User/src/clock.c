@@ -33,9 +33,12 @@
 */
 
 #include <stdio.h>
+#include "backup.h"
 #include "clock.h"
 #include "ds1302.h"
 
+#define CLOCK_GETUP_TIME_SET 0x8000 /* Marks BACKUP_REG_GETUP_TIME as written */
+
 uint8_t clock_year, clock_month, clock_day, clock_hour, clock_minute, clock_second, clock_week;
 char* clock_advice;
 
@@ -84,7 +87,7 @@ clock_determine_season(void) {
 */
 static void
 clock_user_config(void) {
-   size_t t1, t2;
+   int t1, t2;
 
    sscanf(CLOCK_CFG_SLEEP_TIME, "%d:%d", &t1, &t2);
    clock_sleep_time[0] = t1;
@@ -93,6 +96,14 @@ clock_user_config(void) {
    sscanf(CLOCK_CFG_GETUP_TIME, "%d:%d", &t1, &t2);
    clock_get_up_time[0] = t1;
    clock_get_up_time[1] = t2;
+   if (backup_init()) {
+       uint16_t getup = backup_read(BACKUP_REG_GETUP_TIME);
+
+       if (getup & CLOCK_GETUP_TIME_SET) {
+           clock_get_up_time[0] = getup >> 8 & 0x7F;
+           clock_get_up_time[1] = getup & 0xFF;
+       }
+   }
 
    sscanf(CLOCK_CFG_BIRTHDAY, "%d-%d", &t1, &t2);
    clock_birthday_me[0] = t1;
@@ -166,6 +177,62 @@ clock_update(void) {
    clock_determine_season();
 }
 
+/**
+* \brief           Sets fields of the date and time of the RTC and reads it back
+* \param[in]       time: Year, month, day, hour, minute, second and week, in the layout of `ds1302_time`
+* \param[in]       fields: `DS1302_FIELD_*` to set, the others keep running
+*/
+void
+clock_set_time(const uint8_t* time, uint8_t fields) {
+   ds1302_write_fields(time, fields);
+   clock_update();
+}
+
+/**
+* \brief           Sets the getup alarm, kept in a backup register across resets
+* \param[in]       hour: Hour of the alarm
+* \param[in]       minute: Minute of the alarm
+*/
+void
+clock_set_getup_time(uint8_t hour, uint8_t minute) {
+   clock_get_up_time[0] = hour;
+   clock_get_up_time[1] = minute;
+   backup_init();
+   backup_write(BACKUP_REG_GETUP_TIME, CLOCK_GETUP_TIME_SET | hour << 8 | minute);
+}
+
+/**
+* \brief           Gets the number of days of a month
+* \param[in]       year: Year in the century, 0 ~ 99
+* \param[in]       month: Month, 1 ~ 12
+* \return          28 ~ 31
+*/
+uint8_t
+clock_days_in_month(uint8_t year, uint8_t month) {
+   static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+   if (month == 2 && year % 4 == 0) {
+       return 29; /* 2000 was a leap year, 2100 is beyond the RTC */
+   }
+   return days[(month - 1) % 12];
+}
+
+/**
+* \brief           Gets the day of the week of a date
+* \param[in]       year: Year in the century, 0 ~ 99
+* \param[in]       month: Month, 1 ~ 12
+* \param[in]       day: Day of the month
+* \return          1 (Monday) ~ 7 (Sunday), as `clock_week`
+*/
+uint8_t
+clock_weekday(uint8_t year, uint8_t month, uint8_t day) {
+   static const uint8_t offset[12] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+   uint16_t y = 2000 + year - (month < 3);
+   uint8_t weekday = (y + y / 4 - y / 100 + y / 400 + offset[(month - 1) % 12] + day) % 7;
+
+   return weekday == 0 ? 7 : weekday;
+}
+
 /**
 * \brief           Checks if the current time is sleep time
 * \return          Returns `1` if it's sleep time, `0` otherwise
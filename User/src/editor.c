@@ -0,0 +1,242 @@
+/**
+* \file            editor.c
+* \date            10/19/2026
+* \brief           Field by field editor of the time, the date and the alarm
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "editor.h"
+#include "../../config/clock_cfg.h"
+#include "clock.h"
+#include "counter.h"
+#include "ds1302.h"
+#include "idle.h"
+
+#define LOG_TAG "EDITOR"
+#include "elog.h"
+
+static uint8_t editor_open_;                    /*!< Whether the editor is open */
+static uint8_t editor_field;                    /*!< Current `editor_field_t` */
+static uint8_t editor_values[EDITOR_FIELD_NUM]; /*!< Edited values */
+static uint8_t editor_opened[EDITOR_FIELD_NUM]; /*!< Values when the editor opened */
+static int8_t editor_hold_delta;                /*!< Step of the held key, 0 if none is held */
+static uint32_t editor_hold_start;              /*!< Time the key started repeating */
+static uint32_t editor_hold_next;               /*!< Time of the next repeated step */
+static uint32_t editor_activity;                /*!< Time of the last key */
+
+/* Smallest and largest value of each field, the largest day depends on the month */
+static const uint8_t editor_min[EDITOR_FIELD_NUM] = {0, 0, 0, 1, 1, 0, 0};
+static const uint8_t editor_max[EDITOR_FIELD_NUM] = {23, 59, 99, 12, 31, 23, 59};
+
+/**
+ * \brief           Get the largest value of a field
+ */
+static uint8_t
+editor_field_max(uint8_t field) {
+    if (field == EDITOR_DAY) {
+        return clock_days_in_month(editor_values[EDITOR_YEAR], editor_values[EDITOR_MONTH]);
+    }
+    return editor_max[field];
+}
+
+/**
+ * \brief           Step the current field, wrapping around its range
+ */
+static void
+editor_apply(int8_t delta) {
+    uint8_t min = editor_min[editor_field];
+    int16_t range = editor_field_max(editor_field) - min + 1;
+    int16_t value = (editor_values[editor_field] - min + delta) % range;
+
+    editor_values[editor_field] = min + (value < 0 ? value + range : value);
+
+    /* A shorter month or a non leap year may leave the day out of range */
+    if (editor_values[EDITOR_DAY] > editor_field_max(EDITOR_DAY)) {
+        editor_values[EDITOR_DAY] = editor_field_max(EDITOR_DAY);
+    }
+}
+
+/**
+ * \brief           Get the time between the steps of a key held since `start`, at `now`
+ */
+static uint32_t
+editor_repeat_ms(uint32_t start, uint32_t now) {
+    if (now - start < CLOCK_CFG_EDIT_MEDIUM_AFTER_MS) {
+        return CLOCK_CFG_EDIT_REPEAT_SLOW_MS;
+    }
+    if (now - start < CLOCK_CFG_EDIT_FAST_AFTER_MS) {
+        return CLOCK_CFG_EDIT_REPEAT_MEDIUM_MS;
+    }
+    return CLOCK_CFG_EDIT_REPEAT_FAST_MS;
+}
+
+void
+editor_open(void) {
+    editor_values[EDITOR_HOUR] = clock_hour;
+    editor_values[EDITOR_MINUTE] = clock_minute;
+    editor_values[EDITOR_YEAR] = clock_year;
+    editor_values[EDITOR_MONTH] = clock_month;
+    editor_values[EDITOR_DAY] = clock_day;
+    editor_values[EDITOR_ALARM_HOUR] = clock_get_up_time[0];
+    editor_values[EDITOR_ALARM_MINUTE] = clock_get_up_time[1];
+    for (uint8_t field = 0; field < EDITOR_FIELD_NUM; field++) {
+        editor_opened[field] = editor_values[field];
+    }
+    editor_field = EDITOR_HOUR;
+    editor_hold_delta = 0;
+    editor_activity = counter_get_ms();
+    editor_open_ = 1;
+    idle_hold(IDLE_CLIENT_EDITOR, 1);
+    log_i("Editing...");
+}
+
+void
+editor_save(void) {
+    uint8_t time[7];
+    uint8_t fields = 0;
+
+    if (!editor_open_) {
+        return;
+    }
+    editor_open_ = 0;
+    idle_hold(IDLE_CLIENT_EDITOR, 0);
+
+    time[0] = editor_values[EDITOR_YEAR];
+    time[1] = editor_values[EDITOR_MONTH];
+    time[2] = editor_values[EDITOR_DAY];
+    time[3] = editor_values[EDITOR_HOUR];
+    time[4] = editor_values[EDITOR_MINUTE];
+    time[5] = 0;
+    time[6] = clock_weekday(time[0], time[1], time[2]);
+
+    /* Only the changed fields, the others keep running; a new time starts at second 0 */
+    fields |= editor_values[EDITOR_YEAR] != editor_opened[EDITOR_YEAR] ? DS1302_FIELD_YEAR : 0;
+    fields |= editor_values[EDITOR_MONTH] != editor_opened[EDITOR_MONTH] ? DS1302_FIELD_MONTH : 0;
+    fields |= editor_values[EDITOR_DAY] != editor_opened[EDITOR_DAY] ? DS1302_FIELD_DAY : 0;
+    fields |= editor_values[EDITOR_HOUR] != editor_opened[EDITOR_HOUR] ? DS1302_FIELD_HOUR : 0;
+    fields |= editor_values[EDITOR_MINUTE] != editor_opened[EDITOR_MINUTE] ? DS1302_FIELD_MINUTE : 0;
+    if (fields & (DS1302_FIELD_HOUR | DS1302_FIELD_MINUTE)) {
+        fields |= DS1302_FIELD_SECOND;
+    }
+    if ((fields & (DS1302_FIELD_YEAR | DS1302_FIELD_MONTH | DS1302_FIELD_DAY)) && time[6] != clock_week) {
+        fields |= DS1302_FIELD_WEEK;
+    }
+    if (fields) {
+        log_i("Saving time 20%02d-%02d-%02d %02d:%02d, fields 0x%02X", time[0], time[1], time[2], time[3], time[4],
+              fields);
+        clock_set_time(time, fields);
+    }
+
+    if (editor_values[EDITOR_ALARM_HOUR] != editor_opened[EDITOR_ALARM_HOUR]
+        || editor_values[EDITOR_ALARM_MINUTE] != editor_opened[EDITOR_ALARM_MINUTE]) {
+        log_i("Saving alarm %02d:%02d", editor_values[EDITOR_ALARM_HOUR], editor_values[EDITOR_ALARM_MINUTE]);
+        clock_set_getup_time(editor_values[EDITOR_ALARM_HOUR], editor_values[EDITOR_ALARM_MINUTE]);
+    }
+}
+
+void
+editor_cancel(void) {
+    if (editor_open_) {
+        editor_open_ = 0;
+        idle_hold(IDLE_CLIENT_EDITOR, 0);
+        log_i("Editing canceled");
+    }
+}
+
+uint8_t
+editor_is_open(void) {
+    return editor_open_;
+}
+
+void
+editor_next(void) {
+    if (!editor_open_) {
+        return;
+    }
+    editor_field = (editor_field + 1) % EDITOR_FIELD_NUM;
+    editor_hold_delta = 0;
+    editor_activity = counter_get_ms();
+}
+
+void
+editor_step(int8_t delta) {
+    if (!editor_open_) {
+        return;
+    }
+    editor_apply(delta);
+    editor_activity = counter_get_ms();
+}
+
+void
+editor_hold(int8_t delta) {
+    if (!editor_open_) {
+        return;
+    }
+    editor_hold_delta = delta;
+    editor_hold_start = editor_hold_next = editor_activity = counter_get_ms();
+}
+
+void
+editor_release(void) {
+    editor_hold_delta = 0;
+}
+
+void
+editor_process(void) {
+    uint32_t now = counter_get_ms();
+
+    if (!editor_open_) {
+        return;
+    }
+    /* Catch up on the steps due since the last call, a slow loop must not slow the keys down */
+    while (editor_hold_delta != 0 && (int32_t)(now - editor_hold_next) >= 0) {
+        editor_apply(editor_hold_delta);
+        editor_hold_next += editor_repeat_ms(editor_hold_start, editor_hold_next);
+        editor_activity = now;
+    }
+    if (editor_hold_delta == 0 && now - editor_activity >= CLOCK_CFG_EDIT_TIMEOUT_MS) {
+        editor_cancel();
+    }
+}
+
+editor_field_t
+editor_get_field(void) {
+    return (editor_field_t)editor_field;
+}
+
+uint8_t
+editor_get_value(editor_field_t field) {
+    return editor_values[field];
+}
+
+uint8_t
+editor_is_highlighted(void) {
+    return editor_hold_delta != 0 || (counter_get_ms() - editor_activity) / CLOCK_CFG_EDIT_BLINK_MS % 2 == 0;
+}
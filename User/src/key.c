@@ -37,8 +37,19 @@
 */
 
 #include "key.h"
+#include "../../config/key_cfg.h"
+#include "alarm.h"
+#include "editor.h"
+#include "idle.h"
+#include "irq_monitor.h"
+#include "key_queue.h"
+#include "key_record.h"
+#include "key_scan.h"
 #include "multi_button.h"
+#include "nvic.h"
+#include "profile.h"
 #include "screen.h"
+#include "timer3.h"
 #include "voice.h"
 
 #define LOG_TAG "KEY"
@@ -59,6 +70,26 @@
 #define KEY_TIME_DECREASE_PIN  GPIO_Pin_6 /* Time decrease key */
 #define KEY_TIME_INCREASE_PIN  GPIO_Pin_7 /* Time increase key */
 
+#define KEY_EXTI_LINES         0x00FF /* EXTI line n is pin n */
+
+#define KEY_ACTIVE_LOW_PINS    (KEY_MODE_PIN | KEY_PLAY_PAUSE_PIN | KEY_VOICE_RESPONSE_PIN | KEY_SET_TIME_ALARM_PIN)
+
+/* One read of the port samples every key, key n on pin n */
+_Static_assert(KEY_MODE_PIN == 1 << KEY_MODE && KEY_PLAY_PAUSE_PIN == 1 << KEY_PLAY_PAUSE
+                   && KEY_VOICE_RESPONSE_PIN == 1 << KEY_VOICE_RESPONSE
+                   && KEY_SET_TIME_ALARM_PIN == 1 << KEY_SET_TIME_ALARM && KEY_VOLUME_PREV_PIN == 1 << KEY_VOLUME_PREV
+                   && KEY_VOLUME_NEXT_PIN == 1 << KEY_VOLUME_NEXT && KEY_TIME_DECREASE_PIN == 1 << KEY_TIME_DECREASE
+                   && KEY_TIME_INCREASE_PIN == 1 << KEY_TIME_INCREASE,
+               "Keys are not on pins 0 ~ 7 in Key_KeyDef order");
+_Static_assert(TIMER3_PERIOD_MS == TICKS_INTERVAL, "TIM3 does not tick the keys every TICKS_INTERVAL");
+
+/* Records the raw pins on each edge and tick, for tools/key_replay */
+#if KEY_CFG_RECORD
+#define KEY_RECORD(level) key_record_sample(level)
+#else
+#define KEY_RECORD(level) ((void)0)
+#endif /* KEY_CFG_RECORD */
+
 struct Button MODE,               /* Always active */
     PLAY_PAUSE,                   /* Active only in music mode */
     VOICE_RESPONSE,               /* Active when not occupied for a long time during playback */
@@ -66,27 +97,91 @@ struct Button MODE,               /* Always active */
     VOLUME_PREV, VOLUME_NEXT,     /* Always active */
     TIME_DECREASE, TIME_INCREASE; /* Active only during time setting */
 
+/* Indexed by Key_KeyDef */
+static struct Button* const key_buttons[] = {
+    &MODE, &PLAY_PAUSE, &VOICE_RESPONSE, &SET_TIME_ALARM, &VOLUME_PREV, &VOLUME_NEXT, &TIME_DECREASE, &TIME_INCREASE,
+};
+
+/**
+ * \brief A key event and the handler it runs in the main loop
+ */
+typedef struct key_binding {
+    uint8_t key;         /*!< Key_KeyDef */
+    uint8_t event;       /*!< PressEvent */
+    BtnCallback handler; /*!< Called with the key's button */
+} key_binding_t;
+
+static key_scan_t key_scan;
+static volatile uint8_t key_enabled; /* Keys whose state machine runs, written by the main loop */
+static volatile uint8_t key_ticking; /* TIM3 is running, the EXTI lines are masked */
+
 /**
- * \brief Read the state of a button connected to a GPIO pin.
+ * \brief Read the debounced state of a button.
  *
  * \param[in] button_id The ID of the button.
  * \return The state of the button (1 if pressed, 0 if not pressed).
  */
 static uint8_t
 read_button_gpio(uint8_t button_id) {
-    switch (button_id) {
-        case KEY_MODE: return GPIO_ReadInputDataBit(KEY_PORT, KEY_MODE_PIN);
-        case KEY_PLAY_PAUSE: return GPIO_ReadInputDataBit(KEY_PORT, KEY_PLAY_PAUSE_PIN);
-        case KEY_VOICE_RESPONSE: return GPIO_ReadInputDataBit(KEY_PORT, KEY_VOICE_RESPONSE_PIN);
-        case KEY_SET_TIME_ALARM: return GPIO_ReadInputDataBit(KEY_PORT, KEY_SET_TIME_ALARM_PIN);
-        case KEY_VOLUME_PREV: return GPIO_ReadInputDataBit(KEY_PORT, KEY_VOLUME_PREV_PIN);
-        case KEY_VOLUME_NEXT: return GPIO_ReadInputDataBit(KEY_PORT, KEY_VOLUME_NEXT_PIN);
-        case KEY_TIME_DECREASE: return GPIO_ReadInputDataBit(KEY_PORT, KEY_TIME_DECREASE_PIN);
-        case KEY_TIME_INCREASE: return GPIO_ReadInputDataBit(KEY_PORT, KEY_TIME_INCREASE_PIN);
-        default: return 0;
+    return key_scan.level >> button_id & 1;
+}
+
+/**
+ * \brief Start ticking the keys, on an edge or when keys are started.
+ *
+ * Runs in the key interrupts or with them masked.
+ */
+static void
+key_wake(void) {
+    EXTI->IMR &= ~KEY_EXTI_LINES;
+    EXTI->PR = KEY_EXTI_LINES;
+    KEY_RECORD((uint8_t)KEY_PORT->IDR);
+    if (!key_ticking) {
+        key_ticking = 1;
+        idle_hold(IDLE_CLIENT_KEYS, 1);
+        timer3_start();
+    }
+}
+
+/**
+ * \brief Stop ticking the keys until the next edge, from TIM3_IRQHandler.
+ */
+static void
+key_sleep(void) {
+    timer3_stop();
+    key_ticking = 0;
+    EXTI->PR = KEY_EXTI_LINES;
+    EXTI->IMR |= KEY_EXTI_LINES;
+    /* An edge between the last sample and the unmasking raised no interrupt */
+    if ((uint8_t)(KEY_PORT->IDR ^ key_scan.active_low) != key_scan.level) {
+        key_wake();
     }
 }
 
+/**
+ * \brief Let the keys run their state machine.
+ *
+ * \param[in] keys The keys, bit n is key n.
+ */
+static void
+key_start(uint8_t keys) {
+    IRQ_MONITOR_MASK();
+    key_enabled |= keys;
+    key_scan.busy |= keys; /* A key held while stopped is seen as pressed now */
+    key_wake();
+    IRQ_MONITOR_UNMASK();
+}
+
+/**
+ * \brief Freeze the state machine of the keys.
+ *
+ * \param[in] keys The keys, bit n is key n.
+ */
+static void
+key_stop(uint8_t keys) {
+    key_enabled &= ~keys;
+}
+
 /* Key events handler here */
 
 /**
@@ -96,22 +191,14 @@ static void
 key_update(void) {
     switch (screen_get_type()) {
         case SCREEN_MUSIC:
-            button_stop(&VOICE_RESPONSE);
-            button_stop(&SET_TIME_ALARM);
-            button_stop(&TIME_INCREASE);
-            button_stop(&TIME_DECREASE);
-
-            button_start(&PLAY_PAUSE);
+            key_stop(KEY_VOICE_RESPONSE_PIN | KEY_SET_TIME_ALARM_PIN | KEY_TIME_INCREASE_PIN | KEY_TIME_DECREASE_PIN);
+            key_start(KEY_PLAY_PAUSE_PIN);
 
             voice_music_play();
             break;
         case SCREEN_TIME:
-            button_stop(&PLAY_PAUSE);
-            button_stop(&TIME_DECREASE);
-            button_stop(&TIME_INCREASE);
-
-            button_start(&VOICE_RESPONSE);
-            button_start(&SET_TIME_ALARM);
+            key_stop(KEY_PLAY_PAUSE_PIN | KEY_TIME_DECREASE_PIN | KEY_TIME_INCREASE_PIN);
+            key_start(KEY_VOICE_RESPONSE_PIN | KEY_SET_TIME_ALARM_PIN);
             break;
         default: log_e("Illegal screen_t type");
     }
@@ -125,6 +212,7 @@ key_update(void) {
 static void
 mode_single_click_handler(void* btn) {
     log_i("Switch mode...");
+    editor_cancel();
     screen_switch((screen_get_type() + 1) % SCREEN_TYPE_NUM);
     key_update();
 }
@@ -136,17 +224,19 @@ mode_single_click_handler(void* btn) {
  */
 static void
 play_pause_single_click_handler(void* btn) {
-    static uint8_t i;
-
-    if (i % 2 == 0) {
-        log_i("Pause the music...");
-        voice_music_pause();
-    } else {
-        log_i("Continue the music...");
-        voice_music_continue();
-    }
+    log_i("Play/Pause the music...");
+    voice_music_play_pause();
+}
 
-    i++;
+/**
+ * \brief Handler for long press start on play/pause button
+ *
+ * \param[in] btn Pointer to the button structure (unused).
+ */
+static void
+play_pause_long_press_start_handler(void* btn) {
+    log_i("Switch playlist mode...");
+    voice_music_switch_mode();
 }
 
 /**
@@ -156,10 +246,26 @@ play_pause_single_click_handler(void* btn) {
  */
 static void
 voice_response_single_click_handler(void* btn) {
+    if (alarm_is_ringing()) {
+        log_i("Dismiss the alarm...");
+        alarm_dismiss();
+        return;
+    }
     log_i("Say something...");
     voice_invoke();
 }
 
+/**
+ * \brief Handler for long press start on voice response button
+ *
+ * \param[in] btn Pointer to the button structure (unused).
+ */
+static void
+voice_response_long_press_start_handler(void* btn) {
+    log_i("Say the time...");
+    voice_announce(ANNOUNCER_TIME_TEMPERATURE);
+}
+
 /**
  * \brief Handler for the start of a single click on the set time button
  *
@@ -167,8 +273,14 @@ voice_response_single_click_handler(void* btn) {
  */
 static void
 set_time_single_click_start_handler(void* btn) {
-    log_i("set_time_single_click_start_handler Invoked");
-    //TODO 更换时间显示 (时间, 闹钟1, 闹钟2...)
+    if (alarm_is_ringing()) {
+        log_i("Dismiss the alarm...");
+        alarm_dismiss();
+        return;
+    }
+    if (editor_is_open()) {
+        editor_next();
+    }
 }
 
 /**
@@ -178,21 +290,14 @@ set_time_single_click_start_handler(void* btn) {
  */
 static void
 set_time_alarm_long_press_start_handler(__attribute__((unused)) void* btn) {
-    log_i("set_time_alarm_long_press_start_handler Invoked");
-    //长按开始设置时间, 再次长按保存
-    static _Bool i;
-    if (i == 0) {
-        //TODO 进入时间设置模式
-        log_i("Setting time...");
-        button_start(&TIME_DECREASE);
-        button_start(&TIME_INCREASE);
+    /* Long press starts setting the time, another long press saves it */
+    if (!editor_is_open()) {
+        editor_open();
+        key_start(KEY_TIME_DECREASE_PIN | KEY_TIME_INCREASE_PIN);
     } else {
-        //TODO 保存时间
-        log_i("Saving time...");
-        button_stop(&TIME_DECREASE);
-        button_stop(&TIME_INCREASE);
+        editor_save();
+        key_stop(KEY_TIME_DECREASE_PIN | KEY_TIME_INCREASE_PIN);
     }
-    i++;
 }
 
 /**
@@ -246,29 +351,119 @@ volume_next_long_press_start_handler(__attribute__((unused)) void* btn) {
 }
 
 /**
- * \brief Handler for single-click events on the time_decrease button
+ * \brief Handler for presses of the time_decrease button, each press steps once
+ *
+ * \param[in] btn Pointer to the button structure (unused).
+ */
+static void
+time_decrease_press_down_handler(__attribute__((unused)) void* btn) {
+    editor_step(-1);
+}
+
+/**
+ * \brief Handler for the start of a long press on the time_decrease button, steps until released
  *
  * \param[in] btn Pointer to the button structure (unused).
  */
 static void
-time_decrease_single_click_handler(__attribute__((unused)) void* btn) {
-    log_i("time_decrease_single_click_handler Invoked");
-    //TODO Decrease time
+time_decrease_long_press_start_handler(__attribute__((unused)) void* btn) {
+    editor_hold(-1);
 }
 
 /**
- * \brief Handler for single-click events on the time_increase button
+ * \brief Handler for presses of the time_increase button, each press steps once
  *
  * \param[in] btn Pointer to the button structure (unused).
  */
 static void
-time_increase_single_click_handler(__attribute__((unused)) void* btn) {
-    log_i("time_increase_single_click_handler Invoked");
-    //TODO Increase time
+time_increase_press_down_handler(__attribute__((unused)) void* btn) {
+    editor_step(1);
+}
+
+/**
+ * \brief Handler for the start of a long press on the time_increase button, steps until released
+ *
+ * \param[in] btn Pointer to the button structure (unused).
+ */
+static void
+time_increase_long_press_start_handler(__attribute__((unused)) void* btn) {
+    editor_hold(1);
+}
+
+/**
+ * \brief Handler for the release of a time button, ends the stepping of a long press
+ *
+ * \param[in] btn Pointer to the button structure (unused).
+ */
+static void
+time_press_up_handler(__attribute__((unused)) void* btn) {
+    editor_release();
 }
 
 /* Key events handler end */
 
+static const key_binding_t key_bindings[] = {
+    {KEY_MODE, SINGLE_CLICK, mode_single_click_handler},
+    {KEY_MODE, PRESS_REPEAT, mode_single_click_handler},
+    {KEY_PLAY_PAUSE, SINGLE_CLICK, play_pause_single_click_handler},
+    {KEY_PLAY_PAUSE, PRESS_REPEAT, play_pause_single_click_handler},
+    {KEY_PLAY_PAUSE, LONG_PRESS_START, play_pause_long_press_start_handler},
+    {KEY_VOICE_RESPONSE, SINGLE_CLICK, voice_response_single_click_handler},
+    {KEY_VOICE_RESPONSE, PRESS_REPEAT, voice_response_single_click_handler},
+    {KEY_VOICE_RESPONSE, LONG_PRESS_START, voice_response_long_press_start_handler},
+    {KEY_SET_TIME_ALARM, SINGLE_CLICK, set_time_single_click_start_handler},
+    {KEY_SET_TIME_ALARM, PRESS_REPEAT, set_time_single_click_start_handler},
+    {KEY_SET_TIME_ALARM, LONG_PRESS_START, set_time_alarm_long_press_start_handler},
+    {KEY_VOLUME_PREV, SINGLE_CLICK, volume_prev_single_click_handler},
+    {KEY_VOLUME_PREV, PRESS_REPEAT, volume_prev_single_click_handler},
+    {KEY_VOLUME_PREV, LONG_PRESS_START, volume_prev_long_press_start_handler},
+    {KEY_VOLUME_NEXT, SINGLE_CLICK, volume_next_single_click_handler},
+    {KEY_VOLUME_NEXT, LONG_PRESS_START, volume_next_long_press_start_handler},
+    {KEY_TIME_DECREASE, PRESS_DOWN, time_decrease_press_down_handler},
+    {KEY_TIME_DECREASE, LONG_PRESS_START, time_decrease_long_press_start_handler},
+    {KEY_TIME_DECREASE, PRESS_UP, time_press_up_handler},
+    {KEY_TIME_INCREASE, PRESS_DOWN, time_increase_press_down_handler},
+    {KEY_TIME_INCREASE, LONG_PRESS_START, time_increase_long_press_start_handler},
+    {KEY_TIME_INCREASE, PRESS_UP, time_press_up_handler},
+};
+
+/**
+ * \brief Button callback of every bound event, runs in the TIM3 interrupt
+ *
+ * \param[in] btn Pointer to the button structure.
+ */
+static void
+key_post(void* btn) {
+    struct Button* button = btn;
+
+    key_queue_post(button->button_id, button->event);
+}
+
+/**
+ * \brief Route PA0 ~ PA7 to EXTI lines 0 ~ 7, masked until the keys fall idle
+ */
+static void
+key_exti_init(void) {
+    EXTI_InitTypeDef exti_init_struct;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO, ENABLE);
+    for (uint8_t pin = GPIO_PinSource0; pin <= GPIO_PinSource7; pin++) {
+        GPIO_EXTILineConfig(GPIO_PortSourceGPIOA, pin);
+    }
+
+    exti_init_struct.EXTI_Line = KEY_EXTI_LINES;
+    exti_init_struct.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti_init_struct.EXTI_Trigger = EXTI_Trigger_Rising_Falling;
+    exti_init_struct.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&exti_init_struct);
+    EXTI->IMR &= ~KEY_EXTI_LINES;
+
+    /* The same priority as TIM3 in the map, so that neither preempts the other */
+    for (uint8_t irq = NVIC_IRQ_EXTI0; irq <= NVIC_IRQ_EXTI9_5; irq++) {
+        nvic_enable((nvic_irq_t)irq);
+    }
+}
+
 /**
  * \brief Initialize and configure the buttons
  */
@@ -288,67 +483,148 @@ key_init(void) {
     gpio_init_struct.GPIO_Mode = GPIO_Mode_IPD;
     GPIO_Init(KEY_PORT, &gpio_init_struct);
 
-    /* Initializes the button struct handle */
-    button_init(&MODE, read_button_gpio, 0, KEY_MODE);
-    button_init(&PLAY_PAUSE, read_button_gpio, 0, KEY_PLAY_PAUSE);
-    button_init(&VOICE_RESPONSE, read_button_gpio, 0, KEY_VOICE_RESPONSE);
-    button_init(&SET_TIME_ALARM, read_button_gpio, 0, KEY_SET_TIME_ALARM);
-    button_init(&VOLUME_PREV, read_button_gpio, 1, KEY_VOLUME_PREV);
-    button_init(&VOLUME_NEXT, read_button_gpio, 1, KEY_VOLUME_NEXT);
-    button_init(&TIME_DECREASE, read_button_gpio, 1, KEY_TIME_DECREASE);
-    button_init(&TIME_INCREASE, read_button_gpio, 1, KEY_TIME_INCREASE);
-
-    /* Attach the keys' event */
-    //MODE
-    button_attach(&MODE, SINGLE_CLICK, mode_single_click_handler);
-    button_attach(&MODE, PRESS_REPEAT, mode_single_click_handler);
-    //PLAY_PAUSE
-    button_attach(&PLAY_PAUSE, SINGLE_CLICK, play_pause_single_click_handler);
-    button_attach(&PLAY_PAUSE, PRESS_REPEAT, play_pause_single_click_handler);
-    //VOICE_RESPONSE
-    button_attach(&VOICE_RESPONSE, SINGLE_CLICK, voice_response_single_click_handler);
-    button_attach(&VOICE_RESPONSE, PRESS_REPEAT, voice_response_single_click_handler);
-    //SET_TIME_ALARM
-    button_attach(&SET_TIME_ALARM, SINGLE_CLICK, set_time_single_click_start_handler);
-    button_attach(&SET_TIME_ALARM, PRESS_REPEAT, set_time_single_click_start_handler);
-    button_attach(&SET_TIME_ALARM, LONG_PRESS_START, set_time_alarm_long_press_start_handler);
-    //KEY_VOLUME_PREV
-    button_attach(&VOLUME_PREV, SINGLE_CLICK, volume_prev_single_click_handler);
-    button_attach(&VOLUME_PREV, PRESS_REPEAT, volume_prev_single_click_handler);
-    button_attach(&VOLUME_PREV, LONG_PRESS_START, volume_prev_long_press_start_handler);
-    //VOLUME_NEXT
-    button_attach(&VOLUME_NEXT, SINGLE_CLICK, volume_next_single_click_handler);
-    button_attach(&VOLUME_NEXT, LONG_PRESS_START, volume_next_long_press_start_handler);
-    //TIME_DECREASE
-    button_attach(&TIME_DECREASE, SINGLE_CLICK, time_decrease_single_click_handler);
-    button_attach(&TIME_DECREASE, PRESS_REPEAT, time_decrease_single_click_handler);
-    //TIME_INCREASE
-    button_attach(&TIME_INCREASE, SINGLE_CLICK, time_increase_single_click_handler);
-    button_attach(&TIME_INCREASE, PRESS_REPEAT, time_increase_single_click_handler);
-
-    button_start(&MODE);
-    button_start(&VOLUME_PREV);
-    button_start(&VOLUME_NEXT);
+    /* Initializes the button struct handle, key_scan turns every key to active-high */
+    key_scan_init(&key_scan, KEY_ACTIVE_LOW_PINS, (uint8_t)KEY_PORT->IDR);
+#if KEY_CFG_RECORD
+    key_record_init((uint8_t)KEY_PORT->IDR);
+#endif /* KEY_CFG_RECORD */
+    key_exti_init();
+    for (uint8_t key = KEY_MODE; key <= KEY_TIME_INCREASE; key++) {
+        button_init(key_buttons[key], read_button_gpio, 1, key);
+    }
+
+    /* Only queue the events in the interrupt, key_process runs the handlers */
+    for (size_t i = 0; i < sizeof(key_bindings) / sizeof(key_bindings[0]); i++) {
+        button_attach(key_buttons[key_bindings[i].key], key_bindings[i].event, key_post);
+    }
+    key_queue_init();
+
+    key_start(KEY_MODE_PIN | KEY_VOLUME_PREV_PIN | KEY_VOLUME_NEXT_PIN);
     /* Before this point, the Screen should be initialized */
     key_update();
 }
 
+/**
+ * \brief Run the handlers of the key events queued by the interrupt
+ *
+ * Handlers may talk to the DFPlayer, log or switch the screen, so they run here in the
+ * main loop rather than in TIM3_IRQHandler.
+ */
+void
+key_process(void) {
+    static uint8_t depth_max;
+    static uint16_t dropped;
+    key_queue_stats_t stats;
+    key_event_t event;
+
+    while (key_queue_take(&event)) {
+        for (size_t i = 0; i < sizeof(key_bindings) / sizeof(key_bindings[0]); i++) {
+            if (key_bindings[i].key == event.key && key_bindings[i].event == event.event) {
+                key_bindings[i].handler(key_buttons[event.key]);
+            }
+        }
+        key_queue_note_handled(&event);
+    }
+    /* The editor closes by itself after a while */
+    if (!editor_is_open() && (key_enabled & (KEY_TIME_DECREASE_PIN | KEY_TIME_INCREASE_PIN))) {
+        key_stop(KEY_TIME_DECREASE_PIN | KEY_TIME_INCREASE_PIN);
+    }
+
+    /* The last tick may queue an event and stop TIM3, the keys let the MCU STOP once it is handled */
+    IRQ_MONITOR_MASK();
+    key_queue_get_stats(&stats);
+    if (!key_ticking && stats.depth == 0) {
+        idle_hold(IDLE_CLIENT_KEYS, 0);
+    }
+    IRQ_MONITOR_UNMASK();
+
+    if (stats.dropped != dropped) {
+        dropped = stats.dropped;
+        log_w("%u key events dropped, queue full", dropped);
+    }
+    if (stats.depth_max != depth_max && stats.handled != 0) {
+        depth_max = stats.depth_max;
+        log_d("Key queue depth %u, interrupt %lu cycles, latency max %lu mean %lu cycles", depth_max,
+              (unsigned long)stats.isr_max, (unsigned long)stats.latency_max,
+              (unsigned long)(stats.latency_sum / stats.handled));
+    }
+#if KEY_CFG_RECORD
+    key_record_process();
+#endif /* KEY_CFG_RECORD */
+}
+
 /**
  * \brief TIM3 interrupt handler
  *
- * This function is called when Timer 3 (TIM3) generates an interrupt.
- * It uses a counter to implement a periodic timer interrupt, and it calls
- * the `button_ticks` and `ds18b20_convert_t` function at a specific interval (5ms).
+ * This function is called when Timer 3 (TIM3) generates an interrupt, every
+ * TICKS_INTERVAL (5ms) while a key is pressed or its gesture is pending. It
+ * samples the keys, which only queues the key events for key_process, and
+ * stops TIM3 once all of them are idle again.
  */
 __attribute__((unused)) void
 TIM3_IRQHandler(void) {
-    static uint8_t counter1;
+    IRQ_MONITOR_ENTER(NVIC_IRQ_TIM3);
+    PROFILE_ISR_ENTER(PROFILE_ISR_TIM3);
     if (TIM_GetITStatus(TIM3, TIM_IT_Update) == SET) {
-        counter1++;
-        if (counter1 == TICKS_INTERVAL) {
-            counter1 = 0;
-            button_ticks();
-        }
+        uint32_t start = KEY_QUEUE_CYCLES();
+        uint8_t sample = (uint8_t)KEY_PORT->IDR;
+
+        /* The counter has run on from 0 since the update, in 100us counts */
+        IRQ_MONITOR_LATENCY(NVIC_IRQ_TIM3, TIM_GetCounter(TIM3) * TIMER3_CYCLES_PER_COUNT);
+
         TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+        KEY_RECORD(sample);
+        if (!key_scan_tick(&key_scan, sample, key_buttons, key_enabled)) {
+            key_sleep();
+        }
+        key_queue_note_isr(KEY_QUEUE_CYCLES() - start);
     }
+    PROFILE_ISR_EXIT(PROFILE_ISR_TIM3);
+    IRQ_MONITOR_EXIT(NVIC_IRQ_TIM3);
+}
+
+/**
+ * \brief The body of the key edge interrupt handlers, the first edge on an idle keypad starts TIM3
+ * \param irq The handler's interrupt
+ */
+static inline void
+key_edge_isr(nvic_irq_t irq) {
+    IRQ_MONITOR_ENTER(irq);
+    PROFILE_ISR_ENTER(PROFILE_ISR_EXTI);
+    key_wake();
+    PROFILE_ISR_EXIT(PROFILE_ISR_EXTI);
+    IRQ_MONITOR_EXIT(irq);
+}
+
+/**
+ * \brief Key edge interrupt handlers
+ */
+__attribute__((unused)) void
+EXTI0_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI0);
+}
+
+__attribute__((unused)) void
+EXTI1_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI1);
+}
+
+__attribute__((unused)) void
+EXTI2_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI2);
+}
+
+__attribute__((unused)) void
+EXTI3_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI3);
+}
+
+__attribute__((unused)) void
+EXTI4_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI4);
+}
+
+__attribute__((unused)) void
+EXTI9_5_IRQHandler(void) {
+    key_edge_isr(NVIC_IRQ_EXTI9_5);
 }
\ No newline at end of file
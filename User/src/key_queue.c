@@ -0,0 +1,132 @@
+/**
+* \file            key_queue.c
+* \date            10/19/2026
+* \brief           Key event queue from the key interrupt to the main loop
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "key_queue.h"
+
+/*
+ * Single producer, single consumer: the key interrupt only writes the head, the main loop only
+ * writes the tail, so neither needs to mask the other. The indexes run freely over uint8_t and
+ * are reduced modulo KEY_QUEUE_LEN, their difference is the depth.
+ */
+_Static_assert((KEY_QUEUE_LEN & (KEY_QUEUE_LEN - 1)) == 0 && KEY_QUEUE_LEN < 256, "KEY_QUEUE_LEN not a power of two");
+
+/* Keeps the compiler from moving the record accesses across the index accesses, a single core needs no more */
+#define KEY_QUEUE_BARRIER() __asm volatile("" ::: "memory")
+
+static key_event_t key_queue[KEY_QUEUE_LEN];
+static volatile uint8_t key_queue_head; /* Written by the interrupt only */
+static volatile uint8_t key_queue_tail; /* Written by the main loop only */
+
+/* Written by the interrupt only */
+static volatile uint8_t key_queue_depth_max;
+static volatile uint16_t key_queue_dropped;
+static volatile uint32_t key_queue_isr_max;
+
+/* Written by the main loop only */
+static uint32_t key_queue_handled;
+static uint32_t key_queue_latency_max;
+static uint32_t key_queue_latency_sum;
+
+void
+key_queue_init(void) {
+#ifdef KEY_QUEUE_CYCLES_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    *(volatile uint32_t*)0xE0001000 |= 1; /* DWT_CTRL.CYCCNTENA */
+#endif /* KEY_QUEUE_CYCLES_DWT */
+}
+
+uint8_t
+key_queue_post(uint8_t key, uint8_t event) {
+    uint8_t head = key_queue_head;
+    uint8_t depth = (uint8_t)(head - key_queue_tail);
+    key_event_t* slot;
+
+    if (depth >= KEY_QUEUE_LEN) {
+        key_queue_dropped++;
+        return 0;
+    }
+    slot = &key_queue[head % KEY_QUEUE_LEN];
+    slot->key = key;
+    slot->event = event;
+    slot->stamp = KEY_QUEUE_CYCLES();
+    KEY_QUEUE_BARRIER();
+    key_queue_head = head + 1;
+    if (depth + 1 > key_queue_depth_max) {
+        key_queue_depth_max = depth + 1;
+    }
+    return 1;
+}
+
+void
+key_queue_note_isr(uint32_t cycles) {
+    if (cycles > key_queue_isr_max) {
+        key_queue_isr_max = cycles;
+    }
+}
+
+uint8_t
+key_queue_take(key_event_t* event) {
+    uint8_t tail = key_queue_tail;
+
+    if (tail == key_queue_head) {
+        return 0;
+    }
+    KEY_QUEUE_BARRIER();
+    *event = key_queue[tail % KEY_QUEUE_LEN];
+    KEY_QUEUE_BARRIER();
+    key_queue_tail = tail + 1;
+    return 1;
+}
+
+void
+key_queue_note_handled(const key_event_t* event) {
+    uint32_t latency = KEY_QUEUE_CYCLES() - event->stamp;
+
+    key_queue_handled++;
+    key_queue_latency_sum += latency;
+    if (latency > key_queue_latency_max) {
+        key_queue_latency_max = latency;
+    }
+}
+
+void
+key_queue_get_stats(key_queue_stats_t* stats) {
+    stats->depth = (uint8_t)(key_queue_head - key_queue_tail);
+    stats->depth_max = key_queue_depth_max;
+    stats->dropped = key_queue_dropped;
+    stats->handled = key_queue_handled;
+    stats->isr_max = key_queue_isr_max;
+    stats->latency_max = key_queue_latency_max;
+    stats->latency_sum = key_queue_latency_sum;
+}
@@ -0,0 +1,153 @@
+/**
+* \file            key_record.c
+* \date            10/19/2026
+* \brief           Recorder of the key pins, for replaying field sessions on the host
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "key_record.h"
+#include "../../config/key_cfg.h"
+#include "counter.h"
+
+#define LOG_TAG "KEY_RECORD"
+#include "elog.h"
+
+#if KEY_CFG_RECORD
+
+/*
+ * Single producer, single consumer, as the key queue: the key interrupts only write the head,
+ * the main loop only writes the tail. An entry is written whole or not at all.
+ */
+_Static_assert((KEY_CFG_RECORD_SIZE & (KEY_CFG_RECORD_SIZE - 1)) == 0 && KEY_CFG_RECORD_SIZE <= 32768,
+               "KEY_CFG_RECORD_SIZE not a power of two");
+
+/* Longest entry: a 5 byte varint and the level */
+#define KEY_RECORD_ENTRY_MAX 6
+
+#define KEY_RECORD_BARRIER() __asm volatile("" ::: "memory")
+
+static uint8_t key_record_buf[KEY_CFG_RECORD_SIZE];
+static volatile uint16_t key_record_head; /* Written by the interrupts only */
+static volatile uint16_t key_record_tail; /* Written by the main loop only */
+
+/* Written by the interrupts only */
+static uint8_t key_record_level;
+static uint8_t key_record_lost;
+static uint32_t key_record_ms;
+
+/**
+ * \brief Append bytes, the caller checked there is room
+ */
+static void
+key_record_put(const uint8_t* bytes, uint8_t len) {
+    uint16_t head = key_record_head;
+
+    for (uint8_t i = 0; i < len; i++) {
+        key_record_buf[(uint16_t)(head + i) % KEY_CFG_RECORD_SIZE] = bytes[i];
+    }
+    KEY_RECORD_BARRIER();
+    key_record_head = head + len;
+}
+
+void
+key_record_init(uint8_t level) {
+    static const uint8_t header[] = {KEY_RECORD_MAGIC_0, KEY_RECORD_MAGIC_1, KEY_RECORD_VERSION, 0x00};
+
+    key_record_head = key_record_tail = 0;
+    key_record_lost = 0;
+    key_record_level = level;
+    key_record_ms = counter_get_ms();
+    key_record_put(header, sizeof(header));
+    key_record_put(&level, 1);
+}
+
+void
+key_record_sample(uint8_t level) {
+    uint8_t entry[KEY_RECORD_ENTRY_MAX];
+    uint8_t len = 0;
+    uint32_t now, value;
+
+    if (level == key_record_level) {
+        return;
+    }
+    now = counter_get_ms();
+    value = (now - key_record_ms) << 1 | key_record_lost;
+    while (value >= 0x80) {
+        entry[len++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    entry[len++] = (uint8_t)value;
+    entry[len++] = level;
+
+    if ((uint16_t)(key_record_head - key_record_tail) > KEY_CFG_RECORD_SIZE - len) {
+        key_record_lost = 1; /* Try again on the next change, the log is behind */
+        return;
+    }
+    key_record_put(entry, len);
+    key_record_level = level;
+    key_record_ms = now;
+    key_record_lost = 0;
+}
+
+uint16_t
+key_record_read(uint8_t* buf, uint16_t len) {
+    uint16_t tail = key_record_tail;
+    uint16_t n = (uint16_t)(key_record_head - tail);
+
+    if (n > len) {
+        n = len;
+    }
+    KEY_RECORD_BARRIER();
+    for (uint16_t i = 0; i < n; i++) {
+        buf[i] = key_record_buf[(uint16_t)(tail + i) % KEY_CFG_RECORD_SIZE];
+    }
+    KEY_RECORD_BARRIER();
+    key_record_tail = tail + n;
+    return n;
+}
+
+void
+key_record_process(void) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t bytes[KEY_CFG_RECORD_LINE];
+    char line[KEY_CFG_RECORD_LINE * 2 + 1];
+    uint16_t len;
+
+    while ((len = key_record_read(bytes, sizeof(bytes))) != 0) {
+        for (uint16_t i = 0; i < len; i++) {
+            line[2 * i] = hex[bytes[i] >> 4];
+            line[2 * i + 1] = hex[bytes[i] & 0x0F];
+        }
+        line[2 * len] = '\0';
+        elog_raw("krec %s\r\n", line);
+    }
+}
+
+#endif /* KEY_CFG_RECORD */
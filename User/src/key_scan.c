@@ -0,0 +1,80 @@
+/**
+* \file            key_scan.c
+* \date            10/19/2026
+* \brief           Batched key scanner with vertical counter debouncing
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "key_scan.h"
+
+_Static_assert(KEY_SCAN_DEBOUNCE == 3, "The 2-bit counters flip their key at 3");
+
+void
+key_scan_init(key_scan_t* scan, uint8_t active_low, uint8_t sample) {
+    scan->active_low = active_low;
+    scan->level = sample ^ active_low;
+    scan->count0 = 0;
+    scan->count1 = 0;
+    scan->busy = 0;
+}
+
+uint8_t
+key_scan_update(key_scan_t* scan, uint8_t sample) {
+    uint8_t delta = (sample ^ scan->active_low) ^ scan->level;
+    uint8_t changed;
+
+    /* Count up the keys that differ, reset the others */
+    scan->count1 = (scan->count1 ^ scan->count0) & delta;
+    scan->count0 = ~scan->count0 & delta;
+
+    /* A counter reaching KEY_SCAN_DEBOUNCE flips its key, and starts over */
+    changed = scan->count0 & scan->count1;
+    scan->level ^= changed;
+    scan->count0 &= ~changed;
+    scan->count1 &= ~changed;
+    return changed;
+}
+
+uint8_t
+key_scan_tick(key_scan_t* scan, uint8_t sample, struct Button* const* buttons, uint8_t enabled) {
+    uint8_t run = (key_scan_update(scan, sample) | scan->busy) & enabled;
+
+    for (uint8_t key = 0; run != 0; key++, run >>= 1) {
+        if (run & 1) {
+            button_handler(buttons[key]);
+            if (buttons[key]->state != 0) {
+                scan->busy |= 1 << key;
+            } else {
+                scan->busy &= ~(1 << key);
+            }
+        }
+    }
+    return (scan->busy & enabled) | scan->count0 | scan->count1;
+}
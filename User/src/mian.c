@@ -33,11 +33,10 @@
 */
 
 #include <stdio.h>
-#include "clock.h"
-#include "key.h"
-#include "screen.h"
-#include "timer3.h"
-#include "voice.h"
+#include "counter.h"
+#include "idle.h"
+#include "scheduler.h"
+#include "tasks.h"
 #include "nvic.h"
 
 #define LOG_TAG "MAIN"
@@ -53,31 +52,42 @@ void system_init(void);
 */
 void elog_init_(void);
 
+/**
+* \brief           EasyLogger assertion hook, the system stops but keeps sending the logs out.
+* \param[in]       expr: The expression that failed.
+* \param[in]       func: The function it is in.
+* \param[in]       line: The line it is on.
+*/
+void elog_assert_(const char* expr, const char* func, size_t line);
+
 /**
 * \brief           Main entry point for the application.
 * \return          Exit status of the program.
 */
 int main() {
+   /* First of all, the logger enables the interrupt of its DMA */
+   nvic_init();
    elog_init_();
 
    system_init();
+   tasks_init();
    while (1) {
-       clock_update();
-       screen_update();
+       if (!scheduler_run()) {
+           elog_port_drain();
+           idle_wait();
+       }
    }
    return 0;
 }
 
 /**
-* \brief           System initialization function, initializing voice, NVIC, timer, key, clock, and screen modules.
+* \brief           System initialization function, initializing the time base.
+* \note            The NVIC grouping is set before the logger. The other modules are brought up by tasks_init() in the
+*                  order of their dependencies, they enable their interrupts at the priorities of the map, which is
+*                  checked once all of them are up.
 */
 void system_init(void) {
-   voice_init(20);
-   nvic_init();
-   timer3_init();
-   key_init();
-   clock_init();
-   screen_init();
+   counter_init();
 }
 
 /**
@@ -95,6 +105,17 @@ void elog_init_(void) {
    elog_set_fmt(ELOG_LVL_INFO, ELOG_FMT_LVL | ELOG_FMT_TAG | ELOG_FMT_TIME);
    elog_set_fmt(ELOG_LVL_DEBUG, ELOG_FMT_ALL & ~ELOG_FMT_FUNC);
    elog_set_fmt(ELOG_LVL_VERBOSE, ELOG_FMT_ALL & ~ELOG_FMT_FUNC);
+   elog_assert_set_hook(elog_assert_);
    /* Start EasyLogger */
    elog_start();
 }
+
+/**
+* \brief           EasyLogger assertion hook, the system stops but keeps sending the logs out.
+*/
+void elog_assert_(const char* expr, const char* func, size_t line) {
+   elog_a("elog", "(%s) has assert failed at %s:%lu.", expr, func, (unsigned long)line);
+   while (1) {
+      elog_port_drain();
+   }
+}
@@ -0,0 +1,240 @@
+/**
+* \file            music.c
+* \date            10/19/2026
+* \brief           Music library spanning several TF card folders
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "music.h"
+#include "../../config/voice_cfg.h"
+#include "dfplayer_mini.h"
+#include "voice_catalog.h"
+
+#define LOG_TAG "MUSIC"
+#include "elog.h"
+
+/**
+ * \brief           Calculate length of statically allocated array
+ */
+#define ARRAY_LEN(x)                 (sizeof(x) / sizeof((x)[0]))
+
+/* Expands one line of VOICE_MUSIC_LIBRARY into a segment */
+#define MUSIC_SEGMENT(type, folder, num) {type, folder},
+
+/**
+ * \brief           A folder of the library
+ */
+typedef struct music_segment {
+    uint8_t type;   /*!< One of `VOICE_MUSIC_*_FOLDER` */
+    uint8_t folder; /*!< Folder number, unused for the "MP3" folder */
+} music_segment_t;
+
+static const music_segment_t music_segments[] = {VOICE_MUSIC_LIBRARY(MUSIC_SEGMENT)};
+
+#define MUSIC_SEGMENT_NUM ARRAY_LEN(music_segments)
+
+static uint16_t music_segment_size[MUSIC_SEGMENT_NUM]; /*!< Number of tracks of every segment */
+static uint16_t music_size;                            /*!< Number of tracks of the library */
+
+/*
+ * The current track is kept both as a library index and as a (segment, offset) cursor,
+ * so stepping forward and backward never has to walk the segment table.
+ */
+static uint16_t music_index;   /*!< Current track in the library */
+static uint8_t music_segment;  /*!< Segment holding the current track */
+static uint16_t music_offset;  /*!< Current track within its segment, starting from 0 */
+
+static uint8_t music_loaded;                        /*!< Whether the segment sizes were read */
+static voice_catalog_status_t music_catalog_status; /*!< Catalog status the sizes were read with */
+
+/**
+ * \brief           Get the largest track number a folder type can address
+ * \param[in]       type: One of `VOICE_MUSIC_*_FOLDER`
+ * \return          Maximum number of tracks
+ */
+static uint16_t
+music_type_limit(uint8_t type) {
+    switch (type) {
+        case VOICE_MUSIC_LARGE_FOLDER: return 3000;
+        case VOICE_MUSIC_MP3_FOLDER: return 9999;
+        default: return 255;
+    }
+}
+
+/**
+ * \brief           Move the cursor to a library index
+ * \note            Walks the segment table, only used when jumping to an arbitrary track
+ * \param[in]       index: Index in the library, must be lower than music_size
+ */
+static void
+music_locate(uint16_t index) {
+    music_index = index;
+    music_segment = 0;
+    music_offset = index;
+    while (music_offset >= music_segment_size[music_segment]) {
+        music_offset -= music_segment_size[music_segment];
+        music_segment++;
+    }
+}
+
+/**
+ * \brief           Read the segment sizes again once the catalog scan has progressed
+ */
+static void
+music_refresh(void) {
+    voice_catalog_status_t status = voice_catalog_get_status();
+
+    if (music_loaded && music_catalog_status == status) {
+        return;
+    }
+    music_loaded = 1;
+    music_catalog_status = status;
+
+    music_size = 0;
+    for (uint8_t i = 0; i < MUSIC_SEGMENT_NUM; i++) {
+        uint16_t size = voice_catalog_count(music_segments[i].folder);
+        if (size > music_type_limit(music_segments[i].type)) {
+            size = music_type_limit(music_segments[i].type);
+        }
+        if (size > UINT16_MAX - music_size) {
+            size = UINT16_MAX - music_size;
+        }
+        music_segment_size[i] = size;
+        music_size += size;
+    }
+    log_i("Music library: %d tracks in %d folders", music_size, MUSIC_SEGMENT_NUM);
+
+    if (music_size > 0) {
+        music_locate(music_index < music_size ? music_index : 0);
+    }
+}
+
+/**
+ * \brief           Get the number of tracks in the whole library
+ * \return          Number of tracks
+ */
+uint16_t
+music_get_size(void) {
+    music_refresh();
+    return music_size;
+}
+
+/**
+ * \brief           Get the current track
+ * \return          Index of the current track in the library
+ */
+uint16_t
+music_get_index(void) {
+    return music_index;
+}
+
+/**
+ * \brief           Make a track the current one without playing it
+ * \param[in]       index: Index of the track, wrapped to the library size
+ */
+void
+music_seek(uint16_t index) {
+    music_refresh();
+    if (music_size == 0) {
+        return;
+    }
+    music_locate(index % music_size);
+}
+
+/**
+ * \brief           Play the current track
+ */
+void
+music_play(void) {
+    music_refresh();
+    if (music_size == 0) {
+        log_w("Music library is empty");
+        return;
+    }
+
+    const music_segment_t* segment = &music_segments[music_segment];
+    uint16_t number = music_offset + 1;
+    switch (segment->type) {
+        case VOICE_MUSIC_LARGE_FOLDER: df_play_from_large_folder(segment->folder, number); break;
+        case VOICE_MUSIC_MP3_FOLDER: df_play_from_mp3_folder(number); break;
+        default: df_play_from_folder(segment->folder, number); break;
+    }
+    log_i("Play track %d/%d", music_index + 1, music_size);
+}
+
+/**
+ * \brief           Move to the next track, wrapping to the first one, and play it
+ */
+void
+music_next(void) {
+    music_refresh();
+    if (music_size == 0) {
+        return;
+    }
+
+    music_index++;
+    music_offset++;
+    if (music_index == music_size) {
+        music_index = 0;
+        music_segment = 0;
+        music_offset = 0;
+    }
+    /* Cross into the next non-empty segment */
+    while (music_offset >= music_segment_size[music_segment]) {
+        music_offset -= music_segment_size[music_segment];
+        music_segment++;
+    }
+    music_play();
+}
+
+/**
+ * \brief           Move to the previous track, wrapping to the last one, and play it
+ */
+void
+music_previous(void) {
+    music_refresh();
+    if (music_size == 0) {
+        return;
+    }
+
+    if (music_index == 0) {
+        music_index = music_size;
+        music_segment = MUSIC_SEGMENT_NUM;
+        music_offset = 0;
+    }
+    music_index--;
+    /* Cross into the previous non-empty segment */
+    while (music_offset == 0) {
+        music_segment--;
+        music_offset = music_segment_size[music_segment];
+    }
+    music_offset--;
+    music_play();
+}
@@ -0,0 +1,232 @@
+/**
+* \file            playlist.c
+* \date            10/19/2026
+* \brief           Music playlist with sequential, repeat and shuffle modes
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "playlist.h"
+#include "backup.h"
+#include "music.h"
+#include "random.h"
+#include "shuffle.h"
+
+#define LOG_TAG "PLAYLIST"
+#include "elog.h"
+
+/*
+ * The playlist only keeps a position and a seed: in shuffle mode the track played at a
+ * position is shuffle_index(position), in the other modes it is the position itself.
+ * No table is needed whatever the library size, and both directions are O(1).
+ */
+static playlist_mode_t playlist_mode = PLAYLIST_REPEAT_ALL; /*!< Current mode */
+static uint16_t playlist_position;                         /*!< Position of the current track */
+static uint16_t playlist_size;                             /*!< Library size the position refers to */
+static uint32_t playlist_seed;                             /*!< Seed of the current shuffle cycle */
+
+/**
+ * \brief           Get the track played at the current position
+ * \return          Index of the track in the library
+ */
+static uint16_t
+playlist_track(void) {
+    if (playlist_mode == PLAYLIST_SHUFFLE) {
+        return shuffle_index(playlist_position, playlist_size, playlist_seed);
+    }
+    return playlist_position;
+}
+
+/**
+ * \brief           Save the current state into the backup registers
+ */
+static void
+playlist_save(void) {
+    backup_write(BACKUP_REG_PLAYLIST_MODE, playlist_mode);
+    backup_write(BACKUP_REG_PLAYLIST_POSITION, music_get_index());
+    backup_write(BACKUP_REG_PLAYLIST_SEED_L, playlist_seed & 0xFFFF);
+    backup_write(BACKUP_REG_PLAYLIST_SEED_H, playlist_seed >> 16);
+}
+
+/**
+ * \brief           Map the current track to a position again after the library size changed
+ * \return          Number of tracks in the library
+ */
+static uint16_t
+playlist_sync(void) {
+    uint16_t size = music_get_size();
+
+    if (size != playlist_size) {
+        uint16_t track = music_get_index();
+        playlist_size = size;
+        if (size == 0) {
+            playlist_position = 0;
+        } else if (playlist_mode == PLAYLIST_SHUFFLE) {
+            playlist_position = shuffle_position(track % size, size, playlist_seed);
+        } else {
+            playlist_position = track % size;
+        }
+    }
+    return size;
+}
+
+/**
+ * \brief           Draw the seed of a new shuffle cycle
+ * \note            The first track of the new cycle is never the one that just ended it.
+ */
+static void
+playlist_reseed(void) {
+    uint16_t last = music_get_index();
+
+    do {
+        playlist_seed = random_u32();
+    } while (playlist_size > 1 && shuffle_index(0, playlist_size, playlist_seed) == last);
+}
+
+/**
+ * \brief           Make the track at the current position the current one and play it
+ */
+static void
+playlist_start(void) {
+    if (playlist_mode == PLAYLIST_SHUFFLE) {
+        music_seek(playlist_track());
+    }
+    music_play();
+    playlist_save();
+}
+
+void
+playlist_init(void) {
+    if (backup_init()) {
+        uint16_t mode = backup_read(BACKUP_REG_PLAYLIST_MODE);
+        playlist_mode = mode < PLAYLIST_MODE_NUM ? (playlist_mode_t)mode : PLAYLIST_REPEAT_ALL;
+        playlist_seed = backup_read(BACKUP_REG_PLAYLIST_SEED_L)
+                        | (uint32_t)backup_read(BACKUP_REG_PLAYLIST_SEED_H) << 16;
+        music_seek(backup_read(BACKUP_REG_PLAYLIST_POSITION));
+    }
+    playlist_size = 0;
+    playlist_sync();
+    log_i("Playlist mode %d, track %d", playlist_mode, music_get_index() + 1);
+}
+
+playlist_mode_t
+playlist_get_mode(void) {
+    return playlist_mode;
+}
+
+void
+playlist_set_mode(playlist_mode_t mode) {
+    if (mode >= PLAYLIST_MODE_NUM || mode == playlist_mode) {
+        return;
+    }
+
+    uint16_t size = playlist_sync();
+    uint16_t track = music_get_index();
+    if (mode == PLAYLIST_SHUFFLE) {
+        /* Draw a fresh order and carry on from wherever the current track landed in it */
+        playlist_reseed();
+        playlist_position = size > 0 ? shuffle_position(track, size, playlist_seed) : 0;
+    } else {
+        playlist_position = track;
+    }
+    playlist_mode = mode;
+    playlist_save();
+    log_i("Playlist mode %d", mode);
+}
+
+void
+playlist_play(void) {
+    if (playlist_sync() == 0) {
+        music_play(); /* Only logs the empty library */
+        return;
+    }
+    playlist_start();
+}
+
+void
+playlist_next(void) {
+    uint16_t size = playlist_sync();
+
+    if (size == 0) {
+        return;
+    }
+    if (playlist_mode != PLAYLIST_SHUFFLE) {
+        music_next();
+        playlist_position = music_get_index();
+        playlist_save();
+        return;
+    }
+
+    playlist_position++;
+    if (playlist_position == size) {
+        playlist_reseed();
+        playlist_position = 0;
+    }
+    playlist_start();
+}
+
+void
+playlist_previous(void) {
+    uint16_t size = playlist_sync();
+
+    if (size == 0) {
+        return;
+    }
+    if (playlist_mode != PLAYLIST_SHUFFLE) {
+        music_previous();
+        playlist_position = music_get_index();
+        playlist_save();
+        return;
+    }
+
+    /* The order of the previous cycle is gone, go round the current one instead */
+    playlist_position = playlist_position == 0 ? size - 1 : playlist_position - 1;
+    playlist_start();
+}
+
+uint8_t
+playlist_on_finished(void) {
+    uint16_t size = playlist_sync();
+
+    if (size == 0) {
+        return 0;
+    }
+    switch (playlist_mode) {
+        case PLAYLIST_SEQUENTIAL:
+            if (playlist_position + 1 >= size) {
+                log_i("End of the playlist");
+                return 0;
+            }
+            playlist_next();
+            break;
+        case PLAYLIST_REPEAT_ONE: playlist_start(); break;
+        default: playlist_next(); break;
+    }
+    return 1;
+}
@@ -35,8 +35,13 @@
 #include <stdio.h>
 #include "clock.h"
 #include "ds18b20.h"
+#include "editor.h"
+#include "music.h"
+#include "playlist.h"
+#include "profile.h"
 #include "screen.h"
 #include "ssd1306.h"
+#include "voice.h"
 
 #define LOG_TAG "SCREEN"
 #include "elog.h"
@@ -50,6 +55,16 @@ static char* kaomoji[] = {
     "(OwO)", "(>_<)", "(QwQ)", "(^_^)", "(O.o)", "(>_<)",
 };
 
+/* Labels of voice_audio_t on the music screen */
+static const char* audio_labels[] = {
+    "STOP", "VOICE", "PLAY", "PAUSE", "PLAY+VOICE", "VOICE",
+};
+
+/* Labels of playlist_mode_t on the music screen */
+static const char* playlist_labels[] = {
+    "SEQ", "ONE", "ALL", "SHUF",
+};
+
 /* Current screen type */
 static screen_t screen_type = SCREEN_TIME;
 
@@ -82,19 +97,74 @@ screen_get_type(void) {
     return screen_type;
 }
 
+/**
+ * \brief          Draws a two digit field of the editor, inverted while it is highlighted.
+ * \param x: X-coordinate of the field.
+ * \param y: Y-coordinate of the field.
+ * \param font: Font of the field.
+ * \param field: The field.
+ */
+static void
+screen_put_field(uint16_t x, uint16_t y, FontDef_t* font, editor_field_t field) {
+    char buffer[3];
+    uint8_t inverted = editor_get_field() == field && editor_is_highlighted();
+
+    sprintf(buffer, "%02d", editor_get_value(field));
+    SSD1306_GotoXY(x, y);
+    SSD1306_Puts(buffer, font, inverted ? SSD1306_COLOR_BLACK : SSD1306_COLOR_WHITE);
+}
+
+/**
+ * \brief          Draws the time screen while the editor is open.
+ *
+ * Every field is drawn at a fixed place, so a step or a blink changes a few bytes of the display.
+ */
+static void
+screen_draw_editor(void) {
+    /* Date: 20YY-MM-DD */
+    SSD1306_GotoXY(0, 2);
+    SSD1306_PUTS_S("SET");
+    SSD1306_GotoXY(56, 2);
+    SSD1306_PUTS_S("20");
+    screen_put_field(56 + 2 * 7, 2, &Font_7x10, EDITOR_YEAR);
+    SSD1306_PUTS_S("-");
+    screen_put_field(56 + 5 * 7, 2, &Font_7x10, EDITOR_MONTH);
+    SSD1306_PUTS_S("-");
+    screen_put_field(56 + 8 * 7, 2, &Font_7x10, EDITOR_DAY);
+    SSD1306_DrawLine(0, 15, SSD1306_WIDTH - 1, 15, SSD1306_COLOR_WHITE);
+
+    /* Time: HH:MM */
+    screen_put_field(3, 16, &Font_16x26, EDITOR_HOUR);
+    SSD1306_PUTS_L(":");
+    screen_put_field(3 + 3 * 16, 16, &Font_16x26, EDITOR_MINUTE);
+
+    /* Alarm: HH:MM */
+    SSD1306_GotoXY(0, SSD1306_HEIGHT - 1 - 10);
+    SSD1306_PUTS_S("Alarm ");
+    screen_put_field(6 * 7, SSD1306_HEIGHT - 1 - 10, &Font_7x10, EDITOR_ALARM_HOUR);
+    SSD1306_PUTS_S(":");
+    screen_put_field(9 * 7, SSD1306_HEIGHT - 1 - 10, &Font_7x10, EDITOR_ALARM_MINUTE);
+}
+
 /**
  * \brief          Updates the content on the screen based on the current screen type.
+ *
+ * The whole frame is drawn in RAM, SSD1306_UpdateScreen only sends what changed.
  */
 void
 screen_update(void) {
+    char buffer[20];
+
+    PROFILE_BEGIN(PROFILE_SCREEN_DRAW);
     SSD1306_Fill(SSD1306_COLOR_BLACK);
     switch (screen_type) {
         case SCREEN_TIME:
-            ds18b20_convert_t();
-            char buffer[20];
-
-            /* Display temperature and kaomoji */
-            float t = ds18b20_read_t();
+            if (editor_is_open()) {
+                screen_draw_editor();
+                break;
+            }
+            /* Display temperature and kaomoji, read by the temperature task */
+            float t = ds18b20_get_t();
             sprintf(buffer, "%d", (uint8_t)t);
             SSD1306_GotoXY(0, 2);
             SSD1306_PUTS_S(buffer);
@@ -102,7 +172,11 @@ screen_update(void) {
             SSD1306_PUTS_S(kaomoji[clock_second % 6]);
 
             /* Display time */
-            sprintf(buffer, "%02d:%02d", clock_hour, clock_minute);
+            {
+                PROFILE_BEGIN(PROFILE_SPRINTF);
+                sprintf(buffer, "%02d:%02d", clock_hour, clock_minute);
+                PROFILE_END(PROFILE_SPRINTF);
+            }
             SSD1306_GotoXY(3, 16);
             SSD1306_PUTS_L(buffer);
             sprintf(buffer, ":%02d", clock_second);
@@ -119,11 +193,24 @@ screen_update(void) {
             break;
 
         case SCREEN_MUSIC:
+            /* Display what is playing and the playlist mode */
+            SSD1306_GotoXY(0, 2);
+            SSD1306_PUTS_S((char*)audio_labels[voice_get_audio()]);
+            SSD1306_GotoXY(SSD1306_WIDTH - 4 * 7, 2);
+            SSD1306_PUTS_S((char*)playlist_labels[playlist_get_mode()]);
+            SSD1306_DrawLine(0, 15, SSD1306_WIDTH - 1, 15, SSD1306_COLOR_WHITE);
+
             SSD1306_GotoXY(16, SSD1306_HEIGHT / 2 - 12);
             SSD1306_PUTS_L("MUSIC");
+
+            /* Display the current track */
+            sprintf(buffer, "%d/%d", music_get_index() + 1, music_get_size());
+            SSD1306_GotoXY(0, SSD1306_HEIGHT - 1 - 10);
+            SSD1306_PUTS_S(buffer);
             break;
 
         default: screen_switch(SCREEN_TIME);
     }
+    PROFILE_END(PROFILE_SCREEN_DRAW);
     SSD1306_UpdateScreen();
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+/**
+* \file            tasks.c
+* \date            10/19/2026
+* \brief           Task table of the application, run by the scheduler
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "tasks.h"
+#include <stddef.h>
+#include "alarm.h"
+#include "boot.h"
+#include "clock.h"
+#include "editor.h"
+#include "idle.h"
+#include "irq_monitor.h"
+#include "key.h"
+#include "key_queue.h"
+#include "nvic.h"
+#include "profile.h"
+#include "random.h"
+#include "scheduler.h"
+#include "screen.h"
+#include "soft_timer.h"
+#include "temperature.h"
+#include "timer3.h"
+#include "voice.h"
+#include "voice_catalog.h"
+
+/*
+ * Periods follow what each task serves: the keys every TIM3 tick so a click is handled the tick
+ * it is recognized, the DFPlayer faster than it answers, the editor faster than its quickest
+ * repeat, the screen at 20 frames per second and the clock well within the second it shows.
+ * The phases keep the short periods from lining up on the same tick. A budget is the time a
+ * run normally takes with some margin, a run sending a DFPlayer command (10 bytes at 9600 baud)
+ * or reading the DS18B20 is accounted for where the task does that on its own.
+ *
+ * The SCHEDULER_POLL tasks have work only after a key interrupt or while their module holds the
+ * MCU out of STOP (see idle.h), so the clock, the temperature, the report and the software timers
+ * alone pace a STOP. The timers task is released at the next expiry by soft_timer.c, its period
+ * is only a backstop.
+ */
+
+static void tasks_keys(void);
+static void tasks_timers(void);
+static void tasks_temperature(void);
+static void tasks_report(void);
+static void tasks_boot(void);
+
+static const scheduler_task_t tasks_table[] = {
+    [TASK_KEYS]        = {"keys",        tasks_keys,          5,     0,     1000,  0, SCHEDULER_POLL},
+    [TASK_VOICE]       = {"voice",       voice_process,       10,    1,     12000, 1, SCHEDULER_POLL},
+    [TASK_EDITOR]      = {"editor",      editor_process,      10,    2,     200,   1, SCHEDULER_POLL},
+    [TASK_TIMERS]      = {"timers",      tasks_timers,        60000, 5,     2000,  1, 0},
+    [TASK_CLOCK]       = {"clock",       clock_update,        250,   3,     500,   2, 0},
+    [TASK_ALARM]       = {"alarm",       alarm_process,       100,   4,     12000, 2, SCHEDULER_POLL},
+    [TASK_RENDER]      = {"render",      screen_update,       50,    7,     12000, 3, SCHEDULER_POLL},
+    [TASK_TEMPERATURE] = {"temperature", tasks_temperature,   1000,  11,    3000,  4, 0},
+    [TASK_REPORT]      = {"report",      tasks_report,        60000, 60000, 60000, 5, 0},
+    [TASK_BOOT]        = {"boot",        tasks_boot,          10,    0,     12000, 1, SCHEDULER_POLL},
+};
+_Static_assert(sizeof(tasks_table) / sizeof(tasks_table[0]) == TASK_NUM, "tasks_table does not match tasks_id_t");
+
+static scheduler_stats_t tasks_stats[TASK_NUM];
+
+/*
+ * The bring-up, in the order the steps start when nothing holds them back. The first frame only
+ * needs the clock and the panel, so it goes out before the DFPlayer is sent its first command
+ * (10 ms at 9600 baud), and the 2 s the DFPlayer takes to read the TF card run alongside the
+ * tasks. The time base and the NVIC grouping are up before, the timeline counts from the former.
+ */
+
+static void tasks_random(void);
+static void tasks_voice(void);
+static coroutine_status_t tasks_catalog(void);
+static void tasks_nvic(void);
+
+/* Bit of a step in the `after` of another */
+#define TASKS_AFTER(step) BOOT_STEP(TASK_STEP_##step)
+
+static const boot_step_t tasks_steps[] = {
+    [TASK_STEP_IDLE]    = {"idle",    0,                                                          idle_init,          NULL},
+    [TASK_STEP_TIMER3]  = {"timer3",  0,                                                          timer3_init,        NULL},
+    [TASK_STEP_KEYS]    = {"keys",    TASKS_AFTER(TIMER3),                                        key_init,           NULL},
+    [TASK_STEP_CLOCK]   = {"clock",   0,                                                          clock_init,         NULL},
+    [TASK_STEP_RANDOM]  = {"random",  TASKS_AFTER(CLOCK),                                         tasks_random,       NULL},
+    [TASK_STEP_SCREEN]  = {"screen",  0,                                                          screen_init,        NULL},
+    [TASK_STEP_FRAME]   = {"frame",   TASKS_AFTER(CLOCK) | TASKS_AFTER(SCREEN),                   screen_update,      NULL},
+    [TASK_STEP_VOICE]   = {"voice",   0,                                                          tasks_voice,        df_init_process},
+    [TASK_STEP_CATALOG] = {"catalog", TASKS_AFTER(VOICE),                                         voice_catalog_init, tasks_catalog},
+    [TASK_STEP_NVIC]    = {"nvic",    TASKS_AFTER(IDLE) | TASKS_AFTER(KEYS) | TASKS_AFTER(VOICE), tasks_nvic,         NULL},
+};
+_Static_assert(sizeof(tasks_steps) / sizeof(tasks_steps[0]) == TASK_STEP_NUM, "tasks_steps does not match tasks_step_t");
+
+/* The steps the tasks need, all but those waiting on the DFPlayer */
+#define TASKS_STEPS_TASKS (BOOT_STEP(TASK_STEP_VOICE) - 1)
+
+static boot_time_t tasks_times[TASK_STEP_NUM];
+
+/**
+ * \brief           Seed the random numbers from the time read at boot
+ */
+static void
+tasks_random(void) {
+    random_init((uint32_t)clock_day << 24 | (uint32_t)clock_hour << 16 | clock_minute << 8 | clock_second);
+}
+
+/**
+ * \brief           Start the DFPlayer reading the TF card, the voice task drops its work until it is done
+ */
+static void
+tasks_voice(void) {
+    voice_init(20);
+}
+
+/**
+ * \brief           Wait for the track counts of the folders, from the TF card or the fallbacks
+ * \note            The scan ends in \ref VOICE_CATALOG_FALLBACK when the module or the card does not answer, the boot
+ *                  is over then as well.
+ */
+static coroutine_status_t
+tasks_catalog(void) {
+    return voice_catalog_get_status() != VOICE_CATALOG_SCANNING ? COROUTINE_DONE : COROUTINE_WAITING;
+}
+
+/**
+ * \brief           Check the NVIC once every module enabled its interrupts
+ */
+static void
+tasks_nvic(void) {
+    nvic_verify();
+}
+
+/**
+ * \brief           Handle the key events, and draw what they changed without waiting for the frame
+ */
+static void
+tasks_keys(void) {
+    static uint32_t handled;
+    key_queue_stats_t stats;
+
+    key_process();
+    key_queue_get_stats(&stats);
+    if (stats.handled != handled) {
+        handled = stats.handled;
+        scheduler_release(TASK_RENDER);
+    }
+}
+
+/**
+ * \brief           Call back the software timers that expired
+ */
+static void
+tasks_timers(void) {
+    soft_timer_process();
+}
+
+/**
+ * \brief           Bring the timers task forward to the next expiry
+ */
+static void
+tasks_timers_wake(uint32_t ms) {
+    scheduler_release_in(TASK_TIMERS, ms);
+}
+
+/**
+ * \brief           Sample the temperature, coming back every millisecond while a bus transaction waits
+ */
+static void
+tasks_temperature(void) {
+    if (temperature_process() == COROUTINE_WAITING) {
+        scheduler_release_in(TASK_TEMPERATURE, 1);
+    }
+}
+
+/**
+ * \brief           Log the instrumentation of the scheduler, the idle residency, the interrupts and the profile points
+ */
+static void
+tasks_report(void) {
+    scheduler_report();
+    idle_report();
+    irq_monitor_report();
+#if PROFILE_CFG_ENABLE
+    profile_dump();
+#endif /* PROFILE_CFG_ENABLE */
+}
+
+/**
+ * \brief           Drive the steps of the bring-up still waiting, and log the timeline once they are done
+ */
+static void
+tasks_boot(void) {
+    if (boot_process() == COROUTINE_DONE) {
+        boot_report();
+    }
+}
+
+void
+tasks_init(void) {
+    boot_init(tasks_steps, tasks_times, TASK_STEP_NUM);
+    while (!boot_is_done(TASKS_STEPS_TASKS)) {
+        boot_process();
+    }
+    scheduler_init(tasks_table, tasks_stats, TASK_NUM);
+    soft_timer_set_wake_callback(tasks_timers_wake);
+}
@@ -0,0 +1,241 @@
+/**
+* \file            temperature.c
+* \date            10/19/2026
+* \brief           Temperature history and trend
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "temperature.h"
+#include "../../config/temperature_cfg.h"
+#include "counter.h"
+#include "ds18b20.h"
+
+#define LOG_TAG "TEMPERATURE"
+#include "elog.h"
+
+#define TEMPERATURE_SLOT_MS ((int64_t)TEMPERATURE_CFG_SAMPLE_MS * TEMPERATURE_CFG_SLOT_SAMPLES)
+
+/* Time a conversion of the DS18B20 takes at 12 bits */
+#define TEMPERATURE_CONVERT_MS 750
+
+_Static_assert(TEMPERATURE_CFG_SLOTS >= 1 && TEMPERATURE_CFG_SLOTS <= 255, "TEMPERATURE_CFG_SLOTS out of 1 ~ 255");
+_Static_assert(TEMPERATURE_CFG_SLOT_SAMPLES >= 1 && TEMPERATURE_CFG_SLOT_SAMPLES <= 255,
+               "TEMPERATURE_CFG_SLOT_SAMPLES out of 1 ~ 255");
+_Static_assert(TEMPERATURE_CFG_TREND_SLOTS >= 2 && TEMPERATURE_CFG_TREND_SLOTS <= TEMPERATURE_CFG_SLOTS,
+               "TEMPERATURE_CFG_TREND_SLOTS out of 2 ~ TEMPERATURE_CFG_SLOTS");
+_Static_assert(TEMPERATURE_CFG_TREND_STOP < TEMPERATURE_CFG_TREND_START, "The trend would never stop");
+
+static int16_t temperature_slots[TEMPERATURE_CFG_SLOTS]; /*!< Ring of the history, 1/16 degree */
+static int32_t temperature_sum;                          /*!< Sum of the history */
+static int32_t temperature_trend_y;                      /*!< Sum of y over the trend slots */
+static int32_t temperature_trend_xy;                     /*!< Sum of x * y over the trend slots, x = 0 is the oldest */
+static int32_t temperature_pending;                      /*!< Sum of the readings of the slot being filled */
+static int16_t temperature_min, temperature_max;         /*!< Extremes of the history */
+static uint8_t temperature_head;                         /*!< Slot written next */
+static uint8_t temperature_count;                        /*!< Slots in the history */
+static uint8_t temperature_pending_count;                /*!< Readings of the slot being filled */
+static uint8_t temperature_trend;                        /*!< Current `temperature_trend_t` */
+static uint8_t temperature_event;                        /*!< Trend started and not taken yet */
+
+/**
+ * \brief           Divide rounding to the nearest, halves away from zero
+ */
+static int32_t
+temperature_div_round(int32_t a, int32_t b) {
+    return a >= 0 ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+/**
+ * \brief           Get the least-squares slope of the trend slots
+ *
+ * With n slots at x = 0 ~ n-1, Σx and Σx² only depend on n and Σy, Σxy are kept up to date by
+ * temperature_push, so the fit costs the same whatever the window.
+ *
+ * \return          Slope in 1/16 degree per hour
+ */
+static int16_t
+temperature_slope(void) {
+    int32_t n = temperature_count < TEMPERATURE_CFG_TREND_SLOTS ? temperature_count : TEMPERATURE_CFG_TREND_SLOTS;
+    int32_t sx, sxx;
+    int64_t num, den;
+
+    if (n < 2) {
+        return 0;
+    }
+    sx = n * (n - 1) / 2;
+    sxx = (n - 1) * n * (2 * n - 1) / 6;
+    num = (int64_t)n * temperature_trend_xy - (int64_t)sx * temperature_trend_y;
+    den = (int64_t)n * sxx - (int64_t)sx * sx;
+    return (int16_t)(num * 3600000 / (den * TEMPERATURE_SLOT_MS));
+}
+
+/**
+ * \brief           Update the trend, with a hysteresis between TEMPERATURE_CFG_TREND_START and _STOP
+ */
+static void
+temperature_update_trend(void) {
+    int16_t slope;
+
+    if (temperature_count < TEMPERATURE_CFG_TREND_SLOTS) {
+        return;
+    }
+    slope = temperature_slope();
+    if ((temperature_trend == TEMPERATURE_COOLING && slope > -TEMPERATURE_CFG_TREND_STOP)
+        || (temperature_trend == TEMPERATURE_WARMING && slope < TEMPERATURE_CFG_TREND_STOP)) {
+        temperature_trend = TEMPERATURE_STEADY;
+    }
+    if (temperature_trend == TEMPERATURE_STEADY) {
+        if (slope <= -TEMPERATURE_CFG_TREND_START) {
+            temperature_trend = temperature_event = TEMPERATURE_COOLING;
+        } else if (slope >= TEMPERATURE_CFG_TREND_START) {
+            temperature_trend = temperature_event = TEMPERATURE_WARMING;
+        }
+        if (temperature_trend != TEMPERATURE_STEADY) {
+            log_i("%s at %d/16 degree per hour", temperature_trend == TEMPERATURE_COOLING ? "Cooling" : "Warming",
+                  slope);
+        }
+    }
+}
+
+/**
+ * \brief           Append a slot to the history, evicting the oldest once full
+ * \param[in]       y: Temperature of the slot
+ */
+static void
+temperature_push(int16_t y) {
+    int16_t evicted = temperature_slots[temperature_head];
+    uint8_t full = temperature_count == TEMPERATURE_CFG_SLOTS;
+    uint8_t x = temperature_count < TEMPERATURE_CFG_TREND_SLOTS ? temperature_count : TEMPERATURE_CFG_TREND_SLOTS;
+    uint8_t i;
+
+    /* The oldest trend slot leaves the window and the others move one x down: Σxy loses Σy of the rest */
+    if (x == TEMPERATURE_CFG_TREND_SLOTS) {
+        int16_t oldest =
+            temperature_slots[(temperature_head + TEMPERATURE_CFG_SLOTS - TEMPERATURE_CFG_TREND_SLOTS) % TEMPERATURE_CFG_SLOTS];
+        temperature_trend_y -= oldest;
+        temperature_trend_xy -= temperature_trend_y;
+        x--;
+    }
+    temperature_trend_y += y;
+    temperature_trend_xy += (int32_t)x * y;
+
+    temperature_slots[temperature_head] = y;
+    temperature_head = (temperature_head + 1) % TEMPERATURE_CFG_SLOTS;
+    temperature_sum += y;
+    if (full) {
+        temperature_sum -= evicted;
+    } else {
+        temperature_count++;
+    }
+
+    if (temperature_count == 1) {
+        temperature_min = temperature_max = y;
+    } else if (full && (evicted <= temperature_min || evicted >= temperature_max)) {
+        /* An extreme left, only then the history is scanned again */
+        temperature_min = temperature_max = y;
+        for (i = 0; i < TEMPERATURE_CFG_SLOTS; i++) {
+            if (temperature_slots[i] < temperature_min) {
+                temperature_min = temperature_slots[i];
+            }
+            if (temperature_slots[i] > temperature_max) {
+                temperature_max = temperature_slots[i];
+            }
+        }
+    } else if (y < temperature_min) {
+        temperature_min = y;
+    } else if (y > temperature_max) {
+        temperature_max = y;
+    }
+
+    temperature_update_trend();
+}
+
+coroutine_status_t
+temperature_process(void) {
+    static coroutine_t co, step;
+    static uint32_t converted_ms, sampled_ms;
+    static uint8_t converting, sampled;
+    static float t;
+
+    COROUTINE_BEGIN(&co);
+    if (converting && counter_get_ms() - converted_ms < TEMPERATURE_CONVERT_MS) {
+        COROUTINE_EXIT(&co);
+    }
+    /* Every reading refreshes ds18b20_get_t, only one per sample period goes to the history */
+    if (converting) {
+        COROUTINE_CALL(&co, &step, ds18b20_read_t(&step, &t));
+        if (ds18b20_is_present() && (!sampled || counter_get_ms() - sampled_ms >= TEMPERATURE_CFG_SAMPLE_MS)) {
+            temperature_add((int16_t)(t * 16));
+            sampled_ms = counter_get_ms();
+            sampled = 1;
+        }
+    }
+    converted_ms = counter_get_ms();
+    COROUTINE_CALL(&co, &step, ds18b20_convert_t(&step));
+    converting = 1;
+    COROUTINE_END(&co);
+}
+
+void
+temperature_add(int16_t t) {
+    temperature_pending += t;
+    if (++temperature_pending_count < TEMPERATURE_CFG_SLOT_SAMPLES) {
+        return;
+    }
+    temperature_push((int16_t)temperature_div_round(temperature_pending, temperature_pending_count));
+    temperature_pending = 0;
+    temperature_pending_count = 0;
+}
+
+void
+temperature_get_stats(temperature_stats_t* stats) {
+    if (temperature_count == 0) {
+        *stats = (temperature_stats_t){0};
+        return;
+    }
+    stats->min = temperature_min;
+    stats->max = temperature_max;
+    stats->mean = (int16_t)temperature_div_round(temperature_sum, temperature_count);
+    stats->slope = temperature_slope();
+    stats->slots = temperature_count;
+}
+
+temperature_trend_t
+temperature_get_trend(void) {
+    return (temperature_trend_t)temperature_trend;
+}
+
+temperature_trend_t
+temperature_take_event(void) {
+    temperature_trend_t event = (temperature_trend_t)temperature_event;
+
+    temperature_event = TEMPERATURE_STEADY;
+    return event;
+}
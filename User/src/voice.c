@@ -34,17 +34,41 @@
 
 #include "voice.h"
 #include "../../config/voice_cfg.h"
-#include "clock.h"
+#include "announcer.h"
+#include "counter.h"
 #include "dfplayer_mini.h"
+#include "idle.h"
+#include "playlist.h"
+#include "temperature.h"
+#include "volume.h"
+#include "voice_catalog.h"
+#include "voice_category.h"
 
 #define LOG_TAG "VOICE"
 #include "elog.h"
 
+/*
+ * The DFPlayer often reports the end of a track twice in a row, a few milliseconds apart.
+ * Keep the window shorter than the shortest clip, the announcer may play one twice in a row.
+ */
+#define VOICE_FINISHED_REPEAT_MS 200
+/* The DFPlayer rejects an advert right away, past this delay it is playing */
+#define VOICE_ADVERT_REPLY_MS    500
+/* The DFPlayer answers a command well within this, until then the UART must not STOP */
+#define VOICE_REPLY_MS           1000
+
 /* Static variables */
 static voice_status_t voice_status;       /*!< Current voice status */
-static uint8_t voice_volume;               /*!< Current voice volume */
 
-static int8_t voice_music_now = 1;        /*!< Current playing music index */
+/*
+ * What the DFPlayer is playing. The module has a single output, so every voice line and
+ * music command goes through this state: it decides whether a line is interjected as an
+ * advert, and what to do when a track ends.
+ */
+static voice_audio_t voice_audio = VOICE_AUDIO_IDLE;
+static uint8_t voice_line_folder;          /*!< Folder of the interjected voice line */
+static uint8_t voice_line_number;          /*!< Number of the interjected voice line */
+static uint32_t voice_advert_time;         /*!< When the advert command was sent */
 
 /**
 * \brief           Say a phrase from the specified voice category and number.
@@ -53,21 +77,96 @@ static int8_t voice_music_now = 1;        /*!< Current playing music index */
 */
 static void
 voice_say(uint8_t category, uint8_t number) {
-   if (voice_status == VOICE_OFF) {
+   if (voice_status == VOICE_OFF || number == 0) {
        return;
    }
+   announcer_stop();
+
+   if (voice_audio == VOICE_AUDIO_MUSIC || voice_audio == VOICE_AUDIO_ADVERT) {
+#if VOICE_ADVERT_ENABLE
+       uint16_t advert = VOICE_ADVERT_TRACK(category, number);
+       if (advert != 0) {
+           voice_line_folder = category;
+           voice_line_number = number;
+           voice_advert_time = counter_get_ms();
+           voice_audio = VOICE_AUDIO_ADVERT;
+           df_play_advert(advert);
+           log_i("df_play_advert(%d) Invoked", advert);
+           return;
+       }
+#endif /* VOICE_ADVERT_ENABLE */
+       voice_audio = VOICE_AUDIO_LINE_OVER_MUSIC;
+   } else if (voice_audio != VOICE_AUDIO_LINE_OVER_MUSIC) {
+       voice_audio = VOICE_AUDIO_LINE;
+   }
    df_play_from_folder(category, number);
    log_i("df_play_from_folder(%d, %d) Invoked", category, number);
 }
 
 /**
-* \brief           Generate a random number within the given range.
-* \param[in]       number: Maximum value for the random number
-* \return          Random number within the range [1, number]
+* \brief           Say the interjected voice line on its own after the module refused the advert.
+*/
+static void
+voice_advert_fallback(void) {
+   log_w("Advert refused, stop the music for the voice line");
+   voice_audio = VOICE_AUDIO_LINE_OVER_MUSIC;
+   df_play_from_folder(voice_line_folder, voice_line_number);
+}
+
+/**
+* \brief           Move on once the track or the voice line being played has ended.
+*/
+static void
+voice_on_finished(void) {
+   if (announcer_on_finished()) {
+       return;
+   }
+
+   switch (voice_audio) {
+       case VOICE_AUDIO_MUSIC:
+       case VOICE_AUDIO_ADVERT:
+           voice_audio = playlist_on_finished() ? VOICE_AUDIO_MUSIC : VOICE_AUDIO_IDLE;
+           break;
+       case VOICE_AUDIO_LINE_OVER_MUSIC:
+           /* The module cannot seek, the track starts over */
+           playlist_play();
+           voice_audio = VOICE_AUDIO_MUSIC;
+           break;
+       case VOICE_AUDIO_LINE: voice_audio = VOICE_AUDIO_IDLE; break;
+       default: break;
+   }
+}
+
+/**
+* \brief           Say a line picked among the categories of some groups.
+* \param[in]       groups: `VOICE_GROUP()` flags
 */
-static uint8_t
-voice_random(uint8_t number) {
-   return (clock_second + clock_minute + clock_hour) % number + 1;
+static void
+voice_say_group(uint16_t groups) {
+   voice_line_t line;
+
+   if (voice_status == VOICE_OFF) {
+       return;
+   }
+   if (voice_category_pick(groups, &line)) {
+       voice_say(line.folder, line.number);
+   }
+}
+
+/**
+* \brief           Speak about the weather when the room starts cooling down or warming up.
+* \param[in]       trend: The trend that started
+*/
+static void
+voice_on_temperature(temperature_trend_t trend) {
+   uint8_t folder = trend == TEMPERATURE_COOLING ? VOICE_WEATHER_COOL_DOWN : VOICE_WEATHER_SUNNY;
+
+   /* Nobody asked, so only over silence or music and not at night */
+   if ((voice_audio != VOICE_AUDIO_IDLE && voice_audio != VOICE_AUDIO_MUSIC)
+       || (voice_category_context() & (VOICE_WHEN_MIDNIGHT | VOICE_WHEN_SLEEP_TIME))) {
+       return;
+   }
+   voice_say(folder, voice_category_line(folder));
 }
 
 /**
@@ -75,14 +174,7 @@ voice_random(uint8_t number) {
 */
 void
 voice_weather(void) {
-   uint8_t scene = VOICE_DEFAULT;
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
-   // Replace 天气判断 with your actual weather condition check
-   // if (/*天气判断*/) {
-   //     scene = VOICE_WEATHER_RAIN; // Or VOICE_WEATHER_SUNNY, etc.
-   //     number = voice_random(VOICE_WEATHER_NUM);
-   // }
-   voice_say(scene, number);
+   voice_say_group(VOICE_GROUP(VOICE_WEATHER_BASE));
 }
 
 /**
@@ -90,20 +182,7 @@ voice_weather(void) {
 */
 void
 voice_scene(void) {
-   uint8_t scene = VOICE_DEFAULT;
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
-   if (clock_is_sleep_time()) {
-       scene = VOICE_TIME_MIDNIGHT;
-       number = voice_random(VOICE_TIME_MIDNIGHT_NUM);
-   } else if (clock_is_getup_time()) {
-       scene = VOICE_SCENE_WAKE_UP;
-       number = voice_random(VOICE_SCENE_WAKE_UP);
-   }
-   // else if (/*任务完成*/) {
-   //     scene = VOICE_SCENE_MISSION_ACCOMPLISHED;
-   //     number = voice_random(VOICE_SCENE_NUM);
-   // }
-   voice_say(scene, number);
+   voice_say_group(VOICE_GROUP(VOICE_SCENE_BASE));
 }
 
 /**
@@ -111,7 +190,7 @@ voice_scene(void) {
 */
 void
 voice_chat(void) {
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
+   uint8_t number = voice_category_line(VOICE_INTERACTION_CHAT);
    voice_say(VOICE_INTERACTION_CHAT, number);
 }
 
@@ -120,23 +199,7 @@ voice_chat(void) {
 */
 void
 voice_day_of_time(void) {
-   uint8_t scene = VOICE_DEFAULT;
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
-   if (clock_time_of_day == CLOCK_MORNING) {
-       scene = VOICE_TIME_MORNING_GREETING;
-       number = voice_random(VOICE_TIME_MORNING_GREETING_NUM);
-   } else if (clock_time_of_day == CLOCK_AFTERNOON) {
-       // Handle afternoon
-   } else if (clock_time_of_day == CLOCK_DUSK) {
-       // Handle dusk
-   } else if (clock_time_of_day == CLOCK_EVENING) {
-       scene = VOICE_TIME_EVENING;
-       number = voice_random(VOICE_TIME_EVENING_NUM);
-   } else if (clock_time_of_day == CLOCK_MIDNIGHT) {
-       scene = VOICE_TIME_MIDNIGHT;
-       number = voice_random(VOICE_TIME_MIDNIGHT_NUM);
-   }
-   voice_say(scene, number);
+   voice_say_group(VOICE_GROUP(VOICE_TIME_BASE));
 }
 
 /**
@@ -144,54 +207,43 @@ voice_day_of_time(void) {
 */
 void
 voice_season(void) {
-   uint8_t scene = VOICE_DEFAULT;
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
-   if (clock_season == CLOCK_WINTER) {
-       scene = VOICE_SEASON_WINTER;
-       number = voice_random(VOICE_SEASON_WINTER_NUM);
-   }
-   voice_say(scene, number);
+   voice_say_group(VOICE_GROUP(VOICE_SEASON_BASE));
 }
 
 /**
-* \brief           Speak about a birthday event.
-* \param[in]       meOrAlysia: Specify whose birthday event to speak about (0 for Elysia, 1 for the user)
+* \brief           Speak about a birthday event, the triggers of VOICE_CATEGORY_LIST tell whose birthday it is.
 */
 void
-voice_birthday(uint8_t meOrAlysia) {
-   uint8_t scene = VOICE_DEFAULT;
-   uint8_t number = voice_random(VOICE_INTERACTION_CHAT_NUM);
-   if (meOrAlysia == 0 && clock_is_elysia_birthday()) {
-       scene = VOICE_MISC_CHARACTER_BIRTHDAY;
-       number = voice_random(VOICE_MISC_CHARACTER_BIRTHDAY_NUM);
-   } else if (meOrAlysia == 1 && clock_is_my_birthday()) {
-       scene = VOICE_MISC_BIRTHDAY;
-       number = voice_random(VOICE_MISC_BIRTHDAY_NUM);
-   }
-   voice_say(scene, number);
+voice_birthday(void) {
+   voice_say_group(VOICE_GROUP(VOICE_MISC_BASE));
 }
 
 /**
-* \brief           Randomly invoke one of the voice-related functions.
+* \brief           Say a line picked among every category that can be said right now.
 */
 void
 voice_invoke(void) {
-   /* Randomly select the function to trigger */
-   int randomFunction = voice_random(5); // Select a random number between 0 and 5
-
-   /* Call the corresponding function based on the random number */
-   switch (randomFunction) {
-       case 0: voice_weather(); break;
-       case 1: voice_scene(); break;
-       case 2: voice_chat(); break;
-       case 3: voice_day_of_time(); break;
-       case 4: voice_season(); break;
-       case 5:
-           voice_birthday(0); /* Pass 0 to trigger character's birthday */
-           voice_birthday(1);
-           break;
-           /* Add cases for other functions to trigger, if any */
-       default: voice_chat();
+   voice_say_group(VOICE_GROUP_ALL);
+}
+
+/**
+* \brief           Announce the time, and the temperature, with the talking clock clips.
+* \param[in]       phrase: Phrase to say
+*/
+void
+voice_announce(announcer_phrase_t phrase) {
+   if (voice_status == VOICE_OFF) {
+       return;
+   }
+
+   /* The clips follow each other on track-finished frames, which adverts do not send */
+   if (voice_audio == VOICE_AUDIO_MUSIC || voice_audio == VOICE_AUDIO_ADVERT) {
+       voice_audio = VOICE_AUDIO_LINE_OVER_MUSIC;
+   } else if (voice_audio != VOICE_AUDIO_LINE_OVER_MUSIC) {
+       voice_audio = VOICE_AUDIO_LINE;
+   }
+   if (!announcer_start(phrase)) {
+       voice_on_finished();
    }
 }
 
@@ -212,47 +264,44 @@ voice_off(void) {
 }
 
 /**
-* \brief           Set the volume of the voice module.
+* \brief           Set the volume of the voice module, cancelling a volume ramp.
 * \param[in]       volume: New volume level
 */
 void
 voice_set_volume(uint16_t volume) {
-   voice_volume = volume;
-   df_set_volume(volume);
+   volume_set(volume > VOICE_VOLUME_MAX ? VOICE_VOLUME_MAX : (uint8_t)volume);
 }
 
 /**
-* \brief           Increase the volume of the voice module.
+* \brief           Increase the volume of the voice module, cancelling a volume ramp.
 */
 void
 voice_volume_increase(void) {
-   if (voice_volume == VOICE_VOLUME_MAX) {
-       return;
-   }
-   voice_volume++;
-   df_set_volume(voice_volume);
+   volume_step(1);
 }
 
 /**
-* \brief           Decrease the volume of the voice module.
+* \brief           Decrease the volume of the voice module, cancelling a volume ramp.
 */
 void
 voice_volume_decrease(void) {
-   if (voice_volume == 0) {
-       return;
-   }
-   voice_volume--;
-   df_set_volume(voice_volume);
+   volume_step(-1);
 }
 
 /* Music handler functions */
 /**
-* \brief           Play the currently selected music.
+* \brief           Play the currently selected music, unless it is already playing.
 */
 void
 voice_music_play(void) {
    log_i("voice_music_play invoked");
-   df_play_from_folder(VOICE_MUSIC_RESOURCE, voice_music_now);
+   if (voice_audio == VOICE_AUDIO_MUSIC || voice_audio == VOICE_AUDIO_ADVERT
+       || voice_audio == VOICE_AUDIO_LINE_OVER_MUSIC) {
+       return;
+   }
+   announcer_stop();
+   playlist_play();
+   voice_audio = VOICE_AUDIO_MUSIC;
 }
 
 /**
@@ -261,7 +310,11 @@ voice_music_play(void) {
 void
 voice_music_pause(void) {
    log_i("voice_music_pause invoked");
+   if (voice_audio != VOICE_AUDIO_MUSIC && voice_audio != VOICE_AUDIO_ADVERT) {
+       return;
+   }
    df_pause();
+   voice_audio = VOICE_AUDIO_MUSIC_PAUSED;
 }
 
 /**
@@ -270,7 +323,24 @@ voice_music_pause(void) {
 void
 voice_music_continue(void) {
    log_i("voice_music_continue invoked");
+   if (voice_audio != VOICE_AUDIO_MUSIC_PAUSED) {
+       return;
+   }
    df_continue();
+   voice_audio = VOICE_AUDIO_MUSIC;
+}
+
+/**
+* \brief           Pause the music if it is playing, otherwise continue or start it.
+*/
+void
+voice_music_play_pause(void) {
+   switch (voice_audio) {
+       case VOICE_AUDIO_MUSIC:
+       case VOICE_AUDIO_ADVERT: voice_music_pause(); break;
+       case VOICE_AUDIO_MUSIC_PAUSED: voice_music_continue(); break;
+       default: voice_music_play(); break;
+   }
 }
 
 /**
@@ -279,11 +349,9 @@ voice_music_continue(void) {
 void
 voice_music_next(void) {
    log_i("voice_music_next invoked");
-   voice_music_now++;
-   if (voice_music_now > VOICE_MUSIC_NUM) {
-       voice_music_now = 1;
-   }
-   df_play_from_folder(VOICE_MUSIC_RESOURCE, voice_music_now);
+   announcer_stop();
+   playlist_next();
+   voice_audio = VOICE_AUDIO_MUSIC;
 }
 
 /**
@@ -292,21 +360,91 @@ voice_music_next(void) {
 void
 voice_music_previous(void) {
    log_i("voice_music_previous invoked");
-   voice_music_now--;
-   if (voice_music_now < 1) {
-       voice_music_now = VOICE_MUSIC_NUM;
-   }
-   df_play_from_folder(VOICE_MUSIC_RESOURCE, voice_music_now);
+   announcer_stop();
+   playlist_previous();
+   voice_audio = VOICE_AUDIO_MUSIC;
+}
+
+/**
+* \brief           Switch to the next playlist mode.
+*/
+void
+voice_music_switch_mode(void) {
+   playlist_set_mode((playlist_get_mode() + 1) % PLAYLIST_MODE_NUM);
 }
 /* Music handler functions end */
 
+/**
+* \brief           Get what the DFPlayer is playing.
+* \return          Current audio state
+*/
+voice_audio_t
+voice_get_audio(void) {
+   return voice_audio;
+}
+
 /**
 * \brief           Initialize the voice module with the specified volume.
 * \param[in]       volume: Initial volume level
 */
 void
 voice_init(uint8_t volume) {
-   voice_volume = volume;
    df_init(volume);
+   volume_init(volume);
+   playlist_init();
    voice_status = VOICE_ON;
 }
+
+/**
+* \brief           Dispatch the frames received from the DFPlayer and drive the background tasks.
+*/
+void
+voice_process(void) {
+   static uint16_t finished_track;
+   static uint32_t finished_time;
+   df_response_t response;
+   temperature_trend_t trend;
+
+   /* The DFPlayer reads the TF card first, the boot task brings it and the catalog up (see tasks.c) */
+   if (!df_is_ready()) {
+       return;
+   }
+
+   while (df_read_response(&response)) {
+       if (voice_catalog_on_response(&response)) {
+           continue;
+       }
+       if (response.cmd == DF_RESPONSE_TF_FINISHED) {
+           uint32_t now = counter_get_ms();
+           if (response.param == finished_track && now - finished_time < VOICE_FINISHED_REPEAT_MS) {
+               continue;
+           }
+           finished_track = response.param;
+           finished_time = now;
+           voice_on_finished();
+           continue;
+       }
+       if (response.cmd == DF_RESPONSE_ERROR && voice_audio == VOICE_AUDIO_ADVERT
+           && (response.param == DF_ERROR_NOT_FOUND || response.param == DF_ERROR_INSERTION)) {
+           voice_advert_fallback();
+           continue;
+       }
+       log_d("Unhandled DFPlayer frame %02X(%d)", response.cmd, response.param);
+   }
+
+   if (voice_audio == VOICE_AUDIO_ADVERT && counter_get_ms() - voice_advert_time >= VOICE_ADVERT_REPLY_MS) {
+       voice_audio = VOICE_AUDIO_MUSIC;
+   }
+
+   trend = temperature_take_event();
+   if (trend != TEMPERATURE_STEADY) {
+       voice_on_temperature(trend);
+   }
+   volume_process();
+
+   /* A track ends with a frame from the DFPlayer, the UART misses it in STOP, a paused one sends none */
+   idle_hold(IDLE_CLIENT_VOICE, (voice_audio != VOICE_AUDIO_IDLE && voice_audio != VOICE_AUDIO_MUSIC_PAUSED)
+                                    || df_get_idle_ms() < VOICE_REPLY_MS
+                                    || volume_get_ramp() == VOLUME_RAMP_RUNNING || !volume_is_applied()
+                                    || voice_catalog_get_status() == VOICE_CATALOG_SCANNING);
+}
@@ -0,0 +1,308 @@
+/**
+* \file            voice_catalog.c
+* \date            10/19/2026
+* \brief           Catalog of the voice folders on the TF card
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "voice_catalog.h"
+#include "../../config/voice_cfg.h"
+#include "soft_timer.h"
+
+#define LOG_TAG "VOICE_CATALOG"
+#include "elog.h"
+
+/**
+ * \brief           Calculate length of statically allocated array
+ */
+#define ARRAY_LEN(x)                (sizeof(x) / sizeof((x)[0]))
+
+/* A query is sent again if the module does not answer within this time */
+#define VOICE_CATALOG_TIMEOUT_MS    500
+/* Number of times a query is sent before giving up on it */
+#define VOICE_CATALOG_TRIES         3
+/* Scan step querying the total number of files, before the per-folder steps */
+#define VOICE_CATALOG_STEP_TF       0xFF
+
+/*
+ * The scan result is cached in the last flash page, which is excluded from the FLASH region
+ * in STM32F103C8Tx_FLASH.ld. The record is keyed by the total number of files on the TF card,
+ * so a warm boot with the same card content only needs a single query.
+ *
+ * Layout (half-words): magic, entry count, key, counts[entry count], checksum
+ */
+#define VOICE_CATALOG_CACHE_ADDR    0x0800FC00
+#define VOICE_CATALOG_CACHE_MAGIC   0xCA7A
+
+/**
+ * \brief           A voice folder and its compile-time number of tracks
+ */
+typedef struct voice_catalog_entry {
+    uint8_t folder;    /*!< Folder number on the TF card */
+    uint16_t fallback; /*!< Number of tracks used until the folder is scanned */
+} voice_catalog_entry_t;
+
+/* Expands one line of VOICE_CATEGORY_LIST into a catalog entry */
+#define VOICE_CATALOG_CATEGORY_ENTRY(folder, trigger, boost, weight, cooldown) {folder, folder##_NUM},
+/* Expands one line of VOICE_MUSIC_LIBRARY into a catalog entry */
+#define VOICE_CATALOG_MUSIC_ENTRY(type, folder, num) {folder, num},
+
+/* Every folder used by the voice module, folder 0 (the "MP3" folder) cannot be queried */
+static const voice_catalog_entry_t voice_catalog_entries[] = {
+    VOICE_CATEGORY_LIST(VOICE_CATALOG_CATEGORY_ENTRY)
+    VOICE_MUSIC_LIBRARY(VOICE_CATALOG_MUSIC_ENTRY)
+};
+
+#define VOICE_CATALOG_NUM ARRAY_LEN(voice_catalog_entries)
+
+/* Number of tracks of every entry, 2 bytes per folder */
+static uint16_t voice_catalog_counts[VOICE_CATALOG_NUM];
+
+static voice_catalog_status_t voice_catalog_status = VOICE_CATALOG_FALLBACK;
+static uint8_t voice_catalog_step;     /*!< Entry being queried, or \ref VOICE_CATALOG_STEP_TF */
+static uint8_t voice_catalog_tries;    /*!< Number of times the current query has been sent */
+static soft_timer_t voice_catalog_timer; /*!< Runs while a query waits for its answer */
+static uint16_t voice_catalog_key;     /*!< Total number of files on the TF card */
+static uint8_t voice_catalog_guessed;  /*!< A folder kept its compile-time count, the scan is not cached */
+
+static void voice_catalog_timeout(soft_timer_t* timer);
+
+/**
+ * \brief           Compute the checksum of a cache record
+ * \param[in]       key: Total number of files on the TF card
+ * \param[in]       counts: Number of tracks of every entry
+ * \return          Checksum covering the key, the folder layout and the counts
+ */
+static uint16_t
+voice_catalog_checksum(uint16_t key, const uint16_t* counts) {
+    uint16_t checksum = VOICE_CATALOG_CACHE_MAGIC + VOICE_CATALOG_NUM + key;
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        checksum = (checksum << 1 | checksum >> 15) ^ (voice_catalog_entries[i].folder << 8) ^ counts[i];
+    }
+    return checksum;
+}
+
+/**
+ * \brief           Load the cached counts if they were scanned from the same card content
+ * \param[in]       key: Total number of files on the TF card
+ * \return          1 if the cache was loaded, 0 otherwise
+ */
+static uint8_t
+voice_catalog_load(uint16_t key) {
+    const volatile uint16_t* cache = (const volatile uint16_t*)VOICE_CATALOG_CACHE_ADDR;
+    uint16_t counts[VOICE_CATALOG_NUM];
+
+    if (cache[0] != VOICE_CATALOG_CACHE_MAGIC || cache[1] != VOICE_CATALOG_NUM || cache[2] != key) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        counts[i] = cache[3 + i];
+    }
+    if (cache[3 + VOICE_CATALOG_NUM] != voice_catalog_checksum(key, counts)) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        voice_catalog_counts[i] = counts[i];
+    }
+    return 1;
+}
+
+/**
+ * \brief           Write the scanned counts to the flash cache
+ */
+static void
+voice_catalog_save(void) {
+    uint32_t addr = VOICE_CATALOG_CACHE_ADDR;
+    FLASH_Status status;
+
+    FLASH_Unlock();
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+    status = FLASH_ErasePage(VOICE_CATALOG_CACHE_ADDR);
+    if (status == FLASH_COMPLETE) {
+        FLASH_ProgramHalfWord(addr, VOICE_CATALOG_CACHE_MAGIC);
+        FLASH_ProgramHalfWord(addr += 2, VOICE_CATALOG_NUM);
+        FLASH_ProgramHalfWord(addr += 2, voice_catalog_key);
+        for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+            FLASH_ProgramHalfWord(addr += 2, voice_catalog_counts[i]);
+        }
+        status = FLASH_ProgramHalfWord(addr += 2, voice_catalog_checksum(voice_catalog_key, voice_catalog_counts));
+    }
+    FLASH_Lock();
+
+    if (status != FLASH_COMPLETE) {
+        log_w("Failed to cache the catalog (%d)", status);
+    }
+}
+
+/**
+ * \brief           Send the query of the current scan step
+ */
+static void
+voice_catalog_query(void) {
+    if (voice_catalog_step == VOICE_CATALOG_STEP_TF) {
+        df_query_tf_file_num();
+    } else {
+        df_query_file_num_from_folder(voice_catalog_entries[voice_catalog_step].folder);
+    }
+    soft_timer_start(&voice_catalog_timer, VOICE_CATALOG_TIMEOUT_MS, 0);
+    voice_catalog_tries++;
+}
+
+/**
+ * \brief           Move the scan to the given step, or finish it after the last folder
+ * \param[in]       step: Index of the next entry to query
+ */
+static void
+voice_catalog_goto(uint8_t step) {
+    voice_catalog_tries = 0;
+    while (step < VOICE_CATALOG_NUM && voice_catalog_entries[step].folder == 0) {
+        step++;
+    }
+    if (step >= VOICE_CATALOG_NUM) {
+        /* A cached guess would be loaded as the card content on every boot with the same card */
+        if (!voice_catalog_guessed) {
+            voice_catalog_save();
+        }
+        voice_catalog_status = VOICE_CATALOG_READY;
+        log_i("Catalog scanned, %d files on the card%s", voice_catalog_key,
+              voice_catalog_guessed ? ", not cached as some folders did not answer" : "");
+        return;
+    }
+    voice_catalog_step = step;
+    voice_catalog_query();
+}
+
+/**
+ * \brief           Start the asynchronous catalog scan
+ *
+ * The compile-time counts are used until the scan completes, and stay in use for
+ * every folder the module does not answer for.
+ */
+void
+voice_catalog_init(void) {
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        voice_catalog_counts[i] = voice_catalog_entries[i].fallback;
+    }
+    soft_timer_init(&voice_catalog_timer, voice_catalog_timeout);
+    voice_catalog_status = VOICE_CATALOG_SCANNING;
+    voice_catalog_step = VOICE_CATALOG_STEP_TF;
+    voice_catalog_tries = 0;
+    voice_catalog_guessed = 0;
+    voice_catalog_query();
+}
+
+/**
+ * \brief           Resend a timed out query, skip the folders the module does not answer for
+ * \param[in]       timer: \ref voice_catalog_timer
+ */
+static void
+voice_catalog_timeout(soft_timer_t* timer) {
+    (void)timer;
+    if (voice_catalog_status != VOICE_CATALOG_SCANNING) {
+        return;
+    }
+    if (voice_catalog_tries < VOICE_CATALOG_TRIES) {
+        voice_catalog_query();
+    } else if (voice_catalog_step == VOICE_CATALOG_STEP_TF) {
+        voice_catalog_status = VOICE_CATALOG_FALLBACK;
+        log_w("No answer from the module, using the compile-time catalog");
+    } else {
+        log_w("No answer for folder %d, keeping %d tracks", voice_catalog_entries[voice_catalog_step].folder,
+              voice_catalog_counts[voice_catalog_step]);
+        voice_catalog_guessed = 1;
+        voice_catalog_goto(voice_catalog_step + 1);
+    }
+}
+
+/**
+ * \brief           Consume the replies to the catalog queries
+ * \param[in]       response: Frame received from the module
+ * \return          1 if the frame was consumed, 0 otherwise
+ */
+uint8_t
+voice_catalog_on_response(const df_response_t* response) {
+    if (voice_catalog_status != VOICE_CATALOG_SCANNING) {
+        return 0;
+    }
+
+    if (voice_catalog_step == VOICE_CATALOG_STEP_TF) {
+        if (response->cmd != DF_RESPONSE_TF_FILE_NUM) {
+            return 0;
+        }
+        soft_timer_stop(&voice_catalog_timer);
+        voice_catalog_key = response->param;
+        if (voice_catalog_key == 0) {
+            voice_catalog_status = VOICE_CATALOG_FALLBACK;
+            log_w("TF card is empty or missing, using the compile-time catalog");
+        } else if (voice_catalog_load(voice_catalog_key)) {
+            voice_catalog_status = VOICE_CATALOG_READY;
+            log_i("Catalog loaded from cache, %d files on the card", voice_catalog_key);
+        } else {
+            voice_catalog_goto(0);
+        }
+        return 1;
+    }
+
+    if (response->cmd == DF_RESPONSE_FOLDER_FILE_NUM) {
+        voice_catalog_counts[voice_catalog_step] = response->param;
+    } else if (response->cmd == DF_RESPONSE_ERROR && response->param == DF_ERROR_NOT_FOUND) {
+        /* The folder does not exist on the card, other errors are retried on timeout */
+        voice_catalog_counts[voice_catalog_step] = 0;
+    } else {
+        return 0;
+    }
+    soft_timer_stop(&voice_catalog_timer);
+    voice_catalog_goto(voice_catalog_step + 1);
+    return 1;
+}
+
+/**
+ * \brief           Get the number of tracks in a voice folder
+ * \param[in]       folder: Folder number
+ * \return          Number of tracks, 0 if the folder is unknown or empty
+ */
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        if (voice_catalog_entries[i].folder == folder) {
+            return voice_catalog_counts[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Get the catalog scan status
+ * \return          The catalog scan status
+ */
+voice_catalog_status_t
+voice_catalog_get_status(void) {
+    return voice_catalog_status;
+}
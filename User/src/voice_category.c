@@ -0,0 +1,252 @@
+/**
+* \file            voice_category.c
+* \date            10/19/2026
+* \brief           Voice category registry and selection engine
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "voice_category.h"
+#include "../../config/voice_cfg.h"
+#include "alarm.h"
+#include "clock.h"
+#include "counter.h"
+#include "random.h"
+#include "shuffle.h"
+#include "temperature.h"
+#include "voice_catalog.h"
+
+#define LOG_TAG "VOICE_CATEGORY"
+#include "elog.h"
+
+/**
+ * \brief           Calculate length of statically allocated array
+ */
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+/**
+ * \brief           A line of VOICE_CATEGORY_LIST
+ */
+typedef struct voice_category {
+    uint32_t trigger;  /*!< `VOICE_WHEN_*` flags that must all hold */
+    uint32_t boost;    /*!< `VOICE_WHEN_*` flags any of which multiplies the score */
+    uint16_t cooldown; /*!< Minutes before the category can be said again */
+    uint8_t folder;    /*!< Folder of the lines */
+    uint8_t weight;    /*!< Relative odds among the categories that can be said */
+} voice_category_t;
+
+/* The number of lines is not in the table: it comes from the catalog, which falls back to <folder>_NUM */
+#define VOICE_CATEGORY_ENTRY(folder, trigger, boost, weight, cooldown) {trigger, boost, cooldown, folder, weight},
+#define VOICE_CATEGORY_INDEX(folder, trigger, boost, weight, cooldown) folder##_INDEX,
+#define VOICE_CATEGORY_CASE(folder, trigger, boost, weight, cooldown)                                            \
+    case folder: return folder##_INDEX;
+#define VOICE_CATEGORY_CHECK(folder, trigger, boost, weight, cooldown)                                           \
+    _Static_assert((folder) >= 1 && (folder) <= 99, #folder " is not a folder number 01~99");                  \
+    _Static_assert(folder##_NUM <= 255, #folder "_NUM exceeds the 255 lines of a folder");                     \
+    _Static_assert((weight) <= 255 && (cooldown) <= 0xFFFF, #folder " weight or cooldown out of range");
+
+VOICE_CATEGORY_LIST(VOICE_CATEGORY_CHECK)
+
+enum { VOICE_CATEGORY_LIST(VOICE_CATEGORY_INDEX) VOICE_CATEGORY_NUM };
+
+static const voice_category_t voice_categories[] = {VOICE_CATEGORY_LIST(VOICE_CATEGORY_ENTRY)};
+
+static shuffle_bag_t voice_category_bags[VOICE_CATEGORY_NUM]; /*!< Line order of every category */
+static uint16_t voice_category_said[VOICE_CATEGORY_NUM];      /*!< Minute a category was last said, 0: never */
+
+_Static_assert(VOICE_CATEGORY_NUM * 255UL * VOICE_SCORE_BOOST <= 0xFFFFFFUL, "Scores may overflow");
+
+/**
+ * \brief           Find the category of a folder
+ * \note            Generated from the list, two categories sharing a folder do not compile
+ * \param[in]       folder: Folder number
+ * \return          Index of the category, VOICE_CATEGORY_NUM if none
+ */
+static uint8_t
+voice_category_find(uint8_t folder) {
+    switch (folder) {
+        VOICE_CATEGORY_LIST(VOICE_CATEGORY_CASE)
+        default: return VOICE_CATEGORY_NUM;
+    }
+}
+
+/**
+ * \brief           Get the current minute for the cooldowns
+ * \return          Minutes since boot plus one, so 0 can mean "never"
+ */
+static uint16_t
+voice_category_minute(void) {
+    uint16_t minute = (uint16_t)(counter_get_ms() / 60000 + 1);
+    return minute != 0 ? minute : 1;
+}
+
+/**
+ * \brief           Draw the next line of a category and start its cooldown
+ * \param[in]       index: Index of the category
+ * \return          Line number, 0 if the folder is empty
+ */
+static uint8_t
+voice_category_draw(uint8_t index) {
+    uint16_t count = voice_catalog_count(voice_categories[index].folder);
+
+    if (count == 0) {
+        return 0;
+    }
+    if (count > UINT8_MAX) {
+        count = UINT8_MAX;
+    }
+    voice_category_said[index] = voice_category_minute();
+    return shuffle_bag_draw(&voice_category_bags[index], count) + 1;
+}
+
+/**
+ * \brief           Score a category in the current context
+ *
+ * The weight is multiplied by VOICE_SCORE_BOOST when a flag of the boost holds. Once out of its
+ * cooldown a category recovers its score linearly over VOICE_SCORE_RECENT_MINUTES, so the lines
+ * just said lose to the others without being ruled out.
+ *
+ * \param[in]       index: Index of the category
+ * \param[in]       groups: `VOICE_GROUP()` flags to pick from
+ * \param[in]       context: `VOICE_WHEN_*` flags holding right now
+ * \param[in]       now: Current minute, see voice_category_minute
+ * \return          Score, 0 if the category cannot be said
+ */
+static uint32_t
+voice_category_score(uint8_t index, uint16_t groups, uint32_t context, uint16_t now) {
+    const voice_category_t* category = &voice_categories[index];
+    uint32_t score = category->weight;
+
+    if (score == 0 || !(groups & VOICE_GROUP(category->folder))
+        || (context & category->trigger) != category->trigger) {
+        return 0;
+    }
+    if (context & category->boost) {
+        score *= VOICE_SCORE_BOOST;
+    }
+    if (voice_category_said[index] != 0) {
+        uint16_t elapsed = now - voice_category_said[index];
+        if (elapsed < category->cooldown) {
+            return 0;
+        }
+        elapsed -= category->cooldown;
+        if (elapsed < VOICE_SCORE_RECENT_MINUTES) {
+            score = score * (elapsed + 1) / (VOICE_SCORE_RECENT_MINUTES + 1);
+        }
+    }
+    if (voice_catalog_count(category->folder) == 0) {
+        return 0;
+    }
+    return score != 0 ? score : 1;
+}
+
+uint32_t
+voice_category_context(void) {
+    uint32_t context = 0;
+
+    switch (clock_time_of_day) {
+        case CLOCK_MORNING: context |= VOICE_WHEN_MORNING; break;
+        case CLOCK_AFTERNOON: context |= VOICE_WHEN_AFTERNOON; break;
+        case CLOCK_DUSK: context |= VOICE_WHEN_DUSK; break;
+        case CLOCK_EVENING: context |= VOICE_WHEN_EVENING; break;
+        default: context |= VOICE_WHEN_MIDNIGHT; break;
+    }
+    switch (clock_season) {
+        case CLOCK_SPRING: context |= VOICE_WHEN_SPRING; break;
+        case CLOCK_SUMMER: context |= VOICE_WHEN_SUMMER; break;
+        case CLOCK_AUTUMN: context |= VOICE_WHEN_AUTUMN; break;
+        default: context |= VOICE_WHEN_WINTER; break;
+    }
+    if (clock_week == 1) {
+        context |= VOICE_WHEN_MONDAY;
+    } else if (clock_week >= 6) {
+        context |= VOICE_WHEN_WEEKEND;
+    }
+    if (clock_is_my_birthday()) {
+        context |= VOICE_WHEN_BIRTHDAY;
+    }
+    if (clock_is_elysia_birthday()) {
+        context |= VOICE_WHEN_CHARACTER_BIRTHDAY;
+    }
+    if (clock_is_sleep_time()) {
+        context |= VOICE_WHEN_SLEEP_TIME;
+    }
+    if (clock_is_getup_time()) {
+        context |= VOICE_WHEN_GETUP_TIME;
+    }
+    if (alarm_went_off(VOICE_AFTER_ALARM_MINUTES)) {
+        context |= VOICE_WHEN_AFTER_ALARM;
+    }
+    switch (temperature_get_trend()) {
+        case TEMPERATURE_COOLING: context |= VOICE_WHEN_COOLING; break;
+        case TEMPERATURE_WARMING: context |= VOICE_WHEN_WARMING; break;
+        default: break;
+    }
+    return context;
+}
+
+uint8_t
+voice_category_pick(uint16_t groups, voice_line_t* line) {
+    uint32_t scores[VOICE_CATEGORY_NUM];
+    uint32_t context = voice_category_context();
+    uint16_t now = voice_category_minute();
+    uint32_t total = 0;
+    uint8_t index;
+
+    /* The context is computed once, scoring a category is then a few mask tests */
+    for (index = 0; index < VOICE_CATEGORY_NUM; index++) {
+        scores[index] = voice_category_score(index, groups, context, now);
+        total += scores[index];
+    }
+
+    if (total == 0) {
+        index = voice_category_find(VOICE_DEFAULT);
+    } else {
+        uint32_t r = random_range(total);
+        for (index = 0; r >= scores[index]; index++) {
+            r -= scores[index];
+        }
+    }
+
+    line->folder = voice_categories[index].folder;
+    line->number = voice_category_draw(index);
+    log_d("Picked %d/%d scoring %d of %d, context 0x%05x", line->folder, line->number,
+          (int)(total != 0 ? scores[index] : 0), (int)total, (unsigned int)context);
+    return line->number != 0;
+}
+
+uint8_t
+voice_category_line(uint8_t folder) {
+    uint8_t index = voice_category_find(folder);
+
+    if (index == VOICE_CATEGORY_NUM) {
+        return 0;
+    }
+    return voice_category_draw(index);
+}
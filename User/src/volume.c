@@ -0,0 +1,160 @@
+/**
+* \file            volume.c
+* \date            10/19/2026
+* \brief           Volume ramp engine
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#include "volume.h"
+#include "../../config/voice_cfg.h"
+#include "counter.h"
+#include "dfplayer_mini.h"
+
+#define LOG_TAG "VOLUME"
+#include "elog.h"
+
+static uint8_t volume_level;             /*!< Level wanted now */
+static uint8_t volume_sent;              /*!< Level the DFPlayer was last set to */
+static int8_t volume_pending;            /*!< Key steps not applied yet, the key handlers run in the main loop */
+static uint8_t volume_ramp_state;        /*!< Current `volume_ramp_state_t` */
+static volume_curve_t volume_ramp_curve; /*!< Shape of the running ramp */
+static uint8_t volume_ramp_from;         /*!< Starting level of the running ramp */
+static uint8_t volume_ramp_to;           /*!< Final level of the running ramp */
+static uint32_t volume_ramp_start;       /*!< Time the running ramp started */
+static uint32_t volume_ramp_duration;    /*!< Length of the running ramp in milliseconds */
+
+/**
+ * \brief           Clamp a level to 0 ~ VOICE_VOLUME_MAX
+ */
+static uint8_t
+volume_clamp(int16_t level) {
+    return level < 0 ? 0 : level > VOICE_VOLUME_MAX ? VOICE_VOLUME_MAX : (uint8_t)level;
+}
+
+/**
+ * \brief           Cancel the running ramp, if any
+ */
+static void
+volume_cancel(void) {
+    if (volume_ramp_state == VOLUME_RAMP_RUNNING) {
+        volume_ramp_state = VOLUME_RAMP_CANCELED;
+        log_d("Ramp cancelled at %d", volume_level);
+    }
+}
+
+/**
+ * \brief           Get the level of the running ramp at a time
+ * \param[in]       elapsed: Milliseconds since the start, below the duration
+ * \return          Level
+ */
+static uint8_t
+volume_ramp_level(uint32_t elapsed) {
+    /* Progress in 1/65536 of the ramp */
+    uint32_t progress = (uint32_t)(((uint64_t)elapsed << 16) / volume_ramp_duration);
+    int32_t span = (int32_t)volume_ramp_to - volume_ramp_from;
+
+    if (volume_ramp_curve == VOLUME_CURVE_PERCEPTUAL) {
+        progress = (uint32_t)(((uint64_t)progress * progress) >> 16);
+    }
+    /* Round to the nearest level, halves away from zero */
+    return (uint8_t)(volume_ramp_from + (span * (int32_t)progress + (span >= 0 ? 0x8000 : -0x8000)) / 0x10000);
+}
+
+void
+volume_init(uint8_t volume) {
+    volume_level = volume_sent = volume_clamp(volume);
+    volume_ramp_state = VOLUME_RAMP_IDLE;
+}
+
+void
+volume_ramp(uint8_t from, uint8_t to, uint32_t duration_ms, volume_curve_t curve) {
+    volume_ramp_from = from == VOLUME_CURRENT ? volume_level : volume_clamp(from);
+    volume_ramp_to = volume_clamp(to);
+    volume_ramp_curve = curve;
+    volume_ramp_start = counter_get_ms();
+    volume_ramp_duration = duration_ms;
+    volume_ramp_state = VOLUME_RAMP_RUNNING;
+    volume_level = volume_ramp_from;
+    log_d("Ramp %d -> %d in %d ms", volume_ramp_from, volume_ramp_to, (int)duration_ms);
+}
+
+void
+volume_set(uint8_t volume) {
+    volume_cancel();
+    volume_level = volume_clamp(volume);
+}
+
+void
+volume_step(int8_t delta) {
+    volume_pending += delta;
+}
+
+uint8_t
+volume_get(void) {
+    return volume_level;
+}
+
+uint8_t
+volume_is_applied(void) {
+    return volume_sent == volume_level;
+}
+
+volume_ramp_state_t
+volume_get_ramp(void) {
+    return (volume_ramp_state_t)volume_ramp_state;
+}
+
+void
+volume_process(void) {
+    int8_t delta;
+
+    delta = volume_pending;
+    volume_pending = 0;
+
+    /* A key press wins over the ramp, and steps from where the ramp got to */
+    if (delta != 0) {
+        volume_cancel();
+        volume_level = volume_clamp((int16_t)volume_level + delta);
+    }
+    if (volume_ramp_state == VOLUME_RAMP_RUNNING) {
+        uint32_t elapsed = counter_get_ms() - volume_ramp_start;
+        if (elapsed >= volume_ramp_duration) {
+            volume_level = volume_ramp_to;
+            volume_ramp_state = VOLUME_RAMP_DONE;
+        } else {
+            volume_level = volume_ramp_level(elapsed);
+        }
+    }
+
+    if (volume_level != volume_sent && df_get_idle_ms() >= VOICE_VOLUME_COMMAND_GAP_MS) {
+        df_set_volume(volume_level);
+        volume_sent = volume_level;
+    }
+}
@@ -65,6 +65,72 @@ extern "C" {
  */
 #define CLOCK_CFG_GETUP_TIME "07:30"
 
+/**
+ * \brief          Volume the alarm starts at
+ * \hideinitializer
+ */
+#define CLOCK_CFG_ALARM_START_VOLUME 3
+
+/**
+ * \brief          Milliseconds the alarm takes to ramp up to the volume set before it went off
+ * \hideinitializer
+ */
+#define CLOCK_CFG_ALARM_WAKE_MS      60000
+
+/**
+ * \brief          Milliseconds the alarm then takes to escalate to full volume, until dismissed
+ * \hideinitializer
+ */
+#define CLOCK_CFG_ALARM_ESCALATE_MS  120000
+
+/**
+ * \brief          Milliseconds after which an alarm nobody dismissed stops by itself
+ * \hideinitializer
+ */
+#define CLOCK_CFG_ALARM_TIMEOUT_MS   1800000
+
+/**
+ * \brief          Milliseconds between the steps of a held time key at first (1 per second)
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_REPEAT_SLOW_MS   1000
+
+/**
+ * \brief          Milliseconds between the steps once the key is held for CLOCK_CFG_EDIT_MEDIUM_AFTER_MS (5 per second)
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_REPEAT_MEDIUM_MS 200
+
+/**
+ * \brief          Milliseconds between the steps once the key is held for CLOCK_CFG_EDIT_FAST_AFTER_MS (20 per second)
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_REPEAT_FAST_MS   50
+
+/**
+ * \brief          Milliseconds of repeating before the steps speed up to CLOCK_CFG_EDIT_REPEAT_MEDIUM_MS
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_MEDIUM_AFTER_MS  2000
+
+/**
+ * \brief          Milliseconds of repeating before the steps speed up to CLOCK_CFG_EDIT_REPEAT_FAST_MS
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_FAST_AFTER_MS    4000
+
+/**
+ * \brief          Milliseconds without a key after which the editor closes without saving
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_TIMEOUT_MS       30000
+
+/**
+ * \brief          Milliseconds the edited field is shown, then hidden, while blinking
+ * \hideinitializer
+ */
+#define CLOCK_CFG_EDIT_BLINK_MS         500
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -39,8 +39,8 @@
 #define ELOG_OUTPUT_LVL                          ELOG_LVL_VERBOSE
 /* enable assert check */
 #define ELOG_ASSERT_ENABLE
-/* buffer size for every line's log */
-#define ELOG_LINE_BUF_SIZE                       1024
+/* buffer size for every line's log, the longer ones are cut */
+#define ELOG_LINE_BUF_SIZE                       256
 /* output line number max length */
 #define ELOG_LINE_NUM_MAX_LEN                    5
 /* output filter's tag max length */
@@ -62,16 +62,25 @@
 #define ELOG_COLOR_DEBUG                         (F_GREEN B_NULL S_NORMAL)
 #define ELOG_COLOR_VERBOSE                       (F_BLUE B_NULL S_NORMAL)
 /*---------------------------------------------------------------------------*/
-/* enable asynchronous output mode */
-//#define ELOG_ASYNC_OUTPUT_ENABLE
+#if defined(DEBUG)
+/* enable asynchronous output mode, elog_port.c drains it to the UART by DMA from idle time */
+#define ELOG_ASYNC_OUTPUT_ENABLE
+#endif  /* DEBUG */
 /* the highest output level for async mode, other level will sync output */
 #define ELOG_ASYNC_OUTPUT_LVL                    ELOG_LVL_ASSERT
-/* buffer size for asynchronous output mode */
-#define ELOG_ASYNC_OUTPUT_BUF_SIZE               (ELOG_LINE_BUF_SIZE * 10)
+/* buffer size for asynchronous output mode, a power of 2, the logs that do not fit are dropped */
+#define ELOG_ASYNC_OUTPUT_BUF_SIZE               2048
+/* lines to package the async logs in without a lock, one for each nested context, the deeper logs are dropped */
+#define ELOG_ASYNC_LINE_NUM                      4
 /* each asynchronous output's log which must end with newline sign */
 #define ELOG_ASYNC_LINE_OUTPUT
-/* asynchronous output mode using POSIX pthread implementation */
-#define ELOG_ASYNC_OUTPUT_USING_PTHREAD
+/* asynchronous output mode using POSIX pthread implementation, there is none on the MCU */
+//#define ELOG_ASYNC_OUTPUT_USING_PTHREAD
+/*---------------------------------------------------------------------------*/
+/* enable tokenized output mode, the format strings stay in the ELF, tools/elog_token_decode prints the logs */
+//#define ELOG_TOKEN_OUTPUT_ENABLE
+/* bytes of a tokenized log on the wire, up to 254, the strings are cut to fit */
+#define ELOG_TOKEN_FRAME_MAX                     128
 /*---------------------------------------------------------------------------*/
 /* enable buffered output mode */
 //#define ELOG_BUF_OUTPUT_ENABLE
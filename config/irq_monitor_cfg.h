@@ -0,0 +1,63 @@
+/**
+* \file            irq_monitor_cfg.h
+* \date            10/19/2026
+* \brief           Interrupt monitor configuration
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_IRQ_MONITOR_CFG_H
+#define ELYSIA_VOICE_ALARM_CLOCK_IRQ_MONITOR_CFG_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Time the masked sections and the interrupts, 1 to enable
+ *
+ * The report only goes out with the log, so it follows DEBUG unless defined by the build.
+ * Disabled, the hooks are the bare __disable_irq() and __enable_irq(), or nothing.
+ * \hideinitializer
+ */
+#ifndef IRQ_MONITOR_CFG_ENABLE
+#if defined(DEBUG)
+#define IRQ_MONITOR_CFG_ENABLE 1
+#else
+#define IRQ_MONITOR_CFG_ENABLE 0
+#endif /* defined(DEBUG) */
+#endif /* IRQ_MONITOR_CFG_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_IRQ_MONITOR_CFG_H */
@@ -0,0 +1,74 @@
+/**
+* \file            key_cfg.h
+* \date            10/19/2026
+* \brief           Key configuration
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_KEY_CFG_H
+#define ELYSIA_VOICE_ALARM_CLOCK_KEY_CFG_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Record the key pins and stream the record over the log, 1 to enable
+ *
+ * The record only goes out with the log, so it follows DEBUG unless defined by the build.
+ * \hideinitializer
+ */
+#ifndef KEY_CFG_RECORD
+#if defined(DEBUG)
+#define KEY_CFG_RECORD      1
+#else
+#define KEY_CFG_RECORD      0
+#endif /* defined(DEBUG) */
+#endif /* KEY_CFG_RECORD */
+
+/**
+ * \brief          Bytes of record buffered between the key interrupts and the log, power of two
+ * \hideinitializer
+ */
+#define KEY_CFG_RECORD_SIZE 256
+
+/**
+ * \brief          Bytes of record per log line, printed as hex
+ * \hideinitializer
+ */
+#define KEY_CFG_RECORD_LINE 32
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_KEY_CFG_H */
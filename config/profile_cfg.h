@@ -0,0 +1,91 @@
+/**
+* \file            profile_cfg.h
+* \date            10/19/2026
+* \brief           Cycle profiler configuration
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_PROFILE_CFG_H
+#define ELYSIA_VOICE_ALARM_CLOCK_PROFILE_CFG_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Time the profile points in DWT cycles and dump the histograms to the log, 1 to enable
+ *
+ * Off by default, every point then compiles to nothing. The dumps only go out with the log,
+ * so enable it with DEBUG, e.g. -DPROFILE_CFG_ENABLE=1.
+ * \hideinitializer
+ */
+#ifndef PROFILE_CFG_ENABLE
+#define PROFILE_CFG_ENABLE 0
+#endif /* PROFILE_CFG_ENABLE */
+
+/**
+ * \brief          Log2 bins per point (2 ~ 32), bin n counts the durations of 2^(n-1) ~ 2^n - 1 cycles and the
+ *                 last one everything above. 24 bins reach 2^23 cycles, 116 ms at 72 MHz
+ *
+ * A point takes 16 + 4 * PROFILE_CFG_BINS bytes of RAM, 112 bytes with the default.
+ * \hideinitializer
+ */
+#define PROFILE_CFG_BINS   24
+
+/**
+ * \brief          Bytes of snapshot per log line, printed as hex
+ * \hideinitializer
+ */
+#define PROFILE_CFG_LINE   32
+
+/**
+ * \brief          The profile points, each an identifier for PROFILE_BEGIN() or PROFILE_ISR_ENTER()
+ *                 and the name the host tool shows, append new points to keep the old ids
+ * \hideinitializer
+ */
+#define PROFILE_CFG_POINTS(X)                                                                                   \
+    X(PROFILE_SCREEN_DRAW, "screen_draw")                                                                       \
+    X(PROFILE_SSD1306_UPDATE, "SSD1306_UpdateScreen")                                                           \
+    X(PROFILE_SSD1306_PUTC, "SSD1306_Putc")                                                                     \
+    X(PROFILE_SPRINTF, "sprintf")                                                                               \
+    X(PROFILE_DS1302_READ, "ds1302_read")                                                                       \
+    X(PROFILE_DS18B20_BYTE, "ds18b20_byte")                                                                     \
+    X(PROFILE_ISR_TIM2, "TIM2_IRQ")                                                                             \
+    X(PROFILE_ISR_TIM3, "TIM3_IRQ")                                                                             \
+    X(PROFILE_ISR_EXTI, "EXTI_IRQ")                                                                             \
+    X(PROFILE_ISR_USART1, "USART1_IRQ")
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_PROFILE_CFG_H */
@@ -0,0 +1,84 @@
+/**
+* \file            temperature_cfg.h
+* \date            10/19/2026
+* \brief           Temperature history configuration file
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+#ifndef ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_CFG_H
+#define ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_CFG_H
+
+#include "stm32f10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Milliseconds between two DS18B20 readings added to the history, the screen shows one every second
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_SAMPLE_MS    60000
+
+/**
+ * \brief          Readings averaged into a slot of the history, 15 one-minute readings by default
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_SLOT_SAMPLES 15
+
+/**
+ * \brief          Slots of the history, 96 slots of 15 minutes keep a day
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_SLOTS        96
+
+/**
+ * \brief          Latest slots the trend is fitted on, 8 slots of 15 minutes are two hours
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_TREND_SLOTS  8
+
+/**
+ * \brief          Slope starting a cooling or warming trend, 1/16 degree per hour
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_TREND_START  16
+
+/**
+ * \brief          Slope under which the trend ends again, lower than the start so it does not flicker
+ * \hideinitializer
+ */
+#define TEMPERATURE_CFG_TREND_STOP   6
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ELYSIA_VOICE_ALARM_CLOCK_TEMPERATURE_CFG_H */
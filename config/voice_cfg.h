@@ -6,6 +6,9 @@
 * This file contains the category folder number of the audio file,
 * and the number of audio files under the corresponding category.
 * It is configured by the user (if needed).
+*
+* The numbers of audio files are only a fallback: the actual numbers are
+* read from the TF card at startup, see voice_catalog.c.
 */
 
 /*
@@ -118,12 +121,121 @@ extern "C" {
 #define VOICE_DEFAULT                     VOICE_INTERACTION_CHAT
 #define VOICE_DEFAULT_NUM                 VOICE_INTERACTION_CHAT_NUM
 
+/* Conditions a voice category can require, all the flags of its trigger must hold */
+#define VOICE_WHEN_ANY                    0
+#define VOICE_WHEN_MORNING                (1UL << 0)
+#define VOICE_WHEN_AFTERNOON              (1UL << 1)
+#define VOICE_WHEN_DUSK                   (1UL << 2)
+#define VOICE_WHEN_EVENING                (1UL << 3)
+#define VOICE_WHEN_MIDNIGHT               (1UL << 4)
+#define VOICE_WHEN_SPRING                 (1UL << 5)
+#define VOICE_WHEN_SUMMER                 (1UL << 6)
+#define VOICE_WHEN_AUTUMN                 (1UL << 7)
+#define VOICE_WHEN_WINTER                 (1UL << 8)
+#define VOICE_WHEN_MONDAY                 (1UL << 9)
+#define VOICE_WHEN_BIRTHDAY               (1UL << 10) // The user's birthday
+#define VOICE_WHEN_CHARACTER_BIRTHDAY     (1UL << 11)
+#define VOICE_WHEN_SLEEP_TIME             (1UL << 12)
+#define VOICE_WHEN_GETUP_TIME             (1UL << 13)
+#define VOICE_WHEN_AFTER_ALARM            (1UL << 14) // The alarm went off in the last VOICE_AFTER_ALARM_MINUTES
+#define VOICE_WHEN_COOLING                (1UL << 15) // The room is cooling down, see temperature_cfg.h
+#define VOICE_WHEN_WEEKEND                (1UL << 16)
+#define VOICE_WHEN_WARMING                (1UL << 17) // The room is warming up
+#define VOICE_WHEN_NEVER                  (1UL << 31) // No source for this condition yet (rain, tasks)
+
+#define VOICE_AFTER_ALARM_MINUTES         30
+
+/* Scoring of the categories that can be said */
+#define VOICE_SCORE_BOOST                 4   // Score multiplier when a flag of the boost holds
+#define VOICE_SCORE_RECENT_MINUTES        180 // After its cooldown a category recovers its score linearly over this
+
+/*
+ * Voice categories, one line each: X(folder, trigger, boost, weight, cooldown)
+ *   folder:   a folder above, its number of lines is <folder>_NUM
+ *   trigger:  VOICE_WHEN_* flags that must all hold for the category to be said
+ *   boost:    VOICE_WHEN_* flags, the score is multiplied by VOICE_SCORE_BOOST when any holds, VOICE_WHEN_ANY for none
+ *   weight:   relative odds among the categories that can be said, 0 disables the category
+ *   cooldown: minutes before a line of the category can be said again
+ * The first digit of the folder number is the group voice_weather(), voice_scene()... pick from.
+ */
+#define VOICE_CATEGORY_LIST(X)                                                                        \
+    X(VOICE_WEATHER_RAIN,            VOICE_WHEN_NEVER,              VOICE_WHEN_ANY,           4, 60)  \
+    X(VOICE_WEATHER_SUNNY,           VOICE_WHEN_WARMING,            VOICE_WHEN_MORNING,       4, 240) \
+    X(VOICE_WEATHER_COOL_DOWN,       VOICE_WHEN_COOLING,            VOICE_WHEN_MORNING,       4, 240) \
+    X(VOICE_SCENE_REST_TIME,         VOICE_WHEN_AFTERNOON,          VOICE_WHEN_WEEKEND,       2, 60)  \
+    X(VOICE_SCENE_TASK_SET,          VOICE_WHEN_NEVER,              VOICE_WHEN_ANY,           2, 0)   \
+    X(VOICE_SCENE_TASK_ACCOMPLISHED, VOICE_WHEN_NEVER,              VOICE_WHEN_ANY,           2, 0)   \
+    X(VOICE_SCENE_GREETING,          VOICE_WHEN_ANY,                VOICE_WHEN_MORNING,       2, 30)  \
+    X(VOICE_SCENE_WAKE_UP,           VOICE_WHEN_AFTER_ALARM,        VOICE_WHEN_GETUP_TIME,   16, 0)   \
+    X(VOICE_SCENE_HANG_OUT,          VOICE_WHEN_ANY,                VOICE_WHEN_WEEKEND,       1, 60)  \
+    X(VOICE_SCENE_FAILURE,           VOICE_WHEN_NEVER,              VOICE_WHEN_ANY,           2, 0)   \
+    X(VOICE_INTERACTION_CHAT,        VOICE_WHEN_ANY,                VOICE_WHEN_ANY,           8, 0)   \
+    X(VOICE_INTERACTION_EAT,         VOICE_WHEN_ANY,                VOICE_WHEN_DUSK,          1, 60)  \
+    X(VOICE_INTERACTION_LIFT,        VOICE_WHEN_ANY,                VOICE_WHEN_ANY,           1, 60)  \
+    X(VOICE_INTERACTION_NEW_CLOTHES, VOICE_WHEN_ANY,                VOICE_WHEN_WEEKEND,       1, 60)  \
+    X(VOICE_INTERACTION_SHAKE,       VOICE_WHEN_ANY,                VOICE_WHEN_ANY,           1, 60)  \
+    X(VOICE_INTERACTION_THANKS,      VOICE_WHEN_ANY,                VOICE_WHEN_ANY,           1, 60)  \
+    X(VOICE_TIME_MORNING_GREETING,   VOICE_WHEN_MORNING,            VOICE_WHEN_AFTER_ALARM,   6, 120) \
+    X(VOICE_TIME_EVENING,            VOICE_WHEN_EVENING,            VOICE_WHEN_ANY,           6, 120) \
+    X(VOICE_TIME_MIDNIGHT,           VOICE_WHEN_MIDNIGHT,           VOICE_WHEN_SLEEP_TIME,    6, 60)  \
+    X(VOICE_SEASON_WINTER,           VOICE_WHEN_WINTER,             VOICE_WHEN_COOLING,       3, 240) \
+    X(VOICE_SEASON_AUTUMN,           VOICE_WHEN_AUTUMN,             VOICE_WHEN_COOLING,       3, 240) \
+    X(VOICE_SEASON_SUMMER,           VOICE_WHEN_SUMMER,             VOICE_WHEN_AFTERNOON,     3, 240) \
+    X(VOICE_MISC_CHARACTER_BIRTHDAY, VOICE_WHEN_CHARACTER_BIRTHDAY, VOICE_WHEN_ANY,          16, 60)  \
+    X(VOICE_MISC_BIRTHDAY,           VOICE_WHEN_BIRTHDAY,           VOICE_WHEN_MORNING,      16, 60)  \
+    X(VOICE_MISC_MONDAY,             VOICE_WHEN_MONDAY,             VOICE_WHEN_AFTER_ALARM,   4, 720)
+
+/* Talking clock clips, a small vocabulary the announcer builds its phrases from */
+#define VOICE_CLIP                        90
+#define VOICE_CLIP_NUMBER(n)              ((n) + 1) // "001xxx.mp3" ~ "060xxx.mp3" say 0 ~ 59
+#define VOICE_CLIP_IT_IS                  61
+#define VOICE_CLIP_OCLOCK                 62
+#define VOICE_CLIP_OH                     63 // "oh" of "seven oh five"
+#define VOICE_CLIP_DEGREES                64
+#define VOICE_CLIP_MINUS                  65
+#define VOICE_CLIP_GOOD_MORNING           66
+#define VOICE_CLIP_GOOD_AFTERNOON         67
+#define VOICE_CLIP_GOOD_EVENING           68
+#define VOICE_CLIP_GOOD_NIGHT             69
+#define VOICE_CLIP_NUM                    69
+
 /* Music */
 #define VOICE_MUSIC_RESOURCE              80
 #define VOICE_MUSIC_NUM                   84
 
+/* Music folder types, see VOICE_MUSIC_LIBRARY */
+#define VOICE_MUSIC_FOLDER                0 // Folder 01~99, up to 255 tracks named "001xxx.mp3"
+#define VOICE_MUSIC_LARGE_FOLDER          1 // Folder 01~15, up to 3000 tracks named "0001xxx.mp3"
+#define VOICE_MUSIC_MP3_FOLDER            2 // The folder named "MP3", up to 9999 tracks named "0001xxx.mp3"
+
+/*
+ * Music library: the folders are played one after another as one logical library.
+ * One line per folder: X(type, folder, number of tracks). Use folder 0 for VOICE_MUSIC_MP3_FOLDER.
+ * Large folders must not reuse a voice folder number.
+ *
+ * Example with two extra folders:
+ *   X(VOICE_MUSIC_FOLDER, VOICE_MUSIC_RESOURCE, VOICE_MUSIC_NUM) \
+ *   X(VOICE_MUSIC_LARGE_FOLDER, 5, 3000)                         \
+ *   X(VOICE_MUSIC_MP3_FOLDER, 0, 1200)
+ */
+#define VOICE_MUSIC_LIBRARY(X)            X(VOICE_MUSIC_FOLDER, VOICE_MUSIC_RESOURCE, VOICE_MUSIC_NUM)
+
+/*
+ * Voice lines said over music are interjected with the DFPlayer advert command, so the
+ * track resumes where it was. The advert folder holds a copy of the voice lines:
+ * line <number> of folder <folder> is "ADVERT/<VOICE_ADVERT_TRACK(folder, number)>.mp3",
+ * e.g. "ADVERT/2107.mp3" for line 7 of folder 21. A macro yielding 0 means "no advert copy".
+ * Without the copies, set VOICE_ADVERT_ENABLE to 0: the track is stopped for the line and
+ * played again afterwards.
+ */
+#define VOICE_ADVERT_ENABLE               1
+#define VOICE_ADVERT_TRACK(folder, number) ((number) < 100 ? (folder) * 100 + (number) : 0)
+
 #define VOICE_VOLUME_MAX                  (30)
 
+/* The DFPlayer drops commands sent too close together, volume steps wait this long after any command */
+#define VOICE_VOLUME_COMMAND_GAP_MS       100
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,209 @@
+/**
+* \file            announcer_test.c
+* \date            10/19/2026
+* \brief           Host simulation of the gaps between the clips of an announcement
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Says phrases through announcer.c against a modelled DFPlayer and checks the clips they are
+ * made of, then measures the silence between two clips. A command frame takes 10.4 ms on the
+ * wire at 9600 baud, the module starts the clip some latency after it, a clip lasts 300 ~ 700 ms,
+ * and the finished frame comes in some latency after the clip ends. The main loop only reads
+ * that frame on its next pass, so a gap is at most the report latency, one loop period, one
+ * frame and the start latency. It checks that bound for every gap of the 8-clip greeting, over
+ * a range of latencies and loop periods, and prints the mean and longest gaps. Build and run
+ * from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/announcer_test/announcer_test.c User/src/announcer.c -o announcer_test && ./announcer_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../../config/voice_cfg.h"
+#include "announcer.h"
+#include "clock.h"
+#include "dfplayer_mini.h"
+#include "ds18b20.h"
+
+#define TEST_FRAME_US 10400 /* 10 bytes of 10 bits at 9600 baud */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The clock and the sensor */
+
+uint8_t clock_year, clock_month, clock_day, clock_hour, clock_minute, clock_second, clock_week;
+clock_time_of_day_t clock_time_of_day;
+static float test_t;
+
+float
+ds18b20_get_t(void) {
+    return test_t;
+}
+
+/* The DFPlayer */
+
+static uint32_t test_us;          /* Simulated time */
+static uint8_t test_clips[16];    /* Clips asked for */
+static uint8_t test_clip_num;
+static uint32_t test_start_us;    /* Latency from the end of a command frame to the clip playing */
+static uint32_t test_report_us;   /* Latency from the end of a clip to its finished frame */
+static uint32_t test_finished_us; /* Time the finished frame of the clip playing comes in */
+static uint32_t test_end_us;      /* Time the clip playing ends, 0 if none played yet */
+static uint32_t test_gap_sum, test_gap_max, test_gap_num;
+
+void
+df_play_from_folder(uint8_t folder, uint8_t number) {
+    uint32_t begin_us = test_us + TEST_FRAME_US + test_start_us;
+
+    TEST_CHECK(folder == VOICE_CLIP, "clip %u played from folder %u", number, folder);
+    TEST_CHECK(number >= 1 && number <= VOICE_CLIP_NUM, "clip %u out of the vocabulary", number);
+    if (test_clip_num < sizeof(test_clips)) {
+        test_clips[test_clip_num++] = number;
+    }
+    if (test_end_us != 0) {
+        uint32_t gap = begin_us - test_end_us;
+        test_gap_sum += gap;
+        test_gap_num++;
+        if (gap > test_gap_max) {
+            test_gap_max = gap;
+        }
+    }
+    /* 300 ~ 700 ms, spread over the vocabulary */
+    test_end_us = begin_us + 300000 + (uint32_t)number * 5813 % 400000;
+    test_finished_us = test_end_us + test_report_us;
+}
+
+/* Phrases */
+
+static void
+test_say(announcer_phrase_t phrase, uint8_t hour, uint8_t minute, float t, clock_time_of_day_t time_of_day) {
+    clock_hour = hour;
+    clock_minute = minute;
+    clock_time_of_day = time_of_day;
+    test_t = t;
+    test_clip_num = 0;
+    test_end_us = 0;
+    if (announcer_start(phrase)) {
+        while (announcer_on_finished()) {}
+    }
+}
+
+static void
+test_expect(const char* what, const uint8_t* clips, uint8_t num) {
+    TEST_CHECK(test_clip_num == num && memcmp(test_clips, clips, num) == 0, "%s: %u clips, first %u", what,
+               test_clip_num, test_clip_num ? test_clips[0] : 0);
+}
+
+static void
+test_phrases(void) {
+    static const uint8_t time[] = {VOICE_CLIP_IT_IS, VOICE_CLIP_NUMBER(7), VOICE_CLIP_NUMBER(32)};
+    static const uint8_t oclock[] = {VOICE_CLIP_IT_IS, VOICE_CLIP_NUMBER(12), VOICE_CLIP_OCLOCK,
+                                     VOICE_CLIP_NUMBER(18), VOICE_CLIP_DEGREES};
+    static const uint8_t greeting[] = {VOICE_CLIP_GOOD_NIGHT, VOICE_CLIP_IT_IS, VOICE_CLIP_NUMBER(23),
+                                       VOICE_CLIP_OH, VOICE_CLIP_NUMBER(5), VOICE_CLIP_MINUS,
+                                       VOICE_CLIP_NUMBER(3), VOICE_CLIP_DEGREES};
+    static const uint8_t hot[] = {VOICE_CLIP_GOOD_MORNING, VOICE_CLIP_IT_IS, VOICE_CLIP_NUMBER(7),
+                                  VOICE_CLIP_NUMBER(30), VOICE_CLIP_NUMBER(59), VOICE_CLIP_DEGREES};
+
+    test_say(ANNOUNCER_TIME, 7, 32, 18.0f, CLOCK_MORNING);
+    test_expect("time", time, sizeof(time));
+    test_say(ANNOUNCER_TIME_TEMPERATURE, 12, 0, 17.6f, CLOCK_AFTERNOON);
+    test_expect("o'clock", oclock, sizeof(oclock));
+    test_say(ANNOUNCER_GREETING, 23, 5, -2.6f, CLOCK_MIDNIGHT);
+    test_expect("greeting", greeting, sizeof(greeting));
+    test_say(ANNOUNCER_GREETING, 7, 30, 85.0f, CLOCK_MORNING);
+    test_expect("clamped", hot, sizeof(hot));
+
+    test_say(ANNOUNCER_PHRASE_NUM, 7, 30, 18.0f, CLOCK_MORNING);
+    TEST_CHECK(test_clip_num == 0, "unknown phrase said %u clips", test_clip_num);
+
+    /* A phrase cut short says nothing more */
+    test_clip_num = 0;
+    TEST_CHECK(announcer_start(ANNOUNCER_TIME), "phrase not started");
+    announcer_stop();
+    TEST_CHECK(!announcer_on_finished() && test_clip_num == 1, "%u clips after the stop", test_clip_num);
+}
+
+/* Gaps */
+
+static void
+test_gaps(uint32_t start_ms, uint32_t report_ms, uint32_t loop_ms) {
+    uint32_t bound_us = (report_ms + loop_ms + start_ms) * 1000 + TEST_FRAME_US;
+    uint8_t saying;
+
+    test_start_us = start_ms * 1000;
+    test_report_us = report_ms * 1000;
+    test_gap_sum = test_gap_max = test_gap_num = 0;
+    test_clip_num = 0;
+    test_end_us = 0;
+    test_us = 0;
+    clock_hour = 23;
+    clock_minute = 5;
+    clock_time_of_day = CLOCK_MIDNIGHT;
+    test_t = -2.6f;
+
+    /* One pass of the main loop every loop_ms, reading the finished frame if it came in */
+    saying = announcer_start(ANNOUNCER_GREETING);
+    while (saying) {
+        test_us += loop_ms * 1000;
+        if (test_us >= test_finished_us) {
+            saying = announcer_on_finished();
+        }
+    }
+
+    TEST_CHECK(test_gap_num == 7, "%u gaps for the 8-clip greeting", test_gap_num);
+    TEST_CHECK(test_gap_max <= bound_us, "start/report %u/%u ms, loop %u ms: gap of %u us over %u us", start_ms,
+               report_ms, loop_ms, test_gap_max, bound_us);
+    printf("start/report latency %u/%u ms, loop %u ms: mean %u ms, max %u ms\n", start_ms, report_ms, loop_ms,
+           test_gap_num ? test_gap_sum / test_gap_num / 1000 : 0, test_gap_max / 1000);
+}
+
+int
+main(void) {
+    test_phrases();
+    test_gaps(20, 20, 5);
+    test_gaps(20, 20, 40);
+    test_gaps(50, 50, 40);
+    test_gaps(100, 100, 60);
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
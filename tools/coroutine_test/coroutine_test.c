@@ -0,0 +1,438 @@
+/**
+* \file            coroutine_test.c
+* \date            10/19/2026
+* \brief           Host test of the coroutine macros and of the DFPlayer and DS18B20 sequences built on them
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs the coroutine macros of coroutine.h, the initialization and the folder query of
+ * dfplayer_mini.c behind a fake UART, and the 1-Wire transactions of ds18b20.c against a fake
+ * sensor on the DQ pin, all on a simulated microsecond clock that only moves when the test moves
+ * it or a driver busy-waits. It checks that every wait with the line released gives way instead of
+ * blocking, lasts at least its time, that the reset pulse stays bounded, that nothing is sent to a
+ * missing sensor, and that the bytes on the wires are those of the blocking drivers. Build and run
+ * from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IHardware/inc -ISystem/inc tools/coroutine_test/coroutine_test.c \
+ *       -o coroutine_test && ./coroutine_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "stm32f10x.h"
+#include "counter.h"
+#include "delay.h"
+#include "uart.h"
+
+#include "../../Hardware/src/dfplayer_mini.c"
+#include "../../Hardware/src/ds18b20.c"
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* Time */
+
+static uint64_t test_us;
+
+uint32_t
+counter_get_us(void) {
+    return (uint32_t)test_us;
+}
+
+uint32_t
+counter_get_ms(void) {
+    return (uint32_t)(test_us / 1000);
+}
+
+void
+delay_us(uint32_t xus) {
+    test_us += xus;
+}
+
+/* UART to the DFPlayer */
+
+static uint8_t test_tx[64];
+static uint8_t test_tx_len;
+static uart_rx_callback_t test_rx;
+
+void
+uart_init(void) {}
+
+void
+uart_set_rx_callback(uart_rx_callback_t callback) {
+    test_rx = callback;
+}
+
+void
+uart_send_byte(uint8_t byte) {
+    if (test_tx_len < sizeof(test_tx)) {
+        test_tx[test_tx_len] = byte;
+    }
+    test_tx_len++;
+}
+
+void
+uart_send_bytes(const uint8_t bytes[], size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uart_send_byte(bytes[i]);
+    }
+}
+
+/* Command of the only frame sent since the last call, 0 if none, 0xFF if several */
+static uint8_t
+test_tx_cmd(uint16_t* param) {
+    uint8_t len = test_tx_len;
+
+    test_tx_len = 0;
+    if (len == 0) {
+        return 0;
+    }
+    if (len != 10 || test_tx[0] != 0x7E || test_tx[9] != 0xEF) {
+        return 0xFF;
+    }
+    if (param != NULL) {
+        *param = (uint16_t)(test_tx[5] << 8 | test_tx[6]);
+    }
+    return test_tx[3];
+}
+
+static void
+test_df_reply(uint8_t cmd, uint16_t param) {
+    uint8_t frame[10] = {0x7E, 0xFF, 0x06, cmd, 0x00, (uint8_t)(param >> 8), (uint8_t)param, 0, 0, 0xEF};
+    uint16_t checksum = 0;
+
+    for (uint8_t i = 1; i < 7; i++) {
+        checksum -= frame[i];
+    }
+    frame[7] = (uint8_t)(checksum >> 8);
+    frame[8] = (uint8_t)checksum;
+    test_rx(frame, sizeof(frame));
+}
+
+/* DQ pin and the sensor on it */
+
+GPIO_TypeDef host_gpiob;
+static uint8_t test_dq_output; /* Driven by the MCU, released to the pull-up otherwise */
+static uint8_t test_dq_low;
+static uint64_t test_dq_low_us;    /* Time the MCU pulled the line low */
+static uint32_t test_reset_min_us; /* Shortest reset pulse seen */
+static uint8_t test_presence;      /* The sensor pulls the line low until the next read */
+static uint8_t test_absent;        /* No sensor on the line to answer the reset */
+static uint8_t test_bus[8];        /* Bytes written by the MCU since the last reset, LSB first */
+static uint8_t test_bus_bits;
+static uint8_t test_scratchpad[2]; /* Bytes the sensor answers with */
+static uint8_t test_scratchpad_bits;
+
+static void
+test_dq_release(void) {
+    if (test_dq_low && test_us - test_dq_low_us >= 480) {
+        if (test_us - test_dq_low_us < test_reset_min_us) {
+            test_reset_min_us = (uint32_t)(test_us - test_dq_low_us);
+        }
+        test_presence = !test_absent;
+        test_bus_bits = 0;
+        test_scratchpad_bits = 0;
+        memset(test_bus, 0, sizeof(test_bus));
+    }
+    test_dq_low = 0;
+}
+
+void
+RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) {
+    (void)periph;
+    (void)state;
+}
+
+void
+GPIO_Init(GPIO_TypeDef* gpio, GPIO_InitTypeDef* init) {
+    (void)gpio;
+    test_dq_output = init->GPIO_Mode == GPIO_Mode_Out_PP;
+    if (!test_dq_output) {
+        test_dq_release();
+    }
+}
+
+void
+GPIO_ResetBits(GPIO_TypeDef* gpio, uint16_t pin) {
+    (void)gpio;
+    (void)pin;
+    if (!test_dq_low) {
+        test_dq_low = 1;
+        test_dq_low_us = test_us;
+    }
+}
+
+void
+GPIO_SetBits(GPIO_TypeDef* gpio, uint16_t pin) {
+    (void)gpio;
+    (void)pin;
+    test_dq_release();
+}
+
+/* The write slot of ds18b20_one_wire_send_bit, the level after 10 us is the bit */
+void
+GPIO_WriteBit(GPIO_TypeDef* gpio, uint16_t pin, BitAction value) {
+    (void)gpio;
+    (void)pin;
+    if (test_bus_bits < 8 * sizeof(test_bus) && value != Bit_RESET) {
+        test_bus[test_bus_bits / 8] |= (uint8_t)(1 << test_bus_bits % 8);
+    }
+    test_bus_bits++;
+    test_dq_low = 0;
+}
+
+uint8_t
+GPIO_ReadInputDataBit(GPIO_TypeDef* gpio, uint16_t pin) {
+    uint8_t bit;
+
+    (void)gpio;
+    (void)pin;
+    if (test_presence) {
+        test_presence = 0;
+        return 0;
+    }
+    if (test_absent) {
+        return 1;
+    }
+    bit = test_scratchpad[test_scratchpad_bits / 8 % 2] >> test_scratchpad_bits % 8 & 1;
+    test_scratchpad_bits++;
+    return bit;
+}
+
+/* Coroutine macros */
+
+static uint8_t test_event;
+static uint8_t test_step;
+
+static coroutine_status_t
+test_child(coroutine_t* co, uint8_t* runs) {
+    COROUTINE_BEGIN(co);
+    (*runs)++;
+    COROUTINE_YIELD(co);
+    (*runs)++;
+    COROUTINE_YIELD(co);
+    COROUTINE_END(co);
+}
+
+static coroutine_status_t
+test_sequence(coroutine_t* co) {
+    static coroutine_t child;
+    static uint8_t runs;
+
+    COROUTINE_BEGIN(co);
+    test_step = 1;
+    COROUTINE_YIELD(co);
+    test_step = 2;
+    COROUTINE_AWAIT(co, test_event);
+    test_step = 3;
+    COROUTINE_AWAIT_MS(co, 10);
+    test_step = 4;
+    COROUTINE_AWAIT_TIMEOUT(co, test_event == 2, 5);
+    test_step = test_event == 2 ? 5 : 6;
+    runs = 0;
+    COROUTINE_CALL(co, &child, test_child(&child, &runs));
+    test_step = runs == 2 ? 7 : 8;
+    if (test_event == 2) {
+        COROUTINE_EXIT(co);
+    }
+    test_step = 9;
+    COROUTINE_END(co);
+}
+
+static void
+test_macros(void) {
+    coroutine_t co;
+    uint16_t calls = 0;
+
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        coroutine_reset(&co);
+        test_event = 0;
+        test_us = 4294967000ULL; /* On a millisecond, 296 us before the wrap of the microseconds */
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 1, "step %u after the yield", test_step);
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 2, "step %u without the event", test_step);
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 2, "step %u without the event", test_step);
+        test_event = 1;
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 3, "step %u with the event", test_step);
+        test_us += 9999;
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 3, "step %u before 10 ms", test_step);
+        test_us += 1000;
+        TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING && test_step == 4, "step %u after 10 ms", test_step);
+        if (pass == 0) {
+            test_us += 4000; /* The wait started late in its millisecond, it counts from the start of it */
+            TEST_CHECK(test_sequence(&co) == COROUTINE_WAITING, "done before the timeout");
+            test_us += 1000;
+        } else {
+            test_event = 2;
+        }
+        calls = 0;
+        while (test_sequence(&co) == COROUTINE_WAITING) {
+            calls++;
+        }
+        TEST_CHECK(calls == 2, "%u calls through the child in pass %u", calls, pass);
+        TEST_CHECK(test_step == (pass == 0 ? 9 : 7), "step %u at the end of pass %u", test_step, pass);
+        TEST_CHECK(co.line == 0, "line %u after the end", co.line);
+    }
+}
+
+/* DFPlayer */
+
+static void
+test_dfplayer(void) {
+    coroutine_t co;
+    uint16_t param = 0, num = 0xFFFF;
+    uint8_t cmd;
+
+    test_us = 0;
+    df_init(20);
+    cmd = test_tx_cmd(&param);
+    TEST_CHECK(cmd == 0x3F && param == 0x02, "df_init sent %02X %04X", cmd, param);
+    TEST_CHECK(!df_is_ready(), "ready before the TF card is read");
+    df_play_from_folder(1, 1);
+    cmd = test_tx_cmd(NULL);
+    TEST_CHECK(cmd == 0, "command %02X sent while starting", cmd);
+
+    test_us = 1999999;
+    TEST_CHECK(df_init_process() == COROUTINE_WAITING && test_tx_cmd(NULL) == 0, "done before 2 s");
+    test_us = 2000000;
+    TEST_CHECK(df_init_process() == COROUTINE_DONE && df_is_ready(), "not ready after 2 s");
+    cmd = test_tx_cmd(&param);
+    TEST_CHECK(cmd == 0x06 && param == 20, "initialization ended with %02X %04X", cmd, param);
+    df_play_from_folder(1, 1);
+    cmd = test_tx_cmd(&param);
+    TEST_CHECK(cmd == 0x0F && param == 0x0101, "play sent %02X %04X", cmd, param);
+
+    /* A reply, with a stale one before the query that must not count */
+    test_df_reply(DF_RESPONSE_FOLDER_FILE_NUM, 3);
+    coroutine_reset(&co);
+    TEST_CHECK(df_get_file_num_from_folder(&co, 2, &num) == COROUTINE_WAITING, "done without a reply");
+    cmd = test_tx_cmd(&param);
+    TEST_CHECK(cmd == 0x4E && param == 2, "query sent %02X %04X", cmd, param);
+    test_us += 30000;
+    test_df_reply(DF_RESPONSE_FOLDER_FILE_NUM, 7);
+    TEST_CHECK(df_get_file_num_from_folder(&co, 2, &num) == COROUTINE_DONE && num == 7, "%u files", num);
+
+    /* No reply */
+    coroutine_reset(&co);
+    num = 0xFFFF;
+    TEST_CHECK(df_get_file_num_from_folder(&co, 3, &num) == COROUTINE_WAITING, "done without a reply");
+    test_tx_cmd(NULL);
+    test_us += 199000;
+    TEST_CHECK(df_get_file_num_from_folder(&co, 3, &num) == COROUTINE_WAITING, "timed out before 200 ms");
+    test_us += 1000;
+    TEST_CHECK(df_get_file_num_from_folder(&co, 3, &num) == COROUTINE_DONE && num == 0, "%u files without a reply",
+               num);
+}
+
+/* DS18B20 */
+
+/* Runs a transaction, the task calling again every 100 us, returns the number of times it gave way */
+static uint16_t
+test_ds18b20_run(coroutine_t* co, float* t, uint8_t read) {
+    uint16_t waits = 0;
+
+    coroutine_reset(co);
+    while ((read ? ds18b20_read_t(co, t) : ds18b20_convert_t(co)) == COROUTINE_WAITING) {
+        waits++;
+        test_us += 100;
+        if (waits > 1000) {
+            break;
+        }
+    }
+    return waits;
+}
+
+static void
+test_ds18b20(void) {
+    static const struct {
+        uint16_t raw;
+        float t;
+    } readings[] = {{0x0191, 25.0625f}, {0x0550, 85.0f}, {0x0000, 0.0f}, {0xFF5E, -10.125f}, {0xFC90, -55.0f}};
+    coroutine_t co;
+    uint16_t waits;
+    uint64_t start;
+    float t;
+
+    test_us = 0xFFFFFE00ULL; /* Across the wrap of the microseconds */
+    for (size_t r = 0; r < sizeof(readings) / sizeof(readings[0]); r++) {
+        test_reset_min_us = UINT32_MAX;
+        start = test_us;
+        waits = test_ds18b20_run(&co, NULL, 0);
+        TEST_CHECK(waits >= 5 && waits <= 6, "convert gave way %u times", waits);
+        TEST_CHECK(test_reset_min_us >= 480 && test_reset_min_us <= 520, "reset pulse of %u us", test_reset_min_us);
+        TEST_CHECK(test_bus_bits == 16 && test_bus[0] == 0xCC && test_bus[1] == 0x44, "convert wrote %u bits %02X %02X",
+                   test_bus_bits, test_bus[0], test_bus[1]);
+        TEST_CHECK(test_us - start >= 1000, "convert took %u us", (uint32_t)(test_us - start));
+
+        test_scratchpad[0] = (uint8_t)readings[r].raw;
+        test_scratchpad[1] = (uint8_t)(readings[r].raw >> 8);
+        test_reset_min_us = UINT32_MAX;
+        t = 1000.0f;
+        waits = test_ds18b20_run(&co, &t, 1);
+        TEST_CHECK(waits >= 5 && waits <= 6, "read gave way %u times", waits);
+        TEST_CHECK(test_reset_min_us >= 480 && test_reset_min_us <= 520, "reset pulse of %u us", test_reset_min_us);
+        TEST_CHECK(test_bus_bits == 16 && test_bus[0] == 0xCC && test_bus[1] == 0xBE, "read wrote %u bits %02X %02X",
+                   test_bus_bits, test_bus[0], test_bus[1]);
+        TEST_CHECK(test_scratchpad_bits == 16, "read %u bits", test_scratchpad_bits);
+        TEST_CHECK(t == readings[r].t && ds18b20_get_t() == readings[r].t, "%04X read as %g, cached %g",
+                   readings[r].raw, t, ds18b20_get_t());
+    }
+
+    /* Without an answer to the reset, nothing goes on the bus and the last temperature stays */
+    test_absent = 1;
+    waits = test_ds18b20_run(&co, NULL, 0);
+    TEST_CHECK(!ds18b20_is_present() && test_bus_bits == 0, "convert wrote %u bits to no sensor", test_bus_bits);
+    t = 1000.0f;
+    waits = test_ds18b20_run(&co, &t, 1);
+    TEST_CHECK(!ds18b20_is_present() && test_bus_bits == 0 && test_scratchpad_bits == 0,
+               "read wrote %u bits and read %u bits from no sensor", test_bus_bits, test_scratchpad_bits);
+    TEST_CHECK(t == 1000.0f && ds18b20_get_t() == -55.0f, "no sensor read as %g, cached %g", t, ds18b20_get_t());
+    test_absent = 0;
+    test_ds18b20_run(&co, NULL, 0);
+    TEST_CHECK(ds18b20_is_present(), "sensor back");
+}
+
+int
+main(void) {
+    test_macros();
+    test_dfplayer();
+    test_ds18b20();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,366 @@
+/**
+* \file            counter_test.c
+* \date            10/19/2026
+* \brief           Host tests of the time base of counter.c and the delays of delay.c
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Drives counter.c against a simulated TIM2 and delay.c against a simulated cycle counter, and
+ * checks the millisecond and microsecond time bases against 64-bit arithmetic around both of their
+ * wraps, the overflow still pending when they are read, the deadline helpers across the wraps, the
+ * compare of counter_wake_at and delay_us across the wrap of the cycle counter. Build and run from
+ * the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -ISystem/inc tools/counter_test/counter_test.c -o counter_test \
+ *       && ./counter_test
+ */
+
+#include <stdio.h>
+#include "stm32f10x.h"
+
+static uint32_t test_cycles_read(void);
+
+#define COUNTER_CYCLES() test_cycles_read()
+
+#include "../../System/src/counter.c"
+#include "../../System/src/delay.c"
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* TIM2 */
+
+TIM_TypeDef host_tim2;
+static uint8_t test_update;      /* Update flag, the overflow the interrupt has not counted yet */
+static uint8_t test_cc1;         /* CC1 flag, the counter reached the compare */
+static uint8_t test_cc1_enabled; /* CC1 interrupt enabled by counter_wake_at */
+static uint16_t test_compare;
+
+void
+RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state) {
+    (void)periph;
+    (void)state;
+}
+
+void
+nvic_enable(nvic_irq_t irq) {
+    (void)irq;
+}
+
+void
+TIM_InternalClockConfig(TIM_TypeDef* tim) {
+    (void)tim;
+}
+
+void
+TIM_TimeBaseInit(TIM_TypeDef* tim, TIM_TimeBaseInitTypeDef* init) {
+    tim->ARR = init->TIM_Period;
+    tim->CNT = 0;
+    test_update = 1; /* The update event of the StdPeriph library */
+}
+
+void
+TIM_ITConfig(TIM_TypeDef* tim, uint16_t it, FunctionalState state) {
+    (void)tim;
+    if (it == TIM_IT_CC1) {
+        test_cc1_enabled = state == ENABLE;
+    }
+}
+
+void
+TIM_Cmd(TIM_TypeDef* tim, FunctionalState state) {
+    (void)tim;
+    (void)state;
+}
+
+uint16_t
+TIM_GetCounter(TIM_TypeDef* tim) {
+    return tim->CNT;
+}
+
+void
+TIM_SetCounter(TIM_TypeDef* tim, uint16_t counter) {
+    tim->CNT = counter;
+}
+
+void
+TIM_SetCompare1(TIM_TypeDef* tim, uint16_t compare) {
+    (void)tim;
+    test_compare = compare;
+}
+
+FlagStatus
+TIM_GetFlagStatus(TIM_TypeDef* tim, uint16_t flag) {
+    (void)tim;
+    return flag == TIM_FLAG_Update && test_update ? SET : RESET;
+}
+
+ITStatus
+TIM_GetITStatus(TIM_TypeDef* tim, uint16_t it) {
+    if (it == TIM_IT_CC1) {
+        return test_cc1 && test_cc1_enabled ? SET : RESET;
+    }
+    return TIM_GetFlagStatus(tim, it);
+}
+
+void
+TIM_ClearITPendingBit(TIM_TypeDef* tim, uint16_t it) {
+    (void)tim;
+    if (it == TIM_IT_Update) {
+        test_update = 0;
+    } else if (it == TIM_IT_CC1) {
+        test_cc1 = 0;
+    }
+}
+
+/* Sets the time as overflows and counter, the truth is their 64-bit sum */
+static void
+test_set(uint32_t overflows, uint16_t cnt) {
+    counter_overflows = overflows;
+    counter_stopped_ms = 0;
+    host_tim2.CNT = cnt;
+    test_update = 0;
+}
+
+/* Advances TIM2, with the interrupt of an overflow taken or left pending */
+static void
+test_advance(uint32_t us, uint8_t interrupt) {
+    while (us--) {
+        if (++host_tim2.CNT == 0) {
+            test_update = 1;
+        }
+        if (interrupt && test_update) {
+            TIM2_IRQHandler();
+        }
+    }
+}
+
+static uint64_t
+test_truth_us(void) {
+    uint64_t us = (uint64_t)counter_overflows * COUNTER_PERIOD_US + host_tim2.CNT;
+
+    if (test_update) {
+        us += COUNTER_PERIOD_US;
+    }
+    return us + (uint64_t)counter_stopped_ms * 1000;
+}
+
+static uint32_t
+test_truth_ms(void) {
+    return (uint32_t)((test_truth_us() - (uint64_t)counter_stopped_ms * 1000) / 1000) + counter_stopped_ms;
+}
+
+/* The cycle counter, every read advances it */
+
+static uint32_t test_cycles;
+static uint32_t test_cycles_step;
+
+static uint32_t
+test_cycles_read(void) {
+    test_cycles += test_cycles_step;
+    return test_cycles;
+}
+
+/* Both time bases match 64-bit arithmetic, also where they wrap */
+static void
+test_truth(void) {
+    static const uint32_t starts[] = {0, 999, 1000, 65530, 65536 - 3, 1000000, 65536000 - 3, 0xFFFFFFFF - 3};
+    static const uint16_t cnts[] = {0, 1, 463, 464, 999, 1000, 32767, 32768, 65535};
+
+    for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        for (uint32_t o = starts[s]; o - starts[s] < 6; o++) {
+            for (size_t c = 0; c < sizeof(cnts) / sizeof(cnts[0]); c++) {
+                test_set(o, cnts[c]);
+                TEST_CHECK(counter_get_us() == (uint32_t)test_truth_us(), "overflows %u cnt %u: %u us, expected %u", o,
+                           cnts[c], counter_get_us(), (uint32_t)test_truth_us());
+                TEST_CHECK(counter_get_ms() == test_truth_ms(), "overflows %u cnt %u: %u ms, expected %u", o, cnts[c],
+                           counter_get_ms(), test_truth_ms());
+            }
+        }
+    }
+
+    /* The millisecond time base wraps to 0 exactly after 65536000 overflows */
+    test_set(65536000, 0);
+    TEST_CHECK(counter_get_ms() == 0, "%u ms at the wrap", counter_get_ms());
+    test_set(65536000 - 1, 65535);
+    TEST_CHECK(counter_get_ms() == 0xFFFFFFFF, "%u ms before the wrap", counter_get_ms());
+}
+
+/* An overflow the interrupt has not counted yet is counted by the reader */
+static void
+test_pending(void) {
+    test_set(10, 65535);
+    test_advance(5, 0);
+    TEST_CHECK(test_update && host_tim2.CNT == 4, "no overflow pending");
+    TEST_CHECK(counter_get_us() == 11 * 65536 + 4, "%u us with the overflow pending", counter_get_us());
+    TEST_CHECK(counter_get_ms() == (11 * 65536 + 4) / 1000, "%u ms with the overflow pending", counter_get_ms());
+    TIM2_IRQHandler();
+    TEST_CHECK(!test_update && counter_overflows == 11, "%u overflows", counter_overflows);
+    TEST_CHECK(counter_get_us() == 11 * 65536 + 4, "%u us after the interrupt", counter_get_us());
+
+    /* Read late in the period, the flag belongs to the overflow ahead, not yet reached */
+    test_set(10, 65000);
+    test_update = 1;
+    TEST_CHECK(counter_get_us() == 10 * 65536 + 65000, "%u us, the flag counted early", counter_get_us());
+}
+
+/* Stepping through several wraps, both time bases move forward in step with the truth */
+static void
+test_monotonic(void) {
+    uint32_t last_us, last_ms;
+
+    test_set(65536 - 2, 60000);
+    last_us = counter_get_us();
+    last_ms = counter_get_ms();
+    for (int i = 0; i < 100000; i++) {
+        uint32_t us, ms;
+
+        test_advance(7, i % 3 != 0);
+        us = counter_get_us();
+        ms = counter_get_ms();
+        TEST_CHECK(us - last_us == 7, "step of %u us at %u", us - last_us, us);
+        TEST_CHECK(ms - last_ms <= 1 && ms == test_truth_ms(), "%u ms after %u ms", ms, last_ms);
+        if (test_failures) {
+            return;
+        }
+        last_us = us;
+        last_ms = ms;
+    }
+}
+
+/* The time TIM2 stands still in STOP mode is added to both */
+static void
+test_stopped(void) {
+    test_set(100, 2000);
+    counter_advance_ms(1500);
+    TEST_CHECK(counter_get_ms() == (100 * 65536 + 2000) / 1000 + 1500, "%u ms", counter_get_ms());
+    TEST_CHECK(counter_get_us() == 100 * 65536 + 2000 + 1500000, "%u us", counter_get_us());
+}
+
+/* Deadlines set before a wrap are reached after it, not at it */
+static void
+test_deadline(void) {
+    uint32_t deadline;
+
+    test_set(65536 - 1, 65500);
+    deadline = counter_deadline_us(100);
+    TEST_CHECK(deadline < 100, "deadline %u not past the wrap", deadline);
+    TEST_CHECK(!counter_reached_us(deadline), "reached at once");
+    test_advance(99, 1);
+    TEST_CHECK(!counter_reached_us(deadline), "reached 1 us early");
+    test_advance(1, 1);
+    TEST_CHECK(counter_reached_us(deadline), "not reached");
+    test_advance(1000000, 1);
+    TEST_CHECK(counter_reached_us(deadline), "not reached long after");
+
+    test_set(65536000 - 1, 65000);
+    deadline = counter_deadline_ms(2);
+    TEST_CHECK(deadline < 2, "deadline %u not past the wrap", deadline);
+    TEST_CHECK(!counter_reached_ms(deadline), "reached at once");
+    test_advance(1000, 1);
+    TEST_CHECK(!counter_reached_ms(deadline), "reached 1 ms early");
+    test_advance(1000, 1);
+    TEST_CHECK(counter_reached_ms(deadline), "not reached");
+}
+
+/* The compare lands on the millisecond boundary, within the current TIM2 period only */
+static void
+test_wake_at(void) {
+    uint32_t ms;
+
+    test_set(3, 1500);
+    ms = counter_get_ms();
+    counter_wake_at(ms + 3);
+    TEST_CHECK(test_cc1_enabled, "no compare");
+    test_set(3, test_compare);
+    TEST_CHECK(counter_get_ms() == ms + 3 && counter_get_us() % 1000 == 0, "compare %u at %u ms, %u us", test_compare,
+               counter_get_ms(), counter_get_us());
+    test_set(3, test_compare - 1);
+    TEST_CHECK(counter_get_ms() == ms + 2, "compare %u not the first at %u ms", test_compare, ms + 3);
+
+    test_set(3, 1500);
+    counter_wake_at(ms);
+    TEST_CHECK(!test_cc1_enabled, "compare for a time already reached");
+    counter_wake_at(ms + 70);
+    TEST_CHECK(!test_cc1_enabled, "compare past the period");
+    test_set(3, 60000);
+    counter_wake_at(counter_get_ms() + 10);
+    TEST_CHECK(!test_cc1_enabled, "compare past the overflow");
+
+    test_set(3, 1500);
+    counter_wake_at(ms + 1);
+    test_update = 0;
+    host_tim2.CNT = test_compare;
+    test_cc1 = 1;
+    TIM2_IRQHandler();
+    TEST_CHECK(!test_cc1_enabled && !test_cc1, "compare still enabled after it fired");
+}
+
+/* delay_us waits at least its time, across the wrap of the cycle counter */
+static void
+test_delay(void) {
+    static const uint32_t delays[] = {0, 1, 10, 500, 1000, 59652323};
+
+    for (size_t d = 0; d < sizeof(delays) / sizeof(delays[0]); d++) {
+        uint32_t start = 0xFFFFFF00, waited;
+
+        test_cycles = start;
+        test_cycles_step = 13;
+        delay_us(delays[d]);
+        waited = test_cycles - start;
+        TEST_CHECK(waited >= delays[d] * 72 && waited <= delays[d] * 72 + 2 * 13, "delay_us(%u) waited %u cycles",
+                   delays[d], waited);
+    }
+}
+
+int
+main(void) {
+    counter_init();
+    TEST_CHECK(!test_update && counter_get_us() == 0, "%u us after counter_init", counter_get_us());
+    test_truth();
+    test_pending();
+    test_monotonic();
+    test_stopped();
+    test_deadline();
+    test_wake_at();
+    test_delay();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,457 @@
+/**
+* \file            editor_test.c
+* \date            10/19/2026
+* \brief           Host tests of the time and alarm editor
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Replays timelines of key presses through key_scan, multi_button and the editor bindings of key.c,
+ * against a simulated DS1302, and checks the fields written to it, the alarm kept in the backup
+ * registers and the speed of the held keys. Build and run from the repository root, it exits
+ * non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -IHardware/inc -ISystem/inc -ILibraries/multi_button \
+ *       tools/editor_test/editor_test.c User/src/editor.c User/src/clock.c User/src/key_scan.c \
+ *       Libraries/multi_button/multi_button.c -o editor_test && ./editor_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../../config/clock_cfg.h"
+#include "backup.h"
+#include "clock.h"
+#include "ds1302.h"
+#include "editor.h"
+#include "idle.h"
+#include "key.h"
+#include "key_scan.h"
+
+#define TEST_LOOP_MS     10   /* Main loop period */
+#define TEST_PRESS_MAX   32
+#define TEST_WRITE_MAX   8
+#define TEST_ACTIVE_LOW  0x0F /* Keys 0 ~ 3 pull the pin low, as on the board */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+static uint32_t test_ms;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+/* The simulated DS1302: running time, in the layout of ds1302_time, and the writes it got */
+uint8_t ds1302_time[8];
+static uint8_t test_rtc[7];
+static uint32_t test_rtc_ms;
+static struct {
+    uint8_t time[7];
+    uint8_t fields;
+} test_writes[TEST_WRITE_MAX];
+static int test_write_num;
+
+void
+ds1302_init(void) {}
+
+void
+ds1302_read(void) {
+    memcpy(ds1302_time, test_rtc, sizeof(test_rtc));
+}
+
+void
+ds1302_write_fields(const uint8_t* time, uint8_t fields) {
+    if (test_write_num < TEST_WRITE_MAX) {
+        memcpy(test_writes[test_write_num].time, time, 7);
+        test_writes[test_write_num].fields = fields;
+        test_write_num++;
+    }
+    for (int i = 0; i < 7; i++) {
+        if (fields & (1 << i)) {
+            test_rtc[i] = time[i];
+        }
+    }
+    if (fields & DS1302_FIELD_SECOND) {
+        test_rtc_ms = test_ms;
+    }
+}
+
+/* Seconds only, the tests do not run long enough to carry into the minutes */
+static void
+test_rtc_tick(void) {
+    while (test_ms - test_rtc_ms >= 1000) {
+        test_rtc_ms += 1000;
+        test_rtc[5] = (test_rtc[5] + 1) % 60;
+    }
+}
+
+/* The backup registers */
+static uint16_t test_backup[11];
+
+uint8_t
+backup_init(void) {
+    return 1;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    return test_backup[reg / 4];
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    test_backup[reg / 4] = value;
+}
+
+/* Never sleeps */
+void
+idle_hold(idle_client_t client, uint8_t hold) {
+    (void)client;
+    (void)hold;
+}
+
+/* The keys: scripted presses, the scanner and the bindings of key.c for the editor */
+static struct {
+    uint8_t key;
+    uint32_t start, ms;
+} test_presses[TEST_PRESS_MAX];
+static int test_press_num;
+static key_scan_t test_scan;
+static struct Button test_buttons[8];
+static struct Button* const test_list[8] = {
+    &test_buttons[0], &test_buttons[1], &test_buttons[2], &test_buttons[3],
+    &test_buttons[4], &test_buttons[5], &test_buttons[6], &test_buttons[7],
+};
+static uint8_t test_enabled;
+static uint32_t test_hold_ms, test_release_ms;
+
+static uint8_t
+test_read(uint8_t button_id) {
+    return test_scan.level >> button_id & 1;
+}
+
+static void
+test_dispatch(void* btn) {
+    struct Button* button = btn;
+    int8_t delta = button->button_id == KEY_TIME_INCREASE ? 1 : -1;
+
+    switch (button->button_id) {
+        case KEY_SET_TIME_ALARM:
+            if (button->event == SINGLE_CLICK && editor_is_open()) {
+                editor_next();
+            } else if (button->event == LONG_PRESS_START) {
+                if (!editor_is_open()) {
+                    editor_open();
+                    test_enabled |= 1 << KEY_TIME_DECREASE | 1 << KEY_TIME_INCREASE;
+                    test_scan.busy |= 1 << KEY_TIME_DECREASE | 1 << KEY_TIME_INCREASE;
+                } else {
+                    editor_save();
+                    test_enabled &= ~(1 << KEY_TIME_DECREASE | 1 << KEY_TIME_INCREASE);
+                }
+            }
+            break;
+        case KEY_TIME_DECREASE:
+        case KEY_TIME_INCREASE:
+            if (button->event == PRESS_DOWN) {
+                editor_step(delta);
+            } else if (button->event == LONG_PRESS_START) {
+                test_hold_ms = test_ms;
+                editor_hold(delta);
+            } else if (button->event == PRESS_UP) {
+                test_release_ms = test_ms;
+                editor_release();
+            }
+            break;
+        default: break;
+    }
+}
+
+/* The events key.c binds for these keys */
+static const struct {
+    uint8_t key, event;
+} test_bindings[] = {
+    {KEY_SET_TIME_ALARM, SINGLE_CLICK}, {KEY_SET_TIME_ALARM, LONG_PRESS_START},
+    {KEY_TIME_DECREASE, PRESS_DOWN},    {KEY_TIME_DECREASE, LONG_PRESS_START},
+    {KEY_TIME_DECREASE, PRESS_UP},      {KEY_TIME_INCREASE, PRESS_DOWN},
+    {KEY_TIME_INCREASE, LONG_PRESS_START}, {KEY_TIME_INCREASE, PRESS_UP},
+};
+
+static void
+test_press(uint8_t key, uint32_t after, uint32_t ms) {
+    static uint32_t last;
+    uint32_t start = (test_press_num && last > test_ms ? last : test_ms) + after;
+
+    test_presses[test_press_num].key = key;
+    test_presses[test_press_num].start = start;
+    test_presses[test_press_num].ms = ms;
+    test_press_num++;
+    last = start + ms;
+}
+
+static uint8_t
+test_port(void) {
+    uint8_t pressed = 0;
+
+    for (int i = 0; i < test_press_num; i++) {
+        if (test_ms >= test_presses[i].start && test_ms < test_presses[i].start + test_presses[i].ms) {
+            pressed |= 1 << test_presses[i].key;
+        }
+    }
+    return pressed ^ TEST_ACTIVE_LOW;
+}
+
+/* A fresh clock at a date and time, its alarm at 07:30 */
+static void
+test_start(uint8_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute) {
+    uint8_t rtc[7] = {year, month, day, hour, minute, 0, clock_weekday(year, month, day)};
+
+    memcpy(test_rtc, rtc, sizeof(rtc));
+    memset(test_backup, 0, sizeof(test_backup));
+    test_write_num = test_press_num = 0;
+    test_hold_ms = test_release_ms = 0;
+    test_rtc_ms = test_ms;
+    editor_cancel();
+    clock_init();
+
+    key_scan_init(&test_scan, TEST_ACTIVE_LOW, test_port());
+    for (uint8_t key = 0; key < 8; key++) {
+        button_init(&test_buttons[key], test_read, 1, key);
+    }
+    for (size_t i = 0; i < sizeof(test_bindings) / sizeof(test_bindings[0]); i++) {
+        button_attach(&test_buttons[test_bindings[i].key], test_bindings[i].event, test_dispatch);
+    }
+    test_enabled = 1 << KEY_SET_TIME_ALARM;
+}
+
+/* Runs the main loop and the key ticks for some time */
+static void
+test_run(uint32_t ms) {
+    uint32_t end = test_ms + ms;
+
+    for (; test_ms != end; test_ms++) {
+        if (test_ms % TICKS_INTERVAL == 0) {
+            key_scan_tick(&test_scan, test_port(), test_list, test_enabled);
+        }
+        if (test_ms % TEST_LOOP_MS == 0) {
+            test_rtc_tick();
+            clock_update();
+            editor_process();
+        }
+    }
+}
+
+/* Long presses of SET open and save, clicks far enough apart not to make a double click move on */
+static void
+test_open(int fields) {
+    test_press(KEY_SET_TIME_ALARM, 100, 600);
+    for (int i = 0; i < fields; i++) {
+        test_press(KEY_SET_TIME_ALARM, 400, 80);
+    }
+    test_run(1000 + fields * 480 + 400);
+}
+
+static void
+test_save(void) {
+    test_press(KEY_SET_TIME_ALARM, 100, 600);
+    test_run(1000);
+    TEST_CHECK(!editor_is_open(), "editor still open");
+}
+
+static void
+test_calendar(void) {
+    TEST_CHECK(clock_weekday(26, 10, 19) == 1, "2026-10-19 is a Monday");
+    TEST_CHECK(clock_weekday(24, 2, 29) == 4, "2024-02-29 is a Thursday");
+    TEST_CHECK(clock_weekday(0, 1, 1) == 6, "2000-01-01 is a Saturday");
+    TEST_CHECK(clock_weekday(23, 12, 31) == 7, "2023-12-31 is a Sunday");
+    TEST_CHECK(clock_days_in_month(24, 2) == 29 && clock_days_in_month(23, 2) == 28, "February");
+    TEST_CHECK(clock_days_in_month(23, 4) == 30 && clock_days_in_month(23, 12) == 31, "April, December");
+}
+
+/* Opening and saving without a change writes nothing */
+static void
+test_unchanged(void) {
+    test_start(26, 10, 19, 22, 15);
+    test_open(0);
+    TEST_CHECK(editor_is_open() && editor_get_field() == EDITOR_HOUR, "not editing the hour");
+    test_save();
+    TEST_CHECK(test_write_num == 0, "%d writes", test_write_num);
+    TEST_CHECK(test_backup[BACKUP_REG_GETUP_TIME / 4] == 0, "alarm written");
+}
+
+/* One click on the hour writes the hour and restarts the minute, nothing else */
+static void
+test_hour(void) {
+    test_start(26, 10, 19, 22, 15);
+    test_open(0);
+    test_press(KEY_TIME_INCREASE, 100, 100);
+    test_press(KEY_TIME_INCREASE, 150, 100);
+    test_press(KEY_TIME_DECREASE, 500, 100);
+    test_press(KEY_TIME_INCREASE, 500, 100);
+    test_run(2000);
+    TEST_CHECK(editor_get_value(EDITOR_HOUR) == 0, "hour %u, expected 0", editor_get_value(EDITOR_HOUR));
+    test_save();
+    TEST_CHECK(test_write_num == 1, "%d writes", test_write_num);
+    TEST_CHECK(test_writes[0].fields == (DS1302_FIELD_HOUR | DS1302_FIELD_SECOND), "fields 0x%02X",
+               test_writes[0].fields);
+    TEST_CHECK(test_writes[0].time[3] == 0 && test_writes[0].time[5] == 0, "wrote %02u:..:%02u", test_writes[0].time[3],
+               test_writes[0].time[5]);
+    TEST_CHECK(clock_hour == 0 && clock_minute == 15 && clock_day == 19, "clock %02u:%02u day %u", clock_hour,
+               clock_minute, clock_day);
+}
+
+/* Holding a key steps 1, then 5, then 20 times a second */
+static void
+test_hold(void) {
+    uint8_t start, last;
+    int steps[3] = {0};
+
+    test_start(26, 10, 19, 22, 15);
+    test_open(1);
+    TEST_CHECK(editor_get_field() == EDITOR_MINUTE, "not editing the minute");
+    test_press(KEY_TIME_INCREASE, 100, 7000);
+    test_run(100);
+    start = last = editor_get_value(EDITOR_MINUTE); /* Before the step of the press itself */
+    for (int i = 0; i < 7000; i += TEST_LOOP_MS) {
+        uint8_t value;
+
+        test_run(TEST_LOOP_MS);
+        value = editor_get_value(EDITOR_MINUTE);
+        if (value != last && test_hold_ms != 0) {
+            uint32_t held = test_ms - test_hold_ms;
+            int phase = held < CLOCK_CFG_EDIT_MEDIUM_AFTER_MS ? 0 : held < CLOCK_CFG_EDIT_FAST_AFTER_MS ? 1 : 2;
+
+            steps[phase] += (value - last + 60) % 60;
+        }
+        last = value;
+    }
+    test_run(500);
+    TEST_CHECK(test_release_ms > test_hold_ms, "never released");
+    /* The first repeat comes with the long press, then one a second, five a second, twenty a second */
+    TEST_CHECK(steps[0] == 2, "%d steps in the first 2 s", steps[0]);
+    TEST_CHECK(steps[1] == 10, "%d steps from 2 s to 4 s", steps[1]);
+    TEST_CHECK(steps[2] >= 20 * (int)(test_release_ms - test_hold_ms - CLOCK_CFG_EDIT_FAST_AFTER_MS) / 1000 - 1
+                   && steps[2] <= 20 * (int)(test_release_ms - test_hold_ms - CLOCK_CFG_EDIT_FAST_AFTER_MS) / 1000 + 1,
+               "%d steps after 4 s, held %u ms", steps[2], test_release_ms - test_hold_ms);
+    /* No step after the release */
+    TEST_CHECK(editor_get_value(EDITOR_MINUTE) == last, "stepped after the release");
+
+    test_save();
+    TEST_CHECK(test_write_num == 1 && test_writes[0].fields == (DS1302_FIELD_MINUTE | DS1302_FIELD_SECOND),
+               "%d writes, fields 0x%02X", test_write_num, test_writes[0].fields);
+    TEST_CHECK(test_writes[0].time[4] == (start + 1 + steps[0] + steps[1] + steps[2]) % 60, "minute %u",
+               test_writes[0].time[4]);
+}
+
+/* The day wraps at the end of the month, and the week follows the date */
+static void
+test_date(void) {
+    test_start(24, 2, 28, 9, 0);
+    test_open(EDITOR_DAY);
+    TEST_CHECK(editor_get_field() == EDITOR_DAY, "not editing the day");
+    test_press(KEY_TIME_INCREASE, 100, 100);
+    test_press(KEY_TIME_INCREASE, 150, 100);
+    test_run(1000);
+    TEST_CHECK(editor_get_value(EDITOR_DAY) == 1, "day %u, expected 1", editor_get_value(EDITOR_DAY));
+    test_save();
+    TEST_CHECK(test_write_num == 1 && test_writes[0].fields == (DS1302_FIELD_DAY | DS1302_FIELD_WEEK),
+               "%d writes, fields 0x%02X", test_write_num, test_writes[0].fields);
+    TEST_CHECK(test_writes[0].time[2] == 1 && test_writes[0].time[6] == 4, "day %u week %u", test_writes[0].time[2],
+               test_writes[0].time[6]);
+
+    /* Out of a leap year, the 29th of February becomes the 28th */
+    test_start(24, 2, 29, 9, 0);
+    test_open(EDITOR_YEAR);
+    test_press(KEY_TIME_DECREASE, 100, 100);
+    test_run(1000);
+    TEST_CHECK(editor_get_value(EDITOR_YEAR) == 23 && editor_get_value(EDITOR_DAY) == 28, "20%02u-02-%02u",
+               editor_get_value(EDITOR_YEAR), editor_get_value(EDITOR_DAY));
+    test_save();
+    TEST_CHECK(test_write_num == 1
+                   && test_writes[0].fields == (DS1302_FIELD_YEAR | DS1302_FIELD_DAY | DS1302_FIELD_WEEK),
+               "%d writes, fields 0x%02X", test_write_num, test_writes[0].fields);
+}
+
+/* The alarm goes to the backup registers, not to the RTC */
+static void
+test_alarm(void) {
+    test_start(26, 10, 19, 22, 15);
+    test_open(EDITOR_ALARM_HOUR);
+    TEST_CHECK(editor_get_field() == EDITOR_ALARM_HOUR, "not editing the alarm");
+    test_press(KEY_TIME_DECREASE, 100, 100);
+    test_run(1000);
+    test_save();
+    TEST_CHECK(test_write_num == 0, "%d writes", test_write_num);
+    TEST_CHECK(clock_get_up_time[0] == 6 && clock_get_up_time[1] == 30, "alarm %02u:%02u", clock_get_up_time[0],
+               clock_get_up_time[1]);
+    TEST_CHECK((test_backup[BACKUP_REG_GETUP_TIME / 4] & 0x7FFF) == (6 << 8 | 30), "backup 0x%04X",
+               test_backup[BACKUP_REG_GETUP_TIME / 4]);
+
+    /* And comes back after a reset */
+    clock_get_up_time[0] = clock_get_up_time[1] = 0;
+    clock_init();
+    TEST_CHECK(clock_get_up_time[0] == 6 && clock_get_up_time[1] == 30, "alarm %02u:%02u after a reset",
+               clock_get_up_time[0], clock_get_up_time[1]);
+}
+
+/* Left alone, the editor closes without writing */
+static void
+test_timeout(void) {
+    test_start(26, 10, 19, 22, 15);
+    test_open(0);
+    test_press(KEY_TIME_INCREASE, 100, 100);
+    test_run(CLOCK_CFG_EDIT_TIMEOUT_MS - 1000);
+    TEST_CHECK(editor_is_open(), "closed too early");
+    test_run(2000);
+    TEST_CHECK(!editor_is_open(), "still open");
+    TEST_CHECK(test_write_num == 0 && clock_hour == 22, "%d writes, hour %u", test_write_num, clock_hour);
+}
+
+int
+main(void) {
+    test_calendar();
+    test_unchanged();
+    test_hour();
+    test_hold();
+    test_date();
+    test_alarm();
+    test_timeout();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
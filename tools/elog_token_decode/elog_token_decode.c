@@ -0,0 +1,686 @@
+/**
+* \file            elog_token_decode.c
+* \date            10/19/2026
+* \brief           Host decoder of the tokenized logs, against the firmware ELF
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Prints the tokenized logs of a build with ELOG_TOKEN_OUTPUT_ENABLE (see elog_token.h): it reads
+ * the section elog_token out of the firmware ELF, then splits the capture of USART3 at the zero
+ * bytes, decodes each COBS frame and formats its arguments with the format string of its id. A
+ * frame that does not decode is reported and skipped, the text the port sends between the frames
+ * is printed as it is.
+ *
+ * Without arguments it checks itself: it links elog.c and elog_token.c, tokenizes logs of the
+ * firmware through ELOG_TOKEN() and the log macros, decodes them against its own ELF and compares
+ * them with the text printf gives, a byte lost on the wire included. It then times a log call
+ * tokenized and through the synchronous text output of EasyLogger, and counts their bytes on the
+ * wire. Build and run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -DDEBUG -DELOG_TOKEN_OUTPUT_ENABLE -DELOG_TOKEN_HOSTED -ILibraries/easylogger \
+ *       -Itools/host -ISystem/inc tools/elog_token_decode/elog_token_decode.c Libraries/easylogger/elog.c \
+ *       Libraries/easylogger/elog_utils.c Libraries/easylogger/elog_async.c Libraries/easylogger/elog_token.c \
+ *       System/src/log_ring.c -o elog_token_decode && ./elog_token_decode [firmware.elf [capture]]
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_TAG "DECODE"
+#include "elog.h"
+
+#define VIEW_FRAME_MAX  256
+#define VIEW_LINE_MAX   512
+#define VIEW_CASES_MAX  32
+#define BENCH_CALLS     100000
+#define BENCH_UART_BAUD 9600
+#define BENCH_UART_BITS 10 /* Start, 8 data and stop bits */
+
+static const char view_levels[] = "AEWIDV";
+
+/* Format strings out of the ELF */
+typedef struct {
+    char* data;
+    size_t size;
+} view_table_t;
+
+/* A decoded log */
+typedef struct {
+    char level;             /* A, E, W, I, D, V or R for a raw log */
+    const char* tag;
+    int tag_len;
+    uint32_t timestamp_us;
+    char text[VIEW_LINE_MAX];
+} view_log_t;
+
+/* Loads the section elog_token of an ELF, 32 or 64-bit little endian */
+static int
+view_load(const char* path, view_table_t* table) {
+    FILE* file = fopen(path, "rb");
+    unsigned char* elf;
+    long size;
+    int found = 0;
+
+    if (file == NULL) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    elf = malloc(size);
+    if (elf == NULL || fread(elf, 1, size, file) != (size_t)size || size < EI_NIDENT
+        || memcmp(elf, ELFMAG, SELFMAG) != 0 || elf[EI_DATA] != ELFDATA2LSB) {
+        fclose(file);
+        free(elf);
+        return 0;
+    }
+    fclose(file);
+
+#define VIEW_FIND(Ehdr, Shdr)                                                                                   \
+    do {                                                                                                        \
+        const Ehdr* ehdr = (const Ehdr*)elf;                                                                    \
+        const Shdr* shdr = (const Shdr*)(elf + ehdr->e_shoff);                                                  \
+        const char* names = (const char*)elf + shdr[ehdr->e_shstrndx].sh_offset;                                \
+        for (unsigned i = 0; i < ehdr->e_shnum; i++) {                                                          \
+            if (strcmp(names + shdr[i].sh_name, "elog_token") == 0 && shdr[i].sh_type == SHT_PROGBITS) {        \
+                table->size = shdr[i].sh_size;                                                                  \
+                table->data = malloc(table->size + 1);                                                          \
+                memcpy(table->data, elf + shdr[i].sh_offset, table->size);                                      \
+                table->data[table->size] = '\0';                                                                \
+                found = 1;                                                                                      \
+            }                                                                                                   \
+        }                                                                                                       \
+    } while (0)
+
+    if (elf[EI_CLASS] == ELFCLASS32) {
+        VIEW_FIND(Elf32_Ehdr, Elf32_Shdr);
+    } else {
+        VIEW_FIND(Elf64_Ehdr, Elf64_Shdr);
+    }
+#undef VIEW_FIND
+    free(elf);
+    return found;
+}
+
+/* Decodes a COBS frame without its zero, returns its length or -1 when it is broken */
+static int
+view_cobs(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t i = 0, n = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+
+        if (code == 0 || i + code - 1 > len) {
+            return -1;
+        }
+        for (uint8_t j = 1; j < code; j++) {
+            out[n++] = in[i++];
+        }
+        if (code != 0xFF && i < len) {
+            out[n++] = 0;
+        }
+    }
+    return (int)n;
+}
+
+/* Reads a varint, 0 when the frame ends first */
+static int
+view_varint(const uint8_t** p, const uint8_t* end, uint64_t* value) {
+    *value = 0;
+    for (unsigned shift = 0; *p < end && shift < 64; shift += 7) {
+        uint8_t byte = *(*p)++;
+
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Reads a zigzag integer */
+static int
+view_zigzag(const uint8_t** p, const uint8_t* end, int64_t* value) {
+    uint64_t raw;
+
+    if (!view_varint(p, end, &raw)) {
+        return 0;
+    }
+    *value = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+    return 1;
+}
+
+/* Formats the arguments as printf would on the MCU, where int and long are 32-bit; 0 when they run short */
+static int
+view_format(const char* format, const uint8_t* p, const uint8_t* end, char* out, size_t size) {
+    size_t len = 0;
+
+#define VIEW_PUT(...)                                                                                           \
+    do {                                                                                                        \
+        int n = snprintf(out + len, size - len, __VA_ARGS__);                                                   \
+        len += n < 0 ? 0 : (size_t)n;                                                                           \
+        if (len >= size) {                                                                                      \
+            len = size - 1;                                                                                     \
+        }                                                                                                       \
+    } while (0)
+
+    out[0] = '\0';
+    while (*format != '\0') {
+        char spec[32];
+        size_t spec_len = 0;
+        int64_t value;
+        char length = 0;
+
+        if (*format != '%') {
+            VIEW_PUT("%c", *format++);
+            continue;
+        }
+        spec[spec_len++] = *format++;
+        while (strchr("-+ #0", *format) != NULL && *format != '\0') {
+            spec[spec_len++] = *format++;
+        }
+        /* The width and the precision, '*' takes an argument */
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*format != '.') {
+                    break;
+                }
+                spec[spec_len++] = *format++;
+            }
+            if (*format == '*') {
+                format++;
+                if (!view_zigzag(&p, end, &value)) {
+                    return 0;
+                }
+                spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len - 8, "%d", (int)value);
+            }
+            while (*format >= '0' && *format <= '9' && spec_len < sizeof(spec) - 8) {
+                spec[spec_len++] = *format++;
+            }
+        }
+        while (strchr("hljztL", *format) != NULL && *format != '\0') {
+            length = (length == 'h' && *format == 'h') ? 'H' : (length == 'l' && *format == 'l') ? 'q' : *format;
+            format++;
+        }
+        switch (*format) {
+            case 'd':
+            case 'i':
+                if (!view_zigzag(&p, end, &value)) {
+                    return 0;
+                }
+                value = length == 'H' ? (int8_t)value : length == 'h' ? (int16_t)value
+                        : (length == 'q' || length == 'j') ? value : (int32_t)value;
+                memcpy(spec + spec_len, "lld", 4);
+                VIEW_PUT(spec, (long long)value);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                uint64_t unsigned_value;
+
+                if (!view_zigzag(&p, end, &value)) {
+                    return 0;
+                }
+                unsigned_value = length == 'H' ? (uint8_t)value : length == 'h' ? (uint16_t)value
+                                 : (length == 'q' || length == 'j') ? (uint64_t)value : (uint32_t)value;
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = 'l';
+                spec[spec_len++] = *format;
+                spec[spec_len] = '\0';
+                VIEW_PUT(spec, (unsigned long long)unsigned_value);
+                break;
+            }
+            case 'c':
+                if (!view_zigzag(&p, end, &value)) {
+                    return 0;
+                }
+                memcpy(spec + spec_len, "c", 2);
+                VIEW_PUT(spec, (int)value);
+                break;
+            case 'p':
+                if (!view_zigzag(&p, end, &value)) {
+                    return 0;
+                }
+                VIEW_PUT("0x%08lx", (unsigned long)(uint32_t)value);
+                break;
+            case 's': {
+                char str[VIEW_FRAME_MAX];
+                uint64_t str_len;
+
+                if (!view_varint(&p, end, &str_len) || str_len > (uint64_t)(end - p)) {
+                    return 0;
+                }
+                memcpy(str, p, str_len);
+                str[str_len] = '\0';
+                p += str_len;
+                memcpy(spec + spec_len, "s", 2);
+                VIEW_PUT(spec, str);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double number;
+
+                if (end - p < (long)sizeof(number)) {
+                    return 0;
+                }
+                memcpy(&number, p, sizeof(number));
+                p += sizeof(number);
+                spec[spec_len++] = *format;
+                spec[spec_len] = '\0';
+                VIEW_PUT(spec, number);
+                break;
+            }
+            case '%':
+                VIEW_PUT("%%");
+                break;
+            default:
+                /* Not a conversion, as it is */
+                spec[spec_len] = '\0';
+                VIEW_PUT("%s", spec);
+                continue;
+        }
+        format++;
+    }
+#undef VIEW_PUT
+    return p == end;
+}
+
+/* Decodes a frame, COBS and all, 0 when it is broken or its id unknown */
+static int
+view_decode(const view_table_t* table, const uint8_t* frame, size_t len, view_log_t* log) {
+    uint8_t body[VIEW_FRAME_MAX];
+    const uint8_t* p = body;
+    const char* entry;
+    const char* tag;
+    const char* format;
+    uint64_t timestamp;
+    int body_len;
+    uint16_t id;
+
+    if (len > VIEW_FRAME_MAX || (body_len = view_cobs(frame, len, body)) < 3) {
+        return 0;
+    }
+    id = body[0] | body[1] << 8;
+    p += 2;
+    if (id >= table->size || !view_varint(&p, body + body_len, &timestamp)) {
+        return 0;
+    }
+    entry = table->data + id;
+    tag = strchr(entry, '\x1F');
+    format = tag == NULL ? NULL : strchr(tag + 1, '\x1F');
+    if (format == NULL || tag != entry + 1) {
+        return 0;
+    }
+    if (entry[0] == 'R') {
+        log->level = 'R';
+    } else if (entry[0] >= '0' && entry[0] <= '5') {
+        log->level = view_levels[entry[0] - '0'];
+    } else {
+        return 0;
+    }
+    log->tag = tag + 1;
+    log->tag_len = (int)(format - tag - 1);
+    log->timestamp_us = (uint32_t)timestamp;
+    return view_format(format + 1, p, body + body_len, log->text, sizeof(log->text));
+}
+
+/* Whether a frame is text the port sent between the tokenized logs */
+static int
+view_is_text(const uint8_t* frame, size_t len) {
+    if (len == 0 || frame[len - 1] != '\n') {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if ((frame[i] < ' ' || frame[i] > '~') && frame[i] != '\r' && frame[i] != '\n') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Prints the logs of a capture, returns the frames that did not decode */
+static unsigned
+view_print(const view_table_t* table, FILE* capture) {
+    uint8_t frame[VIEW_FRAME_MAX];
+    size_t len = 0;
+    uint64_t time_us = 0;
+    uint32_t last_us = 0;
+    unsigned broken = 0;
+    int c;
+
+    while ((c = fgetc(capture)) != EOF) {
+        view_log_t log;
+
+        if (c != 0) {
+            if (len < sizeof(frame)) {
+                frame[len] = (uint8_t)c;
+            }
+            len++;
+            continue;
+        }
+        if (view_is_text(frame, len)) {
+            printf("%.*s", (int)len, frame);
+        } else if (len > 0 && view_decode(table, frame, len, &log)) {
+            /* The timestamp wraps every 71 minutes, the logs of interrupts may come slightly out of order */
+            time_us += (int32_t)(log.timestamp_us - last_us);
+            last_us = log.timestamp_us;
+            if (log.level == 'R') {
+                printf("%s", log.text);
+            } else {
+                printf("[%6llu.%06llu] %c/%-*.*s %s\n", (unsigned long long)(time_us / 1000000),
+                       (unsigned long long)(time_us % 1000000), log.level, 8, log.tag_len, log.tag, log.text);
+            }
+        } else if (len > 0) {
+            printf("(broken frame of %zu bytes)\n", len);
+            broken++;
+        }
+        len = 0;
+    }
+    return broken;
+}
+
+/* The port for the self-check: the output captured, the timestamps made up */
+static uint8_t view_capture[1 << 16];
+static size_t view_capture_len;
+static uint32_t view_timestamp_us;
+
+ElogErrCode
+elog_port_init(void) {
+    return ELOG_NO_ERR;
+}
+
+void
+elog_port_deinit(void) {}
+
+void
+elog_port_output(const char* log, size_t size) {
+    if (view_capture_len + size > sizeof(view_capture)) {
+        view_capture_len = 0;
+    }
+    memcpy(&view_capture[view_capture_len], log, size);
+    view_capture_len += size;
+}
+
+void
+elog_port_output_lock(void) {}
+
+void
+elog_port_output_unlock(void) {}
+
+const char*
+elog_port_get_time(void) {
+    return "";
+}
+
+const char*
+elog_port_get_p_info(void) {
+    return "";
+}
+
+const char*
+elog_port_get_t_info(void) {
+    return "";
+}
+
+uint32_t
+elog_port_get_timestamp(void) {
+    view_timestamp_us += 1500;
+    return view_timestamp_us;
+}
+
+static int view_failures;
+
+#define VIEW_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            view_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+static char view_expected[VIEW_CASES_MAX][VIEW_LINE_MAX];
+static char view_expected_level[VIEW_CASES_MAX];
+static int view_cases;
+
+/* A log tokenized and the text printf makes of it */
+#define VIEW_CASE(level, format, ...)                                                                           \
+    do {                                                                                                        \
+        ELOG_TOKEN(level, "TEST", format, ##__VA_ARGS__);                                                       \
+        view_expected_level[view_cases] = view_levels[level];                                                   \
+        snprintf(view_expected[view_cases++], VIEW_LINE_MAX, format, ##__VA_ARGS__);                            \
+    } while (0)
+
+/* Splits the capture into frames and decodes them in order against the expected text */
+static void
+view_check_capture(const view_table_t* table, int first, int lost) {
+    size_t start = 0;
+    int i = first;
+
+    for (size_t end = 0; end < view_capture_len; end++) {
+        view_log_t log;
+
+        if (view_capture[end] != 0) {
+            continue;
+        }
+        if (view_decode(table, &view_capture[start], end - start, &log)) {
+            VIEW_CHECK(i < view_cases, "more logs than the %d sent", view_cases);
+            if (i < view_cases) {
+                VIEW_CHECK(strcmp(log.text, view_expected[i]) == 0, "'%s', '%s' expected", log.text,
+                           view_expected[i]);
+                VIEW_CHECK(log.level == view_expected_level[i] && log.tag_len == 4 && memcmp(log.tag, "TEST", 4) == 0,
+                           "level %c tag %.*s", log.level, log.tag_len, log.tag);
+            }
+            i++;
+        } else {
+            VIEW_CHECK(lost > 0, "frame %d broken", i);
+            /* The frame with the lost byte is gone, the next one decodes */
+            lost--;
+            i++;
+        }
+        start = end + 1;
+    }
+    VIEW_CHECK(i == view_cases && lost == 0, "%d logs of %d decoded, %d losses left", i, view_cases, lost);
+}
+
+static void
+view_check(const view_table_t* table) {
+    uint8_t packet[8] = {0x7E, 0xFF, 0x06, 0x0F, 0x00, 0x03, 0x0C, 0xEF};
+    char long_str[200];
+    view_log_t log;
+    size_t start;
+    FILE* capture;
+
+    memset(long_str, 'x', sizeof(long_str) - 1);
+    long_str[sizeof(long_str) - 1] = '\0';
+
+    VIEW_CASE(ELOG_LVL_INFO, "df_play_from_folder(%d, %d) Invoked", 3, 12);
+    VIEW_CASE(ELOG_LVL_INFO, "Send packet: %02X %02X %02X %02X %02X %02X %02X %02X.", packet[0], packet[1], packet[2],
+              packet[3], packet[4], packet[5], packet[6], packet[7]);
+    VIEW_CASE(ELOG_LVL_DEBUG, "Ramp %d -> %d in %d ms", -5, 20, (int)-1000);
+    VIEW_CASE(ELOG_LVL_INFO, "%s at %d/16 degree per hour", 1 ? "Cooling" : "Warming", -3);
+    VIEW_CASE(ELOG_LVL_DEBUG, "Picked %d/%d scoring %d of %d, context 0x%05x", 2, 7, 90, 100, 0x1ABCD);
+    VIEW_CASE(ELOG_LVL_WARN, "%u key events dropped, queue full", 0xFFFFFFFFU);
+    VIEW_CASE(ELOG_LVL_DEBUG, "%-9s prio %u.%u runs %lu exec max %lu mean %lu cycles latency", "TIM3", 0U, 0U, 1234UL,
+              567UL, 89UL);
+    VIEW_CASE(ELOG_LVL_DEBUG, "%-12s %6lu.%03lu ~ %6lu.%03lu ms", "voice", 12UL, 5UL, 20UL, 75UL);
+    VIEW_CASE(ELOG_LVL_ERROR, "%llu us, %lld", 1ULL << 40, -(1LL << 35));
+    VIEW_CASE(ELOG_LVL_VERBOSE, "%.2f C, %c%c, 100%% done, [%*d]", 21.5, 'o', 'k', 6, 42);
+    VIEW_CASE(ELOG_LVL_ASSERT, "No argument");
+    VIEW_CHECK(view_capture_len == 0, "logged before EasyLogger started");
+
+    /* Again with EasyLogger started, synchronous so that the frames come out in the capture */
+    view_cases = 0;
+    elog_init();
+    elog_start();
+    elog_async_enabled(false);
+    view_capture_len = 0;
+    VIEW_CASE(ELOG_LVL_INFO, "df_play_from_folder(%d, %d) Invoked", 3, 12);
+    VIEW_CASE(ELOG_LVL_INFO, "Send packet: %02X %02X %02X %02X %02X %02X %02X %02X.", packet[0], packet[1], packet[2],
+              packet[3], packet[4], packet[5], packet[6], packet[7]);
+    VIEW_CASE(ELOG_LVL_DEBUG, "Ramp %d -> %d in %d ms", -5, 20, (int)-1000);
+    VIEW_CASE(ELOG_LVL_INFO, "%s at %d/16 degree per hour", 1 ? "Cooling" : "Warming", -3);
+    VIEW_CASE(ELOG_LVL_DEBUG, "Picked %d/%d scoring %d of %d, context 0x%05x", 2, 7, 90, 100, 0x1ABCD);
+    VIEW_CASE(ELOG_LVL_WARN, "%u key events dropped, queue full", 0xFFFFFFFFU);
+    VIEW_CASE(ELOG_LVL_DEBUG, "%-9s prio %u.%u runs %lu exec max %lu mean %lu cycles latency", "TIM3", 0U, 0U, 1234UL,
+              567UL, 89UL);
+    VIEW_CASE(ELOG_LVL_DEBUG, "%-12s %6lu.%03lu ~ %6lu.%03lu ms", "voice", 12UL, 5UL, 20UL, 75UL);
+    VIEW_CASE(ELOG_LVL_ERROR, "%llu us, %lld", 1ULL << 40, -(1LL << 35));
+    VIEW_CASE(ELOG_LVL_VERBOSE, "%.2f C, %c%c, 100%% done, [%*d]", 21.5, 'o', 'k', 6, 42);
+    VIEW_CASE(ELOG_LVL_ASSERT, "No argument");
+    view_check_capture(table, 0, 0);
+
+    /* A byte lost on the wire: that frame is broken, the ones after it decode */
+    view_capture_len = 0;
+    view_cases = 0;
+    VIEW_CASE(ELOG_LVL_INFO, "df_play_from_folder(%d, %d) Invoked", 3, 12);
+    start = view_capture_len;
+    VIEW_CASE(ELOG_LVL_DEBUG, "Ramp %d -> %d in %d ms", -5, 20, (int)-1000);
+    memmove(&view_capture[start + 3], &view_capture[start + 4], view_capture_len - start - 4);
+    view_capture_len--;
+    VIEW_CASE(ELOG_LVL_WARN, "%u key events dropped, queue full", 7U);
+    view_check_capture(table, 0, 1);
+
+    /* A string cut to fit the frame, the raw logs and the log macros */
+    view_capture_len = 0;
+    ELOG_TOKEN(ELOG_LVL_INFO, "TEST", "%s|%d", long_str, 5);
+    VIEW_CHECK(view_capture_len <= ELOG_TOKEN_FRAME_MAX, "frame of %zu bytes", view_capture_len);
+    VIEW_CHECK(view_decode(table, view_capture, view_capture_len - 1, &log) && strncmp(log.text, long_str, 64) == 0
+                   && strstr(log.text, "|5") != NULL,
+               "cut string: '%s'", log.text);
+    view_capture_len = 0;
+    elog_raw("prof %s\r\n", "00ff");
+    VIEW_CHECK(view_decode(table, view_capture, view_capture_len - 1, &log) && log.level == 'R'
+                   && strcmp(log.text, "prof 00ff\r\n") == 0,
+               "raw '%s'", log.text);
+    view_capture_len = 0;
+    log_w("Module starting, command %02X dropped.", 0x0C);
+    VIEW_CHECK(view_decode(table, view_capture, view_capture_len - 1, &log) && log.level == 'W'
+                   && strcmp(log.text, "Module starting, command 0C dropped.") == 0
+                   && log.tag_len == (int)strlen(LOG_TAG) && memcmp(log.tag, LOG_TAG, log.tag_len) == 0,
+               "log_w '%s'", log.text);
+    VIEW_CHECK(log.timestamp_us == view_timestamp_us, "timestamp %lu, %lu expected", (unsigned long)log.timestamp_us,
+               (unsigned long)view_timestamp_us);
+    printf("%d logs decoded as printf formats them\n", 2 * 11 + 3 + 3);
+
+    /* A capture as the port sends it, with the text of logs dropped in between */
+    view_capture_len = 0;
+    log_i("Catalog scanned, %d files on the card", 42);
+    elog_port_output("(2 logs dropped)\r\n", 19);
+    log_d("Ramp %d -> %d in %d ms", 3, 12, 1500);
+    elog_raw("prof %s\r\n", "0a0b");
+    capture = tmpfile();
+    fwrite(view_capture, 1, view_capture_len, capture);
+    rewind(capture);
+    VIEW_CHECK(view_print(table, capture) == 0, "broken frames in the capture");
+    fclose(capture);
+}
+
+/* Time of a log call through the synchronous output, and its bytes on the wire */
+static double
+bench_ns_per_call(int tokenized, size_t* bytes) {
+    struct timespec start, end;
+
+    view_capture_len = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < BENCH_CALLS; i++) {
+        if (tokenized) {
+            ELOG_TOKEN(ELOG_LVL_DEBUG, "TEMP", "Temperature %lu.%lu C, alarm %02lu:%02lu", (unsigned long)(20 + i % 10),
+                       (unsigned long)(i % 10), (unsigned long)(i % 24), (unsigned long)(i % 60));
+        } else {
+            elog_output(ELOG_LVL_DEBUG, "TEMP", __FILE__, __FUNCTION__, __LINE__, "Temperature %lu.%lu C, alarm %02lu:%02lu",
+                        (unsigned long)(20 + i % 10), (unsigned long)(i % 10), (unsigned long)(i % 24),
+                        (unsigned long)(i % 60));
+        }
+        if (i == 0) {
+            *bytes = view_capture_len;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / BENCH_CALLS;
+}
+
+static void
+bench(const view_table_t* table) {
+    size_t text_bytes, token_bytes;
+    double text_ns, token_ns;
+
+    /* The debug format of mian.c */
+    elog_set_fmt(ELOG_LVL_DEBUG, ELOG_FMT_ALL & ~ELOG_FMT_FUNC);
+    text_ns = bench_ns_per_call(0, &text_bytes);
+    token_ns = bench_ns_per_call(1, &token_bytes);
+    printf("%zu bytes of format strings in elog_token\n", table->size);
+    printf("log call: text %.0f ns and %zu bytes, %.1f ms at %d baud; tokenized %.0f ns and %zu bytes, %.1f ms\n",
+           text_ns, text_bytes, text_bytes * BENCH_UART_BITS * 1e3 / BENCH_UART_BAUD, BENCH_UART_BAUD, token_ns,
+           token_bytes, token_bytes * BENCH_UART_BITS * 1e3 / BENCH_UART_BAUD);
+}
+
+int
+main(int argc, char** argv) {
+    view_table_t table;
+
+    if (argc > 1) {
+        FILE* capture = argc > 2 ? fopen(argv[2], "rb") : stdin;
+
+        if (!view_load(argv[1], &table)) {
+            fprintf(stderr, "No section elog_token in %s\n", argv[1]);
+            return 1;
+        }
+        if (capture == NULL) {
+            fprintf(stderr, "Cannot open %s\n", argv[2]);
+            return 1;
+        }
+        if (table.size > 0x10000) {
+            fprintf(stderr, "%zu bytes of format strings, the ids only reach 64 KB\n", table.size);
+        }
+        return view_print(&table, capture) != 0;
+    }
+
+    VIEW_CHECK(view_load("/proc/self/exe", &table), "no section elog_token in the program");
+    if (view_failures == 0) {
+        view_check(&table);
+        bench(&table);
+    }
+    printf(view_failures ? "%d checks failed\n" : "All checks passed\n", view_failures);
+    return view_failures != 0;
+}
@@ -0,0 +1,17 @@
+/* Host stand-in for EasyLogger, the host programs print their own report */
+#ifndef ElysiaVACLK_HOST_ELOG_H
+#define ElysiaVACLK_HOST_ELOG_H
+
+#define log_a(...) ((void)0)
+#define log_e(...) ((void)0)
+#define log_w(...) ((void)0)
+#define log_i(...) ((void)0)
+#define log_d(...) ((void)0)
+#define log_v(...) ((void)0)
+
+/* A host program defines its own to capture the raw lines */
+#ifndef elog_raw
+#define elog_raw(...) ((void)0)
+#endif /* elog_raw */
+
+#endif //ElysiaVACLK_HOST_ELOG_H
@@ -0,0 +1,272 @@
+/* Host stand-in for the device header: the integer types, the interrupt masking, the exclusive accesses, the backup registers, the flash programming, the ADC and the peripherals the key, display and sensor drivers, the counter and the idle manager touch */
+#ifndef ElysiaVACLK_HOST_STM32F10X_H
+#define ElysiaVACLK_HOST_STM32F10X_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A single thread on the host, there is no interrupt to mask */
+#define __disable_irq() ((void)0)
+#define __enable_irq()  ((void)0)
+
+/*
+ * LDREX/STREX as a compare and swap of the value the load saw, per thread, so that host threads
+ * can stand in for interrupts preempting each other. Unlike the monitor, it misses a store of
+ * the same value in between, the free running counters it serves never come back to one.
+ */
+static _Thread_local uint32_t host_exclusive;
+
+static inline uint32_t
+__LDREXW(uint32_t* addr) {
+    host_exclusive = __atomic_load_n(addr, __ATOMIC_SEQ_CST);
+    return host_exclusive;
+}
+
+static inline uint32_t
+__STREXW(uint32_t value, uint32_t* addr) {
+    uint32_t expected = host_exclusive;
+
+    return !__atomic_compare_exchange_n(addr, &expected, value, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#define __CLREX() ((void)0)
+#define __DMB()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* Backup data registers, as stm32f10x_bkp.h numbers them */
+#define BKP_DR1  ((uint16_t)0x0004)
+#define BKP_DR2  ((uint16_t)0x0008)
+#define BKP_DR3  ((uint16_t)0x000C)
+#define BKP_DR4  ((uint16_t)0x0010)
+#define BKP_DR5  ((uint16_t)0x0014)
+#define BKP_DR6  ((uint16_t)0x0018)
+#define BKP_DR7  ((uint16_t)0x001C)
+#define BKP_DR8  ((uint16_t)0x0020)
+#define BKP_DR9  ((uint16_t)0x0024)
+#define BKP_DR10 ((uint16_t)0x0028)
+
+/*
+ * The peripherals of the key and display drivers, as the StdPeriph library declares them. The
+ * registers are plain memory and the functions are only declared, a host program that links the
+ * drivers defines them to simulate the hardware.
+ */
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+typedef enum { Bit_RESET = 0, Bit_SET } BitAction;
+
+typedef struct {
+    volatile uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR;
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR;
+} EXTI_TypeDef;
+
+typedef struct {
+    volatile uint16_t CR1, CNT, ARR;
+} TIM_TypeDef;
+
+extern GPIO_TypeDef host_gpioa, host_gpiob;
+extern EXTI_TypeDef host_exti;
+extern TIM_TypeDef host_tim2, host_tim3;
+
+/* The DWT cycle counter at 72 MHz, for the cycle counters a host program points at it */
+uint32_t host_dwt_cyccnt(void);
+
+#define GPIOA (&host_gpioa)
+#define GPIOB (&host_gpiob)
+#define EXTI  (&host_exti)
+#define TIM2  (&host_tim2)
+#define TIM3  (&host_tim3)
+
+#define GPIO_Pin_0 ((uint16_t)0x0001)
+#define GPIO_Pin_1 ((uint16_t)0x0002)
+#define GPIO_Pin_2 ((uint16_t)0x0004)
+#define GPIO_Pin_3 ((uint16_t)0x0008)
+#define GPIO_Pin_4 ((uint16_t)0x0010)
+#define GPIO_Pin_5 ((uint16_t)0x0020)
+#define GPIO_Pin_6 ((uint16_t)0x0040)
+#define GPIO_Pin_7 ((uint16_t)0x0080)
+#define GPIO_Pin_8 ((uint16_t)0x0100)
+#define GPIO_Pin_9 ((uint16_t)0x0200)
+
+#define GPIO_PinSource0      ((uint8_t)0x00)
+#define GPIO_PinSource7      ((uint8_t)0x07)
+#define GPIO_PortSourceGPIOA ((uint8_t)0x00)
+
+#define RCC_APB2Periph_AFIO  ((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOA ((uint32_t)0x00000004)
+#define RCC_APB2Periph_GPIOB ((uint32_t)0x00000008)
+
+#define RCC_APB1Periph_TIM2 ((uint32_t)0x00000001)
+
+#define TIM_IT_Update        ((uint16_t)0x0001)
+#define TIM_IT_CC1           ((uint16_t)0x0002)
+#define TIM_FLAG_Update      ((uint16_t)0x0001)
+#define TIM_CKD_DIV1         ((uint16_t)0x0000)
+#define TIM_CounterMode_Up   ((uint16_t)0x0000)
+
+typedef struct {
+    uint16_t TIM_Prescaler;
+    uint16_t TIM_CounterMode;
+    uint16_t TIM_Period;
+    uint16_t TIM_ClockDivision;
+    uint8_t TIM_RepetitionCounter;
+} TIM_TimeBaseInitTypeDef;
+
+/* The clocks, the RTC and the power modes the idle manager switches */
+typedef enum { ERROR = 0, SUCCESS = !ERROR } ErrorStatus;
+
+#define RCC_HSE_ON              ((uint32_t)0x00010000)
+#define RCC_FLAG_PLLRDY         ((uint8_t)0x39)
+#define RCC_FLAG_LSIRDY         ((uint8_t)0x61)
+#define RCC_SYSCLKSource_PLLCLK ((uint32_t)0x00000002)
+#define RCC_RTCCLKSource_LSI    ((uint32_t)0x00000200)
+#define RTC_IT_ALR              ((uint16_t)0x0002)
+#define EXTI_Line17             ((uint32_t)0x20000)
+#define PWR_Regulator_LowPower  ((uint32_t)0x00000001)
+#define PWR_STOPEntry_WFI       ((uint8_t)0x01)
+
+/* The flash programming of the caches kept in the last page */
+typedef enum { FLASH_BUSY = 1, FLASH_ERROR_PG, FLASH_ERROR_WRP, FLASH_COMPLETE, FLASH_TIMEOUT } FLASH_Status;
+
+#define FLASH_FLAG_EOP          ((uint32_t)0x00000020)
+#define FLASH_FLAG_PGERR        ((uint32_t)0x00000004)
+#define FLASH_FLAG_WRPRTERR     ((uint32_t)0x00000010)
+
+/* The ADC conversions of the internal temperature sensor the random generator is seeded from */
+typedef struct {
+    volatile uint32_t SR, DR;
+} ADC_TypeDef;
+
+extern ADC_TypeDef host_adc1;
+
+#define ADC1 (&host_adc1)
+
+#define RCC_PCLK2_Div6            ((uint32_t)0x00008000)
+#define RCC_APB2Periph_ADC1       ((uint32_t)0x00000200)
+#define ADC_Mode_Independent      ((uint32_t)0x00000000)
+#define ADC_ExternalTrigConv_None ((uint32_t)0x000E0000)
+#define ADC_Channel_TempSensor    ((uint8_t)0x10)
+#define ADC_SampleTime_1Cycles5   ((uint8_t)0x00)
+#define ADC_FLAG_EOC              ((uint8_t)0x02)
+
+typedef struct {
+    uint32_t ADC_Mode;
+    FunctionalState ADC_ScanConvMode;
+    FunctionalState ADC_ContinuousConvMode;
+    uint32_t ADC_ExternalTrigConv;
+    uint32_t ADC_DataAlign;
+    uint8_t ADC_NbrOfChannel;
+} ADC_InitTypeDef;
+
+typedef enum { GPIO_Speed_10MHz = 1, GPIO_Speed_2MHz, GPIO_Speed_50MHz } GPIOSpeed_TypeDef;
+typedef enum {
+    GPIO_Mode_IN_FLOATING = 0x04,
+    GPIO_Mode_IPD = 0x28,
+    GPIO_Mode_IPU = 0x48,
+    GPIO_Mode_Out_OD = 0x14,
+    GPIO_Mode_Out_PP = 0x10,
+} GPIOMode_TypeDef;
+
+typedef struct {
+    uint16_t GPIO_Pin;
+    GPIOSpeed_TypeDef GPIO_Speed;
+    GPIOMode_TypeDef GPIO_Mode;
+} GPIO_InitTypeDef;
+
+typedef enum { EXTI_Mode_Interrupt = 0x00, EXTI_Mode_Event = 0x04 } EXTIMode_TypeDef;
+typedef enum { EXTI_Trigger_Rising = 0x08, EXTI_Trigger_Falling = 0x0C, EXTI_Trigger_Rising_Falling = 0x10 } EXTITrigger_TypeDef;
+
+typedef struct {
+    uint32_t EXTI_Line;
+    EXTIMode_TypeDef EXTI_Mode;
+    EXTITrigger_TypeDef EXTI_Trigger;
+    FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+typedef enum {
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    EXTI9_5_IRQn = 23,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    RTCAlarm_IRQn = 41,
+} IRQn_Type;
+
+/* Priorities mean nothing to a host program that calls the handlers itself */
+#define NVIC_GetPriorityGrouping()           0
+#define NVIC_EncodePriority(group, pre, sub) 0
+#define NVIC_SetPriority(irq, priority)      ((void)0)
+#define NVIC_EnableIRQ(irq)                  ((void)0)
+
+typedef struct {
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state);
+void GPIO_Init(GPIO_TypeDef* gpio, GPIO_InitTypeDef* init);
+void GPIO_WriteBit(GPIO_TypeDef* gpio, uint16_t pin, BitAction value);
+void GPIO_SetBits(GPIO_TypeDef* gpio, uint16_t pin);
+void GPIO_ResetBits(GPIO_TypeDef* gpio, uint16_t pin);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* gpio, uint16_t pin);
+void GPIO_EXTILineConfig(uint8_t port_source, uint8_t pin_source);
+void EXTI_Init(EXTI_InitTypeDef* init);
+void NVIC_Init(NVIC_InitTypeDef* init);
+void RCC_APB1PeriphClockCmd(uint32_t periph, FunctionalState state);
+void TIM_InternalClockConfig(TIM_TypeDef* tim);
+void TIM_TimeBaseInit(TIM_TypeDef* tim, TIM_TimeBaseInitTypeDef* init);
+void TIM_ITConfig(TIM_TypeDef* tim, uint16_t it, FunctionalState state);
+void TIM_Cmd(TIM_TypeDef* tim, FunctionalState state);
+uint16_t TIM_GetCounter(TIM_TypeDef* tim);
+void TIM_SetCounter(TIM_TypeDef* tim, uint16_t counter);
+void TIM_SetCompare1(TIM_TypeDef* tim, uint16_t compare);
+FlagStatus TIM_GetFlagStatus(TIM_TypeDef* tim, uint16_t flag);
+ITStatus TIM_GetITStatus(TIM_TypeDef* tim, uint16_t it);
+void TIM_ClearITPendingBit(TIM_TypeDef* tim, uint16_t it);
+void EXTI_ClearITPendingBit(uint32_t line);
+void RCC_HSEConfig(uint32_t state);
+ErrorStatus RCC_WaitForHSEStartUp(void);
+void RCC_PLLCmd(FunctionalState state);
+FlagStatus RCC_GetFlagStatus(uint8_t flag);
+void RCC_SYSCLKConfig(uint32_t source);
+uint8_t RCC_GetSYSCLKSource(void);
+void RCC_LSICmd(FunctionalState state);
+void RCC_RTCCLKConfig(uint32_t source);
+void RCC_RTCCLKCmd(FunctionalState state);
+uint32_t RTC_GetCounter(void);
+void RTC_SetAlarm(uint32_t alarm);
+void RTC_SetPrescaler(uint32_t prescaler);
+void RTC_WaitForLastTask(void);
+void RTC_WaitForSynchro(void);
+void RTC_ITConfig(uint16_t it, FunctionalState state);
+ITStatus RTC_GetITStatus(uint16_t it);
+void RTC_ClearITPendingBit(uint16_t it);
+void PWR_EnterSTOPMode(uint32_t regulator, uint8_t entry);
+void __WFI(void);
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+void FLASH_ClearFlag(uint32_t flags);
+FLASH_Status FLASH_ErasePage(uint32_t address);
+FLASH_Status FLASH_ProgramHalfWord(uint32_t address, uint16_t data);
+void RCC_ADCCLKConfig(uint32_t prescaler);
+void ADC_StructInit(ADC_InitTypeDef* init);
+void ADC_Init(ADC_TypeDef* adc, ADC_InitTypeDef* init);
+void ADC_TempSensorVrefintCmd(FunctionalState state);
+void ADC_RegularChannelConfig(ADC_TypeDef* adc, uint8_t channel, uint8_t rank, uint8_t sample_time);
+void ADC_Cmd(ADC_TypeDef* adc, FunctionalState state);
+void ADC_ResetCalibration(ADC_TypeDef* adc);
+FlagStatus ADC_GetResetCalibrationStatus(ADC_TypeDef* adc);
+void ADC_StartCalibration(ADC_TypeDef* adc);
+FlagStatus ADC_GetCalibrationStatus(ADC_TypeDef* adc);
+void ADC_SoftwareStartConvCmd(ADC_TypeDef* adc, FunctionalState state);
+FlagStatus ADC_GetFlagStatus(ADC_TypeDef* adc, uint8_t flag);
+uint16_t ADC_GetConversionValue(ADC_TypeDef* adc);
+
+#endif //ElysiaVACLK_HOST_STM32F10X_H
@@ -0,0 +1,176 @@
+/**
+* \file            irq_monitor_test.c
+* \date            10/19/2026
+* \brief           Host tests of the masked section and interrupt monitor
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Drives irq_monitor.c, enabled, against a simulated cycle counter: the longest masked section
+ * keeps its function and line, a section masked again inside another is one section ending at the
+ * first unmask, an unmask without a mask is no section, and the entries, execution and latency of
+ * the interrupts are kept apart. Build and run from the repository root, it exits non-zero on
+ * failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -ISystem/inc tools/irq_monitor_test/irq_monitor_test.c \
+ *       -o irq_monitor_test && ./irq_monitor_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "stm32f10x.h"
+
+static uint32_t test_cycles;
+
+#define COUNTER_CYCLES()       test_cycles
+#define IRQ_MONITOR_CFG_ENABLE 1
+
+#include "../../System/src/irq_monitor.c"
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* A section of the given cycles, returns the line of its mask */
+static uint16_t
+test_section(uint32_t cycles) {
+    uint16_t line;
+
+    IRQ_MONITOR_MASK();
+    line = __LINE__ - 1;
+    test_cycles += cycles;
+    IRQ_MONITOR_UNMASK();
+    return line;
+}
+
+/* A section masked again inside, the inner unmask ends it */
+static uint16_t
+test_nested(uint32_t cycles) {
+    uint16_t line;
+
+    IRQ_MONITOR_MASK();
+    line = __LINE__ - 1;
+    test_cycles += cycles;
+    IRQ_MONITOR_MASK();
+    test_cycles += cycles;
+    IRQ_MONITOR_UNMASK();
+    test_cycles += cycles; /* Unmasked already, as with the bare intrinsics */
+    IRQ_MONITOR_UNMASK();
+    return line;
+}
+
+static void
+test_mask(void) {
+    irq_monitor_mask_t mask;
+    uint16_t line;
+
+    irq_monitor_get_mask(&mask);
+    TEST_CHECK(mask.count == 0 && mask.func == NULL, "no section yet, %lu", (unsigned long)mask.count);
+
+    /* Around the wrap of the cycle counter */
+    test_cycles = 0xFFFFFF00;
+    line = test_section(1000);
+    irq_monitor_get_mask(&mask);
+    TEST_CHECK(mask.count == 1 && mask.cycles_max == 1000, "section %lu cycles %lu", (unsigned long)mask.count,
+               (unsigned long)mask.cycles_max);
+    TEST_CHECK(mask.func != NULL && strcmp(mask.func, "test_section") == 0 && mask.line == line, "site %s %u",
+               mask.func ? mask.func : "-", mask.line);
+
+    /* A shorter one does not take the place of the longest */
+    test_nested(100);
+    irq_monitor_get_mask(&mask);
+    TEST_CHECK(mask.count == 2 && mask.cycles_max == 1000 && strcmp(mask.func, "test_section") == 0,
+               "sections %lu cycles %lu %s", (unsigned long)mask.count, (unsigned long)mask.cycles_max, mask.func);
+
+    /* The nested one ends at the first unmask */
+    line = test_nested(700);
+    irq_monitor_get_mask(&mask);
+    TEST_CHECK(mask.count == 3 && mask.cycles_max == 1400, "sections %lu cycles %lu", (unsigned long)mask.count,
+               (unsigned long)mask.cycles_max);
+    TEST_CHECK(strcmp(mask.func, "test_nested") == 0 && mask.line == line, "site %s %u", mask.func, mask.line);
+
+    /* An unmask alone is no section */
+    test_cycles += 100000;
+    IRQ_MONITOR_UNMASK();
+    irq_monitor_get_mask(&mask);
+    TEST_CHECK(mask.count == 3 && mask.cycles_max == 1400, "sections %lu cycles %lu", (unsigned long)mask.count,
+               (unsigned long)mask.cycles_max);
+}
+
+/* An interrupt of the given cycles, entered the given cycles after its event */
+static void
+test_handler(nvic_irq_t irq, uint32_t cycles, uint32_t latency) {
+    IRQ_MONITOR_ENTER(irq);
+    if (latency != 0) {
+        IRQ_MONITOR_LATENCY(irq, latency);
+    }
+    test_cycles += cycles;
+    IRQ_MONITOR_EXIT(irq);
+}
+
+static void
+test_irqs(void) {
+    irq_monitor_stats_t stats;
+
+    test_cycles = 0xFFFFFFF0;
+    test_handler(NVIC_IRQ_TIM2, 300, 72);
+    test_handler(NVIC_IRQ_TIM2, 100, 720);
+    test_handler(NVIC_IRQ_TIM2, 200, 0);
+    test_handler(NVIC_IRQ_EXTI0, 50, 0);
+
+    irq_monitor_get_stats(NVIC_IRQ_TIM2, &stats);
+    TEST_CHECK(stats.count == 3 && stats.cycles_max == 300 && stats.cycles_sum == 600, "TIM2 %lu max %lu sum %lu",
+               (unsigned long)stats.count, (unsigned long)stats.cycles_max, (unsigned long)stats.cycles_sum);
+    TEST_CHECK(stats.latency_count == 2 && stats.latency_max == 720, "TIM2 latency %lu max %lu",
+               (unsigned long)stats.latency_count, (unsigned long)stats.latency_max);
+
+    irq_monitor_get_stats(NVIC_IRQ_EXTI0, &stats);
+    TEST_CHECK(stats.count == 1 && stats.cycles_max == 50 && stats.latency_count == 0, "EXTI0 %lu max %lu latency %lu",
+               (unsigned long)stats.count, (unsigned long)stats.cycles_max, (unsigned long)stats.latency_count);
+
+    irq_monitor_get_stats(NVIC_IRQ_TIM3, &stats);
+    TEST_CHECK(stats.count == 0 && stats.cycles_sum == 0, "TIM3 %lu", (unsigned long)stats.count);
+}
+
+int
+main(void) {
+    test_mask();
+    test_irqs();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
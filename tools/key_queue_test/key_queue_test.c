@@ -0,0 +1,240 @@
+/**
+* \file            key_queue_test.c
+* \date            10/19/2026
+* \brief           Host tests of the key event queue under bursts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Posts bursts of key events into the queue, first in step with the main loop and then from a
+ * signal handler standing in for TIM3_IRQHandler, and checks that no event is lost, duplicated or
+ * reordered unless it is counted as dropped. Build and run from the repository root, it exits
+ * non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc tools/key_queue_test/key_queue_test.c \
+ *       -o key_queue_test && ./key_queue_test
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+
+/* Nanoseconds stand in for the cycles, clock_gettime is safe in a signal handler */
+static uint32_t test_ns(void);
+#define KEY_QUEUE_CYCLES() test_ns()
+
+#include "../../User/src/key_queue.c"
+
+#define TEST_SIGNAL_US 50     /* Period of the simulated key interrupt */
+#define TEST_RUN_MS    500    /* Length of the interrupt run */
+#define TEST_LOG_MAX   200000 /* Events the interrupt run can record */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+static uint32_t
+test_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+
+static void
+test_reset(void) {
+    key_queue_head = key_queue_tail = 0;
+    key_queue_depth_max = 0;
+    key_queue_dropped = 0;
+    key_queue_isr_max = 0;
+    key_queue_handled = 0;
+    key_queue_latency_max = key_queue_latency_sum = 0;
+}
+
+/* A burst no larger than the queue is kept whole and in order */
+static void
+test_burst(void) {
+    key_event_t event;
+    key_queue_stats_t stats;
+
+    test_reset();
+    for (int i = 0; i < KEY_QUEUE_LEN; i++) {
+        TEST_CHECK(key_queue_post(i % 8, i % 7) == 1, "post %d refused", i);
+    }
+    key_queue_get_stats(&stats);
+    TEST_CHECK(stats.depth == KEY_QUEUE_LEN && stats.depth_max == KEY_QUEUE_LEN, "depth %u max %u", stats.depth,
+               stats.depth_max);
+    for (int i = 0; i < KEY_QUEUE_LEN; i++) {
+        TEST_CHECK(key_queue_take(&event) == 1, "take %d empty", i);
+        TEST_CHECK(event.key == i % 8 && event.event == i % 7, "take %d got key %u event %u", i, event.key,
+                   event.event);
+        key_queue_note_handled(&event);
+    }
+    TEST_CHECK(key_queue_take(&event) == 0, "queue not empty");
+    key_queue_get_stats(&stats);
+    TEST_CHECK(stats.dropped == 0 && stats.handled == KEY_QUEUE_LEN, "dropped %u handled %lu", stats.dropped,
+               (unsigned long)stats.handled);
+}
+
+/* A burst larger than the queue keeps the oldest events and counts the rest */
+static void
+test_overflow(void) {
+    key_event_t event;
+    key_queue_stats_t stats;
+    int taken = 0;
+
+    test_reset();
+    for (int i = 0; i < 40; i++) {
+        key_queue_post(i, 0);
+    }
+    while (key_queue_take(&event)) {
+        TEST_CHECK(event.key == taken, "take %d got key %u", taken, event.key);
+        taken++;
+    }
+    key_queue_get_stats(&stats);
+    TEST_CHECK(taken == KEY_QUEUE_LEN, "%d taken", taken);
+    TEST_CHECK(stats.dropped == 40 - KEY_QUEUE_LEN, "%u dropped", stats.dropped);
+
+    /* Room again once drained */
+    TEST_CHECK(key_queue_post(1, 1) == 1 && key_queue_take(&event) == 1 && event.key == 1, "no room after drain");
+}
+
+/* The free running indexes wrap over uint8_t many times */
+static void
+test_wrap(void) {
+    key_event_t event;
+    uint8_t next = 0, key = 0;
+
+    test_reset();
+    for (int round = 0; round < 1000; round++) {
+        int burst = 1 + round % KEY_QUEUE_LEN;
+
+        for (int i = 0; i < burst; i++) {
+            key_queue_post(key++, 0);
+        }
+        while (key_queue_take(&event)) {
+            TEST_CHECK(event.key == next, "round %d got key %u, expected %u", round, event.key, next);
+            next = event.key + 1;
+        }
+    }
+    TEST_CHECK(key_queue_dropped == 0, "%u dropped", key_queue_dropped);
+}
+
+/* What the simulated interrupt accepted, in order, and what it attempted */
+static uint8_t test_accepted[TEST_LOG_MAX];
+static volatile int test_accepted_num;
+static volatile int test_posted;
+static volatile uint8_t test_seq;
+
+static void
+test_isr(int sig) {
+    uint32_t start = KEY_QUEUE_CYCLES();
+    int burst = 1 + (int)(start / 1000 % 8); /* 1 ~ 8 events, pseudo random */
+
+    for (int i = 0; i < burst && test_accepted_num < TEST_LOG_MAX; i++) {
+        uint8_t seq = test_seq++;
+
+        test_posted++;
+        if (key_queue_post(seq, seq % 7)) {
+            test_accepted[test_accepted_num++] = seq;
+        }
+    }
+    key_queue_note_isr(KEY_QUEUE_CYCLES() - start);
+}
+
+/* The main loop drains the queue with handlers of uneven length while the interrupt posts bursts */
+static void
+test_interrupt(void) {
+    struct itimerval timer = {{0, TEST_SIGNAL_US}, {0, TEST_SIGNAL_US}};
+    struct sigaction action = {0};
+    key_queue_stats_t stats;
+    key_event_t event;
+    uint32_t end;
+    int taken = 0, slow = 0;
+
+    test_reset();
+    action.sa_handler = test_isr;
+    sigaction(SIGALRM, &action, NULL);
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    end = test_ns() + TEST_RUN_MS * 1000000u;
+    while ((int32_t)(end - test_ns()) > 0) {
+        while (key_queue_take(&event)) {
+            /* Every 64th handler is slow enough to let the queue fill */
+            uint32_t busy = test_ns() + (++slow % 64 == 0 ? 2000000u : 2000u);
+
+            TEST_CHECK(taken < test_accepted_num, "took an event never accepted");
+            TEST_CHECK(event.key == test_accepted[taken] && event.event == event.key % 7,
+                       "event %d is key %u, expected %u", taken, event.key, test_accepted[taken]);
+            taken++;
+            while ((int32_t)(busy - test_ns()) > 0) {}
+            key_queue_note_handled(&event);
+        }
+    }
+    timer.it_value.tv_usec = timer.it_interval.tv_usec = 0;
+    setitimer(ITIMER_REAL, &timer, NULL);
+    while (key_queue_take(&event)) {
+        TEST_CHECK(event.key == test_accepted[taken], "event %d is key %u", taken, event.key);
+        taken++;
+        key_queue_note_handled(&event);
+    }
+
+    key_queue_get_stats(&stats);
+    TEST_CHECK(taken == test_accepted_num, "%d taken, %d accepted", taken, test_accepted_num);
+    TEST_CHECK(test_accepted_num + stats.dropped == test_posted, "%d accepted + %u dropped != %d posted",
+               test_accepted_num, stats.dropped, test_posted);
+    TEST_CHECK(stats.dropped > 0, "the slow handlers never filled the queue");
+    TEST_CHECK(stats.depth_max == KEY_QUEUE_LEN, "depth max %u", stats.depth_max);
+    printf("%d posted, %d handled, %u dropped, depth max %u, interrupt max %.1f us, latency max %.1f mean %.1f us\n",
+           test_posted, taken, stats.dropped, stats.depth_max, stats.isr_max / 1000.0, stats.latency_max / 1000.0,
+           stats.handled ? stats.latency_sum / 1000.0 / stats.handled : 0.0);
+}
+
+int
+main(void) {
+    test_burst();
+    test_overflow();
+    test_wrap();
+    test_interrupt();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
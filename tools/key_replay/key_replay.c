@@ -0,0 +1,1215 @@
+/**
+* \file            key_replay.c
+* \date            10/19/2026
+* \brief           Replays key records through the firmware and measures the latency to the DFPlayer and the display
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs the key, editor, clock, alarm, voice and screen modules of the firmware through the
+ * scheduler and the task table of tasks.c, in virtual time, against a simulated DFPlayer behind
+ * the UART and a simulated SSD1306 behind the bit-banged I2C, and feeds them the pin changes of a
+ * key record (see key_record.h). For each key event handled it reports the time from the press to
+ * the first DFPlayer command sent after it, and to the first change of the panel after it, as
+ * p50, p99 and max, and for each task its share of the CPU, WCET, overruns and lateness. The
+ * modules come up through the boot steps of tasks.c as on the clock, their timeline is reported
+ * with the time to the first frame and to the panel turning on, and the record starts once the
+ * last step is done. Between
+ * the tasks idle.c sleeps in a simulated WFI or STOP, its residency is checked against the virtual
+ * clock, and so is that no DFPlayer frame or TIM3 tick falls into a STOP.
+ *
+ * The record is either a capture of the log of a DEBUG build, the `krec` lines are picked out of
+ * it, or the binary stream itself. Without a record, a built-in session of every gesture is
+ * recorded with key_record.c and replayed, and `-o file` saves that record, which makes the run
+ * a benchmark of the key, voice and screen pipelines. `-i seconds` runs on that long after the
+ * record, to see the idle residency of a quiet clock. `-f` has the DFPlayer leave the catalog
+ * queries unanswered, the boot then has to end on the compile-time catalog. It exits non-zero if
+ * the boot never ends. Build and run from the repository root:
+ *
+ *   gcc -std=gnu11 -O2 -DKEY_CFG_RECORD=1 '-DKEY_QUEUE_CYCLES()=0' '-DSCHEDULER_CYCLES()=host_dwt_cyccnt()' \
+ *       -Itools/host -IUser/inc -IHardware/inc -ISystem/inc -ILibraries/multi_button tools/key_replay/key_replay.c \
+ *       User/src/key.c User/src/key_queue.c User/src/key_record.c User/src/key_scan.c \
+ *       Libraries/multi_button/multi_button.c User/src/editor.c User/src/clock.c User/src/alarm.c User/src/screen.c \
+ *       Hardware/src/ssd1306.c Hardware/src/ssd1306_fonts.c User/src/voice.c User/src/voice_category.c \
+ *       User/src/announcer.c User/src/playlist.c User/src/music.c User/src/temperature.c User/src/volume.c \
+ *       Hardware/src/dfplayer_mini.c System/src/shuffle.c System/src/scheduler.c System/src/idle.c \
+ *       System/src/soft_timer.c System/src/boot.c User/src/tasks.c \
+ *       -Wl,--wrap=key_queue_take,--wrap=screen_update -lm -o key_replay \
+ *       && ./key_replay [record] [-o record] [-i seconds] [-f]
+ *
+ * The costs of the blocking I/O below are estimates for 72 MHz, the time between two samples of a
+ * record is only as exact as the TIM3 tick that took them.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../config/key_cfg.h"
+#include "alarm.h"
+#include "backup.h"
+#include "boot.h"
+#include "clock.h"
+#include "counter.h"
+#include "delay.h"
+#include "ds1302.h"
+#include "ds18b20.h"
+#include "editor.h"
+#include "idle.h"
+#include "irq_monitor.h"
+#include "key.h"
+#include "key_queue.h"
+#include "key_record.h"
+#include "multi_button.h"
+#include "nvic.h"
+#include "random.h"
+#include "scheduler.h"
+#include "screen.h"
+#include "tasks.h"
+#include "temperature.h"
+#include "timer3.h"
+#include "uart.h"
+#include "voice.h"
+#include "voice_catalog.h"
+
+#define SIM_GPIO_NS            200ULL     /* A GPIO_WriteBit call */
+#define SIM_UART_BYTE_NS       1041667ULL /* A byte at 9600 baud, uart_send_byte waits for each */
+#define SIM_DS1302_READ_NS     150000ULL  /* ds1302_read, 7 registers bit-banged */
+#define SIM_DS18B20_RESET_NS   570000ULL  /* The reset pulse and the 70 us to the presence pulse, waited for on the spot */
+#define SIM_DS18B20_CONVERT_NS 1100000ULL /* ds18b20_convert_t after the presence window, 2 bytes on the 1-Wire bus */
+#define SIM_DS18B20_READ_NS    2200000ULL /* ds18b20_read_t after the presence window, 2 bytes out and 2 bytes in */
+#define SIM_RENDER_NS          1500000ULL /* Drawing a frame into the SSD1306 buffer */
+#define SIM_DISPATCH_NS        5000ULL    /* A pass of the main loop around a task */
+#define SIM_HSE_START_NS       1000000ULL /* The HSE crystal starting after a STOP */
+
+#define SIM_TIM2_PERIOD_US     65536ULL   /* TIM2 counts microseconds and overflows after 16 bits */
+
+#define SIM_TRACK_MS           4000 /* Every track on the simulated TF card */
+#define SIM_FOLDER_TRACKS      10   /* Tracks in every folder */
+#define SIM_COMMAND_WINDOW_MS  1000 /* A command later than this after an event is not the event's */
+#define SIM_TAIL_MS            3000 /* Run on after the last change of the record */
+#define SIM_SESSION_GAP_MS     1000 /* Between two sessions of a record, after a reset */
+#define SIM_CATALOG_LOST_MS    1500 /* voice_catalog.c giving up on a module that does not answer, 3 tries of 500 ms */
+#define SIM_BOOT_MAX_MS        10000 /* The boot not done after this is hung */
+
+#define SIM_IDLE_LEVEL         0x0F /* Pins of the released keys, keys 0 ~ 3 are active-low */
+#define SIM_KEYS               8
+
+#define MS(ns)                 ((double)(ns) / 1e6)
+
+/* Functions of key.c only the vector table knows */
+void TIM3_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void RTCAlarm_IRQHandler(void);
+
+uint8_t __real_key_queue_take(key_event_t* event);
+void __real_screen_update(void);
+
+static const char* const sim_key_names[SIM_KEYS] = {
+    "MODE", "PLAY_PAUSE", "VOICE_RESPONSE", "SET_TIME_ALARM", "VOLUME_PREV", "VOLUME_NEXT", "TIME_DECREASE", "TIME_INCREASE",
+};
+
+static const char* const sim_event_names[number_of_event] = {
+    "PRESS_DOWN", "PRESS_UP", "PRESS_REPEAT", "SINGLE_CLICK", "DOUBLE_CLICK", "LONG_PRESS_START", "LONG_PRESS_HOLD",
+};
+
+/* Time */
+
+static uint64_t sim_ns;
+
+/* Power modes, TIM2 and the DWT stand still in STOP */
+enum { SIM_RUN, SIM_SLEEP, SIM_STOP };
+static uint64_t sim_stopped_ns;  /* TIM2 stood still */
+static uint32_t sim_advanced_ms; /* counter_advance_ms made up for it */
+static uint64_t sim_wake_ns;     /* Compare of counter_wake_at, 0 if none */
+static uint64_t sim_alarm_ns;    /* RTC alarm */
+static uint64_t sim_sleep_ns, sim_stop_ns;
+static uint32_t sim_stop_lost;   /* DFPlayer frames and TIM3 ticks a STOP swallowed */
+
+/* The record being replayed, times from the first entry */
+typedef struct {
+    uint32_t ms;
+    uint8_t level;
+} sim_change_t;
+
+static sim_change_t* sim_changes;
+static size_t sim_change_num, sim_change_next;
+static uint32_t sim_lost;
+static uint64_t sim_start_ns;
+
+#define SIM_NOT_STARTED (UINT64_MAX / 2) /* sim_start_ns until the boot is done */
+static uint64_t sim_edge_ns[2][SIM_KEYS]; /* Latest release and press of each key */
+
+/* Peripherals */
+GPIO_TypeDef host_gpioa, host_gpiob;
+EXTI_TypeDef host_exti;
+TIM_TypeDef host_tim3;
+
+static uint8_t sim_tim3_on;
+static uint64_t sim_tim3_next;
+
+/* DFPlayer */
+static uart_rx_callback_t sim_df_rx;
+static uint8_t sim_df_frame[10];
+static uint8_t sim_df_len;
+static uint64_t sim_df_finish_ns; /* Time the playing track ends, 0 if none */
+static uint16_t sim_df_track;
+static uint32_t sim_df_commands;
+
+/* SSD1306 */
+static uint8_t sim_oled_ram[8][128];
+static uint8_t sim_oled_scl = 1, sim_oled_sda = 1, sim_oled_busy, sim_oled_bits, sim_oled_byte;
+static uint8_t sim_oled_index, sim_oled_control, sim_oled_page, sim_oled_column, sim_oled_changed;
+static uint32_t sim_oled_bytes, sim_oled_frames;
+static uint64_t sim_oled_on_ns; /* The panel turned on, 0 before */
+
+/* Measurements, one per key event handled */
+typedef struct {
+    uint8_t key, event;
+    uint8_t command_open, pixel_open;
+    uint64_t origin_ns, take_ns, command_ns, pixel_ns;
+} sim_measure_t;
+
+static sim_measure_t* sim_measures;
+static size_t sim_measure_num, sim_measure_cap;
+static uint32_t sim_tail_ms = SIM_TAIL_MS;
+
+/* The catalog, scanned at once, or given up on for the compile-time one when the module does not answer */
+static uint8_t sim_catalog_lost;
+static uint64_t sim_catalog_ns;
+
+static void sim_wait(uint64_t ns);
+
+/* The record */
+
+static void
+sim_add_change(uint32_t ms, uint8_t level) {
+    static size_t cap;
+
+    if (sim_change_num == cap) {
+        cap = cap ? 2 * cap : 256;
+        sim_changes = realloc(sim_changes, cap * sizeof(*sim_changes));
+    }
+    sim_changes[sim_change_num].ms = ms;
+    sim_changes[sim_change_num].level = level;
+    sim_change_num++;
+}
+
+/**
+ * \brief           Decode a record into sim_changes, sessions after a reset follow one another
+ * \return          1 if the record is well formed
+ */
+static int
+sim_decode(const uint8_t* bytes, size_t len) {
+    uint32_t ms = 0;
+    size_t i = 0;
+
+    while (i < len) {
+        if (len - i >= 3 && bytes[i] == KEY_RECORD_MAGIC_0 && bytes[i + 1] == KEY_RECORD_MAGIC_1) {
+            if (bytes[i + 2] != KEY_RECORD_VERSION) {
+                fprintf(stderr, "Record version %u, expected %u\n", bytes[i + 2], KEY_RECORD_VERSION);
+                return 0;
+            }
+            if (sim_change_num != 0) {
+                ms += SIM_SESSION_GAP_MS;
+            }
+            i += 3;
+        } else if (sim_change_num == 0) {
+            fprintf(stderr, "Record without a header\n");
+            return 0;
+        }
+
+        uint32_t value = 0;
+        uint8_t shift = 0;
+        while (i < len && (bytes[i] & 0x80) && shift < 28) {
+            value |= (uint32_t)(bytes[i++] & 0x7F) << shift;
+            shift += 7;
+        }
+        if (len - i < 2) {
+            fprintf(stderr, "Record cut short at byte %zu\n", i);
+            return 0;
+        }
+        value |= (uint32_t)bytes[i++] << shift;
+        sim_lost += value & 1;
+        ms += value >> 1;
+        sim_add_change(ms, bytes[i++]);
+    }
+    return sim_change_num != 0;
+}
+
+/**
+ * \brief           Load a record, binary or the `krec` lines of a log capture
+ */
+static int
+sim_load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    uint8_t* bytes;
+    char* text;
+    size_t len = 0, n = 0;
+    int ok;
+
+    if (file == NULL) {
+        perror(path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    len = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    text = malloc(len + 1);
+    bytes = malloc(len + 1);
+    len = fread(text, 1, len, file);
+    text[len] = '\0';
+    fclose(file);
+
+    if (len >= 2 && text[0] == KEY_RECORD_MAGIC_0 && text[1] == KEY_RECORD_MAGIC_1) {
+        memcpy(bytes, text, len);
+        n = len;
+    } else {
+        for (char* line = strstr(text, "krec "); line != NULL; line = strstr(line, "krec ")) {
+            line += 5;
+            while (isxdigit((unsigned char)line[0]) && isxdigit((unsigned char)line[1])) {
+                char digits[3] = {line[0], line[1], '\0'};
+
+                bytes[n++] = (uint8_t)strtoul(digits, NULL, 16);
+                line += 2;
+            }
+        }
+    }
+    ok = n != 0 && sim_decode(bytes, n);
+    if (n == 0) {
+        fprintf(stderr, "No key record in %s\n", path);
+    }
+    free(text);
+    free(bytes);
+    return ok;
+}
+
+/* The built-in session: a gesture is a key held for some time, some time after the previous one */
+typedef struct {
+    uint8_t key;
+    uint16_t after_ms, hold_ms;
+} sim_gesture_t;
+
+static const sim_gesture_t sim_session[] = {
+    {KEY_VOICE_RESPONSE, 1000, 120},  /* Say something */
+    {KEY_VOLUME_NEXT, 5000, 100},     /* Volume up, slowly and in a burst */
+    {KEY_VOLUME_NEXT, 600, 100},      {KEY_VOLUME_NEXT, 150, 80},      {KEY_VOLUME_NEXT, 150, 80},
+    {KEY_VOLUME_PREV, 800, 100},      /* Volume down in a burst */
+    {KEY_VOLUME_PREV, 150, 80},       {KEY_VOLUME_PREV, 150, 80},
+    {KEY_SET_TIME_ALARM, 1000, 700},  /* Edit the time */
+    {KEY_TIME_INCREASE, 400, 100},    {KEY_TIME_INCREASE, 200, 100},   {KEY_TIME_INCREASE, 400, 3000},
+    {KEY_SET_TIME_ALARM, 400, 100},   {KEY_TIME_DECREASE, 400, 100},   {KEY_TIME_DECREASE, 200, 100},
+    {KEY_SET_TIME_ALARM, 400, 700},
+    {KEY_MODE, 1000, 100},            /* Music */
+    {KEY_PLAY_PAUSE, 1000, 100},      {KEY_VOLUME_NEXT, 1000, 600},    {KEY_PLAY_PAUSE, 1000, 600},
+    {KEY_PLAY_PAUSE, 1000, 100},
+    {KEY_MODE, 1000, 100},            /* Back to the time */
+    {KEY_VOICE_RESPONSE, 2000, 600},  /* Say the time */
+};
+
+#define SIM_SESSION_REPEAT 20
+
+/**
+ * \brief           Record the built-in session with key_record.c, as the firmware does
+ */
+static void
+sim_record_session(const char* path) {
+    uint8_t* bytes = NULL;
+    size_t len = 0, cap = 0;
+    uint8_t level = SIM_IDLE_LEVEL;
+
+    sim_ns = 0;
+    key_record_init(level);
+    for (int repeat = 0; repeat < SIM_SESSION_REPEAT; repeat++) {
+        for (size_t i = 0; i < sizeof(sim_session) / sizeof(sim_session[0]); i++) {
+            for (int edge = 0; edge < 2; edge++) {
+                sim_ns += (edge ? sim_session[i].hold_ms : sim_session[i].after_ms) * 1000000ULL;
+                level ^= 1 << sim_session[i].key;
+                key_record_sample(level);
+                if (cap - len < KEY_CFG_RECORD_SIZE) {
+                    cap = cap ? 2 * cap : 4096;
+                    bytes = realloc(bytes, cap);
+                }
+                len += key_record_read(bytes + len, KEY_CFG_RECORD_SIZE);
+            }
+        }
+    }
+    if (path != NULL) {
+        FILE* file = fopen(path, "wb");
+
+        if (file == NULL || fwrite(bytes, 1, len, file) != len) {
+            perror(path);
+        }
+        if (file != NULL) {
+            fclose(file);
+        }
+    }
+    printf("Built-in session: %zu changes in %zu bytes\n", sizeof(sim_session) / sizeof(sim_session[0]) * 2 * SIM_SESSION_REPEAT,
+           len);
+    sim_decode(bytes, len);
+    free(bytes);
+}
+
+/* Measurements */
+
+static void
+sim_command(void) {
+    sim_df_commands++;
+    for (size_t i = 0; i < sim_measure_num; i++) {
+        if (sim_measures[i].command_open) {
+            sim_measures[i].command_open = 0;
+            sim_measures[i].command_ns = sim_ns;
+        }
+    }
+}
+
+static void
+sim_pixel(void) {
+    sim_oled_frames++;
+    for (size_t i = 0; i < sim_measure_num; i++) {
+        if (sim_measures[i].pixel_open) {
+            sim_measures[i].pixel_open = 0;
+            sim_measures[i].pixel_ns = sim_ns;
+        }
+    }
+}
+
+/* Notes each event key.c takes from the queue, the handlers run right after */
+uint8_t
+__wrap_key_queue_take(key_event_t* event) {
+    sim_measure_t* measure;
+
+    if (!__real_key_queue_take(event)) {
+        return 0;
+    }
+    if (sim_measure_num == sim_measure_cap) {
+        sim_measure_cap = sim_measure_cap ? 2 * sim_measure_cap : 256;
+        sim_measures = realloc(sim_measures, sim_measure_cap * sizeof(*sim_measures));
+    }
+    measure = &sim_measures[sim_measure_num++];
+    measure->key = event->key;
+    measure->event = event->event;
+    measure->origin_ns = sim_edge_ns[event->event != PRESS_UP][event->key];
+    measure->take_ns = sim_ns;
+    measure->command_open = measure->pixel_open = 1;
+    measure->command_ns = measure->pixel_ns = 0;
+    return 1;
+}
+
+/**
+ * \brief           Render a frame: the screen is up to date with the events taken before it
+ */
+void
+__wrap_screen_update(void) {
+    uint64_t start = sim_ns;
+
+    sim_wait(SIM_RENDER_NS);
+    __real_screen_update();
+    for (size_t i = 0; i < sim_measure_num; i++) {
+        if (sim_measures[i].pixel_open && sim_measures[i].take_ns <= start) {
+            sim_measures[i].pixel_open = 0;
+        }
+    }
+}
+
+/**
+ * \brief           Close the command windows gone by
+ */
+static void
+sim_expire(void) {
+    for (size_t i = 0; i < sim_measure_num; i++) {
+        if (sim_measures[i].command_open && sim_ns - sim_measures[i].take_ns > SIM_COMMAND_WINDOW_MS * 1000000ULL) {
+            sim_measures[i].command_open = 0;
+        }
+    }
+}
+
+/* Simulated hardware */
+
+static uint8_t
+sim_set_pins(uint8_t level) {
+    uint8_t changed = (uint8_t)(host_gpioa.IDR ^ level);
+    uint8_t pressed = level ^ SIM_IDLE_LEVEL;
+
+    for (uint8_t key = 0; key < SIM_KEYS; key++) {
+        if (changed >> key & 1) {
+            sim_edge_ns[pressed >> key & 1][key] = sim_ns;
+        }
+    }
+    host_gpioa.IDR = level;
+    host_exti.PR |= changed;
+    changed &= host_exti.IMR;
+    if (changed == 0) {
+        return 0;
+    }
+    if (changed & 0x01) {
+        EXTI0_IRQHandler();
+    } else if (changed & 0x02) {
+        EXTI1_IRQHandler();
+    } else if (changed & 0x04) {
+        EXTI2_IRQHandler();
+    } else if (changed & 0x08) {
+        EXTI3_IRQHandler();
+    } else if (changed & 0x10) {
+        EXTI4_IRQHandler();
+    } else if (changed & 0xE0) {
+        EXTI9_5_IRQHandler();
+    }
+    return 1;
+}
+
+static void
+sim_df_respond(uint8_t cmd, uint16_t param) {
+    uint8_t frame[10] = {0x7E, 0xFF, 0x06, cmd, 0x00, (uint8_t)(param >> 8), (uint8_t)param, 0, 0, 0xEF};
+    uint16_t checksum = 0;
+
+    for (int i = 1; i < 7; i++) {
+        checksum -= frame[i];
+    }
+    frame[7] = (uint8_t)(checksum >> 8);
+    frame[8] = (uint8_t)checksum;
+    if (sim_df_rx != NULL) {
+        sim_df_rx(frame, sizeof(frame));
+    }
+}
+
+/**
+ * \brief           Advance the time to `end`, running the interrupts and the responses of the DFPlayer due meanwhile
+ *
+ * Asleep, the first interrupt ends it early. In STOP, TIM3 and the UART stand still too, what
+ * they would have seen is lost.
+ */
+static uint8_t
+sim_run(uint64_t end, int mode) {
+    for (;;) {
+        uint64_t next = end;
+        uint8_t interrupt = 0;
+        int what = 0;
+
+        if (sim_change_next < sim_change_num && sim_start_ns + sim_changes[sim_change_next].ms * 1000000ULL < next) {
+            next = sim_start_ns + sim_changes[sim_change_next].ms * 1000000ULL;
+            what = 1;
+        }
+        if (sim_tim3_on && sim_tim3_next < next) {
+            next = sim_tim3_next;
+            what = 2;
+        }
+        if (sim_df_finish_ns != 0 && sim_df_finish_ns < next) {
+            next = sim_df_finish_ns;
+            what = 3;
+        }
+        if (what == 0) {
+            break;
+        }
+        if (next > sim_ns) {
+            sim_ns = next;
+        }
+        switch (what) {
+            case 1: interrupt = sim_set_pins(sim_changes[sim_change_next++].level); break;
+            case 2:
+                sim_tim3_next += TIMER3_PERIOD_MS * 1000000ULL;
+                if (mode == SIM_STOP) {
+                    sim_stop_lost++;
+                    break;
+                }
+                TIM3_IRQHandler();
+                interrupt = 1;
+                break;
+            default:
+                sim_df_finish_ns = 0;
+                if (mode == SIM_STOP) {
+                    sim_stop_lost++;
+                    break;
+                }
+                sim_df_respond(DF_RESPONSE_TF_FINISHED, sim_df_track);
+                interrupt = 1;
+                break;
+        }
+        if (interrupt && mode != SIM_RUN) {
+            return 1;
+        }
+    }
+    sim_ns = end;
+    return 0;
+}
+
+static void
+sim_wait(uint64_t ns) {
+    sim_run(sim_ns + ns, SIM_RUN);
+}
+
+/* The DFPlayer: a command is sent once its last byte is out */
+static void
+sim_df_byte(uint8_t byte) {
+    if (sim_df_len == 0 && byte != 0x7E) {
+        return;
+    }
+    sim_df_frame[sim_df_len++] = byte;
+    if (sim_df_len < sizeof(sim_df_frame)) {
+        return;
+    }
+    sim_df_len = 0;
+    if (byte != 0xEF) {
+        return;
+    }
+    switch (sim_df_frame[3]) {
+        case 0x03: /* Track */
+        case 0x0F: /* Folder and track */
+        case 0x12: /* MP3 folder */
+        case 0x14: /* Large folder */
+            sim_df_track = (uint16_t)(sim_df_frame[5] << 8 | sim_df_frame[6]);
+            sim_df_finish_ns = sim_ns + SIM_TRACK_MS * 1000000ULL;
+            break;
+        case 0x0E: /* Pause */
+        case 0x16: /* Stop */ sim_df_finish_ns = 0; break;
+        case 0x0D: /* Continue */ sim_df_finish_ns = sim_ns + SIM_TRACK_MS * 1000000ULL; break;
+        default: break;
+    }
+    sim_command();
+}
+
+void
+uart_init(void) {}
+
+void
+uart_set_rx_callback(uart_rx_callback_t callback) {
+    sim_df_rx = callback;
+}
+
+void
+uart_send_byte(uint8_t byte) {
+    sim_wait(SIM_UART_BYTE_NS);
+    sim_df_byte(byte);
+}
+
+void
+uart_send_bytes(const uint8_t bytes[], size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uart_send_byte(bytes[i]);
+    }
+}
+
+/* The SSD1306: decodes the I2C of ssd1306.c into its display RAM, page addressing only */
+static void
+sim_oled_take(uint8_t byte) {
+    switch (sim_oled_index++) {
+        case 0: break; /* Address */
+        case 1: sim_oled_control = byte; break;
+        default:
+            if (sim_oled_control == 0x40) {
+                sim_oled_bytes++;
+                if (sim_oled_ram[sim_oled_page][sim_oled_column] != byte) {
+                    sim_oled_ram[sim_oled_page][sim_oled_column] = byte;
+                    sim_oled_changed = 1;
+                }
+                sim_oled_column = (sim_oled_column + 1) % 128;
+            } else if (byte >= 0xB0 && byte <= 0xB7) {
+                sim_oled_page = byte - 0xB0;
+            } else if (byte <= 0x0F) {
+                sim_oled_column = (sim_oled_column & 0xF0) | byte;
+            } else if (byte <= 0x17) {
+                sim_oled_column = (uint8_t)((sim_oled_column & 0x0F) | (byte & 0x07) << 4);
+            } else if (byte == 0xAF && sim_oled_on_ns == 0) {
+                sim_oled_on_ns = sim_ns;
+            }
+            break;
+    }
+}
+
+static void
+sim_oled_pin(uint16_t pin, uint8_t value) {
+    if (pin == GPIO_Pin_9) {
+        if (sim_oled_scl && sim_oled_sda && !value) { /* Start */
+            sim_oled_busy = 1;
+            sim_oled_bits = sim_oled_index = sim_oled_changed = 0;
+        } else if (sim_oled_scl && !sim_oled_sda && value && sim_oled_busy) { /* Stop */
+            sim_oled_busy = 0;
+            if (sim_oled_changed) {
+                sim_pixel();
+            }
+        }
+        sim_oled_sda = value;
+    } else if (pin == GPIO_Pin_8) {
+        if (!sim_oled_scl && value && sim_oled_busy) {
+            if (sim_oled_bits++ < 8) {
+                sim_oled_byte = (uint8_t)(sim_oled_byte << 1 | sim_oled_sda);
+            } else { /* Acknowledge clock */
+                sim_oled_take(sim_oled_byte);
+                sim_oled_bits = 0;
+            }
+        }
+        sim_oled_scl = value;
+    }
+}
+
+void
+GPIO_WriteBit(GPIO_TypeDef* gpio, uint16_t pin, BitAction value) {
+    sim_wait(SIM_GPIO_NS);
+    if (gpio == GPIOB) {
+        sim_oled_pin(pin, value != Bit_RESET);
+    }
+}
+
+void
+RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) {
+    (void)periph;
+    (void)state;
+}
+
+void
+GPIO_Init(GPIO_TypeDef* gpio, GPIO_InitTypeDef* init) {
+    (void)gpio;
+    (void)init;
+}
+
+void
+GPIO_EXTILineConfig(uint8_t port_source, uint8_t pin_source) {
+    (void)port_source;
+    (void)pin_source;
+}
+
+void
+EXTI_Init(EXTI_InitTypeDef* init) {
+    host_exti.IMR |= init->EXTI_Line;
+}
+
+void
+nvic_enable(nvic_irq_t irq) {
+    (void)irq;
+}
+
+uint8_t
+nvic_verify(void) {
+    return 0;
+}
+
+void
+irq_monitor_report(void) {
+}
+
+ITStatus
+TIM_GetITStatus(TIM_TypeDef* tim, uint16_t it) {
+    (void)tim;
+    (void)it;
+    return SET;
+}
+
+void
+TIM_ClearITPendingBit(TIM_TypeDef* tim, uint16_t it) {
+    (void)tim;
+    (void)it;
+}
+
+void
+timer3_init(void) {}
+
+void
+timer3_start(void) {
+    sim_tim3_on = 1;
+    sim_tim3_next = sim_ns + TIMER3_PERIOD_MS * 1000000ULL;
+}
+
+void
+timer3_stop(void) {
+    sim_tim3_on = 0;
+}
+
+/* The rest of the board */
+
+uint32_t
+counter_get_ms(void) {
+    return (uint32_t)((sim_ns - sim_stopped_ns) / 1000000) + sim_advanced_ms;
+}
+
+uint32_t
+counter_get_us(void) {
+    return (uint32_t)((sim_ns - sim_stopped_ns) / 1000) + sim_advanced_ms * 1000;
+}
+
+void
+counter_wake_at(uint32_t ms) {
+    int32_t left = (int32_t)(ms - counter_get_ms());
+    uint64_t tim2 = sim_ns - sim_stopped_ns;
+
+    /* The compare of the current TIM2 period, past it the overflow wakes anyway */
+    sim_wake_ns = 0;
+    if (left > 0 && (tim2 / 1000000 + left) * 1000 < (tim2 / 1000 / SIM_TIM2_PERIOD_US + 1) * SIM_TIM2_PERIOD_US) {
+        sim_wake_ns = sim_stopped_ns + (tim2 / 1000000 + left) * 1000000;
+    }
+}
+
+void
+counter_advance_ms(uint32_t ms) {
+    sim_advanced_ms += ms;
+}
+
+uint32_t
+host_dwt_cyccnt(void) {
+    return (uint32_t)((sim_ns - sim_stopped_ns) * 72 / 1000);
+}
+
+/* Power modes */
+
+void
+__WFI(void) {
+    uint64_t start = sim_ns;
+    uint64_t tim2 = sim_ns - sim_stopped_ns;
+    uint64_t end = sim_stopped_ns + (tim2 / 1000 / SIM_TIM2_PERIOD_US + 1) * SIM_TIM2_PERIOD_US * 1000; /* TIM2 overflow */
+
+    if (sim_wake_ns > sim_ns && sim_wake_ns < end) {
+        end = sim_wake_ns;
+    }
+    sim_run(end, SIM_SLEEP);
+    sim_wake_ns = 0;
+    sim_sleep_ns += sim_ns - start;
+}
+
+void
+PWR_EnterSTOPMode(uint32_t regulator, uint8_t entry) {
+    uint64_t start = sim_ns;
+
+    (void)regulator;
+    (void)entry;
+    if (!sim_run(sim_alarm_ns > sim_ns ? sim_alarm_ns : sim_ns, SIM_STOP)) {
+        RTCAlarm_IRQHandler();
+    }
+    sim_stopped_ns += sim_ns - start;
+    sim_stop_ns += sim_ns - start;
+}
+
+/* The LSI at exactly 40 kHz, the RTC counts ms */
+uint32_t
+RTC_GetCounter(void) {
+    return (uint32_t)(sim_ns / 1000000);
+}
+
+void
+RTC_SetAlarm(uint32_t alarm) {
+    sim_alarm_ns = (uint64_t)alarm * 1000000;
+}
+
+ErrorStatus
+RCC_WaitForHSEStartUp(void) {
+    sim_wait(SIM_HSE_START_NS);
+    return SUCCESS;
+}
+
+FlagStatus
+RCC_GetFlagStatus(uint8_t flag) {
+    (void)flag;
+    return SET;
+}
+
+uint8_t
+RCC_GetSYSCLKSource(void) {
+    return 0x08;
+}
+
+ITStatus
+RTC_GetITStatus(uint16_t it) {
+    (void)it;
+    return SET;
+}
+
+void
+RCC_HSEConfig(uint32_t state) {
+    (void)state;
+}
+
+void
+RCC_PLLCmd(FunctionalState state) {
+    (void)state;
+}
+
+void
+RCC_SYSCLKConfig(uint32_t source) {
+    (void)source;
+}
+
+void
+RCC_LSICmd(FunctionalState state) {
+    (void)state;
+}
+
+void
+RCC_RTCCLKConfig(uint32_t source) {
+    (void)source;
+}
+
+void
+RCC_RTCCLKCmd(FunctionalState state) {
+    (void)state;
+}
+
+void
+RTC_SetPrescaler(uint32_t prescaler) {
+    (void)prescaler;
+}
+
+void
+RTC_WaitForLastTask(void) {}
+
+void
+RTC_WaitForSynchro(void) {}
+
+void
+RTC_ITConfig(uint16_t it, FunctionalState state) {
+    (void)it;
+    (void)state;
+}
+
+void
+RTC_ClearITPendingBit(uint16_t it) {
+    (void)it;
+}
+
+void
+EXTI_ClearITPendingBit(uint32_t line) {
+    (void)line;
+}
+
+void
+delay_us(uint32_t xus) {
+    sim_wait(xus * 1000ULL);
+}
+
+void
+delay_ms(uint32_t xms) {
+    sim_wait(xms * 1000000ULL);
+}
+
+void
+delay_s(uint32_t xs) {
+    sim_wait(xs * 1000000000ULL);
+}
+
+uint8_t ds1302_time[8] = {26, 10, 19, 7, 45, 0, 1};
+
+void
+ds1302_init(void) {}
+
+void
+ds1302_read(void) {
+    uint32_t s = (uint32_t)(sim_ns / 1000000000) + 45 * 60;
+
+    sim_wait(SIM_DS1302_READ_NS);
+    ds1302_time[3] = 7 + s / 3600 % 17;
+    ds1302_time[4] = s / 60 % 60;
+    ds1302_time[5] = s % 60;
+}
+
+void
+ds1302_write_fields(const uint8_t* time, uint8_t fields) {
+    (void)time;
+    (void)fields;
+}
+
+void
+ds18b20_init(void) {}
+
+coroutine_status_t
+ds18b20_convert_t(coroutine_t* co) {
+    COROUTINE_BEGIN(co);
+    sim_wait(SIM_DS18B20_RESET_NS);
+    COROUTINE_AWAIT_US(co, 500);
+    sim_wait(SIM_DS18B20_CONVERT_NS);
+    COROUTINE_END(co);
+}
+
+coroutine_status_t
+ds18b20_read_t(coroutine_t* co, float* t) {
+    COROUTINE_BEGIN(co);
+    sim_wait(SIM_DS18B20_RESET_NS);
+    COROUTINE_AWAIT_US(co, 500);
+    sim_wait(SIM_DS18B20_READ_NS);
+    *t = 22.5f;
+    COROUTINE_END(co);
+}
+
+float
+ds18b20_get_t(void) {
+    return 22.5f;
+}
+
+bool
+ds18b20_is_present(void) {
+    return true;
+}
+
+uint8_t
+backup_init(void) {
+    return 0;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    (void)reg;
+    return 0;
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    (void)reg;
+    (void)value;
+}
+
+static uint64_t sim_random = 0x853C49E6748FEA9BULL;
+
+void
+random_init(uint32_t seed) {
+    sim_random ^= seed;
+}
+
+uint32_t
+random_u32(void) {
+    sim_random = sim_random * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(sim_random >> 33);
+}
+
+uint32_t
+random_range(uint32_t bound) {
+    return (uint32_t)(((uint64_t)random_u32() << 32 | random_u32()) % bound);
+}
+
+void
+voice_catalog_init(void) {
+    sim_catalog_ns = sim_ns + (sim_catalog_lost ? SIM_CATALOG_LOST_MS * 1000000ULL : 0);
+}
+
+uint8_t
+voice_catalog_on_response(const df_response_t* response) {
+    (void)response;
+    return 0;
+}
+
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    (void)folder;
+    return SIM_FOLDER_TRACKS;
+}
+
+voice_catalog_status_t
+voice_catalog_get_status(void) {
+    if (sim_ns < sim_catalog_ns) {
+        return VOICE_CATALOG_SCANNING;
+    }
+    return sim_catalog_lost ? VOICE_CATALOG_FALLBACK : VOICE_CATALOG_READY;
+}
+
+/* Report */
+
+static int
+sim_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief           Print p50, p99 and max of the latencies of the measures matching a key and an event, -1 for any
+ */
+static void
+sim_print_latency(int key, int event, int pixel) {
+    uint64_t* ns = malloc((sim_measure_num + 1) * sizeof(*ns));
+    size_t n = 0, total = 0;
+
+    for (size_t i = 0; i < sim_measure_num; i++) {
+        const sim_measure_t* m = &sim_measures[i];
+        uint64_t at = pixel ? m->pixel_ns : m->command_ns;
+
+        if ((key >= 0 && m->key != key) || (event >= 0 && m->event != event)) {
+            continue;
+        }
+        total++;
+        if (at != 0) {
+            ns[n++] = at - m->origin_ns;
+        }
+    }
+    if (n == 0) {
+        printf("  %4zu/%-4zu %8s %8s %8s", n, total, "-", "-", "-");
+    } else {
+        qsort(ns, n, sizeof(*ns), sim_compare);
+        printf("  %4zu/%-4zu %8.1f %8.1f %8.1f", n, total, MS(ns[(n - 1) * 50 / 100]), MS(ns[(n - 1) * 99 / 100]),
+               MS(ns[n - 1]));
+    }
+    free(ns);
+}
+
+/**
+ * \brief           Print the instrumentation of the scheduler, CPU shares of the whole run
+ */
+static void
+sim_print_tasks(void) {
+    double elapsed = (double)scheduler_get_elapsed_ms() * 1000 * SCHEDULER_CYCLES_PER_US;
+    double busy = 0;
+
+    printf("%-12s %6s %6s %8s %7s %9s %9s %8s %6s %9s\n", "Task", "period", "budget", "runs", "cpu %", "mean us",
+           "wcet us", "overruns", "late", "lateness");
+    for (uint8_t i = 0; i < TASK_NUM; i++) {
+        const scheduler_task_t* task = scheduler_get_task(i);
+        const scheduler_stats_t* stats = scheduler_get_stats(i);
+
+        busy += (double)stats->cycles_sum;
+        printf("%-12s %6u %6u %8u %7.2f %9.1f %9.1f %8u %6u %9u\n", task->name, task->period_ms, task->budget_us,
+               stats->runs, 100 * (double)stats->cycles_sum / elapsed,
+               stats->runs ? (double)stats->cycles_sum / stats->runs / SCHEDULER_CYCLES_PER_US : 0,
+               (double)stats->cycles_max / SCHEDULER_CYCLES_PER_US, stats->overruns, stats->late,
+               stats->lateness_max);
+    }
+    printf("%-12s %6s %6s %8s %7.2f\n\n", "idle", "", "", "", 100 - 100 * busy / elapsed);
+}
+
+/**
+ * \brief           Print the timeline of the boot steps, and when the panel showed the first frame
+ */
+static void
+sim_print_boot(void) {
+    const boot_time_t* frame = boot_get_time(TASK_STEP_FRAME);
+
+    printf("%-12s %9s %9s %9s\n", "Boot step", "start ms", "done ms", "took ms");
+    for (uint8_t i = 0; i < TASK_STEP_NUM; i++) {
+        const boot_time_t* time = boot_get_time(i);
+
+        printf("%-12s %9.3f %9.3f %9.3f\n", boot_get_step(i)->name, time->start_us / 1000.0, time->done_us / 1000.0,
+               (time->done_us - time->start_us) / 1000.0);
+    }
+    printf("First frame after %.3f ms, panel on after %.3f ms%s\n\n", frame->done_us / 1000.0, MS(sim_oled_on_ns),
+           sim_oled_on_ns / 1000 > frame->done_us ? ", later than the frame" : "");
+}
+
+/**
+ * \brief           Print the residency idle.c counted, and the time the simulation spent in each mode
+ */
+static void
+sim_print_idle(void) {
+    idle_stats_t stats;
+    double total;
+
+    idle_get_stats(&stats);
+    total = (double)stats.run_ms + stats.sleep_ms + stats.stop_ms;
+    printf("Residency    run %5.1f%%  sleep %5.1f%% in %u  stop %5.1f%% in %u\n", 100 * stats.run_ms / total,
+           100 * stats.sleep_ms / total, stats.sleeps, 100 * stats.stop_ms / total, stats.stops);
+    total = (double)(sim_ns - sim_start_ns);
+    printf("Virtual time run %5.1f%%  sleep %5.1f%%        stop %5.1f%%, %u frames or ticks lost in STOP\n\n",
+           100 * (total - sim_sleep_ns - sim_stop_ns) / total, 100 * sim_sleep_ns / total, 100 * sim_stop_ns / total,
+           sim_stop_lost);
+}
+
+static void
+sim_report(void) {
+    key_queue_stats_t stats;
+
+    key_queue_get_stats(&stats);
+    printf("Replayed %zu changes over %.1f s", sim_change_num, MS(sim_ns - sim_start_ns) / 1000);
+    if (sim_lost != 0) {
+        printf(", %u gaps where the record lost changes", sim_lost);
+    }
+    printf("\n%u DFPlayer commands, %u panel updates of %u bytes, %u key events dropped\n\n", sim_df_commands,
+           sim_oled_frames, sim_oled_bytes, stats.dropped);
+    sim_print_boot();
+    sim_print_tasks();
+    sim_print_idle();
+
+    printf("%-32s  %-9s %8s %8s %8s  %-9s %8s %8s %8s\n", "Latency from the press, ms", "command", "p50", "p99", "max",
+           "pixel", "p50", "p99", "max");
+    for (int key = 0; key < SIM_KEYS; key++) {
+        for (int event = 0; event < number_of_event; event++) {
+            size_t n = 0;
+
+            for (size_t i = 0; i < sim_measure_num; i++) {
+                n += sim_measures[i].key == key && sim_measures[i].event == event;
+            }
+            if (n == 0) {
+                continue;
+            }
+            printf("%-15s %-16s", sim_key_names[key], sim_event_names[event]);
+            sim_print_latency(key, event, 0);
+            sim_print_latency(key, event, 1);
+            printf("\n");
+        }
+    }
+    printf("%-32s", "All");
+    sim_print_latency(-1, -1, 0);
+    sim_print_latency(-1, -1, 1);
+    printf("\n");
+}
+
+int
+main(int argc, char** argv) {
+    const char* record = NULL;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            sim_tail_ms = (uint32_t)atoi(argv[++i]) * 1000;
+        } else if (strcmp(argv[i], "-f") == 0) {
+            sim_catalog_lost = 1;
+        } else {
+            record = argv[i];
+        }
+    }
+    if (record != NULL ? !sim_load(record) : (sim_record_session(output), sim_change_num == 0)) {
+        return 1;
+    }
+
+    /* Boot as mian.c does, the record starts with the DFPlayer ready, once the boot task is done */
+    sim_ns = 0;
+    host_gpioa.IDR = sim_changes[0].level;
+    sim_start_ns = SIM_NOT_STARTED;
+    sim_change_next = 1;
+    tasks_init();
+
+    /* The main loop of mian.c */
+    while (sim_change_next < sim_change_num
+           || sim_ns < sim_start_ns + (sim_changes[sim_change_num - 1].ms + sim_tail_ms) * 1000000ULL) {
+        if (sim_start_ns == SIM_NOT_STARTED && boot_is_done(BOOT_STEP(TASK_STEP_NUM) - 1)) {
+            sim_start_ns = sim_ns;
+        } else if (sim_start_ns == SIM_NOT_STARTED && sim_ns > SIM_BOOT_MAX_MS * 1000000ULL) {
+            printf("Boot not done after %u ms\n\n", SIM_BOOT_MAX_MS);
+            sim_print_boot();
+            return 1;
+        }
+        if (scheduler_run()) {
+            sim_wait(SIM_DISPATCH_NS);
+        } else {
+            idle_wait();
+        }
+        sim_expire();
+    }
+    sim_report();
+    return 0;
+}
@@ -0,0 +1,322 @@
+/**
+* \file            key_scan_bench.c
+* \date            10/19/2026
+* \brief           Host benchmark of the batched key scanner against the multi_button path
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Plays scripted pin waveforms, bounce and glitches included, through the key path as it was
+ * (every started button reads its pin through read_button_gpio and debounces in multi_button)
+ * and through key_scan_tick (one port read, key_scan, only the busy keys reach the state machine).
+ * Both must report the same events on the same ticks, then the time per tick of each is
+ * measured. Build and run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -ILibraries/multi_button \
+ *       tools/key_scan_bench/key_scan_bench.c User/src/key_scan.c -o key_scan_bench && ./key_scan_bench
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "key_scan.h"
+
+/*
+ * The library twice in one program: renamed and with its own debounce for the old path, as it is
+ * for the new one.
+ */
+#undef DEBOUNCE_TICKS
+#define DEBOUNCE_TICKS   3
+#define head_handle      old_head_handle
+#define button_init      old_button_init
+#define button_attach    old_button_attach
+#define get_button_event old_get_button_event
+#define button_start     old_button_start
+#define button_stop      old_button_stop
+#define button_ticks     old_button_ticks
+#define button_handler   old_button_handler
+#include "../../Libraries/multi_button/multi_button.c"
+#undef DEBOUNCE_TICKS
+#undef head_handle
+#undef button_init
+#undef button_attach
+#undef get_button_event
+#undef button_start
+#undef button_stop
+#undef button_ticks
+#undef button_handler
+#define DEBOUNCE_TICKS 0
+#include "../../Libraries/multi_button/multi_button.c"
+
+#define BENCH_KEYS       8
+#define BENCH_ACTIVE_LOW 0x0F  /* Keys 0 ~ 3 pull the pin low, as on the board */
+#define BENCH_TICKS      12000 /* One minute of 5 ms ticks */
+#define BENCH_EVENT_MAX  1024
+#define BENCH_REPEAT     200
+
+static int bench_failures;
+
+#define BENCH_CHECK(cond, ...)                                                                                  \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            bench_failures++;                                                                                   \
+        }                                                                                                       \
+    } while (0)
+
+/* The script: pressed keys per tick, then the port as read, upper pins floating */
+static uint8_t bench_pressed[BENCH_TICKS];
+static uint16_t bench_port[BENCH_TICKS];
+static volatile uint32_t bench_idr;
+
+typedef struct {
+    uint16_t tick;
+    uint8_t key;
+    uint8_t event;
+} bench_event_t;
+
+typedef struct {
+    bench_event_t events[BENCH_EVENT_MAX];
+    int num;
+} bench_log_t;
+
+static bench_log_t bench_old_log, bench_new_log;
+static bench_log_t* bench_log;
+static uint16_t bench_tick;
+
+static void
+bench_record(void* btn) {
+    struct Button* button = btn;
+
+    if (bench_log->num < BENCH_EVENT_MAX) {
+        bench_log->events[bench_log->num].tick = bench_tick;
+        bench_log->events[bench_log->num].key = button->button_id;
+        bench_log->events[bench_log->num].event = button->event;
+        bench_log->num++;
+    }
+}
+
+/* Holds a key from `start` for `ticks`, with `bounce` glitches back to the old level after each edge */
+static void
+bench_press(uint8_t key, int start, int ticks, int bounce) {
+    for (int t = start; t < start + ticks && t < BENCH_TICKS; t++) {
+        bench_pressed[t] |= 1 << key;
+    }
+    for (int b = 0; b < bounce; b++) {
+        int press = start + 1 + 2 * b, release = start + ticks + 1 + 2 * b;
+
+        if (press < BENCH_TICKS) {
+            bench_pressed[press] &= ~(1 << key);
+        }
+        if (release < BENCH_TICKS) {
+            bench_pressed[release] |= 1 << key;
+        }
+    }
+}
+
+static void
+bench_script(void) {
+    int t = 100;
+
+    memset(bench_pressed, 0, sizeof(bench_pressed));
+    /* A clean and a bouncing click on every key */
+    for (uint8_t key = 0; key < BENCH_KEYS; key++, t += 200) {
+        bench_press(key, t, 20, 0);
+        bench_press(key, t + 100, 20, 2);
+    }
+    /* Double click, triple click, long press with hold */
+    bench_press(3, t, 15, 1);
+    bench_press(3, t + 30, 15, 1);
+    t += 200;
+    for (int i = 0; i < 3; i++) {
+        bench_press(2, t + 30 * i, 12, 0);
+    }
+    t += 200;
+    bench_press(4, t, 400, 2);
+    t += 600;
+    /* Two keys together, and one clicked while another is held */
+    bench_press(4, t, 40, 1);
+    bench_press(5, t + 5, 40, 1);
+    bench_press(0, t + 200, 200, 0);
+    bench_press(1, t + 250, 20, 0);
+    t += 600;
+    /* One and two tick glitches the debounce must swallow */
+    for (int i = 0; i < 50; i++, t += 37) {
+        bench_pressed[t] ^= 1 << (i % BENCH_KEYS);
+        if (i % 2) {
+            bench_pressed[t + 1] ^= 1 << (i % BENCH_KEYS);
+        }
+    }
+    /* The rest of the minute is idle, as most of the day is */
+    for (int i = 0; i < BENCH_TICKS; i++) {
+        bench_port[i] = (uint16_t)(0xA500 | (bench_pressed[i] ^ BENCH_ACTIVE_LOW));
+    }
+}
+
+/* The old path: read_button_gpio, one GPIO_ReadInputDataBit per button */
+__attribute__((noinline)) static uint8_t
+bench_read_input_bit(uint16_t pin) {
+    return (bench_idr & pin) != 0;
+}
+
+static uint8_t
+bench_old_read(uint8_t button_id) {
+    switch (button_id) {
+        case 0: return bench_read_input_bit(1 << 0);
+        case 1: return bench_read_input_bit(1 << 1);
+        case 2: return bench_read_input_bit(1 << 2);
+        case 3: return bench_read_input_bit(1 << 3);
+        case 4: return bench_read_input_bit(1 << 4);
+        case 5: return bench_read_input_bit(1 << 5);
+        case 6: return bench_read_input_bit(1 << 6);
+        case 7: return bench_read_input_bit(1 << 7);
+        default: return 0;
+    }
+}
+
+static struct Button bench_old_buttons[BENCH_KEYS];
+
+static void
+bench_old_init(int record) {
+    old_head_handle = NULL;
+    for (uint8_t key = 0; key < BENCH_KEYS; key++) {
+        old_button_init(&bench_old_buttons[key], bench_old_read, !(BENCH_ACTIVE_LOW >> key & 1), key);
+        for (int ev = 0; ev < number_of_event && record; ev++) {
+            old_button_attach(&bench_old_buttons[key], ev, bench_record);
+        }
+    }
+    /* Started last to first, so the list runs the keys in the order key_scan_tick does */
+    for (int key = BENCH_KEYS - 1; key >= 0; key--) {
+        old_button_start(&bench_old_buttons[key]);
+    }
+}
+
+static void
+bench_old_tick(void) {
+    old_button_ticks();
+}
+
+/* The new path, as TIM3_IRQHandler in key.c with every key started */
+static key_scan_t bench_scan;
+static struct Button bench_new_buttons[BENCH_KEYS];
+static struct Button* const bench_new_list[BENCH_KEYS] = {
+    &bench_new_buttons[0], &bench_new_buttons[1], &bench_new_buttons[2], &bench_new_buttons[3],
+    &bench_new_buttons[4], &bench_new_buttons[5], &bench_new_buttons[6], &bench_new_buttons[7],
+};
+
+static uint8_t
+bench_new_read(uint8_t button_id) {
+    return bench_scan.level >> button_id & 1;
+}
+
+static void
+bench_new_init(int record) {
+    key_scan_init(&bench_scan, BENCH_ACTIVE_LOW, (uint8_t)bench_idr);
+    bench_scan.busy = 0xFF;
+    for (uint8_t key = 0; key < BENCH_KEYS; key++) {
+        button_init(&bench_new_buttons[key], bench_new_read, 1, key);
+        for (int ev = 0; ev < number_of_event && record; ev++) {
+            button_attach(&bench_new_buttons[key], ev, bench_record);
+        }
+    }
+}
+
+static void
+bench_new_tick(void) {
+    key_scan_tick(&bench_scan, (uint8_t)bench_idr, bench_new_list, 0xFF);
+}
+
+static void
+bench_play(void (*init)(int), void (*tick)(void), int record) {
+    bench_idr = bench_port[0];
+    init(record);
+    for (bench_tick = 0; bench_tick < BENCH_TICKS; bench_tick++) {
+        bench_idr = bench_port[bench_tick];
+        tick();
+    }
+}
+
+static double
+bench_ns_per_tick(void (*init)(int), void (*tick)(void)) {
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        bench_play(init, tick, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / ((double)BENCH_REPEAT * BENCH_TICKS);
+}
+
+static void
+bench_compare(void) {
+    int clicks = 0, longs = 0;
+
+    bench_log = &bench_old_log;
+    bench_play(bench_old_init, bench_old_tick, 1);
+    bench_log = &bench_new_log;
+    bench_play(bench_new_init, bench_new_tick, 1);
+
+    BENCH_CHECK(bench_old_log.num == bench_new_log.num, "%d events before, %d now", bench_old_log.num,
+                bench_new_log.num);
+    for (int i = 0; i < bench_old_log.num && i < bench_new_log.num; i++) {
+        bench_event_t* a = &bench_old_log.events[i];
+        bench_event_t* b = &bench_new_log.events[i];
+
+        if (a->tick != b->tick || a->key != b->key || a->event != b->event) {
+            BENCH_CHECK(0, "event %d: key %u event %u tick %u before, key %u event %u tick %u now", i, a->key,
+                        a->event, a->tick, b->key, b->event, b->tick);
+            break;
+        }
+        clicks += b->event == SINGLE_CLICK;
+        longs += b->event == LONG_PRESS_START;
+    }
+    /* Two per key, the two of the chord and the one during the hold, double and triple clicks are not single */
+    BENCH_CHECK(clicks == 2 * BENCH_KEYS + 3, "%d single clicks", clicks);
+    BENCH_CHECK(longs == 2, "%d long presses", longs);
+    printf("%d events match\n", bench_new_log.num);
+}
+
+int
+main(void) {
+    double old_ns, new_ns;
+
+    bench_script();
+    bench_compare();
+
+    old_ns = bench_ns_per_tick(bench_old_init, bench_old_tick);
+    new_ns = bench_ns_per_tick(bench_new_init, bench_new_tick);
+    printf("multi_button path %.1f ns/tick, key_scan path %.1f ns/tick, %.1fx\n", old_ns, new_ns, old_ns / new_ns);
+
+    printf(bench_failures ? "%d checks failed\n" : "All checks passed\n", bench_failures);
+    return bench_failures != 0;
+}
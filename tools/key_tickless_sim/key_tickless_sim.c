@@ -0,0 +1,278 @@
+/**
+* \file            key_tickless_sim.c
+* \date            10/19/2026
+* \brief           Host simulation of the tickless key handling
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs scripted key presses millisecond by millisecond through two drivers of key_scan_tick: the
+ * old one, with TIM3 interrupting every millisecond and ticking the keys every fifth, and the
+ * tickless one of key.c, where an edge on a masked EXTI line starts a 5 ms TIM3 and the keys
+ * falling idle stop it. Both must report the same gestures within one tick of each other, and
+ * the interrupts each takes are counted, over the script and over an idle hour. Build and run
+ * from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -ILibraries/multi_button \
+ *       tools/key_tickless_sim/key_tickless_sim.c User/src/key_scan.c Libraries/multi_button/multi_button.c \
+ *       -o key_tickless_sim && ./key_tickless_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "key_scan.h"
+
+#define SIM_KEYS       8
+#define SIM_ACTIVE_LOW 0x0F /* Keys 0 ~ 3 pull the pin low, as on the board */
+#define SIM_EVENT_MAX  512
+#define SIM_HOUR_MS    (3600u * 1000u)
+
+static int sim_failures;
+
+#define SIM_CHECK(cond, ...)                                                                                    \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            sim_failures++;                                                                                     \
+        }                                                                                                       \
+    } while (0)
+
+/* A press of a key, bouncing for `bounce` ms after both edges */
+typedef struct {
+    uint8_t key;
+    uint32_t start;
+    uint32_t ms;
+    uint8_t bounce;
+} sim_press_t;
+
+typedef struct {
+    uint32_t ms;
+    uint8_t key;
+    uint8_t event;
+} sim_event_t;
+
+/* One driver: its scanner, buttons and what they reported */
+typedef struct {
+    key_scan_t scan;
+    struct Button buttons[SIM_KEYS];
+    struct Button* list[SIM_KEYS];
+    sim_event_t events[SIM_EVENT_MAX];
+    int event_num;
+    uint32_t interrupts;
+    /* Tickless only */
+    uint8_t ticking;
+    uint32_t next_tick;
+    uint32_t ticking_ms;
+} sim_driver_t;
+
+static sim_driver_t sim_old, sim_new;
+static sim_driver_t* sim_current; /* Driver whose buttons are being run */
+static uint32_t sim_ms;
+
+static uint8_t
+sim_read(uint8_t button_id) {
+    return sim_current->scan.level >> button_id & 1;
+}
+
+static void
+sim_record(void* btn) {
+    struct Button* button = btn;
+
+    if (sim_current->event_num < SIM_EVENT_MAX) {
+        sim_event_t* e = &sim_current->events[sim_current->event_num++];
+
+        e->ms = sim_ms;
+        e->key = button->button_id;
+        e->event = button->event;
+    }
+}
+
+static void
+sim_init(sim_driver_t* d, uint8_t port) {
+    memset(d, 0, sizeof(*d));
+    sim_current = d;
+    key_scan_init(&d->scan, SIM_ACTIVE_LOW, port);
+    for (uint8_t key = 0; key < SIM_KEYS; key++) {
+        d->list[key] = &d->buttons[key];
+        button_init(&d->buttons[key], sim_read, 1, key);
+        for (int ev = 0; ev < number_of_event; ev++) {
+            if (ev != LONG_PRESS_HOLD) {
+                button_attach(&d->buttons[key], ev, sim_record);
+            }
+        }
+    }
+    /* key_start of every key */
+    d->scan.busy = 0xFF;
+    d->ticking = 1;
+    d->next_tick = TICKS_INTERVAL;
+}
+
+static uint8_t
+sim_port(const sim_press_t* script, int num, uint32_t ms) {
+    uint8_t pressed = 0;
+
+    for (int i = 0; i < num; i++) {
+        const sim_press_t* p = &script[i];
+        uint32_t end = p->start + p->ms;
+        uint8_t on = ms >= p->start && ms < end;
+
+        /* Bounce flips the level every other millisecond right after an edge */
+        if ((ms >= p->start && ms < p->start + p->bounce) || (ms >= end && ms < end + p->bounce)) {
+            on = ((ms - (ms >= end ? end : p->start)) & 1) ? !on : on;
+        }
+        pressed |= on << p->key;
+    }
+    return pressed ^ SIM_ACTIVE_LOW;
+}
+
+/* The old driver: TIM3 at 1 kHz, the keys on every fifth interrupt */
+static void
+sim_old_ms(uint8_t port) {
+    sim_current = &sim_old;
+    sim_old.interrupts++;
+    if (sim_ms % TICKS_INTERVAL == 0) {
+        key_scan_tick(&sim_old.scan, port, sim_old.list, 0xFF);
+    }
+}
+
+/* The tickless driver, as key_wake, key_sleep, TIM3_IRQHandler and the EXTI handlers of key.c */
+static void
+sim_new_wake(void) {
+    if (!sim_new.ticking) {
+        sim_new.ticking = 1;
+        sim_new.next_tick = sim_ms + TICKS_INTERVAL;
+    }
+}
+
+static void
+sim_new_ms(uint8_t port, uint8_t edge) {
+    sim_current = &sim_new;
+    if (!sim_new.ticking && edge) {
+        sim_new.interrupts++; /* EXTI */
+        sim_new_wake();
+    }
+    if (sim_new.ticking) {
+        sim_new.ticking_ms++;
+    }
+    if (sim_new.ticking && sim_ms == sim_new.next_tick) {
+        sim_new.interrupts++; /* TIM3 */
+        sim_new.next_tick += TICKS_INTERVAL;
+        if (!key_scan_tick(&sim_new.scan, port, sim_new.list, 0xFF)) {
+            sim_new.ticking = 0;
+            if ((uint8_t)(port ^ sim_new.scan.active_low) != sim_new.scan.level) {
+                sim_new_wake();
+            }
+        }
+    }
+}
+
+static void
+sim_run(const sim_press_t* script, int num, uint32_t length) {
+    uint8_t port = sim_port(script, num, 0), last = port;
+
+    sim_ms = 0;
+    sim_init(&sim_old, port);
+    sim_init(&sim_new, port);
+    for (sim_ms = 0; sim_ms < length; sim_ms++) {
+        port = sim_port(script, num, sim_ms);
+        sim_old_ms(port);
+        sim_new_ms(port, port != last);
+        last = port;
+    }
+}
+
+/* Same gestures, in the same order, each at most a tick apart */
+static void
+sim_compare(const char* name, int clicks, int doubles, int longs) {
+    int found[number_of_event] = {0};
+
+    SIM_CHECK(sim_old.event_num == sim_new.event_num, "%s: %d events before, %d now", name, sim_old.event_num,
+              sim_new.event_num);
+    for (int i = 0; i < sim_old.event_num && i < sim_new.event_num; i++) {
+        sim_event_t* a = &sim_old.events[i];
+        sim_event_t* b = &sim_new.events[i];
+
+        if (a->key != b->key || a->event != b->event || abs((int)a->ms - (int)b->ms) > TICKS_INTERVAL) {
+            SIM_CHECK(0, "%s: event %d is key %u event %u at %u ms before, key %u event %u at %u ms now", name, i,
+                      a->key, a->event, a->ms, b->key, b->event, b->ms);
+            return;
+        }
+        found[b->event]++;
+    }
+    SIM_CHECK(found[SINGLE_CLICK] == clicks, "%s: %d single clicks, expected %d", name, found[SINGLE_CLICK], clicks);
+    SIM_CHECK(found[DOUBLE_CLICK] == doubles, "%s: %d double clicks, expected %d", name, found[DOUBLE_CLICK],
+              doubles);
+    SIM_CHECK(found[LONG_PRESS_START] == longs, "%s: %d long presses, expected %d", name, found[LONG_PRESS_START],
+              longs);
+    SIM_CHECK(!sim_new.ticking, "%s: still ticking at the end", name);
+    printf("%-12s %3d events, interrupts %7lu before, %5lu now, ticking %5.1f%% of the time\n", name,
+           sim_new.event_num, (unsigned long)sim_old.interrupts, (unsigned long)sim_new.interrupts,
+           100.0 * sim_new.ticking_ms / sim_ms);
+}
+
+int
+main(void) {
+    static const sim_press_t clicks[] = {
+        {0, 1000, 80, 3}, {4, 3000, 120, 0}, {7, 5000, 60, 4},
+    };
+    static const sim_press_t multi[] = {
+        {1, 1000, 80, 2}, {1, 1200, 80, 2},                     /* Double */
+        {5, 3000, 70, 0}, {5, 3150, 70, 3}, {5, 3300, 70, 0}, /* Triple, a repeat */
+        {2, 6000, 60, 0}, {2, 6200, 60, 0}, {2, 6400, 60, 0}, {2, 6600, 60, 0},
+    };
+    static const sim_press_t longs[] = {
+        {4, 1000, 2500, 3}, /* Volume key held through the long press and its holds */
+        {3, 5000, 600, 0},
+        {0, 8000, 1500, 0}, {5, 8400, 100, 2}, /* A click while another key is held */
+    };
+    static const sim_press_t glitches[] = {
+        {6, 1000, 1, 0}, {6, 1500, 2, 0}, {1, 2000, 3, 0}, {3, 2500, 2, 0},
+    };
+
+    sim_run(clicks, sizeof(clicks) / sizeof(clicks[0]), 8000);
+    sim_compare("clicks", 3, 0, 0);
+    sim_run(multi, sizeof(multi) / sizeof(multi[0]), 9000);
+    sim_compare("multi-click", 0, 1, 0);
+    sim_run(longs, sizeof(longs) / sizeof(longs[0]), 11000);
+    sim_compare("long press", 1, 0, 3);
+    sim_run(glitches, sizeof(glitches) / sizeof(glitches[0]), 4000);
+    sim_compare("glitches", 0, 0, 0);
+
+    sim_run(NULL, 0, SIM_HOUR_MS);
+    sim_compare("idle hour", 0, 0, 0);
+    SIM_CHECK(sim_old.interrupts == SIM_HOUR_MS, "%lu interrupts before", (unsigned long)sim_old.interrupts);
+    SIM_CHECK(sim_new.interrupts <= 1, "%lu interrupts now", (unsigned long)sim_new.interrupts);
+
+    printf(sim_failures ? "%d checks failed\n" : "All checks passed\n", sim_failures);
+    return sim_failures != 0;
+}
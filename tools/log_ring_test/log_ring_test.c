@@ -0,0 +1,456 @@
+/**
+* \file            log_ring_test.c
+* \date            10/19/2026
+* \brief           Host tests of the log ring and benchmark of the asynchronous EasyLogger output
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Checks log_ring.c alone: records in order, the filler at the wrap, a record not committed
+ * holding the next ones back, drops counted and the free space left zero. Then producer threads,
+ * standing in for the main loop and the interrupts, write numbered records as fast as they can
+ * while a consumer takes them out: every record must come out whole and in the order of its
+ * producer, and the records received and dropped must add up to the ones sent.
+ *
+ * Then EasyLogger itself with elog_async.c: the lines out of the ring must be the ones the
+ * synchronous output writes, a log of an interrupt in the middle of another one must not break
+ * it, down to ELOG_ASYNC_LINE_NUM nested logs, and the time of a log call is measured both ways
+ * with the part of it under the output lock, the interrupts masked on the board. The synchronous
+ * call also waits there for its bytes to leave USART3 at 9600 baud, that time is added from the
+ * length of the lines. Build and run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -pthread -DDEBUG -ILibraries/easylogger -Itools/host -ISystem/inc \
+ *       tools/log_ring_test/log_ring_test.c System/src/log_ring.c Libraries/easylogger/elog.c \
+ *       Libraries/easylogger/elog_utils.c Libraries/easylogger/elog_async.c -o log_ring_test && ./log_ring_test
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "log_ring.h"
+
+#define LOG_TAG "bench"
+#include "elog.h"
+
+#define TEST_PRODUCERS   4
+#define TEST_RECORDS     200000
+#define TEST_RECORD_MIN  8
+#define TEST_RECORD_MAX  64
+#define BENCH_CALLS      100000
+#define BENCH_BATCH      8      /* Calls between two drains, well within the ring */
+#define BENCH_UART_BAUD  9600
+#define BENCH_UART_BITS  10     /* Start, 8 data and stop bits */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* Whether every byte of a buffer is zero */
+static int
+test_is_zero(const uint8_t* buf, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        if (buf[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Takes the oldest record out, checks it is the expected one */
+static void
+test_take(log_ring_t* ring, const char* expected) {
+    uint32_t len = 0;
+    const char* record = log_ring_peek(ring, &len);
+
+    TEST_CHECK(record != NULL, "no record, %s expected", expected);
+    if (record != NULL) {
+        TEST_CHECK(len == strlen(expected) && memcmp(record, expected, len) == 0, "%.*s, %s expected", (int)len,
+                   record, expected);
+        log_ring_release(ring);
+    }
+}
+
+static void
+test_ring(void) {
+    static uint8_t buf[64] __attribute__((aligned(4)));
+    log_ring_t ring;
+    uint32_t len;
+    void* first;
+    void* second;
+
+    log_ring_init(&ring, buf, sizeof(buf));
+    TEST_CHECK(log_ring_is_empty(&ring) && log_ring_peek(&ring, &len) == NULL, "not empty once set up");
+
+    /* 20 bytes take 24: two records, then a third that only fits after the wrap */
+    TEST_CHECK(log_ring_write(&ring, "aaaaaaaaaaaaaaaaaaaa", 20), "first dropped");
+    TEST_CHECK(log_ring_write(&ring, "bbbbbbbbbbbbbbbbbbbb", 20), "second dropped");
+    TEST_CHECK(!log_ring_write(&ring, "cccccccccccccccccccc", 20), "third written in a full ring");
+    test_take(&ring, "aaaaaaaaaaaaaaaaaaaa");
+    TEST_CHECK(log_ring_write(&ring, "dddddddddddddddddddd", 20), "dropped after the wrap");
+    test_take(&ring, "bbbbbbbbbbbbbbbbbbbb");
+    test_take(&ring, "dddddddddddddddddddd");
+    TEST_CHECK(log_ring_is_empty(&ring) && test_is_zero(buf, sizeof(buf)), "free space not zero");
+
+    /* Longer than the ring, and zero bytes */
+    TEST_CHECK(!log_ring_write(&ring, buf, 61), "record longer than the ring written");
+    TEST_CHECK(log_ring_write(&ring, "", 0), "empty record dropped");
+    test_take(&ring, "");
+    TEST_CHECK(log_ring_get_dropped(&ring) == 2, "%lu dropped, 2 expected", (unsigned long)log_ring_get_dropped(&ring));
+
+    /* A record reserved first and committed last holds the one after it back */
+    first = log_ring_reserve(&ring, 3);
+    second = log_ring_reserve(&ring, 3);
+    TEST_CHECK(first != NULL && second != NULL, "reserve failed");
+    if (first != NULL && second != NULL) {
+        memcpy(second, "two", 3);
+        log_ring_commit(&ring, second);
+        TEST_CHECK(log_ring_peek(&ring, &len) == NULL, "record after one not committed taken");
+        memcpy(first, "one", 3);
+        log_ring_commit(&ring, first);
+        test_take(&ring, "one");
+        test_take(&ring, "two");
+    }
+    TEST_CHECK(log_ring_is_empty(&ring) && test_is_zero(buf, sizeof(buf)), "free space not zero");
+}
+
+static uint8_t test_buf[ELOG_ASYNC_OUTPUT_BUF_SIZE] __attribute__((aligned(4)));
+static log_ring_t test_log_ring;
+static int test_done;
+static uint32_t test_written[TEST_PRODUCERS], test_dropped[TEST_PRODUCERS];
+
+/* Bytes of a record: its producer, its number and a pattern of both */
+static uint32_t
+test_record_len(uint32_t seq) {
+    return TEST_RECORD_MIN + seq % (TEST_RECORD_MAX - TEST_RECORD_MIN + 1);
+}
+
+static uint8_t
+test_record_byte(uint32_t producer, uint32_t seq, uint32_t i) {
+    return (uint8_t)(producer * 31 + seq * 7 + i);
+}
+
+static void*
+test_producer(void* arg) {
+    uint32_t producer = (uint32_t)(uintptr_t)arg;
+    uint8_t record[TEST_RECORD_MAX];
+
+    for (uint32_t seq = 0; seq < TEST_RECORDS; seq++) {
+        uint32_t len = test_record_len(seq);
+
+        record[0] = (uint8_t)producer;
+        memcpy(&record[1], &seq, sizeof(seq));
+        for (uint32_t i = 1 + sizeof(seq); i < len; i++) {
+            record[i] = test_record_byte(producer, seq, i);
+        }
+        if (log_ring_write(&test_log_ring, record, len)) {
+            test_written[producer]++;
+        } else {
+            /* Full, let the consumer catch up a little as an interrupt would by returning */
+            test_dropped[producer]++;
+            sched_yield();
+        }
+    }
+    __atomic_add_fetch(&test_done, 1, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+/* Checks a record out of the ring, returns its producer or -1 when it is broken */
+static int
+test_check_record(const uint8_t* record, uint32_t len, int64_t* last) {
+    uint32_t producer = record[0], seq;
+
+    if (len < TEST_RECORD_MIN || producer >= TEST_PRODUCERS) {
+        return -1;
+    }
+    memcpy(&seq, &record[1], sizeof(seq));
+    if (len != test_record_len(seq) || (int64_t)seq <= last[producer]) {
+        return -1;
+    }
+    for (uint32_t i = 1 + sizeof(seq); i < len; i++) {
+        if (record[i] != test_record_byte(producer, seq, i)) {
+            return -1;
+        }
+    }
+    last[producer] = seq;
+    return (int)producer;
+}
+
+static void
+test_producers(void) {
+    pthread_t threads[TEST_PRODUCERS];
+    uint32_t received[TEST_PRODUCERS] = {0};
+    int64_t last[TEST_PRODUCERS];
+    uint32_t total = 0, dropped = 0, broken = 0;
+
+    log_ring_init(&test_log_ring, test_buf, sizeof(test_buf));
+    for (uint32_t i = 0; i < TEST_PRODUCERS; i++) {
+        last[i] = -1;
+        pthread_create(&threads[i], NULL, test_producer, (void*)(uintptr_t)i);
+    }
+    for (;;) {
+        uint32_t len;
+        const uint8_t* record = log_ring_peek(&test_log_ring, &len);
+        int producer;
+
+        if (record == NULL) {
+            /* Done once every producer is and the ring is empty after it */
+            if (__atomic_load_n(&test_done, __ATOMIC_SEQ_CST) == TEST_PRODUCERS && log_ring_is_empty(&test_log_ring)) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        producer = test_check_record(record, len, last);
+        if (producer < 0) {
+            broken++;
+        } else {
+            received[producer]++;
+        }
+        log_ring_release(&test_log_ring);
+    }
+    for (uint32_t i = 0; i < TEST_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_CHECK(received[i] == test_written[i], "producer %lu: %lu received, %lu written", (unsigned long)i,
+                   (unsigned long)received[i], (unsigned long)test_written[i]);
+        total += received[i];
+        dropped += test_dropped[i];
+    }
+    TEST_CHECK(broken == 0, "%lu records broken or out of order", (unsigned long)broken);
+    TEST_CHECK(dropped == log_ring_get_dropped(&test_log_ring), "%lu dropped, the ring counted %lu",
+               (unsigned long)dropped, (unsigned long)log_ring_get_dropped(&test_log_ring));
+    TEST_CHECK(total + dropped == TEST_PRODUCERS * TEST_RECORDS, "%lu received and %lu dropped of %lu",
+               (unsigned long)total, (unsigned long)dropped, (unsigned long)TEST_PRODUCERS * TEST_RECORDS);
+    TEST_CHECK(total > 0, "nothing received");
+    TEST_CHECK(test_is_zero(test_buf, sizeof(test_buf)), "free space not zero");
+    printf("%d producers: %lu records received, %lu dropped\n", TEST_PRODUCERS, (unsigned long)total,
+           (unsigned long)dropped);
+}
+
+/* The synchronous output, standing in for USART3 without its wait */
+static char bench_out[1 << 20];
+static size_t bench_out_len;
+
+ElogErrCode
+elog_port_init(void) {
+    return ELOG_NO_ERR;
+}
+
+void
+elog_port_deinit(void) {}
+
+void
+elog_port_output(const char* log, size_t size) {
+    if (bench_out_len + size > sizeof(bench_out)) {
+        bench_out_len = 0;
+    }
+    memcpy(&bench_out[bench_out_len], log, size);
+    bench_out_len += size;
+}
+
+/* Time under the output lock, with the interrupts masked on the board */
+static struct timespec bench_lock_start;
+static double bench_locked_ns;
+static uint32_t bench_locks;
+
+void
+elog_port_output_lock(void) {
+    bench_locks++;
+    clock_gettime(CLOCK_MONOTONIC, &bench_lock_start);
+}
+
+void
+elog_port_output_unlock(void) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bench_locked_ns += (end.tv_sec - bench_lock_start.tv_sec) * 1e9 + (end.tv_nsec - bench_lock_start.tv_nsec);
+}
+
+/* Logs still to nest, each one in the middle of the one before as an interrupt would */
+static uint32_t test_nest;
+
+const char*
+elog_port_get_time(void) {
+    if (test_nest > 0) {
+        uint32_t depth = ELOG_ASYNC_LINE_NUM + 1 - test_nest--;
+
+        log_d("nested %lu", (unsigned long)depth);
+    }
+    return "";
+}
+
+const char*
+elog_port_get_p_info(void) {
+    return "";
+}
+
+const char*
+elog_port_get_t_info(void) {
+    return "";
+}
+
+/* What the port sends of the asynchronous lines */
+static char bench_async[1 << 16];
+static size_t bench_async_len;
+
+static void
+bench_drain(void) {
+    const char* log;
+    size_t size;
+
+    while ((log = elog_async_peek_line(&size)) != NULL) {
+        if (bench_async_len + size <= sizeof(bench_async)) {
+            memcpy(&bench_async[bench_async_len], log, size);
+            bench_async_len += size;
+        }
+        elog_async_release_line();
+    }
+}
+
+/* A log line as the tasks write them */
+static void
+bench_log(uint32_t i) {
+    log_d("Temperature %lu.%lu C, alarm %02lu:%02lu", (unsigned long)(20 + i % 10), (unsigned long)(i % 10),
+          (unsigned long)(i % 24), (unsigned long)(i % 60));
+}
+
+/* Logs nested in one another, one more than there are lines */
+static void
+test_nested(void) {
+    uint32_t dropped = elog_async_get_dropped();
+    const char* pos = bench_async;
+    char text[16];
+
+    bench_async_len = 0;
+    test_nest = ELOG_ASYNC_LINE_NUM;
+    log_d("nested 0");
+    bench_drain();
+    bench_async[bench_async_len < sizeof(bench_async) ? bench_async_len : sizeof(bench_async) - 1] = '\0';
+    TEST_CHECK(elog_async_get_dropped() == dropped + 1, "%lu nested logs dropped, 1 expected",
+               (unsigned long)(elog_async_get_dropped() - dropped));
+    /* The innermost one first, each line whole */
+    for (int depth = ELOG_ASYNC_LINE_NUM - 1; depth >= 0; depth--) {
+        const char* line;
+
+        snprintf(text, sizeof(text), "nested %d", depth);
+        line = strstr(pos, text);
+        TEST_CHECK(line != NULL, "%s missing or out of order", text);
+        if (line != NULL) {
+            pos = line + strlen(text);
+        }
+    }
+    snprintf(text, sizeof(text), "nested %d", ELOG_ASYNC_LINE_NUM);
+    TEST_CHECK(strstr(bench_async, text) == NULL, "line of the dropped log");
+}
+
+/* Time of a log call and of its part under the output lock, the drain between the batches left out */
+static double
+bench_ns_per_call(double* locked_ns) {
+    struct timespec start, end;
+    double ns = 0;
+
+    bench_locked_ns = 0;
+
+    for (uint32_t i = 0; i < BENCH_CALLS; i += BENCH_BATCH) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t j = 0; j < BENCH_BATCH; j++) {
+            bench_log(i + j);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ns += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+        bench_drain();
+        bench_async_len = 0;
+    }
+    *locked_ns = bench_locked_ns / BENCH_CALLS;
+    return ns / BENCH_CALLS;
+}
+
+static void
+bench_elog(void) {
+    double async_ns, async_locked_ns, sync_ns, sync_locked_ns, uart_ms;
+    size_t line_len;
+    uint32_t dropped;
+
+    elog_init();
+    elog_set_fmt(ELOG_LVL_DEBUG, ELOG_FMT_ALL & ~ELOG_FMT_FUNC);
+    elog_start();
+    bench_drain();
+
+    /* The same lines both ways */
+    bench_async_len = 0;
+    bench_out_len = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        bench_log(i);
+        bench_drain();
+    }
+    elog_async_enabled(false);
+    for (uint32_t i = 0; i < 100; i++) {
+        bench_log(i);
+    }
+    TEST_CHECK(bench_async_len == bench_out_len && memcmp(bench_async, bench_out, bench_out_len) == 0,
+               "%lu bytes out of the ring, %lu written synchronously", (unsigned long)bench_async_len,
+               (unsigned long)bench_out_len);
+    line_len = bench_out_len / 100;
+
+    elog_async_enabled(true);
+    test_nested();
+
+    dropped = elog_async_get_dropped();
+    bench_locks = 0;
+    async_ns = bench_ns_per_call(&async_locked_ns);
+    TEST_CHECK(elog_async_get_dropped() == dropped, "%lu logs dropped", (unsigned long)(elog_async_get_dropped() - dropped));
+    TEST_CHECK(bench_locks == 0, "%lu asynchronous logs took the output lock", (unsigned long)bench_locks);
+    elog_async_enabled(false);
+    sync_ns = bench_ns_per_call(&sync_locked_ns);
+
+    uart_ms = line_len * BENCH_UART_BITS * 1e3 / BENCH_UART_BAUD;
+    printf("%lu bytes a line, log call: asynchronous %.0f ns, %.0f ns of it masked, synchronous %.0f ns, %.0f ns of it "
+           "masked + %.1f ms on USART3 at %d baud\n", (unsigned long)line_len, async_ns, async_locked_ns, sync_ns,
+           sync_locked_ns, uart_ms, BENCH_UART_BAUD);
+}
+
+int
+main(void) {
+    test_ring();
+    test_producers();
+    bench_elog();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,267 @@
+/**
+* \file            music_test.c
+* \date            10/19/2026
+* \brief           Host test of the music library navigation against a simulated DFPlayer
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Walks a library of five folders, one of each type, a large folder of 3000 tracks, an empty
+ * one and one with more tracks on the card than its command addresses, through music.c, with
+ * a simulated DFPlayer that checks every play command against the addressing limits of its
+ * type and the files on the simulated TF card. Forward and backward over two laps, every track
+ * must play in library order, each exactly once a lap, and a random mix of steps and seeks must
+ * follow a plain index. The sizes are read again when the catalog status changes, and an empty
+ * library plays nothing. Build and run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc tools/music_test/music_test.c \
+ *       -o music_test && ./music_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../config/voice_cfg.h"
+
+/* The library of the test, in place of the one of voice_cfg.h */
+#undef VOICE_MUSIC_LIBRARY
+#define VOICE_MUSIC_LIBRARY(X)                                                                                  \
+    X(VOICE_MUSIC_FOLDER, VOICE_MUSIC_RESOURCE, VOICE_MUSIC_NUM)                                                \
+    X(VOICE_MUSIC_LARGE_FOLDER, 5, 3000)                                                                        \
+    X(VOICE_MUSIC_LARGE_FOLDER, 6, 40)                                                                          \
+    X(VOICE_MUSIC_FOLDER, 7, 255)                                                                               \
+    X(VOICE_MUSIC_MP3_FOLDER, 0, 12)
+
+/* Built in with the library above */
+#include "../../User/src/music.c"
+
+#define TEST_LAPS 2
+#define TEST_RANDOM_STEPS 100000
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The TF card and the catalog */
+
+static uint16_t test_card[100];                /* Tracks of every folder, [0] for the "MP3" folder */
+static voice_catalog_status_t test_status = VOICE_CATALOG_READY;
+
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    return test_card[folder];
+}
+
+voice_catalog_status_t
+voice_catalog_get_status(void) {
+    return test_status;
+}
+
+/* The DFPlayer, a track is folder * 10000 + number, the "MP3" folder being 0 */
+
+static uint32_t test_played;   /* Last track played, 0 if none */
+static uint32_t test_plays;
+static uint32_t test_invalid;  /* Commands out of the limits or past the files of the folder */
+
+static void
+test_play(uint8_t folder, uint16_t number, uint8_t folder_max, uint16_t number_max) {
+    test_plays++;
+    test_played = (uint32_t)folder * 10000 + number;
+    if (folder > folder_max || number == 0 || number > number_max || number > test_card[folder]) {
+        if (test_invalid++ < 5) {
+            printf("  invalid play of folder %u track %u\n", folder, number);
+        }
+    }
+}
+
+void
+df_play_from_folder(uint8_t folder, uint8_t number) {
+    test_play(folder, number, 99, 255);
+    test_invalid += folder == 0;
+}
+
+void
+df_play_from_large_folder(uint8_t folder, uint16_t number) {
+    test_play(folder, number, 15, 3000);
+    test_invalid += folder == 0;
+}
+
+void
+df_play_from_mp3_folder(uint16_t number) {
+    test_play(0, number, 0, 9999);
+}
+
+/* The library order the player must follow */
+
+static uint32_t test_order[UINT16_MAX];
+static uint16_t test_size;
+
+static void
+test_card_set(uint16_t large, uint16_t small) {
+    memset(test_card, 0, sizeof(test_card));
+    test_card[VOICE_MUSIC_RESOURCE] = VOICE_MUSIC_NUM;
+    test_card[5] = large;
+    test_card[6] = 0;
+    test_card[7] = small;
+    test_card[0] = 12;
+
+    /* Folder 7 holds more than its command addresses, only the first 255 are in the library */
+    test_size = 0;
+    for (uint16_t n = 1; n <= test_card[VOICE_MUSIC_RESOURCE]; n++) {
+        test_order[test_size++] = VOICE_MUSIC_RESOURCE * 10000 + n;
+    }
+    for (uint16_t n = 1; n <= test_card[5]; n++) {
+        test_order[test_size++] = 5 * 10000 + n;
+    }
+    for (uint16_t n = 1; n <= test_card[7] && n <= 255; n++) {
+        test_order[test_size++] = 7 * 10000 + n;
+    }
+    for (uint16_t n = 1; n <= test_card[0]; n++) {
+        test_order[test_size++] = n;
+    }
+}
+
+/**
+ * \brief           Step a number of laps in one direction, every track must play in order, once a lap
+ */
+static void
+test_laps(int8_t direction) {
+    static uint8_t plays[UINT16_MAX];
+    uint32_t wrong = 0, index = 0;
+    clock_t start;
+    double ns;
+
+    memset(plays, 0, sizeof(plays));
+    music_seek(0);
+    start = clock();
+    for (uint32_t step = 0; step < (uint32_t)TEST_LAPS * test_size; step++) {
+        if (direction > 0) {
+            music_next();
+            index = (index + 1) % test_size;
+        } else {
+            music_previous();
+            index = (index + test_size - 1) % test_size;
+        }
+        if (music_get_index() != index || test_played != test_order[index]) {
+            if (wrong++ < 5) {
+                printf("  step %u: index %u played %u, expected index %u track %u\n", step, music_get_index(),
+                       test_played, index, test_order[index]);
+            }
+        }
+        plays[index]++;
+    }
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (TEST_LAPS * test_size);
+
+    TEST_CHECK(wrong == 0, "%s: %u steps off the library order", direction > 0 ? "next" : "previous", wrong);
+    for (uint16_t i = 0; i < test_size; i++) {
+        if (plays[i] != TEST_LAPS) {
+            TEST_CHECK(0, "track %u played %u times in %u laps", test_order[i], plays[i], TEST_LAPS);
+            break;
+        }
+    }
+    printf("%s over %u laps of %u tracks, %.0f ns per step on this host\n", direction > 0 ? "Next" : "Previous",
+           TEST_LAPS, test_size, ns);
+}
+
+int
+main(void) {
+    uint32_t wrong = 0, index = 0, plays;
+
+    test_card_set(3000, 300);
+    TEST_CHECK(music_get_size() == test_size && test_size == 84 + 3000 + 255 + 12, "library of %u tracks, expected %u",
+               music_get_size(), test_size);
+
+    test_laps(1);
+    test_laps(-1);
+
+    /* Steps and seeks at random, against a plain index */
+    srand(1);
+    music_seek(0);
+    for (uint32_t step = 0; step < TEST_RANDOM_STEPS; step++) {
+        switch (rand() % 4) {
+            case 0:
+                index = (uint32_t)rand();
+                music_seek((uint16_t)index);
+                index = (uint16_t)index % test_size;
+                music_play();
+                break;
+            case 1:
+                music_previous();
+                index = (index + test_size - 1) % test_size;
+                break;
+            default:
+                music_next();
+                index = (index + 1) % test_size;
+                break;
+        }
+        wrong += music_get_index() != index || test_played != test_order[index];
+    }
+    TEST_CHECK(wrong == 0, "random: %u steps off the library order", wrong);
+    TEST_CHECK(test_invalid == 0, "%u invalid play commands", test_invalid);
+
+    /* The scan brings other sizes, the current track is kept while it is in the library */
+    test_status = VOICE_CATALOG_SCANNING;
+    music_seek(100);
+    test_card_set(1500, 10);
+    test_status = VOICE_CATALOG_READY;
+    music_play();
+    TEST_CHECK(music_get_size() == test_size && music_get_index() == 100 && test_played == test_order[100],
+               "after the scan: %u tracks, index %u", music_get_size(), music_get_index());
+    music_seek(1500);
+    test_status = VOICE_CATALOG_FALLBACK;
+    test_card_set(1000, 10);
+    music_next();
+    TEST_CHECK(music_get_index() == 1 && test_played == test_order[1], "shrunk library: index %u played %u",
+               music_get_index(), test_played);
+    test_laps(1);
+
+    /* An empty library plays nothing */
+    test_status = VOICE_CATALOG_SCANNING;
+    memset(test_card, 0, sizeof(test_card));
+    plays = test_plays;
+    music_next();
+    music_previous();
+    music_play();
+    TEST_CHECK(music_get_size() == 0 && test_plays == plays, "empty library: %u tracks, %u plays", music_get_size(),
+               test_plays - plays);
+    TEST_CHECK(test_invalid == 0, "%u invalid play commands", test_invalid);
+
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
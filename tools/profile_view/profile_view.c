@@ -0,0 +1,427 @@
+/**
+* \file            profile_view.c
+* \date            10/19/2026
+* \brief           Renders the cycle profile snapshots of a log, and checks profile.c against them
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Picks the `prof` lines out of the log of a build with PROFILE_CFG_ENABLE (see profile.h),
+ * decodes the snapshots and renders, for each point over all of them, its count, its share of
+ * the CPU, its mean, the bins holding its p50 and p99 and its longest time, then its log2
+ * histogram. The names come from config/profile_cfg.h, so build it from the same tree as the
+ * firmware.
+ *
+ * Without a log it checks itself: it builds System/src/profile.c on a simulated cycle counter,
+ * times known durations through the macros, nested interrupts and the wrap of the counter
+ * included, and decodes its own dump against them. Build and run from the repository root, it
+ * exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -DPROFILE_CFG_ENABLE=1 '-DPROFILE_CYCLES()=view_cycles' -Itools/host -ISystem/inc \
+ *       tools/profile_view/profile_view.c -o profile_view && ./profile_view [log]
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32f10x.h"
+
+static uint32_t view_cycles;
+static void view_raw(const char* format, ...);
+
+#define elog_raw(...) view_raw(__VA_ARGS__)
+
+#include "../../System/src/profile.c"
+
+static const char* const view_names[PROFILE_NUM] = {
+#define VIEW_POINT_NAME(id, name) [id] = name,
+    PROFILE_CFG_POINTS(VIEW_POINT_NAME)
+#undef VIEW_POINT_NAME
+};
+
+/* Points summed over the snapshots */
+typedef struct view_total {
+    uint32_t snapshots;
+    uint64_t elapsed_ms;
+    uint8_t cycles_per_us;
+    profile_stats_t stats[PROFILE_NUM];
+} view_total_t;
+
+static int view_failures;
+
+#define VIEW_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            view_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The firmware side */
+
+static uint32_t view_ms;
+static char* view_log;
+static size_t view_log_len;
+
+uint32_t
+counter_get_ms(void) {
+    return view_ms;
+}
+
+static void
+view_raw(const char* format, ...) {
+    char line[256];
+    va_list args;
+    int n;
+
+    va_start(args, format);
+    n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    view_log = realloc(view_log, view_log_len + (size_t)n + 1);
+    memcpy(view_log + view_log_len, line, (size_t)n + 1);
+    view_log_len += (size_t)n;
+}
+
+/* Decoding */
+
+static int
+view_varint(const uint8_t* bytes, size_t len, size_t* pos, uint64_t* value) {
+    *value = 0;
+    for (uint8_t shift = 0; shift < 64; shift += 7) {
+        if (*pos >= len) {
+            return 0;
+        }
+        *value |= (uint64_t)(bytes[*pos] & 0x7F) << shift;
+        if ((bytes[(*pos)++] & 0x80) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Adds the snapshots in the bytes to the total, returns 0 on a malformed or foreign one */
+static int
+view_decode(const uint8_t* bytes, size_t len, view_total_t* total) {
+    size_t pos = 0;
+
+    while (pos < len) {
+        uint64_t value;
+
+        if (len - pos < 6 || bytes[pos] != PROFILE_MAGIC_0 || bytes[pos + 1] != PROFILE_MAGIC_1) {
+            fprintf(stderr, "No snapshot at byte %zu\n", pos);
+            return 0;
+        }
+        if (bytes[pos + 2] != PROFILE_VERSION || bytes[pos + 3] != PROFILE_NUM || bytes[pos + 4] != PROFILE_CFG_BINS) {
+            fprintf(stderr, "Snapshot of version %u with %u points and %u bins, this tree has %u, %u and %u\n",
+                    bytes[pos + 2], bytes[pos + 3], bytes[pos + 4], PROFILE_VERSION, PROFILE_NUM, PROFILE_CFG_BINS);
+            return 0;
+        }
+        total->cycles_per_us = bytes[pos + 5];
+        pos += 6;
+        if (!view_varint(bytes, len, &pos, &value)) {
+            return 0;
+        }
+        total->elapsed_ms += value;
+        total->snapshots++;
+
+        while (pos < len && bytes[pos] != PROFILE_END_MARK) {
+            profile_stats_t* stats;
+            uint64_t count, max, sum, mask;
+            uint8_t id = bytes[pos++];
+
+            if (id >= PROFILE_NUM || !view_varint(bytes, len, &pos, &count) || !view_varint(bytes, len, &pos, &max)
+                || !view_varint(bytes, len, &pos, &sum) || !view_varint(bytes, len, &pos, &mask)) {
+                fprintf(stderr, "Malformed point at byte %zu\n", pos);
+                return 0;
+            }
+            stats = &total->stats[id];
+            stats->count += (uint32_t)count;
+            stats->sum += sum;
+            if (max > stats->max) {
+                stats->max = (uint32_t)max;
+            }
+            for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+                if (mask >> bin & 1) {
+                    if (!view_varint(bytes, len, &pos, &value)) {
+                        return 0;
+                    }
+                    stats->bins[bin] += (uint32_t)value;
+                }
+            }
+        }
+        if (pos == len) {
+            fprintf(stderr, "Snapshot cut short\n");
+            return 0;
+        }
+        pos++;
+    }
+    return 1;
+}
+
+/* Takes the bytes of the `prof` lines of a log */
+static size_t
+view_extract(const char* text, uint8_t* bytes) {
+    size_t n = 0;
+
+    for (const char* line = strstr(text, "prof "); line != NULL; line = strstr(line, "prof ")) {
+        line += 5;
+        while (isxdigit((unsigned char)line[0]) && isxdigit((unsigned char)line[1])) {
+            char digits[3] = {line[0], line[1], '\0'};
+
+            bytes[n++] = (uint8_t)strtoul(digits, NULL, 16);
+            line += 2;
+        }
+    }
+    return n;
+}
+
+/* Rendering */
+
+/* Microseconds of the longest duration a bin of a point can hold */
+static double
+view_bin_us(uint8_t bin, const profile_stats_t* stats, const view_total_t* total) {
+    uint64_t cycles = bin == PROFILE_CFG_BINS - 1 ? UINT32_MAX : (1ULL << bin) - 1;
+
+    return (double)(cycles < stats->max ? cycles : stats->max) / total->cycles_per_us;
+}
+
+/* Bin holding the given share of the durations */
+static uint8_t
+view_bin_at(const profile_stats_t* stats, double share) {
+    uint64_t seen = 0;
+
+    for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+        seen += stats->bins[bin];
+        if (seen >= share * stats->count) {
+            return bin;
+        }
+    }
+    return PROFILE_CFG_BINS - 1;
+}
+
+static void
+view_render(const view_total_t* total) {
+    double elapsed_us = (double)total->elapsed_ms * 1000;
+
+    printf("%u snapshots over %.1f s at %u cycles per us, p50 and p99 are the bins holding them\n\n",
+           total->snapshots, total->elapsed_ms / 1000.0, total->cycles_per_us);
+    printf("%-22s %10s %7s %10s %10s %10s %10s\n", "Point", "count", "cpu %", "mean us", "p50 <= us", "p99 <= us",
+           "max us");
+    for (uint8_t id = 0; id < PROFILE_NUM; id++) {
+        const profile_stats_t* stats = &total->stats[id];
+        double us = (double)stats->sum / total->cycles_per_us;
+
+        if (stats->count == 0) {
+            continue;
+        }
+        printf("%-22s %10u %7.2f %10.1f %10.1f %10.1f %10.1f\n", view_names[id], stats->count,
+               elapsed_us > 0 ? 100.0 * us / elapsed_us : 0.0, us / stats->count,
+               view_bin_us(view_bin_at(stats, 0.5), stats, total), view_bin_us(view_bin_at(stats, 0.99), stats, total),
+               (double)stats->max / total->cycles_per_us);
+    }
+    for (uint8_t id = 0; id < PROFILE_NUM; id++) {
+        const profile_stats_t* stats = &total->stats[id];
+        uint32_t peak = 0;
+
+        if (stats->count == 0) {
+            continue;
+        }
+        printf("\n%s\n", view_names[id]);
+        for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+            if (stats->bins[bin] > peak) {
+                peak = stats->bins[bin];
+            }
+        }
+        for (uint8_t bin = 0; bin < PROFILE_CFG_BINS; bin++) {
+            if (stats->bins[bin] == 0) {
+                continue;
+            }
+            printf("  %s %10.1f us %-40.*s %u\n", bin == PROFILE_CFG_BINS - 1 ? "> " : "<=",
+                   bin == PROFILE_CFG_BINS - 1 ? view_bin_us(bin - 1, stats, total) : view_bin_us(bin, stats, total),
+                   (int)((stats->bins[bin] * 40ULL + peak - 1) / peak), "########################################",
+                   stats->bins[bin]);
+        }
+    }
+}
+
+static int
+view_load(const char* path) {
+    FILE* file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    static view_total_t total;
+    char* text = NULL;
+    uint8_t* bytes;
+    size_t len = 0, n;
+    int ok;
+
+    if (file == NULL) {
+        perror(path);
+        return 0;
+    }
+    for (;;) {
+        text = realloc(text, len + 65536);
+        n = fread(text + len, 1, 65535, file);
+        len += n;
+        if (n == 0) {
+            break;
+        }
+    }
+    text[len] = '\0';
+    if (file != stdin) {
+        fclose(file);
+    }
+    bytes = malloc(len / 2 + 1);
+    n = view_extract(text, bytes);
+    ok = n != 0 && view_decode(bytes, n, &total);
+    if (n == 0) {
+        fprintf(stderr, "No profile snapshot in %s\n", path);
+    } else if (ok) {
+        view_render(&total);
+    }
+    free(text);
+    free(bytes);
+    return ok;
+}
+
+/* Self check */
+
+static profile_stats_t view_expected[PROFILE_NUM];
+
+static void
+view_expect(profile_point_t id, uint32_t cycles) {
+    profile_stats_t* stats = &view_expected[id];
+    uint8_t bin = 0;
+
+    while (bin < PROFILE_CFG_BINS - 1 && cycles >> bin != 0) {
+        bin++;
+    }
+    stats->count++;
+    stats->sum += cycles;
+    stats->max = cycles > stats->max ? cycles : stats->max;
+    stats->bins[bin]++;
+}
+
+static void
+view_isr(profile_point_t id, uint32_t cycles, uint32_t nested) {
+    PROFILE_ISR_ENTER(id);
+    view_cycles += cycles / 2;
+    if (nested != 0) {
+        view_isr(PROFILE_ISR_TIM2, nested, 0);
+    }
+    view_cycles += cycles - cycles / 2;
+    PROFILE_ISR_EXIT(id);
+    view_expect(id, cycles);
+}
+
+static void
+view_check(void) {
+    static view_total_t total;
+    uint8_t* bytes;
+    size_t n;
+
+    view_cycles = 0xFFFFF000; /* Across the wrap of the counter */
+    srand(46);
+    for (uint32_t i = 0; i < 20000; i++) {
+        uint32_t own = (uint32_t)rand() % 200000, isr = (uint32_t)rand() % 3 == 0 ? 700 + i % 50 : 0;
+
+        {
+            PROFILE_BEGIN(PROFILE_SCREEN_DRAW);
+            view_cycles += own / 3;
+            if (isr != 0) {
+                view_isr(PROFILE_ISR_TIM3, isr, i % 2 == 0 ? 90 : 0);
+            }
+            {
+                PROFILE_BEGIN(PROFILE_SSD1306_PUTC);
+                view_cycles += own / 3;
+                PROFILE_END(PROFILE_SSD1306_PUTC);
+                view_expect(PROFILE_SSD1306_PUTC, own / 3);
+            }
+            view_cycles += own - 2 * (own / 3);
+            PROFILE_END(PROFILE_SCREEN_DRAW);
+            view_expect(PROFILE_SCREEN_DRAW, own);
+        }
+    }
+    /* The edges of the bins */
+    for (uint8_t bin = 0; bin < 33; bin++) {
+        for (int8_t d = -1; d <= 1; d++) {
+            uint32_t cycles = bin == 32 ? 0xFFFFFFFF : (uint32_t)((1ULL << bin) + d);
+
+            PROFILE_BEGIN(PROFILE_DS1302_READ);
+            view_cycles += cycles;
+            PROFILE_END(PROFILE_DS1302_READ);
+            view_expect(PROFILE_DS1302_READ, cycles);
+        }
+    }
+    VIEW_CHECK(profile_isr_cycles != 0, "no interrupt cycles");
+
+    for (uint8_t id = 0; id < PROFILE_NUM; id++) {
+        profile_stats_t stats;
+
+        profile_get_stats(id, &stats);
+        VIEW_CHECK(memcmp(&stats, &view_expected[id], sizeof(stats)) == 0,
+                   "%s: %u times, max %u, sum %llu, expected %u, %u, %llu", view_names[id], stats.count, stats.max,
+                   (unsigned long long)stats.sum, view_expected[id].count, view_expected[id].max,
+                   (unsigned long long)view_expected[id].sum);
+    }
+
+    view_ms = 60000;
+    profile_dump();
+    view_ms = 120000;
+    profile_dump();
+    bytes = malloc(view_log_len / 2 + 1);
+    n = view_extract(view_log, bytes);
+    VIEW_CHECK(view_decode(bytes, n, &total), "dump not decoded");
+    VIEW_CHECK(total.snapshots == 2 && total.elapsed_ms == 120000 && total.cycles_per_us == COUNTER_CYCLES_PER_US,
+               "%u snapshots over %llu ms", total.snapshots, (unsigned long long)total.elapsed_ms);
+    for (uint8_t id = 0; id < PROFILE_NUM; id++) {
+        profile_stats_t stats;
+
+        VIEW_CHECK(memcmp(&total.stats[id], &view_expected[id], sizeof(stats)) == 0, "%s decoded as %u times",
+                   view_names[id], total.stats[id].count);
+        profile_get_stats(id, &stats);
+        VIEW_CHECK(stats.count == 0 && stats.max == 0, "%s not cleared by the dump", view_names[id]);
+    }
+    view_render(&total);
+    printf("\n%zu bytes of snapshot in %zu bytes of log\n", n, view_log_len);
+    free(bytes);
+}
+
+int
+main(int argc, char** argv) {
+    if (argc > 1) {
+        return !view_load(argv[1]);
+    }
+    view_check();
+    printf(view_failures ? "%d checks failed\n" : "All checks passed\n", view_failures);
+    return view_failures != 0;
+}
@@ -0,0 +1,325 @@
+/**
+* \file            random_test.c
+* \date            10/19/2026
+* \brief           Host statistical test of the random generator and the shuffle bags
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs the PCG32 generator of random.c and the shuffle bags of shuffle.c on the host. It checks
+ * that random_range() is uniform by a chi-square test over several bounds and streams, that its
+ * rejection removes the bias a plain modulo has on a large bound, and that two device IDs give
+ * two different sequences. Then it draws 1000 rounds from bags of 1 to 9 lines and 10000 rounds
+ * from a bag of 84 lines: every line comes up once per round, a round never starts with the line
+ * that ended the one before, and the first line of a round is uniform. The seeding of
+ * random_init() reads the ADC and the device ID of the chip and is left to the target. Build and
+ * run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc tools/random_test/random_test.c \
+ *       System/src/shuffle.c -lm -o random_test && ./random_test
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Built in to pick the stream as random_init() does from the device ID */
+#include "../../System/src/random.c"
+#include "shuffle.h"
+
+#define TEST_DRAWS_PER_VALUE 2000  /* Draws per possible value of random_range() */
+#define TEST_CHI2_Z          3.09  /* Normal quantile of the 0.1% significance level */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The ADC, only linked: random_init() is not run on the host */
+
+ADC_TypeDef host_adc1;
+
+void
+RCC_ADCCLKConfig(uint32_t prescaler) {
+    (void)prescaler;
+}
+
+void
+ADC_StructInit(ADC_InitTypeDef* init) {
+    memset(init, 0, sizeof(*init));
+}
+
+void
+ADC_Init(ADC_TypeDef* adc, ADC_InitTypeDef* init) {
+    (void)adc;
+    (void)init;
+}
+
+void
+ADC_TempSensorVrefintCmd(FunctionalState state) {
+    (void)state;
+}
+
+void
+ADC_RegularChannelConfig(ADC_TypeDef* adc, uint8_t channel, uint8_t rank, uint8_t sample_time) {
+    (void)adc;
+    (void)channel;
+    (void)rank;
+    (void)sample_time;
+}
+
+void
+ADC_Cmd(ADC_TypeDef* adc, FunctionalState state) {
+    (void)adc;
+    (void)state;
+}
+
+void
+ADC_ResetCalibration(ADC_TypeDef* adc) {
+    (void)adc;
+}
+
+FlagStatus
+ADC_GetResetCalibrationStatus(ADC_TypeDef* adc) {
+    (void)adc;
+    return RESET;
+}
+
+void
+ADC_StartCalibration(ADC_TypeDef* adc) {
+    (void)adc;
+}
+
+FlagStatus
+ADC_GetCalibrationStatus(ADC_TypeDef* adc) {
+    (void)adc;
+    return RESET;
+}
+
+void
+ADC_SoftwareStartConvCmd(ADC_TypeDef* adc, FunctionalState state) {
+    (void)adc;
+    (void)state;
+}
+
+FlagStatus
+ADC_GetFlagStatus(ADC_TypeDef* adc, uint8_t flag) {
+    (void)adc;
+    (void)flag;
+    return SET;
+}
+
+uint16_t
+ADC_GetConversionValue(ADC_TypeDef* adc) {
+    (void)adc;
+    return 0;
+}
+
+void
+RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) {
+    (void)periph;
+    (void)state;
+}
+
+void
+delay_us(uint32_t xus) {
+    (void)xus;
+}
+
+/**
+ * \brief           Seed the generator as random_init() does, from a device ID and a seed
+ */
+static void
+test_seed(uint32_t uid0, uint32_t uid1, uint32_t uid2, uint64_t seed) {
+    random_increment = ((uint64_t)(uid0 ^ uid2) << 32 | uid1) << 1 | 1;
+    random_state = 0;
+    random_u32();
+    random_state += seed;
+    random_u32();
+}
+
+/**
+ * \brief           Chi-square statistic of counts that should all be total / num
+ */
+static double
+test_chi2(const uint32_t* counts, uint32_t num, uint32_t total) {
+    double expected = (double)total / num, chi2 = 0;
+    for (uint32_t i = 0; i < num; i++) {
+        chi2 += (counts[i] - expected) * (counts[i] - expected) / expected;
+    }
+    return chi2;
+}
+
+/**
+ * \brief           Critical chi-square value at the 0.1% level, by the Wilson-Hilferty approximation
+ */
+static double
+test_chi2_critical(uint32_t df) {
+    double k = 2.0 / (9.0 * df);
+    return df * pow(1 - k + TEST_CHI2_Z * sqrt(k), 3);
+}
+
+static void
+test_range(void) {
+    static const uint32_t bounds[] = {2, 3, 6, 9, 84, 255};
+    static const uint32_t uids[][3] = {{0, 0, 0}, {0x0667FF48, 0x4851847, 0x87101720}, {0xFFFFFFFF, 1, 0x12345678}};
+    static uint32_t counts[255];
+
+    for (uint8_t u = 0; u < sizeof(uids) / sizeof(uids[0]); u++) {
+        for (uint8_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++) {
+            uint32_t total = bounds[b] * TEST_DRAWS_PER_VALUE;
+            double chi2, critical = test_chi2_critical(bounds[b] - 1);
+
+            test_seed(uids[u][0], uids[u][1], uids[u][2], 0x12345678ULL << 32 | 43200);
+            memset(counts, 0, sizeof(counts));
+            for (uint32_t i = 0; i < total; i++) {
+                uint32_t r = random_range(bounds[b]);
+                TEST_CHECK(r < bounds[b], "random_range(%u) gave %u", bounds[b], r);
+                counts[r < bounds[b] ? r : 0]++;
+            }
+            chi2 = test_chi2(counts, bounds[b], total);
+            TEST_CHECK(chi2 < critical, "stream %u, random_range(%u): chi2 %.1f over %.1f", u, bounds[b], chi2,
+                       critical);
+            if (u == 1 && bounds[b] == 84) {
+                printf("random_range(84): chi2 %.1f (df 83, 0.1%% critical value %.1f)\n", chi2, critical);
+            }
+        }
+    }
+
+    TEST_CHECK(random_range(0) == 0 && random_range(1) == 0, "random_range of an empty or single range");
+
+    /* A plain modulo by 3 * 2^30 draws the lowest third twice as often as the rest */
+    uint32_t low = 0;
+    for (uint32_t i = 0; i < 30000; i++) {
+        low += random_range(0xC0000000UL) < 0x40000000UL;
+    }
+    TEST_CHECK(low > 9500 && low < 10500, "%u of 30000 draws in the lowest third of a large bound", low);
+}
+
+static void
+test_streams(void) {
+    uint32_t a[8], b[8];
+    uint8_t shared = 0;
+
+    test_seed(0x0667FF48, 0x4851847, 0x87101720, 1);
+    for (uint8_t i = 0; i < 8; i++) {
+        a[i] = random_u32();
+    }
+    test_seed(0x0667FF48, 0x4851848, 0x87101720, 1);
+    for (uint8_t i = 0; i < 8; i++) {
+        b[i] = random_u32();
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        for (uint8_t j = 0; j < 8; j++) {
+            shared += a[i] == b[j];
+        }
+    }
+    TEST_CHECK(shared == 0, "two device IDs share %u of 8 values", shared);
+}
+
+/**
+ * \brief           Draw rounds from a bag and check every round and the first lines of them
+ * \param[in]       size: Lines of the folder
+ * \param[in]       rounds: Rounds drawn
+ */
+static void
+test_bag(uint8_t size, uint32_t rounds) {
+    static uint32_t firsts[255];
+    shuffle_bag_t bag = {0};
+    int16_t last = -1;
+    uint32_t repeats = 0, twice = 0;
+
+    memset(firsts, 0, sizeof(firsts));
+    for (uint32_t round = 0; round < rounds; round++) {
+        uint8_t drawn[255] = {0};
+        for (uint8_t i = 0; i < size; i++) {
+            uint8_t line = shuffle_bag_draw(&bag, size);
+            if (line >= size) {
+                TEST_CHECK(0, "bag of %u lines drew %u", size, line);
+                return;
+            }
+            repeats += drawn[line]++ != 0;
+            twice += size > 1 && line == last;
+            if (i == 0) {
+                firsts[line]++;
+            }
+            last = line;
+        }
+    }
+    TEST_CHECK(repeats == 0, "bag of %u lines: %u lines repeated within a round", size, repeats);
+    TEST_CHECK(twice == 0, "bag of %u lines: %u lines said twice in a row", size, twice);
+
+    /* The first line never repeats the last one, but over many rounds every line starts as often */
+    if (size > 2) {
+        double chi2 = test_chi2(firsts, size, rounds), critical = test_chi2_critical(size - 1);
+        TEST_CHECK(chi2 < critical, "bag of %u lines: first lines chi2 %.1f over %.1f", size, chi2, critical);
+        if (size == 84) {
+            printf("bag of 84 lines, first lines of %u rounds: chi2 %.1f (critical %.1f)\n", rounds, chi2,
+                   critical);
+        }
+    }
+}
+
+static void
+test_bags(void) {
+    shuffle_bag_t bag = {0};
+    uint8_t drawn[7] = {0};
+
+    test_seed(0x0667FF48, 0x4851847, 0x87101720, 0x9876543210ULL);
+    for (uint8_t size = 1; size <= 9; size++) {
+        test_bag(size, 1000);
+    }
+    test_bag(84, 10000);
+
+    /* A folder that changed size starts a whole new round */
+    for (uint8_t i = 0; i < 3; i++) {
+        shuffle_bag_draw(&bag, 5);
+    }
+    for (uint8_t i = 0; i < 7; i++) {
+        drawn[shuffle_bag_draw(&bag, 7) % 7]++;
+    }
+    TEST_CHECK(memchr(drawn, 0, sizeof(drawn)) == NULL, "round after a size change misses lines");
+}
+
+int
+main(void) {
+    test_range();
+    test_streams();
+    test_bags();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
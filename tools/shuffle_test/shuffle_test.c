@@ -0,0 +1,278 @@
+/**
+* \file            shuffle_test.c
+* \date            10/19/2026
+* \brief           Host test of the shuffle permutation and the persisted playlist
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Checks the Feistel permutation of shuffle.c over library sizes from 1 to 65535 and many seeds,
+ * every position mapping to a distinct track and shuffle_position() undoing it. Then plays a
+ * 3084-track library in shuffle mode through playlist.c and music.c against a simulated DFPlayer,
+ * every track exactly once per cycle and no cycle starting with the track that ended the one
+ * before, and resets the clock in the middle of cycles: with the backup registers kept, the
+ * mode, the track and the rest of the cycle must be those it would have played without the
+ * reset, and without them the playlist starts over in its default mode. Build and run from the
+ * repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc tools/shuffle_test/shuffle_test.c \
+ *       System/src/shuffle.c -o shuffle_test && ./shuffle_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../config/voice_cfg.h"
+
+/* A library of the size of the large folders */
+#undef VOICE_MUSIC_LIBRARY
+#define VOICE_MUSIC_LIBRARY(X)                                                                                  \
+    X(VOICE_MUSIC_FOLDER, VOICE_MUSIC_RESOURCE, VOICE_MUSIC_NUM)                                                \
+    X(VOICE_MUSIC_LARGE_FOLDER, 5, 3000)
+
+/* Built in to reset them as a reset of the clock does */
+#include "../../User/src/music.c"
+#undef LOG_TAG
+#include "../../User/src/playlist.c"
+
+#define TEST_TRACKS 3084
+#define TEST_CYCLES 6
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* Random numbers and the backup registers */
+
+static uint64_t test_random = 0x853C49E6748FEA9BULL;
+
+uint32_t
+random_u32(void) {
+    test_random = test_random * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(test_random >> 32);
+}
+
+static uint16_t test_backup[11];
+static uint8_t test_backup_kept;
+
+uint8_t
+backup_init(void) {
+    return test_backup_kept;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    return test_backup[reg / 4];
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    test_backup[reg / 4] = value;
+    test_backup_kept = 1;
+}
+
+/* The catalog and the DFPlayer, the track played as its library index */
+
+static int32_t test_played = -1;
+
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    return folder == VOICE_MUSIC_RESOURCE ? VOICE_MUSIC_NUM : folder == 5 ? 3000 : 0;
+}
+
+voice_catalog_status_t
+voice_catalog_get_status(void) {
+    return VOICE_CATALOG_READY;
+}
+
+void
+df_play_from_folder(uint8_t folder, uint8_t number) {
+    test_played = folder == VOICE_MUSIC_RESOURCE ? number - 1 : -1;
+}
+
+void
+df_play_from_large_folder(uint8_t folder, uint16_t number) {
+    test_played = folder == 5 ? VOICE_MUSIC_NUM + number - 1 : -1;
+}
+
+void
+df_play_from_mp3_folder(uint16_t number) {
+    (void)number;
+    test_played = -1;
+}
+
+/**
+ * \brief           Lose the RAM as a reset does, the backup registers stay or not
+ */
+static void
+test_reset(uint8_t kept) {
+    music_loaded = 0;
+    music_index = music_offset = music_segment = 0;
+    playlist_mode = PLAYLIST_REPEAT_ALL;
+    playlist_position = playlist_size = 0;
+    playlist_seed = 0;
+    if (!kept) {
+        memset(test_backup, 0, sizeof(test_backup));
+        test_backup_kept = 0;
+    }
+    playlist_init();
+}
+
+/* Every position to a distinct track, undone by shuffle_position */
+static void
+test_permutation(void) {
+    static const uint16_t sizes[] = {1, 2, 3, 4, 5, 15, 16, 17, 63, 64, 65, 84, 255, 256, 257, 1000, 3084, 4096, 65535};
+    static uint8_t seen[65536];
+    uint32_t seeds = 0;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t count = sizes[s] > 5000 ? 4 : 200;
+
+        for (uint32_t k = 0; k < count; k++, seeds++) {
+            uint32_t seed = k < 2 ? k * 0xFFFFFFFFUL : random_u32();
+            uint32_t wrong = 0;
+
+            memset(seen, 0, sizes[s]);
+            for (uint32_t position = 0; position < sizes[s]; position++) {
+                uint16_t index = shuffle_index((uint16_t)position, sizes[s], seed);
+
+                if (index >= sizes[s] || seen[index]++ || shuffle_position(index, sizes[s], seed) != position) {
+                    wrong++;
+                }
+            }
+            TEST_CHECK(wrong == 0, "size %u seed 0x%08X: %u positions wrong", sizes[s], seed, wrong);
+        }
+    }
+    /* Not the identity, and not the same order for two seeds */
+    TEST_CHECK(shuffle_index(0, 3084, 1) != shuffle_index(0, 3084, 2)
+                   || shuffle_index(1, 3084, 1) != shuffle_index(1, 3084, 2),
+               "two seeds give the same order");
+    printf("%u permutations checked\n", seeds);
+}
+
+/**
+ * \brief           Play cycles in shuffle mode, resetting the clock every few tracks
+ * \param[out]      order: Tracks played
+ * \param[in]       expected: Tracks of the run without reset, NULL for that run
+ * \param[in]       reset_every: Tracks between two resets, 0 for none
+ */
+static void
+test_cycles(int32_t* order, const int32_t* expected, uint32_t reset_every) {
+    static uint8_t seen[TEST_TRACKS];
+    uint32_t wrong = 0, repeats = 0, resets = 0;
+    int32_t last = -1;
+
+    test_random = 0x853C49E6748FEA9BULL;
+    test_reset(0);
+    playlist_set_mode(PLAYLIST_SHUFFLE);
+    playlist_play();
+    /* The switch carries on from where the current track landed in the order, the cycles start after */
+    while (playlist_position != 0) {
+        last = test_played;
+        playlist_on_finished();
+    }
+    for (uint32_t cycle = 0; cycle < TEST_CYCLES; cycle++) {
+        memset(seen, 0, sizeof(seen));
+        for (uint32_t i = 0; i < TEST_TRACKS; i++) {
+            uint32_t n = cycle * TEST_TRACKS + i;
+
+            if (n != 0) {
+                if (reset_every != 0 && n % reset_every == 0) {
+                    /* The track playing at the reset is played again from the start */
+                    test_reset(1);
+                    resets++;
+                    TEST_CHECK(playlist_get_mode() == PLAYLIST_SHUFFLE && music_get_index() == last,
+                               "after a reset: mode %d, track %u instead of %d", playlist_get_mode(),
+                               music_get_index(), last);
+                }
+                playlist_on_finished();
+            }
+            order[n] = test_played;
+            if (test_played < 0 || test_played >= TEST_TRACKS || seen[test_played]++) {
+                wrong++;
+            }
+            if (i == 0 && test_played == last) {
+                repeats++;
+            }
+            if (expected != NULL && test_played != expected[n]) {
+                wrong++;
+            }
+            last = test_played;
+        }
+    }
+    TEST_CHECK(wrong == 0, "%u tracks out of their cycle or not those of the run without reset", wrong);
+    TEST_CHECK(repeats == 0, "%u cycles started with the last track of the one before", repeats);
+    if (reset_every != 0) {
+        printf("%u cycles of %u tracks through %u resets\n", TEST_CYCLES, TEST_TRACKS, resets);
+    }
+}
+
+int
+main(void) {
+    static int32_t order[TEST_CYCLES * TEST_TRACKS], reset_order[TEST_CYCLES * TEST_TRACKS];
+
+    test_permutation();
+
+    test_cycles(order, NULL, 0);
+    test_cycles(reset_order, order, 997);
+    test_cycles(reset_order, order, TEST_TRACKS);
+
+    /* The mode and the track survive a reset and the mode switches */
+    playlist_set_mode(PLAYLIST_REPEAT_ONE);
+    playlist_next();
+    uint16_t track = music_get_index();
+    test_reset(1);
+    TEST_CHECK(playlist_get_mode() == PLAYLIST_REPEAT_ONE && music_get_index() == track,
+               "repeat one: mode %d, track %u", playlist_get_mode(), music_get_index());
+    playlist_set_mode(PLAYLIST_SHUFFLE);
+    TEST_CHECK(music_get_index() == track, "shuffle kept track %u instead of %u", music_get_index(), track);
+    playlist_on_finished();
+    playlist_set_mode(PLAYLIST_SEQUENTIAL);
+    track = music_get_index();
+    playlist_next();
+    TEST_CHECK(music_get_index() == (track + 1) % TEST_TRACKS, "sequential after shuffle: %u after %u",
+               music_get_index(), track);
+
+    /* Without the backup domain, the default mode from the first track */
+    test_reset(0);
+    TEST_CHECK(playlist_get_mode() == PLAYLIST_REPEAT_ALL && music_get_index() == 0,
+               "lost registers: mode %d, track %u", playlist_get_mode(), music_get_index());
+
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
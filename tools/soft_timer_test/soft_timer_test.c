@@ -0,0 +1,335 @@
+/**
+* \file            soft_timer_test.c
+* \date            10/19/2026
+* \brief           Host tests and benchmark of the software timer wheel
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Checks soft_timer.c against a plain list of expiry times: timers around every wheel boundary
+ * and past the reach of the top wheel, the time base wrapping, periodic timers late by several
+ * periods, and random timers started, stopped and restarted from callbacks while the time moves
+ * in steps of 1 ms to minutes. soft_timer_next_ms() is checked never to be later than the next
+ * expiry. Then times start, stop and expiry with hundreds of timers running. Build and run from
+ * the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -ISystem/inc tools/soft_timer_test/soft_timer_test.c \
+ *       System/src/soft_timer.c -o soft_timer_test && ./soft_timer_test [timers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "soft_timer.h"
+
+#define TEST_TIMERS_MAX 4096
+#define TEST_TIMERS     500 /* Default number of timers of the random test and the benchmark */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+static uint32_t test_ms;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+/* A timer and what the reference expects of it */
+typedef struct {
+    soft_timer_t timer;
+    uint8_t running; /* Reference state */
+    uint32_t due;    /* Reference expiry */
+    uint32_t period;
+    uint32_t calls;
+    uint32_t last;   /* Time of the last callback */
+} test_timer_t;
+
+static test_timer_t test_timers[TEST_TIMERS_MAX];
+static int test_num;
+static uint8_t test_chaos; /* Callbacks stop and restart other timers */
+
+static uint32_t test_rand_state = 1;
+
+static uint32_t
+test_rand(void) {
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+    return test_rand_state;
+}
+
+static void
+test_start(test_timer_t* t, uint32_t ms, uint32_t period) {
+    soft_timer_start(&t->timer, ms, period);
+    t->running = 1;
+    t->due = test_ms + ms;
+    t->period = period;
+}
+
+static void
+test_stop(test_timer_t* t) {
+    soft_timer_stop(&t->timer);
+    t->running = 0;
+}
+
+static void
+test_callback(soft_timer_t* timer) {
+    test_timer_t* t = (test_timer_t*)timer;
+
+    TEST_CHECK(t->running, "timer %d called while stopped", (int)(t - test_timers));
+    TEST_CHECK((int32_t)(test_ms - t->due) >= 0, "timer %d called at %u, due at %u", (int)(t - test_timers), test_ms,
+               t->due);
+    t->calls++;
+    t->last = test_ms;
+    if (t->period == 0) {
+        t->running = 0;
+    } else {
+        t->due += t->period;
+        if ((int32_t)(test_ms - t->due) >= 0) {
+            t->due += ((test_ms - t->due) / t->period + 1) * t->period;
+        }
+    }
+    TEST_CHECK(soft_timer_is_running(timer) == t->running, "timer %d running %d, expected %d", (int)(t - test_timers),
+               soft_timer_is_running(timer), t->running);
+
+    if (test_chaos) {
+        test_timer_t* other = &test_timers[test_rand() % test_num];
+
+        switch (test_rand() % 4) {
+            case 0: test_stop(other); break;
+            case 1: test_start(other, 1 + test_rand() % 3000, 0); break;
+            case 2: test_start(t, 1 + test_rand() % 100, test_rand() % 2 ? 1 + test_rand() % 500 : 0); break;
+            default: break;
+        }
+    }
+}
+
+/* Moves the time and processes, every timer due must be called back once, no other */
+static void
+test_step(uint32_t ms) {
+    uint32_t calls[TEST_TIMERS_MAX];
+    uint32_t next = soft_timer_next_ms(), first = SOFT_TIMER_NEVER;
+
+    for (int i = 0; i < test_num; i++) {
+        calls[i] = test_timers[i].calls;
+        if (test_timers[i].running && test_timers[i].due - test_ms < first) {
+            first = test_timers[i].due - test_ms;
+        }
+    }
+    TEST_CHECK(next <= first, "at %u next in %u ms, a timer is due in %u ms", test_ms, next, first);
+
+    test_ms += ms;
+    soft_timer_process();
+    for (int i = 0; i < test_num; i++) {
+        test_timer_t* t = &test_timers[i];
+
+        if (t->calls == calls[i]) {
+            TEST_CHECK(!t->running || (int32_t)(test_ms - t->due) < 0, "timer %d due at %u not called at %u", i, t->due,
+                       test_ms);
+        } else {
+            TEST_CHECK(t->calls - calls[i] == 1 || test_chaos, "timer %d called %u times at %u", i,
+                       t->calls - calls[i], test_ms);
+        }
+    }
+}
+
+static void
+test_reset(uint32_t now, int num) {
+    for (int i = 0; i < test_num; i++) {
+        test_stop(&test_timers[i]);
+    }
+    test_ms = now;
+    soft_timer_process();
+    test_num = num;
+    test_chaos = 0;
+    for (int i = 0; i < num; i++) {
+        soft_timer_init(&test_timers[i].timer, test_callback);
+        test_timers[i].running = 0;
+        test_timers[i].calls = 0;
+    }
+}
+
+/* One-shot timers on both sides of every slot boundary expire at their millisecond, stepping by 1 ms */
+static void
+test_boundaries(void) {
+    static const uint32_t starts[] = {0, 5, 31, 1023, 1024, 0xFFFFFFF0};
+    static const uint32_t bases[] = {1, 32, 1024, 32768, 1048576};
+    static const int32_t offsets[] = {-2, -1, 0, 1, 2};
+
+    for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        int n = 0;
+
+        test_reset(starts[s], 1 + sizeof(bases) / sizeof(bases[0]) * sizeof(offsets) / sizeof(offsets[0]));
+        test_start(&test_timers[n++], 0, 0);
+        soft_timer_process();
+        TEST_CHECK(test_timers[0].calls == 1, "start %u timer for 0 ms not called at once", starts[s]);
+        for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++) {
+            for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+                if ((int32_t)bases[b] + offsets[o] > 0) {
+                    test_start(&test_timers[n++], bases[b] + offsets[o], 0);
+                }
+            }
+        }
+        for (uint32_t ms = 0; ms < 1048576 + 4; ms++) {
+            test_step(1);
+        }
+        for (int i = 0; i < n; i++) {
+            TEST_CHECK(test_timers[i].calls == 1, "start %u timer %d called %u times", starts[s], i,
+                       test_timers[i].calls);
+            TEST_CHECK(test_timers[i].calls == 0 || test_timers[i].last == test_timers[i].due,
+                       "start %u timer %d called at %u, due at %u", starts[s], i, test_timers[i].last,
+                       test_timers[i].due);
+        }
+    }
+}
+
+/* A periodic timer keeps its grid, and is called once when late by several periods */
+static void
+test_periodic(void) {
+    test_reset(100, 2);
+    test_start(&test_timers[0], 10, 10);
+    test_start(&test_timers[1], 3000000, 0); /* Beyond the top wheel */
+    for (int i = 0; i < 100; i++) {
+        test_step(1);
+    }
+    TEST_CHECK(test_timers[0].calls == 10 && test_timers[0].last == 200, "%u calls, last at %u", test_timers[0].calls,
+               test_timers[0].last);
+    test_step(55);
+    TEST_CHECK(test_timers[0].calls == 11 && test_timers[0].due == 260, "%u calls, due at %u", test_timers[0].calls,
+               test_timers[0].due);
+    while (test_timers[1].calls == 0 && test_ms < 3100000) {
+        test_step(soft_timer_next_ms() ? soft_timer_next_ms() : 1);
+    }
+    TEST_CHECK(test_timers[1].last == 3000100, "far timer called at %u", test_timers[1].last);
+}
+
+/* Random timers and steps, with the callbacks stopping and restarting timers */
+static void
+test_random(int num, uint32_t start) {
+    test_reset(start, num);
+    for (int i = 0; i < num; i++) {
+        uint32_t ms = test_rand() % 4 == 0 ? test_rand() % 3000000 : test_rand() % 5000;
+
+        test_start(&test_timers[i], ms, test_rand() % 3 == 0 ? 1 + test_rand() % 2000 : 0);
+    }
+    test_chaos = 1;
+    for (int i = 0; i < 20000 && !test_failures; i++) {
+        switch (test_rand() % 8) {
+            case 0: test_step(test_rand() % 100000); break;
+            case 1: test_step(soft_timer_next_ms() == SOFT_TIMER_NEVER ? 1 : soft_timer_next_ms()); break;
+            default: test_step(test_rand() % 50); break;
+        }
+        if (test_rand() % 16 == 0) {
+            test_start(&test_timers[test_rand() % num], test_rand() % 200000, 0);
+        }
+    }
+}
+
+static double
+test_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+test_bench_callback(soft_timer_t* timer) {
+    (void)timer;
+}
+
+/* Start, stop and expiry of `num` timers, each repeated until it takes long enough to time */
+static void
+test_bench(int num) {
+    static soft_timer_t timers[TEST_TIMERS_MAX];
+    uint32_t ms[TEST_TIMERS_MAX];
+    double start_ns = 0, stop_ns = 0, expire_ns = 0, t;
+    long rounds = 0, calls = 0;
+
+    test_reset(0, 0);
+    for (int i = 0; i < num; i++) {
+        soft_timer_init(&timers[i], test_bench_callback);
+        ms[i] = 1 + test_rand() % 60000;
+    }
+    while (start_ns + stop_ns + expire_ns < 0.5e9) {
+        t = test_now_ns();
+        for (int i = 0; i < num; i++) {
+            soft_timer_start(&timers[i], ms[i], 0);
+        }
+        start_ns += test_now_ns() - t;
+
+        t = test_now_ns();
+        for (int i = 0; i < num; i++) {
+            soft_timer_stop(&timers[i]);
+        }
+        stop_ns += test_now_ns() - t;
+
+        for (int i = 0; i < num; i++) {
+            soft_timer_start(&timers[i], ms[i], 0);
+        }
+        t = test_now_ns();
+        while (soft_timer_next_ms() != SOFT_TIMER_NEVER) {
+            test_ms += soft_timer_next_ms();
+            calls += soft_timer_process();
+        }
+        expire_ns += test_now_ns() - t;
+        rounds++;
+    }
+    TEST_CHECK(calls == rounds * num, "%ld callbacks for %ld", calls, rounds * num);
+    printf("%d timers over 1 ~ 60000 ms: start %.1f ns, stop %.1f ns, expiry %.1f ns per timer\n", num,
+           start_ns / rounds / num, stop_ns / rounds / num, expire_ns / rounds / num);
+}
+
+int
+main(int argc, char* argv[]) {
+    int num = argc > 1 ? atoi(argv[1]) : TEST_TIMERS;
+
+    if (num < 1 || num > TEST_TIMERS_MAX) {
+        printf("1 ~ %d timers\n", TEST_TIMERS_MAX);
+        return 2;
+    }
+    test_boundaries();
+    test_periodic();
+    test_random(num, 0);
+    test_random(num, 0xFFFF0000);
+    test_bench(num);
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,290 @@
+/**
+* \file            temperature_test.c
+* \date            10/19/2026
+* \brief           Host tests of the temperature history with synthetic curves
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Feeds synthetic temperature curves to the temperature module and checks its statistics against
+ * a brute-force recomputation. Build and run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/temperature_test/temperature_test.c -lm -o temperature_test && ./temperature_test
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Built in so every curve can start from an empty history */
+#include "../../User/src/temperature.c"
+
+#define TEST_SLOT_MINUTES TEMPERATURE_CFG_SLOT_SAMPLES
+
+static int test_failures;
+static uint32_t test_ms;
+static float test_t;
+static bool test_present = true;
+static uint32_t test_reads, test_converts;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+/* Both give way once, as the presence window of the bus does */
+coroutine_status_t
+ds18b20_convert_t(coroutine_t* co) {
+    COROUTINE_BEGIN(co);
+    COROUTINE_YIELD(co);
+    test_converts++;
+    COROUTINE_END(co);
+}
+
+coroutine_status_t
+ds18b20_read_t(coroutine_t* co, float* t) {
+    COROUTINE_BEGIN(co);
+    COROUTINE_YIELD(co);
+    test_reads++;
+    *t = test_t;
+    COROUTINE_END(co);
+}
+
+bool
+ds18b20_is_present(void) {
+    return test_present;
+}
+
+/**
+ * \brief           Empty the history
+ */
+static void
+test_reset(void) {
+    memset(temperature_slots, 0, sizeof(temperature_slots));
+    temperature_sum = temperature_trend_y = temperature_trend_xy = temperature_pending = 0;
+    temperature_min = temperature_max = 0;
+    temperature_head = temperature_count = temperature_pending_count = 0;
+    temperature_trend = temperature_event = TEMPERATURE_STEADY;
+}
+
+/**
+ * \brief           Check the statistics against the slots recomputed from scratch
+ * \param[in]       slots: Every slot pushed so far, oldest first
+ * \param[in]       n: Number of slots pushed
+ */
+static void
+test_check_stats(const int16_t* slots, int n) {
+    temperature_stats_t stats;
+    int first = n > TEMPERATURE_CFG_SLOTS ? n - TEMPERATURE_CFG_SLOTS : 0;
+    int trend = n - first < TEMPERATURE_CFG_TREND_SLOTS ? n - first : TEMPERATURE_CFG_TREND_SLOTS;
+    int16_t min = slots[first], max = slots[first];
+    double sum = 0, sx = 0, sy = 0, sxy = 0, sxx = 0;
+    int i;
+
+    for (i = first; i < n; i++) {
+        min = slots[i] < min ? slots[i] : min;
+        max = slots[i] > max ? slots[i] : max;
+        sum += slots[i];
+    }
+    for (i = 0; i < trend; i++) {
+        double y = slots[n - trend + i];
+        sx += i;
+        sy += y;
+        sxy += i * y;
+        sxx += (double)i * i;
+    }
+
+    temperature_get_stats(&stats);
+    TEST_CHECK(stats.slots == n - first, "slots %d, expected %d", stats.slots, n - first);
+    TEST_CHECK(stats.min == min && stats.max == max, "min/max %d/%d, expected %d/%d", stats.min, stats.max, min,
+               max);
+    TEST_CHECK(fabs(stats.mean - sum / (n - first)) <= 0.5, "mean %d, expected %.2f", stats.mean, sum / (n - first));
+    if (trend >= 2) {
+        double slope = (trend * sxy - sx * sy) / (trend * sxx - sx * sx) * (60.0 / TEST_SLOT_MINUTES);
+        TEST_CHECK(fabs(stats.slope - slope) < 1.0, "slope %d, expected %.2f", stats.slope, slope);
+    }
+}
+
+/**
+ * \brief           Feed a curve minute by minute and check the statistics after every slot
+ * \param[in]       curve: Temperature in degrees at a minute
+ * \param[in]       minutes: Length of the curve
+ * \param[out]      cooling, warming: Number of events of each kind
+ * \return          Number of slots pushed
+ */
+static int
+test_feed(double (*curve)(int), int minutes, int* cooling, int* warming) {
+    static int16_t slots[7 * 24 * 60 / TEST_SLOT_MINUTES];
+    temperature_trend_t last = TEMPERATURE_STEADY;
+    int32_t pending = 0;
+    int n = 0;
+    int m;
+
+    test_reset();
+    *cooling = *warming = 0;
+    for (m = 0; m < minutes; m++) {
+        int16_t t = (int16_t)lround(curve(m) * 16);
+        temperature_add(t);
+        pending += t;
+        if ((m + 1) % TEST_SLOT_MINUTES != 0) {
+            continue;
+        }
+        slots[n++] = (int16_t)lround((double)pending / TEST_SLOT_MINUTES);
+        pending = 0;
+        test_check_stats(slots, n);
+
+        temperature_trend_t event = temperature_take_event();
+        TEST_CHECK(temperature_take_event() == TEMPERATURE_STEADY, "event taken twice");
+        if (event != TEMPERATURE_STEADY) {
+            TEST_CHECK(event != last, "two %s events in a row", event == TEMPERATURE_COOLING ? "cooling" : "warming");
+            last = event;
+            *cooling += event == TEMPERATURE_COOLING;
+            *warming += event == TEMPERATURE_WARMING;
+        }
+    }
+    return n;
+}
+
+static double
+test_constant(int m) {
+    return 21.5;
+}
+
+static double
+test_cold_ramp(int m) {
+    return 2.0 - 2.0 * m / 60; /* -2 degrees an hour, well below zero */
+}
+
+static double
+test_front(int m) {
+    /* Flat, loses 5 degrees in two hours, then recovers in twelve */
+    if (m < 600) {
+        return 20.0;
+    } else if (m < 720) {
+        return 20.0 - 5.0 * (m - 600) / 120;
+    } else if (m < 1440) {
+        return 15.0 + 5.0 * (m - 720) / 720;
+    }
+    return 20.0;
+}
+
+static double
+test_daily(int m) {
+    return 18.0 + 5.0 * sin(2 * M_PI * m / 1440); /* Slope peaks at 1.3 degrees an hour */
+}
+
+static double
+test_mild(int m) {
+    return 18.0 + 2.0 * sin(2 * M_PI * m / 1440) + ((m * 7919) % 5 - 2) / 16.0; /* 0.5 degree an hour, noisy */
+}
+
+int
+main(void) {
+    int cooling, warming;
+    temperature_stats_t stats;
+
+    test_feed(test_constant, 2 * 1440, &cooling, &warming);
+    temperature_get_stats(&stats);
+    TEST_CHECK(stats.min == 344 && stats.max == 344 && stats.mean == 344 && stats.slope == 0, "constant stats");
+    TEST_CHECK(cooling == 0 && warming == 0, "constant: %d cooling, %d warming", cooling, warming);
+
+    test_feed(test_cold_ramp, 6 * 60, &cooling, &warming);
+    temperature_get_stats(&stats);
+    TEST_CHECK(stats.slope == -32, "ramp slope %d, expected -32", stats.slope);
+    TEST_CHECK(stats.min < 0, "ramp min %d, expected below zero", stats.min);
+    TEST_CHECK(cooling == 1 && warming == 0, "ramp: %d cooling, %d warming", cooling, warming);
+    TEST_CHECK(temperature_get_trend() == TEMPERATURE_COOLING, "ramp trend");
+
+    test_feed(test_front, 2 * 1440, &cooling, &warming);
+    TEST_CHECK(cooling == 1 && warming == 0, "front: %d cooling, %d warming", cooling, warming);
+    TEST_CHECK(temperature_get_trend() == TEMPERATURE_STEADY, "front trend");
+
+    test_feed(test_daily, 7 * 1440, &cooling, &warming);
+    /* Rising through midnight, so warming also starts the first day */
+    TEST_CHECK(cooling == 7 && warming == 8, "daily: %d cooling, %d warming", cooling, warming);
+
+    test_feed(test_mild, 7 * 1440, &cooling, &warming);
+    TEST_CHECK(cooling == 0 && warming == 0, "mild: %d cooling, %d warming", cooling, warming);
+
+    /* A reading every second, the first conversion is only started, one per sample period to the history */
+    test_reset();
+    test_t = 19.0625f;
+    for (test_ms = 0; test_ms < 3 * 1440 * 60000U; test_ms += 1000) {
+        uint8_t calls = 1;
+
+        while (temperature_process() == COROUTINE_WAITING) {
+            calls++;
+        }
+        TEST_CHECK(calls == (test_ms == 0 ? 2 : 3), "%u calls at %u ms", calls, test_ms);
+        if (test_ms == TEST_SLOT_MINUTES * 60000U - 1000) {
+            TEST_CHECK(temperature_count == 1 && temperature_pending_count == 0, "%u slots and %u readings in %u minutes",
+                       temperature_count, temperature_pending_count, TEST_SLOT_MINUTES);
+        }
+    }
+    temperature_get_stats(&stats);
+    TEST_CHECK(test_converts == 3 * 86400 && test_reads == 3 * 86400 - 1, "%u conversions, %u reads", test_converts,
+               test_reads);
+    test_ms -= 500;
+    TEST_CHECK(temperature_process() == COROUTINE_DONE && test_reads == 3 * 86400 - 1, "read during the conversion");
+    TEST_CHECK(stats.slots == TEMPERATURE_CFG_SLOTS && stats.mean == 305, "process: %d slots, mean %d", stats.slots,
+               stats.mean);
+
+    /* Without an answer to the reset, the released line is no reading for the history */
+    test_present = false;
+    test_t = -0.0625f;
+    {
+        int32_t sum = temperature_sum, pending = temperature_pending;
+        uint8_t head = temperature_head, pending_count = temperature_pending_count;
+
+        for (test_ms += 500; test_ms < 3 * 1440 * 60000U + 4 * TEST_SLOT_MINUTES * 60000U; test_ms += 1000) {
+            while (temperature_process() == COROUTINE_WAITING) {}
+        }
+        TEST_CHECK(temperature_sum == sum && temperature_pending == pending && temperature_head == head
+                       && temperature_pending_count == pending_count,
+                   "readings of a missing sensor went to the history");
+    }
+
+    printf("%s, %u bytes of history and trend\n", test_failures ? "FAILED" : "OK",
+           (unsigned)(sizeof(temperature_slots) + sizeof(temperature_sum) + sizeof(temperature_trend_y)
+                      + sizeof(temperature_trend_xy) + sizeof(temperature_pending) + 2 * sizeof(temperature_min)
+                      + 5 * sizeof(uint8_t)));
+    return test_failures != 0;
+}
@@ -0,0 +1,325 @@
+/**
+* \file            voice_catalog_test.c
+* \date            10/19/2026
+* \brief           Host test of the catalog scan against a simulated DFPlayer
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs the catalog scan of voice_catalog.c against a simulated DFPlayer answering the queries
+ * after a reply time, or losing them, and a simulated TF card, on a simulated millisecond clock
+ * driving soft_timer.c. The flash cache page is mapped at its address on the target, so the
+ * record written by one boot is the one loaded by the next. It checks the counts of a cold and a
+ * warm boot, a changed card, a missing folder, a lost reply, a folder that never answers, whose
+ * guessed count must not be cached, and a module that does not answer at all. Build and run from
+ * the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/voice_catalog_test/voice_catalog_test.c System/src/soft_timer.c -o voice_catalog_test \
+ *       && ./voice_catalog_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* Built in for the entries and the state of the scan */
+#include "../../User/src/voice_catalog.c"
+
+#define TEST_REPLY_MS   30 /* The module answering a query */
+#define TEST_BOOT_MS    10000
+#define TEST_PAGE       0x0800F000UL /* Host page holding the cache page of the target */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* Time */
+
+static uint32_t test_ms;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+/* The TF card and the module */
+
+static uint16_t test_files[256];   /* Tracks of every folder on the card */
+static uint8_t test_present[256];  /* The folder exists on the card */
+static uint8_t test_mute[256];     /* The module never answers for the folder */
+static uint8_t test_mute_tf;       /* The module never answers the total */
+static uint8_t test_lose;          /* Replies still to lose */
+static uint16_t test_queries;
+static uint8_t test_pending;       /* A reply is on its way */
+static uint32_t test_reply_ms;
+static df_response_t test_reply;
+
+static void
+test_send(uint8_t cmd, uint16_t param) {
+    test_queries++;
+    if (test_lose != 0) {
+        test_lose--;
+        return;
+    }
+    test_reply.cmd = cmd;
+    test_reply.param = param;
+    test_reply_ms = test_ms + TEST_REPLY_MS;
+    test_pending = 1;
+}
+
+void
+df_query_tf_file_num(void) {
+    uint16_t total = 0;
+
+    for (int i = 1; i < 256; i++) {
+        total += test_files[i];
+    }
+    if (!test_mute_tf) {
+        test_send(DF_RESPONSE_TF_FILE_NUM, total);
+    } else {
+        test_queries++;
+    }
+}
+
+void
+df_query_file_num_from_folder(uint8_t folder) {
+    if (test_mute[folder]) {
+        test_queries++;
+    } else if (test_present[folder]) {
+        test_send(DF_RESPONSE_FOLDER_FILE_NUM, test_files[folder]);
+    } else {
+        test_send(DF_RESPONSE_ERROR, DF_ERROR_NOT_FOUND);
+    }
+}
+
+/* The last flash page */
+
+static uint16_t* test_flash = (uint16_t*)VOICE_CATALOG_CACHE_ADDR;
+static uint8_t test_unlocked;
+static uint16_t test_erases, test_programs;
+
+void
+FLASH_Unlock(void) {
+    test_unlocked = 1;
+}
+
+void
+FLASH_Lock(void) {
+    test_unlocked = 0;
+}
+
+void
+FLASH_ClearFlag(uint32_t flags) {
+    (void)flags;
+}
+
+FLASH_Status
+FLASH_ErasePage(uint32_t address) {
+    if (!test_unlocked || address != VOICE_CATALOG_CACHE_ADDR) {
+        return FLASH_ERROR_WRP;
+    }
+    memset(test_flash, 0xFF, 1024);
+    test_erases++;
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status
+FLASH_ProgramHalfWord(uint32_t address, uint16_t data) {
+    uint16_t* half = &test_flash[(address - VOICE_CATALOG_CACHE_ADDR) / 2];
+
+    if (!test_unlocked || address < VOICE_CATALOG_CACHE_ADDR || address >= VOICE_CATALOG_CACHE_ADDR + 1024) {
+        return FLASH_ERROR_WRP;
+    }
+    /* Only an erased half-word can be programmed */
+    if (*half != 0xFFFF) {
+        return FLASH_ERROR_PG;
+    }
+    *half = data;
+    test_programs++;
+    return FLASH_COMPLETE;
+}
+
+/* Boots */
+
+/**
+ * \brief           Put the card content as voice_cfg.h counts it, with an offset on every folder
+ */
+static void
+test_card(int16_t offset) {
+    memset(test_files, 0, sizeof(test_files));
+    memset(test_present, 0, sizeof(test_present));
+    memset(test_mute, 0, sizeof(test_mute));
+    test_mute_tf = 0;
+    test_lose = 0;
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        test_files[voice_catalog_entries[i].folder] = (uint16_t)(voice_catalog_entries[i].fallback + offset);
+        test_present[voice_catalog_entries[i].folder] = 1;
+    }
+}
+
+/**
+ * \brief           Boot, scan until the status leaves SCANNING
+ * \return          Time the scan took, in ms
+ */
+static uint32_t
+test_boot(void) {
+    uint32_t start = test_ms;
+
+    test_queries = test_erases = test_programs = 0;
+    test_pending = 0;
+    voice_catalog_init();
+    while (voice_catalog_get_status() == VOICE_CATALOG_SCANNING && test_ms - start < TEST_BOOT_MS) {
+        test_ms++;
+        if (test_pending && test_ms >= test_reply_ms) {
+            test_pending = 0;
+            voice_catalog_on_response(&test_reply);
+        }
+        soft_timer_process();
+    }
+    return test_ms - start;
+}
+
+/**
+ * \brief           Check every folder against the card, or its compile-time count where the card is not used
+ * \param[in]       guessed: Folder keeping its compile-time count, 0 for none
+ * \param[in]       all: Every folder keeps its compile-time count
+ */
+static int
+test_counts(uint8_t guessed, uint8_t all) {
+    int wrong = 0;
+
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        uint8_t folder = voice_catalog_entries[i].folder;
+        uint16_t expected = all || folder == guessed ? voice_catalog_entries[i].fallback
+                            : test_present[folder]   ? test_files[folder]
+                                                     : 0;
+
+        if (folder != 0 && voice_catalog_count(folder) != expected) {
+            printf("  folder %u: %u tracks, expected %u\n", folder, voice_catalog_count(folder), expected);
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+int
+main(void) {
+    uint8_t folders = 0, mute;
+    uint32_t ms;
+
+    if (mmap((void*)TEST_PAGE, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+        != (void*)TEST_PAGE) {
+        printf("Cannot map the flash page at 0x%08lX\n", TEST_PAGE);
+        return 1;
+    }
+    memset(test_flash, 0xFF, 1024);
+    for (uint8_t i = 0; i < VOICE_CATALOG_NUM; i++) {
+        folders += voice_catalog_entries[i].folder != 0;
+    }
+
+    /* Cold boot, a query per folder, written to the cache */
+    test_card(1);
+    ms = test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY, "cold boot: status %d", voice_catalog_get_status());
+    TEST_CHECK(test_counts(0, 0) == 0, "cold boot counts");
+    TEST_CHECK(test_queries == 1 + folders, "cold boot: %u queries for %u folders", test_queries, folders);
+    TEST_CHECK(test_erases == 1 && test_programs == 4 + VOICE_CATALOG_NUM, "cold boot: %u erases, %u half-words",
+               test_erases, test_programs);
+    printf("Cold boot scanned %u folders in %u ms\n", folders, ms);
+
+    /* Warm boot, the total alone, loaded from the cache */
+    ms = test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY && test_counts(0, 0) == 0, "warm boot counts");
+    TEST_CHECK(test_queries == 1 && test_erases == 0, "warm boot: %u queries, %u erases", test_queries, test_erases);
+    printf("Warm boot loaded the cache in %u ms\n", ms);
+
+    /* Another card, scanned again, a folder it lacks counts 0 */
+    test_card(2);
+    test_present[VOICE_SCENE_HANG_OUT] = 0;
+    test_files[VOICE_SCENE_HANG_OUT] = 0;
+    test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY && test_counts(0, 0) == 0, "changed card counts");
+    TEST_CHECK(test_queries == 1 + folders && test_erases == 1, "changed card: %u queries, %u erases", test_queries,
+               test_erases);
+
+    /* A reply lost twice, the query is sent again */
+    test_card(3);
+    test_lose = 2;
+    test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY && test_counts(0, 0) == 0, "lost reply counts");
+    TEST_CHECK(test_queries == 3 + folders && test_erases == 1, "lost reply: %u queries, %u erases", test_queries,
+               test_erases);
+
+    /* A folder never answers, it keeps its compile-time count, and the scan is not cached */
+    test_card(4);
+    mute = VOICE_INTERACTION_CHAT;
+    test_mute[mute] = 1;
+    ms = test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY && test_counts(mute, 0) == 0, "mute folder counts");
+    TEST_CHECK(test_queries == VOICE_CATALOG_TRIES + folders, "mute folder: %u queries", test_queries);
+    TEST_CHECK(test_erases == 0 && test_programs == 0, "mute folder: %u erases, %u half-words cached", test_erases,
+               test_programs);
+    TEST_CHECK(ms >= VOICE_CATALOG_TRIES * VOICE_CATALOG_TIMEOUT_MS, "mute folder given up after %u ms", ms);
+
+    /* So the next boot with the same card scans again, and caches it once the folder answers */
+    test_mute[mute] = 0;
+    test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_READY && test_counts(0, 0) == 0, "rescan counts");
+    TEST_CHECK(test_queries == 1 + folders && test_erases == 1, "rescan: %u queries, %u erases", test_queries,
+               test_erases);
+
+    /* The module does not answer at all, the compile-time catalog, the cache left as it is */
+    test_mute_tf = 1;
+    ms = test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_FALLBACK && test_counts(0, 1) == 0, "mute module counts");
+    TEST_CHECK(test_queries == VOICE_CATALOG_TRIES && test_erases == 0, "mute module: %u queries, %u erases",
+               test_queries, test_erases);
+    printf("Mute module given up after %u ms\n", ms);
+
+    /* A card without files, the compile-time catalog at once */
+    memset(test_files, 0, sizeof(test_files));
+    test_mute_tf = 0;
+    test_boot();
+    TEST_CHECK(voice_catalog_get_status() == VOICE_CATALOG_FALLBACK && test_counts(0, 1) == 0, "empty card counts");
+    TEST_CHECK(test_queries == 1, "empty card: %u queries", test_queries);
+
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,239 @@
+/**
+* \file            voice_category_test.c
+* \date            10/19/2026
+* \brief           Host test of the voice category table and its line counts
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Walks VOICE_CATEGORY_LIST of voice_cfg.h with its own X macro and checks, line by line, what
+ * voice_category.c and voice_catalog.c generate from it: the category of each folder is at the
+ * index of its line with the trigger, boost, weight and cooldown of that line, and the catalog
+ * entry at that index is the folder with <folder>_NUM lines. Then it draws from every category
+ * and checks the lines come from 1 to <folder>_NUM before the scan, each once per round, and from
+ * 1 to the scanned count once the card said otherwise, an empty folder saying nothing. Build and
+ * run from the repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/voice_category_test/voice_category_test.c System/src/shuffle.c System/src/soft_timer.c \
+ *       -o voice_category_test && ./voice_category_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* Built in for the tables they generate from the list */
+#include "../../User/src/voice_category.c"
+#undef LOG_TAG
+#undef ARRAY_LEN
+#include "../../User/src/voice_catalog.c"
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The clock, the alarm, the sensor and the module, none of which the table depends on */
+
+uint8_t clock_year, clock_month, clock_day, clock_hour, clock_minute, clock_second, clock_week;
+clock_time_of_day_t clock_time_of_day;
+clock_season_t clock_season;
+static uint32_t test_ms;
+static uint32_t test_random = 1;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+uint8_t
+clock_is_sleep_time(void) {
+    return 0;
+}
+
+uint8_t
+clock_is_getup_time(void) {
+    return 0;
+}
+
+uint8_t
+clock_is_my_birthday(void) {
+    return 0;
+}
+
+uint8_t
+clock_is_elysia_birthday(void) {
+    return 0;
+}
+
+uint8_t
+alarm_went_off(uint16_t minutes) {
+    (void)minutes;
+    return 0;
+}
+
+temperature_trend_t
+temperature_get_trend(void) {
+    return TEMPERATURE_STEADY;
+}
+
+uint32_t
+random_u32(void) {
+    test_random = test_random * 1664525 + 1013904223;
+    return test_random;
+}
+
+uint32_t
+random_range(uint32_t bound) {
+    return bound != 0 ? random_u32() % bound : 0;
+}
+
+void
+df_query_tf_file_num(void) {}
+
+void
+df_query_file_num_from_folder(uint8_t folder) {
+    (void)folder;
+}
+
+void
+FLASH_Unlock(void) {}
+
+void
+FLASH_Lock(void) {}
+
+void
+FLASH_ClearFlag(uint32_t flags) {
+    (void)flags;
+}
+
+FLASH_Status
+FLASH_ErasePage(uint32_t address) {
+    (void)address;
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status
+FLASH_ProgramHalfWord(uint32_t address, uint16_t data) {
+    (void)address;
+    (void)data;
+    return FLASH_COMPLETE;
+}
+
+/**
+ * \brief           Check the category and the catalog entry generated from one line of the list
+ * \param[in]       index: Index of the line in the list
+ */
+static void
+test_row(uint8_t index, const char* name, uint8_t folder, uint16_t num, uint32_t trigger, uint32_t boost,
+         uint8_t weight, uint16_t cooldown) {
+    const voice_category_t* category = &voice_categories[index];
+
+    TEST_CHECK(voice_category_find(folder) == index, "%s found at %u, listed at %u", name,
+               voice_category_find(folder), index);
+    TEST_CHECK(category->folder == folder && category->trigger == trigger && category->boost == boost
+                   && category->weight == weight && category->cooldown == cooldown,
+               "%s: category %u is folder %u, not the listed one", name, index, category->folder);
+    TEST_CHECK(voice_catalog_entries[index].folder == folder && voice_catalog_entries[index].fallback == num,
+               "%s: catalog entry %u is folder %u of %u lines, not %u of %u", name, index,
+               voice_catalog_entries[index].folder, voice_catalog_entries[index].fallback, folder, num);
+    TEST_CHECK(voice_catalog_count(folder) == num, "%s: %u lines before the scan, not %s_NUM %u", name,
+               voice_catalog_count(folder), name, num);
+}
+
+/**
+ * \brief           Draw a few rounds of a folder and check every line comes once per round
+ * \param[in]       count: Lines the catalog holds for the folder
+ */
+static void
+test_draws(const char* name, uint8_t folder, uint16_t count) {
+    for (uint8_t round = 0; round < 3; round++) {
+        uint8_t drawn[256] = {0};
+        for (uint16_t i = 0; i < count; i++) {
+            uint8_t line = voice_category_line(folder);
+            TEST_CHECK(line >= 1 && line <= count && !drawn[line], "%s: line %u drawn of %u", name, line, count);
+            drawn[line] = 1;
+        }
+    }
+    if (count == 0) {
+        TEST_CHECK(voice_category_line(folder) == 0, "%s: empty folder said a line", name);
+    }
+}
+
+static void
+test_list(void) {
+    uint8_t index = 0;
+
+#define TEST_ROW(folder, trigger, boost, weight, cooldown)                                                      \
+    TEST_CHECK(folder##_INDEX == index, #folder "_INDEX is %u, listed at %u", folder##_INDEX, index);           \
+    test_row(index++, #folder, folder, folder##_NUM, trigger, boost, weight, cooldown);
+    VOICE_CATEGORY_LIST(TEST_ROW)
+#undef TEST_ROW
+
+    TEST_CHECK(index == VOICE_CATEGORY_NUM, "%u lines listed, %u categories", index, VOICE_CATEGORY_NUM);
+    TEST_CHECK(voice_category_find(VOICE_DEFAULT) < VOICE_CATEGORY_NUM, "no category for the default folder");
+    TEST_CHECK(voice_category_find(VOICE_CLIP) == VOICE_CATEGORY_NUM && voice_category_line(VOICE_CLIP) == 0,
+               "the clip folder has a category");
+    TEST_CHECK(voice_category_find(VOICE_MUSIC_RESOURCE) == VOICE_CATEGORY_NUM, "the music folder has a category");
+}
+
+static void
+test_counts(void) {
+    /* Before the scan, the compile-time counts */
+#define TEST_DRAWS(folder, trigger, boost, weight, cooldown) test_draws(#folder, folder, folder##_NUM);
+    VOICE_CATEGORY_LIST(TEST_DRAWS)
+#undef TEST_DRAWS
+
+    /* A card with a line more, a line less or no line at all in its folders */
+    for (uint8_t i = 0; i < VOICE_CATEGORY_NUM; i++) {
+        voice_catalog_counts[i] = (uint16_t)(voice_catalog_entries[i].fallback + i % 3 - 1);
+    }
+    voice_catalog_status = VOICE_CATALOG_READY;
+#define TEST_DRAWS(folder, trigger, boost, weight, cooldown)                                                    \
+    test_draws(#folder, folder, (uint16_t)(folder##_NUM + folder##_INDEX % 3 - 1));
+    VOICE_CATEGORY_LIST(TEST_DRAWS)
+#undef TEST_DRAWS
+}
+
+int
+main(void) {
+    voice_catalog_init();
+    test_list();
+    test_counts();
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,335 @@
+/**
+* \file            voice_sim.c
+* \date            10/19/2026
+* \brief           Host simulation of a year of voice line picks
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Replays a year of clock time and room temperature through the real clock, alarm, temperature and
+ * voice category modules, presses the voice key at random while awake and reports how the picks spread
+ * over the categories. Build and run from the repository root:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/voice_sim/voice_sim.c User/src/voice_category.c User/src/clock.c User/src/alarm.c \
+ *       User/src/temperature.c User/src/volume.c System/src/shuffle.c -lm -o voice_sim && ./voice_sim [seed]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../config/voice_cfg.h"
+#include "alarm.h"
+#include "clock.h"
+#include "dfplayer_mini.h"
+#include "ds18b20.h"
+#include "random.h"
+#include "temperature.h"
+#include "voice.h"
+#include "voice_catalog.h"
+#include "voice_category.h"
+
+#define SIM_YEAR           26
+#define SIM_FIRST_WEEKDAY  4 // 2026-01-01 is a Thursday
+#define SIM_PRESS_PER_HOUR 1 // Voice key presses per waking hour on average
+#define SIM_FRONTS         24 // Cold fronts in the year
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+/* Stand-ins for the hardware the modules read */
+uint8_t ds1302_time[8];
+static uint32_t sim_ms;
+static float sim_t;
+
+/* Cold fronts: the room loses 6 degrees over 3 hours and recovers over 2 days */
+static uint32_t sim_fronts[SIM_FRONTS];
+
+/* Sunny days: the sun through the window adds up to 5 degrees from 10:00 to 16:00 */
+static uint8_t sim_sunny[365];
+
+static uint64_t sim_state = 0x853C49E6748FEA9BULL;
+
+static uint32_t
+sim_rand(void) {
+    sim_state = sim_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(sim_state >> 33);
+}
+
+void
+ds1302_init(void) {}
+
+void
+ds1302_read(void) {}
+
+void
+ds1302_write_fields(const uint8_t* time, uint8_t fields) {
+    (void)time;
+    (void)fields;
+}
+
+/* No backup domain: the alarm stays at its default */
+uint8_t
+backup_init(void) {
+    return 0;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    (void)reg;
+    return 0;
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    (void)reg;
+    (void)value;
+}
+
+uint32_t
+counter_get_ms(void) {
+    return sim_ms;
+}
+
+coroutine_status_t
+ds18b20_convert_t(coroutine_t* co) {
+    (void)co;
+    return COROUTINE_DONE;
+}
+
+coroutine_status_t
+ds18b20_read_t(coroutine_t* co, float* t) {
+    (void)co;
+    *t = sim_t;
+    return COROUTINE_DONE;
+}
+
+bool
+ds18b20_is_present(void) {
+    return true;
+}
+
+void
+voice_announce(announcer_phrase_t phrase) {
+    (void)phrase;
+}
+
+voice_audio_t
+voice_get_audio(void) {
+    return VOICE_AUDIO_IDLE;
+}
+
+void
+voice_music_play(void) {}
+
+void
+voice_music_pause(void) {}
+
+void
+df_set_volume(uint8_t volume) {
+    (void)volume;
+}
+
+uint32_t
+df_get_idle_ms(void) {
+    return UINT32_MAX;
+}
+
+uint32_t
+random_u32(void) {
+    return sim_rand();
+}
+
+uint32_t
+random_range(uint32_t bound) {
+    return (uint32_t)(((uint64_t)sim_rand() << 32 | sim_rand()) % bound);
+}
+
+#define SIM_CATALOG_CASE(folder, trigger, boost, weight, cooldown) case folder: return folder##_NUM;
+
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    switch (folder) {
+        VOICE_CATEGORY_LIST(SIM_CATALOG_CASE)
+        default: return 0;
+    }
+}
+
+#define SIM_CATEGORY_NAME(folder, trigger, boost, weight, cooldown) {folder, #folder},
+
+static const struct {
+    uint8_t folder;
+    const char* name;
+} sim_categories[] = {VOICE_CATEGORY_LIST(SIM_CATEGORY_NAME)};
+
+static const char* const sim_seasons[] = {"spring", "summer", "autumn", "winter"};
+
+/**
+ * \brief           Room temperature at a minute of the year
+ */
+static float
+sim_temperature(uint32_t minute) {
+    float day = minute / 1440.0f;
+    float t = 17.0f - 9.0f * cosf(2 * (float)M_PI * (day - 15) / 365) /* Coldest mid January */
+              - 1.5f * cosf(2 * (float)M_PI * (day - 0.625f));      /* Warmest at 15:00 */
+    uint32_t of_day = minute % 1440;
+    size_t i;
+
+    if (sim_sunny[minute / 1440] && of_day >= 10 * 60 && of_day < 16 * 60) {
+        t += 5.0f * sinf((float)M_PI * (of_day - 10 * 60) / (6 * 60));
+    }
+    for (i = 0; i < ARRAY_LEN(sim_fronts); i++) {
+        if (minute < sim_fronts[i]) {
+            continue;
+        }
+        uint32_t since = minute - sim_fronts[i];
+        if (since < 180) {
+            t -= 6.0f * since / 180;
+        } else if (since < 180 + 2880) {
+            t -= 6.0f * (180 + 2880 - since) / 2880;
+        }
+    }
+    /* The DS18B20 resolves 1/16 degree */
+    return roundf(t * 16) / 16;
+}
+
+/**
+ * \brief           Set the simulated RTC to a minute of the year
+ */
+static void
+sim_set_clock(uint32_t minute) {
+    static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    uint32_t day = minute / 1440;
+    uint8_t month = 0;
+
+    ds1302_time[6] = (SIM_FIRST_WEEKDAY - 1 + day) % 7 + 1;
+    while (day >= days[month]) {
+        day -= days[month++];
+    }
+    ds1302_time[0] = SIM_YEAR;
+    ds1302_time[1] = month + 1;
+    ds1302_time[2] = day + 1;
+    ds1302_time[3] = minute / 60 % 24;
+    ds1302_time[4] = minute % 60;
+    ds1302_time[5] = 0;
+}
+
+int
+main(int argc, char* argv[]) {
+    static uint32_t counts[ARRAY_LEN(sim_categories)][4];
+    static uint32_t per_season[4];
+    uint32_t cooling_minutes = 0, warming_minutes = 0, cool_down_in_front = 0, picks = 0;
+    uint32_t trends[3] = {0}, weather_lines = 0;
+    temperature_trend_t trend = TEMPERATURE_STEADY;
+    uint32_t clocks = 0;
+    uint32_t minute;
+    size_t i;
+
+    if (argc > 1) {
+        sim_state ^= strtoull(argv[1], NULL, 0);
+    }
+    for (i = 0; i < ARRAY_LEN(sim_fronts); i++) {
+        sim_fronts[i] = sim_rand() % (365 * 1440);
+    }
+    for (i = 0; i < ARRAY_LEN(sim_sunny); i++) {
+        sim_sunny[i] = sim_rand() % 3 == 0;
+    }
+
+    clock_init();
+    for (minute = 0; minute < 365 * 1440; minute++) {
+        sim_ms = minute * 60000U;
+        sim_t = sim_temperature(minute);
+        sim_set_clock(minute);
+        clock_update();
+        alarm_process();
+        temperature_process();
+
+        cooling_minutes += temperature_get_trend() == TEMPERATURE_COOLING;
+        warming_minutes += temperature_get_trend() == TEMPERATURE_WARMING;
+
+        /* voice_process says a weather line when a trend starts, unless it is night */
+        if ((trend = temperature_take_event()) != TEMPERATURE_STEADY) {
+            trends[trend]++;
+            if (!(voice_category_context() & (VOICE_WHEN_MIDNIGHT | VOICE_WHEN_SLEEP_TIME))) {
+                weather_lines++;
+            }
+        }
+
+        /* Awake from the getup time until half past eleven, the alarm always gets a press */
+        uint16_t of_day = clock_hour * 60 + clock_minute;
+        uint8_t awake = of_day >= 7 * 60 + 30 && of_day < 23 * 60 + 30;
+        if (!(clock_is_getup_time() || (awake && sim_rand() % 60 < SIM_PRESS_PER_HOUR))) {
+            continue;
+        }
+
+        voice_line_t line;
+        clock_t start = clock();
+        voice_category_pick(VOICE_GROUP_ALL, &line);
+        clocks += clock() - start;
+        picks++;
+
+        for (i = 0; i < ARRAY_LEN(sim_categories); i++) {
+            if (sim_categories[i].folder == line.folder) {
+                counts[i][clock_season]++;
+                per_season[clock_season]++;
+                break;
+            }
+        }
+        if (line.folder == VOICE_WEATHER_COOL_DOWN) {
+            for (i = 0; i < ARRAY_LEN(sim_fronts); i++) {
+                if (minute >= sim_fronts[i] && minute - sim_fronts[i] < 180 + 2880) {
+                    cool_down_in_front++;
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("%u picks in a year, %.2f us per pick on this host\n", picks, clocks * 1e6 / CLOCKS_PER_SEC / picks);
+    printf("%-30s %7s %7s %7s %7s %7s\n", "category", "all", sim_seasons[0], sim_seasons[1], sim_seasons[2],
+           sim_seasons[3]);
+    for (i = 0; i < ARRAY_LEN(sim_categories); i++) {
+        uint32_t all = counts[i][0] + counts[i][1] + counts[i][2] + counts[i][3];
+        printf("%-30s %6.2f%%", sim_categories[i].name, 100.0 * all / picks);
+        for (size_t s = 0; s < 4; s++) {
+            printf(" %6.2f%%", per_season[s] != 0 ? 100.0 * counts[i][s] / per_season[s] : 0.0);
+        }
+        printf("\n");
+    }
+    printf("%u cooling and %u warming trends lasting %u and %u minutes, %u announced by a weather line\n",
+           trends[TEMPERATURE_COOLING], trends[TEMPERATURE_WARMING], cooling_minutes, warming_minutes, weather_lines);
+    printf("%u of the cool down lines picked by the key fell in a cold front\n", cool_down_in_front);
+    /* A year of fronts without a trend means the readings never reached the history */
+    if (trends[TEMPERATURE_COOLING] == 0 || trends[TEMPERATURE_WARMING] == 0) {
+        printf("FAIL: no cooling or no warming trend in a year\n");
+        return 1;
+    }
+    return 0;
+}
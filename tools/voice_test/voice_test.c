@@ -0,0 +1,414 @@
+/**
+* \file            voice_test.c
+* \date            10/19/2026
+* \brief           Host test of the voice lines interjected into the music
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Plays music through voice.c, playlist.c and music.c against a simulated DFPlayer, on a
+ * simulated millisecond clock, and says voice lines over it. The simulated module plays one
+ * track at a time, suspends it for an advert and resumes it where it was once the advert ends,
+ * refuses an advert it has no file for, or when no track plays, and reports the end of a track,
+ * twice as the real one often does, but not the end of an advert. It checks that an interjected
+ * line leaves the track whole and the next track follows it once, that a refused advert has the
+ * line said on its own and the track started over, that lines over silence leave it silent, and
+ * that a second line over the first one still resumes the track. Build and run from the
+ * repository root, it exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Wall -Itools/host -IUser/inc -IHardware/inc -ISystem/inc tools/voice_test/voice_test.c \
+ *       User/src/playlist.c User/src/music.c System/src/shuffle.c -o voice_test && ./voice_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* Built in to follow its state */
+#include "../../User/src/voice.c"
+
+#define TEST_TRACK_MS  180000 /* Every music track */
+#define TEST_LINE_MS   3000   /* Every voice line and advert */
+#define TEST_REPLY_MS  20     /* The module answering a command */
+#define TEST_REPEAT_MS 5      /* The second end of track frame */
+#define TEST_LINE      7      /* Line of the chat folder said */
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* Time */
+
+static uint32_t test_ms;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+/* The DFPlayer, a track is folder * 100 + number */
+
+static uint16_t test_track;      /* Track loaded, 0 if none */
+static uint32_t test_track_left; /* Time left of it, while it is suspended or paused */
+static uint32_t test_track_end;  /* Time it ends, while it plays */
+static uint8_t test_paused;
+static uint16_t test_advert;     /* Advert playing over the track, 0 if none */
+static uint32_t test_advert_end;
+static uint8_t test_advert_missing; /* The ADVERT folder lacks the copies of the lines */
+static uint32_t test_heard[2];   /* Time each of the first two music tracks was heard */
+static uint16_t test_started[100]; /* Times each music track was started from its beginning */
+static uint16_t test_lines;      /* Lines started from their folder */
+static uint16_t test_adverts;    /* Adverts started */
+
+static struct {
+    uint32_t ms;
+    df_response_t response;
+} test_frames[8];
+static uint8_t test_frame_num;
+
+static void
+test_send(uint32_t delay_ms, uint8_t cmd, uint16_t param) {
+    if (test_frame_num < sizeof(test_frames) / sizeof(test_frames[0])) {
+        test_frames[test_frame_num].ms = test_ms + delay_ms;
+        test_frames[test_frame_num].response.cmd = cmd;
+        test_frames[test_frame_num].response.param = param;
+        test_frame_num++;
+    }
+}
+
+uint8_t
+df_read_response(df_response_t* response) {
+    for (uint8_t i = 0; i < test_frame_num; i++) {
+        if (test_frames[i].ms <= test_ms) {
+            *response = test_frames[i].response;
+            memmove(&test_frames[i], &test_frames[i + 1], (test_frame_num - i - 1) * sizeof(test_frames[0]));
+            test_frame_num--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void
+df_play_from_folder(uint8_t folder, uint8_t number) {
+    test_track = (uint16_t)(folder * 100 + number);
+    test_track_end = test_ms + (folder == VOICE_MUSIC_RESOURCE ? TEST_TRACK_MS : TEST_LINE_MS);
+    test_paused = 0;
+    test_advert = 0;
+    if (folder == VOICE_MUSIC_RESOURCE) {
+        test_started[number]++;
+    } else {
+        test_lines++;
+    }
+}
+
+void
+df_play_from_large_folder(uint8_t folder, uint16_t number) {
+    (void)folder;
+    (void)number;
+}
+
+void
+df_play_from_mp3_folder(uint16_t number) {
+    (void)number;
+}
+
+void
+df_play_advert(uint16_t number) {
+    if (test_track == 0 || test_paused) {
+        test_send(TEST_REPLY_MS, DF_RESPONSE_ERROR, DF_ERROR_INSERTION);
+        return;
+    }
+    if (test_advert_missing) {
+        test_send(TEST_REPLY_MS, DF_RESPONSE_ERROR, DF_ERROR_NOT_FOUND);
+        return;
+    }
+    if (test_advert == 0) {
+        test_track_left = test_track_end - test_ms;
+    }
+    test_advert = number;
+    test_advert_end = test_ms + TEST_LINE_MS;
+    test_adverts++;
+}
+
+void
+df_pause(void) {
+    if (test_track != 0 && !test_paused && test_advert == 0) {
+        test_track_left = test_track_end - test_ms;
+        test_paused = 1;
+    }
+}
+
+void
+df_continue(void) {
+    if (test_paused) {
+        test_track_end = test_ms + test_track_left;
+        test_paused = 0;
+    }
+}
+
+/**
+ * \brief           Move the module on by a millisecond
+ */
+static void
+test_tick(void) {
+    test_ms++;
+    if (test_advert != 0) {
+        /* The track goes on where it was, without a frame */
+        if (test_ms >= test_advert_end) {
+            test_advert = 0;
+            test_track_end = test_ms + test_track_left;
+        }
+        return;
+    }
+    if (test_track == 0 || test_paused) {
+        return;
+    }
+    if (test_track / 100 == VOICE_MUSIC_RESOURCE && test_track % 100 <= 2) {
+        test_heard[test_track % 100 - 1]++;
+    }
+    if (test_ms >= test_track_end) {
+        test_send(0, DF_RESPONSE_TF_FINISHED, test_track);
+        test_send(TEST_REPEAT_MS, DF_RESPONSE_TF_FINISHED, test_track);
+        test_track = 0;
+    }
+}
+
+/**
+ * \brief           Run the module and the voice task for some time
+ */
+static void
+test_run(uint32_t ms) {
+    for (uint32_t end = test_ms + ms; test_ms < end;) {
+        test_tick();
+        voice_process();
+    }
+}
+
+/* The rest of the device, the module is ready and the catalog scanned */
+
+void
+df_init(uint8_t volume) {
+    (void)volume;
+}
+
+uint8_t
+df_is_ready(void) {
+    return 1;
+}
+
+uint32_t
+df_get_idle_ms(void) {
+    return UINT32_MAX;
+}
+
+uint8_t
+voice_catalog_on_response(const df_response_t* response) {
+    (void)response;
+    return 0;
+}
+
+uint16_t
+voice_catalog_count(uint8_t folder) {
+    return folder == VOICE_MUSIC_RESOURCE ? VOICE_MUSIC_NUM : 0;
+}
+
+voice_catalog_status_t
+voice_catalog_get_status(void) {
+    return VOICE_CATALOG_READY;
+}
+
+uint8_t
+voice_category_line(uint8_t folder) {
+    (void)folder;
+    return TEST_LINE;
+}
+
+uint8_t
+voice_category_pick(uint16_t groups, voice_line_t* line) {
+    (void)groups;
+    line->folder = VOICE_INTERACTION_CHAT;
+    line->number = TEST_LINE;
+    return 1;
+}
+
+uint32_t
+voice_category_context(void) {
+    return 0;
+}
+
+uint8_t
+announcer_start(announcer_phrase_t phrase) {
+    (void)phrase;
+    return 0;
+}
+
+uint8_t
+announcer_on_finished(void) {
+    return 0;
+}
+
+void
+announcer_stop(void) {}
+
+temperature_trend_t
+temperature_take_event(void) {
+    return TEMPERATURE_STEADY;
+}
+
+void
+volume_init(uint8_t volume) {
+    (void)volume;
+}
+
+void
+volume_set(uint8_t volume) {
+    (void)volume;
+}
+
+void
+volume_step(int8_t delta) {
+    (void)delta;
+}
+
+void
+volume_process(void) {}
+
+uint8_t
+volume_is_applied(void) {
+    return 1;
+}
+
+volume_ramp_state_t
+volume_get_ramp(void) {
+    return VOLUME_RAMP_IDLE;
+}
+
+void
+idle_hold(idle_client_t client, uint8_t hold) {
+    (void)client;
+    (void)hold;
+}
+
+uint8_t
+backup_init(void) {
+    return 0;
+}
+
+uint16_t
+backup_read(uint16_t reg) {
+    (void)reg;
+    return 0;
+}
+
+void
+backup_write(uint16_t reg, uint16_t value) {
+    (void)reg;
+    (void)value;
+}
+
+uint32_t
+random_u32(void) {
+    return 0x12345678;
+}
+
+int
+main(void) {
+    uint32_t heard;
+
+    voice_init(20);
+
+    /* A line over silence is said on its own, and silence follows */
+    voice_chat();
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_LINE && test_lines == 1, "line over silence: state %d, %u lines",
+               voice_get_audio(), test_lines);
+    test_run(TEST_LINE_MS + 100);
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_IDLE && test_track == 0, "after the line: state %d, track %u",
+               voice_get_audio(), test_track);
+
+    /* A line interjected a minute into the first track, which goes on where it was */
+    voice_music_play();
+    TEST_CHECK(test_track == VOICE_MUSIC_RESOURCE * 100 + 1 && test_started[1] == 1, "music started on %u",
+               test_track);
+    test_run(60000);
+    voice_chat();
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_ADVERT && test_adverts == 1
+                   && test_advert == VOICE_ADVERT_TRACK(VOICE_INTERACTION_CHAT, TEST_LINE),
+               "interjection: state %d, advert %u", voice_get_audio(), test_advert);
+    test_run(VOICE_ADVERT_REPLY_MS + 10);
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_MUSIC, "advert playing: state %d", voice_get_audio());
+    test_run(TEST_TRACK_MS);
+    TEST_CHECK(test_heard[0] == TEST_TRACK_MS && test_started[1] == 1, "first track heard for %u ms, started %u times",
+               test_heard[0], test_started[1]);
+    TEST_CHECK(test_started[2] == 1 && test_track == VOICE_MUSIC_RESOURCE * 100 + 2,
+               "second track started %u times, playing %u", test_started[2], test_track);
+
+    /* The module has no copy of the line, it is said on its own and the track starts over */
+    test_advert_missing = 1;
+    test_run(30000);
+    voice_chat();
+    test_run(TEST_REPLY_MS + 10);
+    heard = test_heard[1];
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_LINE_OVER_MUSIC && test_lines == 2
+                   && test_track == VOICE_INTERACTION_CHAT * 100 + TEST_LINE,
+               "refused advert: state %d, %u lines, playing %u", voice_get_audio(), test_lines, test_track);
+    test_run(TEST_LINE_MS);
+    TEST_CHECK(voice_get_audio() == VOICE_AUDIO_MUSIC && test_started[2] == 2
+                   && test_track == VOICE_MUSIC_RESOURCE * 100 + 2,
+               "after the line: state %d, second track started %u times", voice_get_audio(), test_started[2]);
+    test_advert_missing = 0;
+
+    /* A second line over the first one, the track still goes on where it was */
+    test_run(10000);
+    voice_chat();
+    test_run(1000);
+    voice_chat();
+    test_run(TEST_TRACK_MS);
+    TEST_CHECK(test_adverts == 3 && test_heard[1] == heard + TEST_TRACK_MS,
+               "second track heard for %u ms after %u, %u adverts", test_heard[1] - heard, heard, test_adverts);
+    TEST_CHECK(test_started[3] == 1 && voice_get_audio() == VOICE_AUDIO_MUSIC, "third track started %u times, state %d",
+               test_started[3], voice_get_audio());
+
+    /* Paused, a line is said on its own */
+    voice_music_pause();
+    voice_chat();
+    TEST_CHECK(test_adverts == 3 && test_lines == 3 && voice_get_audio() == VOICE_AUDIO_LINE,
+               "over the paused music: %u adverts, %u lines, state %d", test_adverts, test_lines, voice_get_audio());
+
+    printf(test_failures ? "%d checks failed\n" : "All checks passed\n", test_failures);
+    return test_failures != 0;
+}
@@ -0,0 +1,353 @@
+/**
+* \file            volume_test.c
+* \date            10/19/2026
+* \brief           Host tests of the volume ramp engine and the alarm wake-up
+*/
+
+/*
+* Copyright (c) 2026 JinLiang YAN
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge,
+* publish, distribute, sublicense, and/or sell copies of the Software,
+* and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+* AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* This file is part of Elysia-Voice-alarm-clock.
+*
+* Author:          JinLiang YAN <yanmiku0206@outlook.com>
+*/
+
+/*
+ * Runs the volume ramps and the alarm against a simulated DFPlayer and checks when the volume
+ * commands are sent, how many and how far apart. Build and run from the repository root, it
+ * exits non-zero on failure:
+ *
+ *   gcc -std=gnu11 -O2 -Itools/host -IUser/inc -IHardware/inc -ISystem/inc \
+ *       tools/volume_test/volume_test.c User/src/volume.c User/src/alarm.c -o volume_test && ./volume_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../config/clock_cfg.h"
+#include "../../config/voice_cfg.h"
+#include "alarm.h"
+#include "clock.h"
+#include "dfplayer_mini.h"
+#include "voice.h"
+#include "volume.h"
+
+#define TEST_LOOP_MS 10 /* Main loop period */
+#define TEST_CMD_MAX 256
+
+static int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                                                   \
+    do {                                                                                                        \
+        if (!(cond)) {                                                                                          \
+            printf("FAIL %s:%d: ", __func__, __LINE__);                                                         \
+            printf(__VA_ARGS__);                                                                                \
+            printf("\n");                                                                                       \
+            test_failures++;                                                                                    \
+        }                                                                                                       \
+    } while (0)
+
+/* The simulated player: every command, volume or not, and the volume it is at */
+static uint32_t test_ms;
+static uint32_t test_cmd_ms = 0xFFFF0000; /* Long ago */
+static uint32_t test_cmd_gap_min;
+static struct {
+    uint32_t ms;
+    uint8_t volume;
+} test_cmds[TEST_CMD_MAX];
+static int test_cmd_num;
+static uint8_t test_player_volume;
+
+/* The rest of the firmware, as much as the alarm sees of it */
+uint8_t clock_hour, clock_minute;
+static uint8_t test_getup;
+static voice_audio_t test_audio;
+static uint32_t test_announce_ms;
+static uint8_t test_announce_volume;
+
+uint32_t
+counter_get_ms(void) {
+    return test_ms;
+}
+
+static void
+test_command(void) {
+    if (test_ms - test_cmd_ms < test_cmd_gap_min) {
+        test_cmd_gap_min = test_ms - test_cmd_ms;
+    }
+    test_cmd_ms = test_ms;
+}
+
+uint32_t
+df_get_idle_ms(void) {
+    return test_ms - test_cmd_ms;
+}
+
+void
+df_set_volume(uint8_t volume) {
+    test_command();
+    if (test_cmd_num < TEST_CMD_MAX) {
+        test_cmds[test_cmd_num].ms = test_ms;
+        test_cmds[test_cmd_num].volume = volume;
+        test_cmd_num++;
+    }
+    test_player_volume = volume;
+}
+
+uint8_t
+clock_is_getup_time(void) {
+    return test_getup;
+}
+
+void
+voice_announce(announcer_phrase_t phrase) {
+    test_command();
+    test_announce_ms = test_ms;
+    test_announce_volume = test_player_volume;
+    test_audio = VOICE_AUDIO_LINE;
+}
+
+voice_audio_t
+voice_get_audio(void) {
+    /* The greeting lasts three seconds */
+    if (test_audio == VOICE_AUDIO_LINE && test_ms - test_announce_ms >= 3000) {
+        test_audio = VOICE_AUDIO_IDLE;
+    }
+    return test_audio;
+}
+
+void
+voice_music_play(void) {
+    test_command();
+    test_audio = VOICE_AUDIO_MUSIC;
+}
+
+void
+voice_music_pause(void) {
+    if (test_audio == VOICE_AUDIO_MUSIC) {
+        test_command();
+        test_audio = VOICE_AUDIO_MUSIC_PAUSED;
+    }
+}
+
+/**
+ * \brief           Start from a quiet player at a volume
+ */
+static void
+test_reset(uint8_t volume) {
+    volume_init(volume);
+    test_player_volume = volume;
+    test_cmd_num = 0;
+    test_cmd_gap_min = UINT32_MAX;
+    test_ms += 10000;
+}
+
+/**
+ * \brief           Run the main loop for some time
+ */
+static void
+test_run(uint32_t ms, uint8_t with_alarm) {
+    uint32_t end = test_ms + ms;
+
+    for (; test_ms != end; test_ms += TEST_LOOP_MS) {
+        if (with_alarm) {
+            alarm_process();
+        }
+        volume_process();
+    }
+}
+
+/**
+ * \brief           Check the commands step by one level in one direction, and end at a level
+ */
+static void
+test_check_monotonic(const char* name, int direction, uint8_t last) {
+    int i;
+
+    for (i = 1; i < test_cmd_num; i++) {
+        int step = (int)test_cmds[i].volume - test_cmds[i - 1].volume;
+        TEST_CHECK(step * direction > 0, "%s: command %d goes %d -> %d", name, i, test_cmds[i - 1].volume,
+                   test_cmds[i].volume);
+    }
+    TEST_CHECK(test_cmd_num > 0 && test_cmds[test_cmd_num - 1].volume == last, "%s: ends at %d, expected %d", name,
+               test_cmd_num ? test_cmds[test_cmd_num - 1].volume : -1, last);
+    TEST_CHECK(test_cmd_gap_min >= VOICE_VOLUME_COMMAND_GAP_MS, "%s: commands %u ms apart", name, test_cmd_gap_min);
+}
+
+static void
+test_linear(void) {
+    uint32_t start;
+    int i;
+
+    test_reset(5);
+    start = test_ms;
+    volume_ramp(VOLUME_CURRENT, 20, 15000, VOLUME_CURVE_LINEAR);
+    test_run(16000, 0);
+    TEST_CHECK(test_cmd_num == 15, "%d commands, expected 15", test_cmd_num);
+    test_check_monotonic("linear", 1, 20);
+    /* Level k is reached half a step before k seconds, rounding to the nearest */
+    for (i = 0; i < test_cmd_num; i++) {
+        int32_t late = (int32_t)(test_cmds[i].ms - start) - (i * 1000 + 500);
+        TEST_CHECK(late >= 0 && late <= TEST_LOOP_MS, "step %d sent %d ms late", i, late);
+    }
+    TEST_CHECK(volume_get_ramp() == VOLUME_RAMP_DONE, "linear: not done");
+}
+
+static void
+test_perceptual(void) {
+    uint32_t start;
+    int i;
+
+    test_reset(0);
+    start = test_ms;
+    volume_ramp(VOLUME_CURRENT, 30, 60000, VOLUME_CURVE_PERCEPTUAL);
+    test_run(61000, 0);
+    TEST_CHECK(test_cmd_num == 30, "%d commands, expected 30", test_cmd_num);
+    test_check_monotonic("perceptual", 1, 30);
+    /* Level 1 at sqrt(0.5 / 30) of the ramp, half volume at sqrt(14.5 / 30) */
+    TEST_CHECK(test_cmds[0].ms - start >= 7740 && test_cmds[0].ms - start <= 7760, "first step at %u ms",
+               test_cmds[0].ms - start);
+    for (i = 0; i < test_cmd_num && test_cmds[i].volume < 15; i++) {}
+    TEST_CHECK(test_cmds[i].ms - start >= 41700 && test_cmds[i].ms - start <= 41720, "half volume at %u ms",
+               test_cmds[i].ms - start);
+}
+
+static void
+test_fast(void) {
+    test_reset(0);
+    volume_ramp(VOLUME_CURRENT, 30, 1000, VOLUME_CURVE_LINEAR);
+    test_run(1200, 0);
+    TEST_CHECK(test_cmd_num <= 11, "%d commands for a 1 s ramp", test_cmd_num);
+    test_check_monotonic("fast", 1, 30);
+
+    test_reset(20);
+    volume_ramp(VOLUME_CURRENT, 0, 2000, VOLUME_CURVE_LINEAR);
+    test_run(2200, 0);
+    test_check_monotonic("fade out", -1, 0);
+}
+
+static void
+test_key_cancels(void) {
+    uint8_t level;
+
+    test_reset(10);
+    volume_ramp(VOLUME_CURRENT, 30, 20000, VOLUME_CURVE_LINEAR);
+    test_run(5000, 0);
+    level = volume_get();
+    /* Two presses within a loop iteration, as from the key interrupt */
+    volume_step(1);
+    volume_step(1);
+    test_run(20000, 0);
+    TEST_CHECK(volume_get_ramp() == VOLUME_RAMP_CANCELED, "key did not cancel the ramp");
+    TEST_CHECK(test_cmds[test_cmd_num - 1].volume == level + 2, "after the keys %d, expected %d",
+               test_cmds[test_cmd_num - 1].volume, level + 2);
+    TEST_CHECK(test_cmd_num == level - 10 + 1, "%d commands, expected %d", test_cmd_num, level - 10 + 1);
+
+    test_reset(29);
+    volume_step(5);
+    test_run(200, 0);
+    TEST_CHECK(test_cmd_num == 1 && test_cmds[0].volume == VOICE_VOLUME_MAX, "step is not clamped");
+}
+
+static void
+test_busy_player(void) {
+    uint32_t busy_end;
+
+    test_reset(0);
+    volume_ramp(VOLUME_CURRENT, 10, 500, VOLUME_CURVE_LINEAR);
+    /* Other commands every 50 ms for a second, the volume waits for a pause */
+    for (busy_end = test_ms + 1000; test_ms < busy_end; test_ms += TEST_LOOP_MS) {
+        if (test_ms % 50 == 0) {
+            test_command();
+        }
+        volume_process();
+    }
+    TEST_CHECK(test_cmd_num == 0, "%d volume commands while busy", test_cmd_num);
+    test_run(200, 0);
+    TEST_CHECK(test_cmd_num == 1 && test_cmds[0].volume == 10, "%d commands after busy, the last %d",
+               test_cmd_num, test_cmd_num ? test_cmds[0].volume : -1);
+}
+
+/**
+ * \brief           Sound the alarm, at 20 before it went off
+ * \param[in]       press_ms: Time a volume down key is pressed, 0 for none
+ * \param[in]       dismiss_ms: Time the alarm is dismissed
+ */
+static void
+test_alarm(uint32_t press_ms, uint32_t dismiss_ms) {
+    uint32_t start;
+    uint8_t at_wake = 0, at_press = 0, max = 0;
+    int i;
+
+    test_reset(20);
+    test_audio = VOICE_AUDIO_IDLE;
+    test_getup = 1;
+    start = test_ms;
+    while (test_ms - start < dismiss_ms) {
+        test_run(TEST_LOOP_MS, 1);
+        if (test_ms - start == CLOCK_CFG_ALARM_WAKE_MS + 1000) {
+            at_wake = volume_get();
+        }
+        if (press_ms != 0 && test_ms - start == press_ms) {
+            at_press = volume_get();
+            volume_step(-1);
+        }
+        if (test_ms - start == 60000 + 1000) {
+            test_getup = 0;
+        }
+    }
+    for (i = 0; i < test_cmd_num; i++) {
+        max = test_cmds[i].volume > max ? test_cmds[i].volume : max;
+    }
+    alarm_dismiss();
+    test_run(1000, 1);
+
+    TEST_CHECK(test_cmds[0].volume == CLOCK_CFG_ALARM_START_VOLUME, "alarm starts at %d", test_cmds[0].volume);
+    TEST_CHECK(test_announce_volume == CLOCK_CFG_ALARM_START_VOLUME, "greeting at %d", test_announce_volume);
+    TEST_CHECK(!alarm_is_ringing() && test_audio == VOICE_AUDIO_MUSIC_PAUSED, "still ringing");
+    TEST_CHECK(test_cmd_gap_min >= VOICE_VOLUME_COMMAND_GAP_MS, "alarm commands %u ms apart", test_cmd_gap_min);
+    if (press_ms == 0) {
+        TEST_CHECK(at_wake == 20, "%d at the end of the wake ramp", at_wake);
+        TEST_CHECK(max == VOICE_VOLUME_MAX, "escalated up to %d", max);
+        TEST_CHECK(volume_get() == 20 && test_player_volume == 20, "volume %d after dismissal", volume_get());
+    } else {
+        TEST_CHECK(max == at_press, "escalated up to %d after a key at %d", max, at_press);
+        TEST_CHECK(volume_get() == at_press - 1, "volume %d after dismissal, expected the key's %d", volume_get(),
+                   at_press - 1);
+    }
+    printf("alarm: %d volume commands, start %d, %d at %d s, up to %d, %d after dismissal\n", test_cmd_num,
+           test_cmds[0].volume, at_wake, (CLOCK_CFG_ALARM_WAKE_MS + 1000) / 1000, max, volume_get());
+}
+
+int
+main(void) {
+    test_linear();
+    test_perceptual();
+    test_fast();
+    test_key_cancels();
+    test_busy_player();
+    test_alarm(0, CLOCK_CFG_ALARM_WAKE_MS + CLOCK_CFG_ALARM_ESCALATE_MS + 10000);
+    test_alarm(30000, 200000);
+
+    printf("%s\n", test_failures ? "FAILED" : "OK");
+    return test_failures != 0;
+}